@@ -0,0 +1,101 @@
+// Description: Defines the CachedFourMomentum class, a four-momentum that keeps its derived kinematics once computed.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef CACHEDFOURMOMENTUM_H
+#define CACHEDFOURMOMENTUM_H
+
+#include "FourMomentum.h"
+#include <cmath>
+#include <limits>
+
+// A FourMomentum plus pT, eta, phi and mass, each computed on first request and kept
+// until a component changes. NaN marks a value not computed yet. Cached values are
+// exactly what the FourMomentum getters return, so caching never changes a result.
+//
+// FourMomentum itself stays a packed 32-byte value for the batch kernels and
+// arithmetic; this wrapper is what long-lived objects such as Lepton hold.
+class alignas(32) CachedFourMomentum
+{
+private:
+  FourMomentum momentum;
+  mutable double pt;
+  mutable double eta;
+  mutable double phi;
+  mutable double mass;
+
+  static constexpr double unset = std::numeric_limits<double>::quiet_NaN();
+
+public:
+  constexpr CachedFourMomentum(double energy = 0.0, double px = 0.0, double py = 0.0, double pz = 0.0)
+    : momentum(energy, px, py, pz), pt(unset), eta(unset), phi(unset), mass(unset)
+  {}
+  constexpr explicit CachedFourMomentum(const FourMomentum& momentum)
+    : momentum(momentum), pt(unset), eta(unset), phi(unset), mass(unset)
+  {}
+
+  // Setters; each drops the cached values
+  void set(const FourMomentum& value) { momentum = value; invalidate(); }
+  void set_energy(double energy) { momentum.set_energy(energy); invalidate(); } // Throws like FourMomentum::set_energy
+  void set_px(double px) { momentum.set_px(px); invalidate(); }
+  void set_py(double py) { momentum.set_py(py); invalidate(); }
+  void set_pz(double pz) { momentum.set_pz(pz); invalidate(); }
+  void invalidate() { pt = eta = phi = mass = unset; }
+
+  // Fills the cache with values computed elsewhere, e.g. by kinematics_batch. They
+  // must be the values the getters would compute.
+  void prime(double pt_value, double eta_value, double phi_value, double mass_value) const
+  {
+    pt = pt_value;
+    eta = eta_value;
+    phi = phi_value;
+    mass = mass_value;
+  }
+
+  // Getters
+  const FourMomentum& get() const { return momentum; }
+  constexpr double get_energy() const { return momentum.get_energy(); }
+  constexpr double get_px() const { return momentum.get_px(); }
+  constexpr double get_py() const { return momentum.get_py(); }
+  constexpr double get_pz() const { return momentum.get_pz(); }
+
+  double get_pt() const
+  {
+    if (std::isnan(pt))
+    {
+      pt = momentum.get_pt();
+    }
+    return pt;
+  }
+
+  double get_eta() const
+  {
+    if (std::isnan(eta))
+    {
+      eta = momentum.get_eta_for_pt(get_pt());
+    }
+    return eta;
+  }
+
+  double get_phi() const
+  {
+    if (std::isnan(phi))
+    {
+      phi = momentum.get_phi();
+    }
+    return phi;
+  }
+
+  double get_mass() const
+  {
+    if (std::isnan(mass))
+    {
+      mass = momentum.get_mass();
+    }
+    return mass;
+  }
+};
+
+static_assert(sizeof(CachedFourMomentum) == 64, "CachedFourMomentum is the 32-byte vector plus four cached values");
+
+#endif
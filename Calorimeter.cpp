@@ -0,0 +1,348 @@
+// Description: Defines the Calorimeter class, an eta-phi-layer cell grid with topological clustering of energy deposits.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Calorimeter.h"
+#include "Electron.h"
+#include "ParticleStore.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+  constexpr double pi = 3.141592653589793;
+
+  // Energy a minimum-ionising muon leaves in each layer, in MeV
+  constexpr std::array<double, calorimeter_layer_count> muon_layer_deposits{{60.0, 240.0, 700.0, 700.0}};
+  // Share of a hadronic tau's energy in each layer
+  constexpr std::array<double, calorimeter_layer_count> hadronic_layer_fractions{{0.05, 0.15, 0.55, 0.25}};
+
+  double wrap_phi(double phi)
+  {
+    phi = std::remainder(phi, 2 * pi); // [-pi, pi]
+    return phi >= pi ? phi - 2 * pi : phi;
+  }
+}
+
+Calorimeter::Calorimeter(const CalorimeterConfig& config)
+  : config(config), eta_scale(0.0), phi_scale(0.0)
+{
+  if (config.eta_bins == 0 || config.phi_bins < 3)
+  {
+    throw std::invalid_argument("Calorimeter needs at least one eta bin and three phi bins");
+  }
+  if (!(config.max_abs_eta > 0))
+  {
+    throw std::invalid_argument("Calorimeter eta coverage must be greater than 0");
+  }
+  if (config.core_fraction < 0 || config.core_fraction > 1)
+  {
+    throw std::invalid_argument("Calorimeter shower core fraction must be between 0 and 1");
+  }
+  if (config.seed_threshold < config.neighbor_threshold || config.neighbor_threshold < config.perimeter_threshold)
+  {
+    throw std::invalid_argument("Clustering thresholds must satisfy seed >= neighbour >= perimeter");
+  }
+  std::size_t cell_count = calorimeter_layer_count * config.eta_bins * config.phi_bins;
+  if (cell_count > static_cast<std::size_t>(INT32_MAX))
+  {
+    throw std::invalid_argument("Calorimeter grid is too large");
+  }
+  cells.assign(cell_count, 0.0);
+  cluster_of.assign(cell_count, -1);
+  touched_flag.assign(cell_count, 0);
+  eta_scale = config.eta_bins / (2 * config.max_abs_eta);
+  phi_scale = config.phi_bins / (2 * pi);
+}
+
+double Calorimeter::get_cell_energy(std::size_t layer, std::size_t eta_bin, std::size_t phi_bin) const
+{
+  if (layer >= calorimeter_layer_count || eta_bin >= config.eta_bins || phi_bin >= config.phi_bins)
+  {
+    throw std::out_of_range("Calorimeter cell out of range");
+  }
+  return cells[cell_index(layer, eta_bin, phi_bin)];
+}
+
+double Calorimeter::get_total_energy() const
+{
+  double total = 0.0;
+  for (std::uint32_t cell : touched)
+  {
+    total += cells[cell];
+  }
+  return total;
+}
+
+void Calorimeter::reset()
+{
+  for (std::uint32_t cell : touched)
+  {
+    cells[cell] = 0.0;
+    cluster_of[cell] = -1;
+    touched_flag[cell] = 0;
+  }
+  touched.clear();
+}
+
+void Calorimeter::add_to_cell(std::size_t cell, double energy)
+{
+  if (!touched_flag[cell])
+  {
+    touched_flag[cell] = 1;
+    touched.push_back(static_cast<std::uint32_t>(cell));
+  }
+  cells[cell] += energy;
+}
+
+bool Calorimeter::find_bins(double eta, double phi, std::size_t& eta_bin, std::size_t& phi_bin) const
+{
+  if (!(std::abs(eta) < config.max_abs_eta) || !std::isfinite(phi))
+  {
+    return false;
+  }
+  eta_bin = std::min(static_cast<std::size_t>((eta + config.max_abs_eta) * eta_scale), config.eta_bins - 1);
+  phi_bin = std::min(static_cast<std::size_t>((wrap_phi(phi) + pi) * phi_scale), config.phi_bins - 1);
+  return true;
+}
+
+void Calorimeter::deposit(double eta, double phi, std::size_t layer, double energy)
+{
+  if (layer >= calorimeter_layer_count)
+  {
+    throw std::out_of_range("Calorimeter layer out of range");
+  }
+  std::size_t eta_bin, phi_bin;
+  if (find_bins(eta, phi, eta_bin, phi_bin))
+  {
+    add_to_cell(cell_index(layer, eta_bin, phi_bin), energy);
+  }
+}
+
+void Calorimeter::deposit_shower(double eta, double phi, const std::array<double, calorimeter_layer_count>& layer_energies)
+{
+  std::size_t eta_bin, phi_bin;
+  if (!find_bins(eta, phi, eta_bin, phi_bin))
+  {
+    return;
+  }
+  double neighbor_fraction = (1.0 - config.core_fraction) / 8;
+  for (std::size_t layer = 0; layer < calorimeter_layer_count; ++layer)
+  {
+    double energy = layer_energies[layer];
+    if (energy == 0.0)
+    {
+      continue;
+    }
+    double core = energy * config.core_fraction;
+    for (int d_eta = -1; d_eta <= 1; ++d_eta)
+    {
+      std::ptrdiff_t neighbor_eta = static_cast<std::ptrdiff_t>(eta_bin) + d_eta;
+      for (int d_phi = -1; d_phi <= 1; ++d_phi)
+      {
+        if (d_eta == 0 && d_phi == 0)
+        {
+          continue;
+        }
+        if (neighbor_eta < 0 || neighbor_eta >= static_cast<std::ptrdiff_t>(config.eta_bins))
+        {
+          core += energy * neighbor_fraction; // Off the edge of the grid: keep the energy in the hit cell
+          continue;
+        }
+        std::size_t neighbor_phi = (phi_bin + config.phi_bins + d_phi) % config.phi_bins;
+        add_to_cell(cell_index(layer, static_cast<std::size_t>(neighbor_eta), neighbor_phi), energy * neighbor_fraction);
+      }
+    }
+    add_to_cell(cell_index(layer, eta_bin, phi_bin), core);
+  }
+}
+
+void Calorimeter::deposit_event(const ParticleStore& event)
+{
+  for (ParticleView particle : event)
+  {
+    FourMomentum momentum = particle.get_four_momentum();
+    std::array<double, calorimeter_layer_count> layers{};
+    switch (particle.get_type())
+    {
+      case ParticleType::Electron:
+        layers = particle.get_layer_energies();
+        break;
+      case ParticleType::Muon:
+        for (std::size_t layer = 0; layer < calorimeter_layer_count; ++layer)
+        {
+          layers[layer] = std::min(muon_layer_deposits[layer], momentum.get_energy() / calorimeter_layer_count);
+        }
+        break;
+      case ParticleType::Tau:
+        if (particle.get_decay_mode() == TauDecayMode::Leptonic)
+        {
+          continue; // Its decay products are rows of their own
+        }
+        for (std::size_t layer = 0; layer < calorimeter_layer_count; ++layer)
+        {
+          layers[layer] = hadronic_layer_fractions[layer] * momentum.get_energy();
+        }
+        break;
+      case ParticleType::Neutrino:
+      case ParticleType::TauNeutrino:
+        continue;
+    }
+    deposit_shower(momentum.get_eta(), momentum.get_phi(), layers);
+  }
+}
+
+// Eight eta-phi neighbours in the same layer (phi wraps, eta does not), plus the
+// cells directly in front of and behind it in the neighbouring layers
+template <typename Visit>
+void Calorimeter::for_each_neighbor(std::uint32_t cell, Visit visit) const
+{
+  std::size_t phi_bin = cell % config.phi_bins;
+  std::size_t eta_bin = (cell / config.phi_bins) % config.eta_bins;
+  std::size_t layer = cell / (config.phi_bins * config.eta_bins);
+  for (int d_eta = -1; d_eta <= 1; ++d_eta)
+  {
+    std::ptrdiff_t neighbor_eta = static_cast<std::ptrdiff_t>(eta_bin) + d_eta;
+    if (neighbor_eta < 0 || neighbor_eta >= static_cast<std::ptrdiff_t>(config.eta_bins))
+    {
+      continue;
+    }
+    for (int d_phi = -1; d_phi <= 1; ++d_phi)
+    {
+      if (d_eta != 0 || d_phi != 0)
+      {
+        std::size_t neighbor_phi = (phi_bin + config.phi_bins + d_phi) % config.phi_bins;
+        visit(static_cast<std::uint32_t>(cell_index(layer, static_cast<std::size_t>(neighbor_eta), neighbor_phi)));
+      }
+    }
+  }
+  if (layer > 0)
+  {
+    visit(static_cast<std::uint32_t>(cell_index(layer - 1, eta_bin, phi_bin)));
+  }
+  if (layer + 1 < calorimeter_layer_count)
+  {
+    visit(static_cast<std::uint32_t>(cell_index(layer + 1, eta_bin, phi_bin)));
+  }
+}
+
+void Calorimeter::cluster(std::vector<CaloCluster>& clusters)
+{
+  clusters.clear();
+  seeds.clear();
+  for (std::uint32_t cell : touched)
+  {
+    cluster_of[cell] = -1;
+    if (cells[cell] > config.seed_threshold)
+    {
+      seeds.push_back(cell);
+    }
+  }
+  std::sort(seeds.begin(), seeds.end(), [this](std::uint32_t a, std::uint32_t b)
+  {
+    return cells[a] > cells[b] || (cells[a] == cells[b] && a < b);
+  });
+
+  std::size_t cells_per_layer = config.eta_bins * config.phi_bins;
+  for (std::uint32_t seed : seeds)
+  {
+    if (cluster_of[seed] >= 0)
+    {
+      continue; // Already swallowed by a more energetic cluster
+    }
+    std::int32_t id = static_cast<std::int32_t>(clusters.size());
+    double seed_phi = -pi + ((seed % config.phi_bins) + 0.5) / phi_scale;
+    CaloCluster result{0.0, 0.0, 0.0, {0.0, 0.0, 0.0, 0.0}, 0};
+    double eta_sum = 0.0;
+    double phi_offset_sum = 0.0; // Relative to the seed, so clusters across phi = +-pi average correctly
+
+    auto take = [&](std::uint32_t cell)
+    {
+      cluster_of[cell] = id;
+      double energy = cells[cell];
+      double eta = -config.max_abs_eta + (((cell / config.phi_bins) % config.eta_bins) + 0.5) / eta_scale;
+      double phi = -pi + ((cell % config.phi_bins) + 0.5) / phi_scale;
+      result.energy += energy;
+      result.layer_energies[cell / cells_per_layer] += energy;
+      result.cell_count += 1;
+      eta_sum += energy * eta;
+      phi_offset_sum += energy * wrap_phi(phi - seed_phi);
+    };
+
+    frontier.clear();
+    frontier.push_back(seed);
+    take(seed);
+    for (std::size_t next = 0; next < frontier.size(); ++next)
+    {
+      for_each_neighbor(frontier[next], [&](std::uint32_t neighbor)
+      {
+        if (!touched_flag[neighbor] || cluster_of[neighbor] >= 0 || cells[neighbor] <= config.perimeter_threshold)
+        {
+          return;
+        }
+        take(neighbor);
+        if (cells[neighbor] > config.neighbor_threshold)
+        {
+          frontier.push_back(neighbor); // Perimeter cells join the cluster but do not grow it
+        }
+      });
+    }
+
+    result.eta = eta_sum / result.energy;
+    result.phi = wrap_phi(seed_phi + phi_offset_sum / result.energy);
+    clusters.push_back(result);
+  }
+}
+
+int find_nearest_cluster(const std::vector<CaloCluster>& clusters, double eta, double phi, double max_delta_r)
+{
+  int nearest = -1;
+  double best = max_delta_r * max_delta_r;
+  for (std::size_t i = 0; i < clusters.size(); ++i)
+  {
+    double d_eta = clusters[i].eta - eta;
+    double d_phi = wrap_phi(clusters[i].phi - phi);
+    double distance = d_eta * d_eta + d_phi * d_phi;
+    if (distance <= best)
+    {
+      best = distance;
+      nearest = static_cast<int>(i);
+    }
+  }
+  return nearest;
+}
+
+std::size_t Calorimeter::update_electron_layers(ParticleStore& event, const std::vector<CaloCluster>& clusters) const
+{
+  std::size_t matched = 0;
+  const auto& types = event.type_column();
+  for (ParticleStore::Index row = 0; row < event.size(); ++row)
+  {
+    if (types[row] != ParticleType::Electron)
+    {
+      continue;
+    }
+    FourMomentum momentum = event[row].get_four_momentum();
+    int nearest = find_nearest_cluster(clusters, momentum.get_eta(), momentum.get_phi(), config.match_radius);
+    if (nearest >= 0)
+    {
+      // As in Electron, any difference from the electron's energy is spread evenly over the layers
+      event.set_layer_energies(row, clusters[nearest].layer_energies);
+      ++matched;
+    }
+  }
+  return matched;
+}
+
+bool Calorimeter::update_electron_layers(Electron& electron, const std::vector<CaloCluster>& clusters) const
+{
+  const FourMomentum& momentum = electron.get_four_momentum();
+  int nearest = find_nearest_cluster(clusters, momentum.get_eta(), momentum.get_phi(), config.match_radius);
+  if (nearest < 0)
+  {
+    return false;
+  }
+  electron.set_layer_energies(clusters[nearest].layer_energies);
+  return true;
+}
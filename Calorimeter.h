@@ -0,0 +1,104 @@
+// Description: Defines the Calorimeter class, an eta-phi-layer cell grid with topological clustering of energy deposits.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef CALORIMETER_H
+#define CALORIMETER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Electron;
+class ParticleStore;
+
+constexpr std::size_t calorimeter_layer_count = 4; // EM_1, EM_2, HAD_1, HAD_2, as in Electron
+
+struct CalorimeterConfig
+{
+  // Geometry
+  std::size_t eta_bins = 50;
+  std::size_t phi_bins = 64;
+  double max_abs_eta = 2.5;
+
+  // Showers put core_fraction of each layer's energy in the hit cell and share the
+  // rest equally between its eight eta-phi neighbours
+  double core_fraction = 0.8;
+
+  // Topological clustering thresholds, in MeV: clusters start from cells above the
+  // seed threshold, grow through neighbours above the neighbour threshold and take
+  // in, without growing further, neighbours above the perimeter threshold
+  double seed_threshold = 1000.0;
+  double neighbor_threshold = 400.0;
+  double perimeter_threshold = 100.0;
+
+  double match_radius = 0.1; // Largest delta R between an electron and its cluster
+};
+
+struct CaloCluster
+{
+  double energy;
+  double eta; // Energy-weighted cell centres
+  double phi;
+  std::array<double, calorimeter_layer_count> layer_energies;
+  std::uint32_t cell_count;
+};
+
+// Cells live in one flat array, phi fastest, then eta, then layer. Every deposit
+// records its cell in a touched list the first time it lands there, so reset() and
+// the clustering seed scan cost O(touched cells), not O(grid size).
+//
+// Not thread-safe: use one instance per thread.
+class Calorimeter
+{
+private:
+  CalorimeterConfig config;
+  std::vector<double> cells;
+  std::vector<std::int32_t> cluster_of; // Per cell: owning cluster or -1; only touched cells are ever set
+  std::vector<std::uint8_t> touched_flag;
+  std::vector<std::uint32_t> touched;
+  std::vector<std::uint32_t> seeds; // Clustering scratch, kept between events
+  std::vector<std::uint32_t> frontier;
+  double eta_scale; // Bins per unit eta
+  double phi_scale; // Bins per radian
+
+  std::size_t cell_index(std::size_t layer, std::size_t eta_bin, std::size_t phi_bin) const
+  {
+    return (layer * config.eta_bins + eta_bin) * config.phi_bins + phi_bin;
+  }
+  void add_to_cell(std::size_t cell, double energy);
+  bool find_bins(double eta, double phi, std::size_t& eta_bin, std::size_t& phi_bin) const;
+  template <typename Visit>
+  void for_each_neighbor(std::uint32_t cell, Visit visit) const;
+
+public:
+  explicit Calorimeter(const CalorimeterConfig& config = CalorimeterConfig());
+
+  const CalorimeterConfig& get_config() const { return config; }
+  std::size_t get_cell_count() const { return cells.size(); }
+  std::size_t get_touched_count() const { return touched.size(); }
+  double get_cell_energy(std::size_t layer, std::size_t eta_bin, std::size_t phi_bin) const;
+  double get_total_energy() const;
+
+  void reset(); // Clears the touched cells only
+
+  // Deposits outside |eta| < max_abs_eta are dropped
+  void deposit(double eta, double phi, std::size_t layer, double energy); // Into a single cell
+  void deposit_shower(double eta, double phi, const std::array<double, calorimeter_layer_count>& layer_energies);
+  void deposit_event(const ParticleStore& event); // Electrons, muons and hadronic taus; neutrinos pass through
+
+  // Builds topological clusters from the current deposits, highest-energy seed first.
+  // A cell belongs to the first cluster that reaches it; clusters are not split.
+  void cluster(std::vector<CaloCluster>& clusters);
+
+  // Sets the layer energies of each electron in the event from the nearest cluster
+  // within match_radius; returns how many electrons were matched
+  std::size_t update_electron_layers(ParticleStore& event, const std::vector<CaloCluster>& clusters) const;
+  bool update_electron_layers(Electron& electron, const std::vector<CaloCluster>& clusters) const;
+};
+
+// Index of the cluster nearest to (eta, phi) within max_delta_r, or -1
+int find_nearest_cluster(const std::vector<CaloCluster>& clusters, double eta, double phi, double max_delta_r);
+
+#endif
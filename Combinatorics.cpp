@@ -0,0 +1,267 @@
+// Description: Defines the Combinatorics class, which enumerates lepton pairs and triplets for invariant-mass resonance searches.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Combinatorics.h"
+#include "FourMomentum.h"
+#include "Lepton.h"
+#include "ParticleStore.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+  double signed_square(double value)
+  {
+    return value < 0 ? -value * value : value * value;
+  }
+
+  // The window in terms of m^2, for rejecting candidates before taking a square root.
+  // Slightly widened so rounding never rejects a candidate the exact check would keep.
+  struct SquaredWindow
+  {
+    double low;
+    double high;
+
+    explicit SquaredWindow(const CandidateSelection& selection)
+      : low(signed_square(selection.min_mass)), high(signed_square(selection.max_mass))
+    {
+      low -= std::abs(low) * 1e-12;
+      high += std::abs(high) * 1e-12;
+    }
+  };
+
+  double mass_squared(double e, double x, double y, double z)
+  {
+    return e * e - (x * x + y * y + z * z);
+  }
+
+  double candidate_mass(double e, double x, double y, double z)
+  {
+    return FourMomentum(e, x, y, z).get_mass(); // Same rounding as summing the particles directly
+  }
+}
+
+Combinatorics::Combinatorics(const CandidateSelection& selection)
+{
+  set_selection(selection);
+}
+
+void Combinatorics::set_selection(const CandidateSelection& new_selection)
+{
+  if (new_selection.min_mass > new_selection.max_mass)
+  {
+    throw std::invalid_argument("Candidate mass window must have min_mass <= max_mass");
+  }
+  selection = new_selection;
+}
+
+void Combinatorics::stage(std::uint32_t index, double e, double x, double y, double z, int q, ParticleType t)
+{
+  if ((selection.type_mask & particle_type_bit(t)) == 0)
+  {
+    return;
+  }
+  double transverse = std::hypot(x, y);
+  if (transverse < selection.min_pt[0] && transverse < selection.min_pt[1] && transverse < selection.min_pt[2])
+  {
+    return; // Below every threshold, so it can never take part
+  }
+  rows.push_back(Row{e, x, y, z, transverse, index, static_cast<std::int8_t>(q), t});
+}
+
+void Combinatorics::sort_staged()
+{
+  // Ties keep input order so the output does not depend on the sort implementation
+  std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.pt > b.pt || (a.pt == b.pt && a.index < b.index); });
+  std::size_t count = rows.size();
+  energy.resize(count);
+  px.resize(count);
+  py.resize(count);
+  pz.resize(count);
+  pt.resize(count);
+  charge.resize(count);
+  type.resize(count);
+  source_index.resize(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const Row& row = rows[i];
+    energy[i] = row.energy;
+    px[i] = row.px;
+    py[i] = row.py;
+    pz[i] = row.pz;
+    pt[i] = row.pt;
+    charge[i] = row.charge;
+    type[i] = row.type;
+    source_index[i] = row.index;
+  }
+}
+
+void Combinatorics::load(const ParticleStore& event)
+{
+  rows.clear();
+  const auto& energies = event.energy_column();
+  const auto& xs = event.px_column();
+  const auto& ys = event.py_column();
+  const auto& zs = event.pz_column();
+  const auto& charges = event.charge_column();
+  const auto& types = event.type_column();
+  for (std::size_t i = 0; i < event.size(); ++i)
+  {
+    stage(static_cast<std::uint32_t>(i), energies[i], xs[i], ys[i], zs[i], charges[i], types[i]);
+  }
+  sort_staged();
+}
+
+void Combinatorics::load(const Lepton* const* leptons, std::size_t count)
+{
+  rows.clear();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const FourMomentum& momentum = leptons[i]->get_four_momentum();
+    stage(static_cast<std::uint32_t>(i), momentum.get_energy(), momentum.get_px(), momentum.get_py(), momentum.get_pz(),
+          leptons[i]->get_charge(), leptons[i]->get_type_id());
+  }
+  sort_staged();
+}
+
+bool Combinatorics::charges_pass(int first, int second) const
+{
+  switch (selection.charge)
+  {
+    case ChargeRequirement::Opposite: return first == -second && first != 0;
+    case ChargeRequirement::Same: return first == second;
+    case ChargeRequirement::Any: break;
+  }
+  return true;
+}
+
+bool Combinatorics::flavors_pass(ParticleType first, ParticleType second) const
+{
+  switch (selection.flavor)
+  {
+    case FlavorRequirement::Same: return first == second;
+    case FlavorRequirement::Different: return first != second;
+    case FlavorRequirement::Any: break;
+  }
+  return true;
+}
+
+std::size_t Combinatorics::emit_pairs(PairCandidates& out) const
+{
+  std::size_t count = pt.size();
+  std::size_t added = 0;
+  SquaredWindow window(selection);
+  for (std::size_t i = 0; i < count && pt[i] >= selection.min_pt[0]; ++i)
+  {
+    for (std::size_t j = i + 1; j < count && pt[j] >= selection.min_pt[1]; ++j)
+    {
+      if (!charges_pass(charge[i], charge[j]) || !flavors_pass(type[i], type[j]))
+      {
+        continue;
+      }
+      double e = energy[i] + energy[j];
+      double x = px[i] + px[j];
+      double y = py[i] + py[j];
+      double z = pz[i] + pz[j];
+      double m2 = mass_squared(e, x, y, z);
+      if (m2 < window.low || m2 > window.high)
+      {
+        continue;
+      }
+      double mass = candidate_mass(e, x, y, z);
+      if (mass < selection.min_mass || mass > selection.max_mass)
+      {
+        continue;
+      }
+      out.first.push_back(source_index[i]);
+      out.second.push_back(source_index[j]);
+      out.mass.push_back(mass);
+      ++added;
+    }
+  }
+  return added;
+}
+
+std::size_t Combinatorics::emit_triplets(TripletCandidates& out) const
+{
+  std::size_t count = pt.size();
+  std::size_t added = 0;
+  bool same_charge = selection.charge == ChargeRequirement::Same;
+  bool same_flavor = selection.flavor == FlavorRequirement::Same;
+  SquaredWindow window(selection);
+  for (std::size_t i = 0; i < count && pt[i] >= selection.min_pt[0]; ++i)
+  {
+    for (std::size_t j = i + 1; j < count && pt[j] >= selection.min_pt[1]; ++j)
+    {
+      // "All the same" requirements can already be decided on the pair
+      if ((same_charge && charge[i] != charge[j]) || (same_flavor && type[i] != type[j]))
+      {
+        continue;
+      }
+      double e12 = energy[i] + energy[j];
+      double x12 = px[i] + px[j];
+      double y12 = py[i] + py[j];
+      double z12 = pz[i] + pz[j];
+      if (mass_squared(e12, x12, y12, z12) > window.high)
+      {
+        continue; // m123 >= m12, so every triplet built on this pair is above the window
+      }
+      for (std::size_t k = j + 1; k < count && pt[k] >= selection.min_pt[2]; ++k)
+      {
+        bool all_same_charge = charge[i] == charge[j] && charge[j] == charge[k];
+        bool all_same_flavor = type[i] == type[j] && type[j] == type[k];
+        if ((selection.charge == ChargeRequirement::Opposite && all_same_charge) || (same_charge && !all_same_charge) ||
+            (selection.flavor == FlavorRequirement::Different && all_same_flavor) || (same_flavor && !all_same_flavor))
+        {
+          continue;
+        }
+        double e = e12 + energy[k];
+        double x = x12 + px[k];
+        double y = y12 + py[k];
+        double z = z12 + pz[k];
+        double m2 = mass_squared(e, x, y, z);
+        if (m2 < window.low || m2 > window.high)
+        {
+          continue;
+        }
+        double mass = candidate_mass(e, x, y, z);
+        if (mass < selection.min_mass || mass > selection.max_mass)
+        {
+          continue;
+        }
+        out.first.push_back(source_index[i]);
+        out.second.push_back(source_index[j]);
+        out.third.push_back(source_index[k]);
+        out.mass.push_back(mass);
+        ++added;
+      }
+    }
+  }
+  return added;
+}
+
+std::size_t Combinatorics::find_pairs(const ParticleStore& event, PairCandidates& out)
+{
+  load(event);
+  return emit_pairs(out);
+}
+
+std::size_t Combinatorics::find_pairs(const Lepton* const* leptons, std::size_t count, PairCandidates& out)
+{
+  load(leptons, count);
+  return emit_pairs(out);
+}
+
+std::size_t Combinatorics::find_triplets(const ParticleStore& event, TripletCandidates& out)
+{
+  load(event);
+  return emit_triplets(out);
+}
+
+std::size_t Combinatorics::find_triplets(const Lepton* const* leptons, std::size_t count, TripletCandidates& out)
+{
+  load(leptons, count);
+  return emit_triplets(out);
+}
@@ -0,0 +1,134 @@
+// Description: Defines the Combinatorics class, which enumerates lepton pairs and triplets for invariant-mass resonance searches.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef COMBINATORICS_H
+#define COMBINATORICS_H
+
+#include "ParticleType.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class Lepton;
+class ParticleStore;
+
+enum class ChargeRequirement : std::uint8_t
+{
+  Any,
+  Opposite, // Pairs: q1 = -q2. Triplets: not all charges of one sign (|q1 + q2 + q3| = 1 for unit charges)
+  Same // Every member has the same charge
+};
+
+enum class FlavorRequirement : std::uint8_t
+{
+  Any,
+  Same, // All members of one particle type, e.g. ee or mumu
+  Different // Pairs: e-mu. Triplets: not all of one type
+};
+
+struct CandidateSelection
+{
+  std::uint8_t type_mask = particle_type_bit(ParticleType::Electron) | particle_type_bit(ParticleType::Muon);
+  ChargeRequirement charge = ChargeRequirement::Opposite;
+  FlavorRequirement flavor = FlavorRequirement::Same;
+  // Minimum pT of the leading, second and third member, in MeV. Members are
+  // enumerated in falling pT order, so loops stop at the first lepton below threshold.
+  std::array<double, 3> min_pt = {0.0, 0.0, 0.0};
+  double min_mass = 0.0; // Invariant mass window, in MeV
+  double max_mass = std::numeric_limits<double>::infinity();
+};
+
+// Flat output buffers: entry i is one candidate. Indices refer to the input
+// collection (ParticleStore rows, or positions in the Lepton array).
+struct PairCandidates
+{
+  std::vector<std::uint32_t> first;
+  std::vector<std::uint32_t> second;
+  std::vector<double> mass;
+
+  std::size_t size() const { return mass.size(); }
+  void clear()
+  {
+    first.clear();
+    second.clear();
+    mass.clear();
+  }
+};
+
+struct TripletCandidates
+{
+  std::vector<std::uint32_t> first;
+  std::vector<std::uint32_t> second;
+  std::vector<std::uint32_t> third;
+  std::vector<double> mass;
+
+  std::size_t size() const { return mass.size(); }
+  void clear()
+  {
+    first.clear();
+    second.clear();
+    third.clear();
+    mass.clear();
+  }
+};
+
+// Builds pair and triplet candidates without creating particle objects. Each call
+// gathers the selected leptons into pT-ordered scratch columns, which are kept
+// between events, then sums four-momenta straight from those columns. Within a
+// candidate the members are ordered by falling pT.
+//
+// Triplets use the fact that adding a physical (time- or light-like) momentum
+// never lowers the invariant mass: once m12 is above max_mass no third lepton can
+// bring the triplet back into the window, so those pairs are skipped.
+//
+// Not thread-safe: use one instance per thread.
+class Combinatorics
+{
+private:
+  CandidateSelection selection;
+
+  // Scratch columns of the selected leptons, sorted by falling pT
+  std::vector<double> energy;
+  std::vector<double> px;
+  std::vector<double> py;
+  std::vector<double> pz;
+  std::vector<double> pt;
+  std::vector<std::int8_t> charge;
+  std::vector<ParticleType> type;
+  std::vector<std::uint32_t> source_index;
+
+  struct Row
+  {
+    double energy, px, py, pz, pt;
+    std::uint32_t index;
+    std::int8_t charge;
+    ParticleType type;
+  };
+  std::vector<Row> rows; // Staging area for sorting
+
+  void load(const ParticleStore& event);
+  void load(const Lepton* const* leptons, std::size_t count);
+  void stage(std::uint32_t index, double e, double x, double y, double z, int q, ParticleType t);
+  void sort_staged();
+  bool charges_pass(int first, int second) const;
+  bool flavors_pass(ParticleType first, ParticleType second) const;
+  std::size_t emit_pairs(PairCandidates& out) const;
+  std::size_t emit_triplets(TripletCandidates& out) const;
+
+public:
+  explicit Combinatorics(const CandidateSelection& selection = CandidateSelection());
+
+  const CandidateSelection& get_selection() const { return selection; }
+  void set_selection(const CandidateSelection& selection);
+
+  // Append the candidates of one event to out and return how many were added
+  std::size_t find_pairs(const ParticleStore& event, PairCandidates& out);
+  std::size_t find_pairs(const Lepton* const* leptons, std::size_t count, PairCandidates& out);
+  std::size_t find_triplets(const ParticleStore& event, TripletCandidates& out);
+  std::size_t find_triplets(const Lepton* const* leptons, std::size_t count, TripletCandidates& out);
+};
+
+#endif
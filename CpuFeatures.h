@@ -0,0 +1,45 @@
+// Description: Runtime detection of the SIMD instruction sets used by the batch kernels.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+// x86 kernels are built with per-function target attributes, so the rest of the
+// program can still be compiled for a baseline CPU.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define LEPTON_X86_KERNELS 1
+#else
+#define LEPTON_X86_KERNELS 0
+#endif
+
+enum class SimdLevel { Scalar, Avx2, Avx512 };
+
+inline SimdLevel detect_simd_level()
+{
+#if LEPTON_X86_KERNELS
+  static const SimdLevel level = []
+  {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+      return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return SimdLevel::Avx2;
+    }
+    return SimdLevel::Scalar;
+  }();
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+constexpr const char* simd_level_name(SimdLevel level)
+{
+  return level == SimdLevel::Avx512 ? "avx512" : level == SimdLevel::Avx2 ? "avx2" : "scalar";
+}
+
+#endif
@@ -3,39 +3,71 @@
 // Date: 18/04/2024
 
 #include "Detector.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "ParticleStore.h"
 #include <iostream>
 
+namespace
+{
+  // Maps a detector name to its type; returns false for unknown names
+  bool parse_detector_type(const std::string& name, DetectorType& type)
+  {
+    for (std::size_t detector = 0; detector < detector_type_count; ++detector)
+    {
+      if (name == detector_type_name(static_cast<DetectorType>(detector)))
+      {
+        type = static_cast<DetectorType>(detector);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Per-particle-type masks for every detector, built once from the acceptance table
+  constexpr std::array<std::uint8_t, particle_type_count> build_mask_table()
+  {
+    std::array<std::uint8_t, particle_type_count> table{};
+    for (std::size_t particle = 0; particle < particle_type_count; ++particle)
+    {
+      table[particle] = Detector::acceptance_mask(static_cast<ParticleType>(particle));
+    }
+    return table;
+  }
+  constexpr std::array<std::uint8_t, particle_type_count> mask_table = build_mask_table();
+}
+
 Detector::Detector() 
-  : detector_type("tracker"), status(false) 
+  : detector_type(DetectorType::Tracker), status(false) 
+{}
+
+Detector::Detector(DetectorType type) 
+  : detector_type(type), status(false) 
 {}
 
 Detector::Detector(const std::string& type) 
-  : status(false) 
+  : detector_type(DetectorType::Tracker), status(false) 
 {
   // Validate detector type before setting
-  if (type == "tracker" || type == "calorimeter" || type == "muon chamber") 
+  if (!parse_detector_type(type, this->detector_type)) 
   {
-    this->detector_type = type;
-  } 
-  else 
-  {
-    std::cerr << "Invalid detector type. Setting to default 'tracker'.\n";
-    this->detector_type = "tracker"; // Default to tracker if invalid
+    LEPTON_LOG_WARNING(LogCategory::Detector, "Invalid detector type. Setting to default 'tracker'.");
   }
 }
 
 Detector::~Detector() {}
 
+void Detector::set_detector_type(DetectorType type) 
+{
+  this->detector_type = type;
+}
+
 void Detector::set_detector_type(const std::string& type) 
 {
   // Validate detector type as in constructor
-  if (type == "tracker" || type == "calorimeter" || type == "muon chamber") 
-  {
-    this->detector_type = type;
-  } 
-  else 
+  if (!parse_detector_type(type, this->detector_type)) 
   {
-    std::cerr << "Invalid detector type. No change made.\n";
+    LEPTON_LOG_WARNING(LogCategory::Detector, "Invalid detector type. No change made.");
   }
 }
 
@@ -44,11 +76,16 @@ void Detector::set_status(bool status)
   this->status = status;
 }
 
-std::string Detector::get_detector_type() const 
+DetectorType Detector::get_type() const 
 {
   return this->detector_type;
 }
 
+std::string Detector::get_detector_type() const 
+{
+  return detector_type_name(this->detector_type);
+}
+
 bool Detector::get_status() const 
 {
   return this->status;
@@ -66,27 +103,57 @@ void Detector::turn_off()
 
 int Detector::detect_particle(const Lepton& particle) const 
 {
+  LEPTON_METRIC_COUNT(detector_checked_counter(static_cast<std::size_t>(detector_type)));
   if (!status) 
   {
-    std::cout << "Detector is off.\n";
+    LEPTON_LOG_DEBUG(LogCategory::Detector, "Detector is off.");
     return 0;
   }
 
-  if ((detector_type == "tracker" && (particle.get_particle_type() == "electron" || particle.get_particle_type() == "muon")) ||
-      (detector_type == "calorimeter" && particle.get_particle_type() == "electron") ||
-      (detector_type == "muon chamber" && particle.get_particle_type() == "muon")) 
+  if (accepts(detector_type, particle.get_type_id())) 
   {
-    std::cout << particle.get_particle_type() << (particle.get_charge() == 1 ? " (antiparticle)" : "") << " was detected\n";
+    LEPTON_METRIC_COUNT(detector_accepted_counter(static_cast<std::size_t>(detector_type)));
+    LEPTON_LOG_INFO(LogCategory::Detector, particle.get_particle_type() << (particle.get_charge() == 1 ? " (antiparticle)" : "") << " was detected");
     return 1;
   }
 
   return 0;
 }
 
+std::size_t Detector::detect_particles(const ParticleType* types, std::size_t count) const 
+{
+  LEPTON_METRIC_ADD(detector_checked_counter(static_cast<std::size_t>(detector_type)), count);
+  if (!status) 
+  {
+    return 0;
+  }
+
+  const auto& row = acceptance[static_cast<std::size_t>(detector_type)];
+  std::size_t detected = 0;
+  for (std::size_t i = 0; i < count; ++i) 
+  {
+    detected += row[static_cast<std::size_t>(types[i])];
+  }
+  LEPTON_METRIC_ADD(detector_accepted_counter(static_cast<std::size_t>(detector_type)), detected);
+  return detected;
+}
+
+std::size_t Detector::detect_particles(const ParticleStore& store) const 
+{
+  return detect_particles(store.type_column().data(), store.size());
+}
+
+void Detector::acceptance_masks(const ParticleType* types, std::size_t count, std::uint8_t* masks) 
+{
+  for (std::size_t i = 0; i < count; ++i) 
+  {
+    masks[i] = mask_table[static_cast<std::size_t>(types[i])];
+  }
+}
+
 void Detector::print_info() const 
 {
-  std::cout << "Detector Type: " << this->detector_type
+  std::cout << "Detector Type: " << detector_type_name(this->detector_type)
             << "\nStatus: " << (this->status ? "On" : "Off") << '\n';
 }
 
-
@@ -6,22 +6,48 @@
 #define DETECTOR_H
 
 #include "Lepton.h"
+#include "ParticleType.h"
+#include <array>
+#include <cstdint>
 #include <string>
 
+class ParticleStore;
+
+enum class DetectorType : std::uint8_t { Tracker, Calorimeter, MuonChamber };
+constexpr std::size_t detector_type_count = 3;
+
+// Bit of a detector in acceptance masks
+constexpr std::uint8_t detector_type_bit(DetectorType type)
+{
+  return static_cast<std::uint8_t>(1u << static_cast<unsigned>(type));
+}
+
 class Detector 
 {
 private:
-  std::string detector_type; // "tracker", "calorimeter", or "muon chamber"
+  DetectorType detector_type; // tracker, calorimeter or muon chamber
   bool status; // true for on, false for off
 
+  // Which particle types each detector responds to, indexed [detector][particle]
+  static constexpr std::array<std::array<std::uint8_t, particle_type_count>, detector_type_count> acceptance
+  {{
+    // Electron, Muon, Neutrino, TauNeutrino, Tau
+    {{1, 1, 0, 0, 0}}, // Tracker sees charged, long-lived leptons
+    {{1, 0, 0, 0, 0}}, // Calorimeter absorbs electrons
+    {{0, 1, 0, 0, 0}}, // Muon chamber sees muons
+  }};
+
 public:
   Detector(); // Default constructor
-  Detector(const std::string& type); // Parameterized constructor
+  Detector(DetectorType type); // Parameterized constructor
+  Detector(const std::string& type); // Parameterized constructor taking the detector name
   ~Detector(); // Destructor
 
   // Setters and getters
+  void set_detector_type(DetectorType type);
   void set_detector_type(const std::string& type);
   void set_status(bool status);
+  DetectorType get_type() const;
   std::string get_detector_type() const;
   bool get_status() const;
 
@@ -30,10 +56,34 @@ public:
   void turn_off();
   int detect_particle(const Lepton& particle) const;
 
+  // Batch detection over a type column: returns how many particles this detector sees
+  std::size_t detect_particles(const ParticleType* types, std::size_t count) const;
+  std::size_t detect_particles(const ParticleStore& store) const;
+
+  // Acceptance lookups, independent of detector status
+  static constexpr bool accepts(DetectorType detector, ParticleType particle)
+  {
+    return acceptance[static_cast<std::size_t>(detector)][static_cast<std::size_t>(particle)] != 0;
+  }
+  static constexpr std::uint8_t acceptance_mask(ParticleType particle) // Bit d set if detector type d sees the particle
+  {
+    std::uint8_t mask = 0;
+    for (std::size_t detector = 0; detector < detector_type_count; ++detector)
+    {
+      mask |= static_cast<std::uint8_t>(acceptance[detector][static_cast<std::size_t>(particle)] << detector);
+    }
+    return mask;
+  }
+  static void acceptance_masks(const ParticleType* types, std::size_t count, std::uint8_t* masks);
+
   // Utility
   void print_info() const;
 };
 
-#endif 
+constexpr const char* detector_type_name(DetectorType type)
+{
+  return type == DetectorType::Tracker ? "tracker" : type == DetectorType::Calorimeter ? "calorimeter" : "muon chamber";
+}
 
+#endif 
 
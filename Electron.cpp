@@ -7,10 +7,16 @@
 
 // Constructor with initial energy validation
 Electron::Electron(double mass, int charge, double energy, double px, double py, double pz)
-  : Lepton(mass, charge, (energy > 0 ? energy : throw std::invalid_argument("Energy must be greater than 0")), px, py, pz), calorimeter_layers{0, 0, 0, 0} 
+  : Lepton(static_type_id, mass, charge, (energy > 0 ? energy : throw std::invalid_argument("Energy must be greater than 0")), px, py, pz), calorimeter_layers{0, 0, 0, 0} 
 {
 }
 
+Electron::Electron(double mass, int charge, double energy, double px, double py, double pz, const std::array<double, 4>& layers)
+  : Electron(mass, charge, energy, px, py, pz)
+{
+  calorimeter_layers = layers;
+}
+
 // Sets the calorimeter layer energies and adjusts them to match the electron's total energy
 void Electron::set_layer_energies(const std::array<double, 4>& energies) 
 {
@@ -47,7 +53,7 @@ void Electron::set_energy(double energy)
   if (energy != total_layer_energy) {
     throw std::invalid_argument("Energy must match the sum of the calorimeter layers' energies.");
   }
-  this->four_momentum->set_energy(energy);
+  this->four_momentum.set_energy(energy);
 }
 void Electron::print_info() const
 {
@@ -2,16 +2,31 @@
 // Author: Leo Feasby
 // Date: 18/04/2024
 
+#ifndef ELECTRON_H
+#define ELECTRON_H
+
 #include "Lepton.h"
 #include <array>
 
-class Electron : public Lepton 
+class Electron final : public Lepton 
 {
 private:
   std::array<double, 4> calorimeter_layers; // EM_1, EM_2, HAD_1, HAD_2
 
 public:
+  static constexpr ParticleType static_type_id = ParticleType::Electron;
+
   Electron(double mass, int charge, double energy, double px, double py, double pz); // Constructor declaration only
+  // Layers kept exactly as given, not adjusted to the energy, so a ParticleStore row
+  // round-trips through an object
+  Electron(double mass, int charge, double energy, double px, double py, double pz, const std::array<double, 4>& layers);
+
+  // Electron combined = a + b + ...: rest masses, charges and four-momenta of the electrons
+  // added. Only sums of Electrons convert.
+  template <typename Left, typename Right, typename = std::enable_if_t<is_lepton_sum_of<Electron, MomentumSum<Left, Right>>::value>>
+  Electron(const MomentumSum<Left, Right>& sum)
+    : Electron(sum.summed_rest_mass(), sum.summed_charge(), sum.get_energy(), sum.get_px(), sum.get_py(), sum.get_pz())
+  {}
 
   void set_layer_energies(const std::array<double, 4>& energies); // Method declaration only
 
@@ -23,19 +38,12 @@ public:
 
   std::string get_particle_type() const override 
   {
-    return "Electron";
+    return particle_type_name(static_type_id);
   }
 
   void print_info() const override; // Declaration only
 
-  Electron operator+(const Electron& other) const 
-  {
-    return Electron(this->get_rest_mass() + other.get_rest_mass(),
-                    this->get_charge() + other.get_charge(),
-                    this->get_e() + other.get_e(),
-                    this->get_px() + other.get_px(),
-                    this->get_py() + other.get_py(),
-                    this->get_pz() + other.get_pz());
-  }
   // Additional electron-specific methods can be added here
 };
+
+#endif
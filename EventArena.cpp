@@ -0,0 +1,61 @@
+// Description: Defines the EventArena class, a monotonic per-event allocator for particles and their decay products.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "EventArena.h"
+#include <stdexcept>
+
+EventArena::EventArena(std::size_t block_size)
+  : block_size(block_size), current_block(0), offset(0), used_bytes(0), cleanups(nullptr)
+{
+  if (block_size == 0)
+  {
+    throw std::invalid_argument("Arena block size must be greater than 0");
+  }
+}
+
+EventArena::~EventArena()
+{
+  reset();
+}
+
+void* EventArena::allocate_slow(std::size_t bytes, std::size_t alignment)
+{
+  // Move on to the next retained block that fits, or grow by one block
+  std::size_t needed = bytes + alignment;
+  std::size_t next = current_block < blocks.size() ? current_block + 1 : current_block;
+  while (next < blocks.size() && blocks[next].size < needed)
+  {
+    ++next;
+  }
+  if (next == blocks.size())
+  {
+    std::size_t size = needed > block_size ? needed : block_size;
+    blocks.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+  }
+  current_block = next;
+  offset = 0;
+  return allocate(bytes, alignment);
+}
+
+void EventArena::reset()
+{
+  for (Cleanup* cleanup = cleanups; cleanup != nullptr; cleanup = cleanup->next)
+  {
+    cleanup->destroy(cleanup->object);
+  }
+  cleanups = nullptr;
+  current_block = 0;
+  offset = 0;
+  used_bytes = 0;
+}
+
+std::size_t EventArena::get_capacity() const
+{
+  std::size_t capacity = 0;
+  for (const auto& block : blocks)
+  {
+    capacity += block.size;
+  }
+  return capacity;
+}
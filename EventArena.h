@@ -0,0 +1,124 @@
+// Description: Defines the EventArena class, a monotonic per-event allocator for particles and their decay products.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef EVENTARENA_H
+#define EVENTARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Contiguous array allocated from an EventArena; valid until the arena is reset
+template <typename T>
+class ArenaSpan
+{
+private:
+  T* first;
+  std::size_t count;
+
+public:
+  ArenaSpan() : first(nullptr), count(0) {}
+  ArenaSpan(T* first, std::size_t count) : first(first), count(count) {}
+
+  T* begin() const { return first; }
+  T* end() const { return first + count; }
+  T* data() const { return first; }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  T& operator[](std::size_t i) const { return first[i]; }
+};
+
+// Bump allocator scoped to one event. Everything created for an event is released
+// together by reset(), which runs the recorded destructors in reverse order and
+// rewinds to the first block. Blocks are kept between events, so once the arena has
+// grown to fit the largest event, processing makes no further global-heap calls.
+class EventArena
+{
+private:
+  struct Block
+  {
+    std::unique_ptr<unsigned char[]> storage;
+    std::size_t size;
+  };
+
+  // Destructor records live in the arena itself, forming a singly linked list
+  struct Cleanup
+  {
+    void (*destroy)(void*);
+    void* object;
+    Cleanup* next;
+  };
+
+  std::vector<Block> blocks;
+  std::size_t block_size;
+  std::size_t current_block;
+  std::size_t offset; // Into blocks[current_block]
+  std::size_t used_bytes;
+  Cleanup* cleanups;
+
+  void* allocate_slow(std::size_t bytes, std::size_t alignment);
+
+  template <typename T>
+  static void destroy(void* object)
+  {
+    static_cast<T*>(object)->~T();
+  }
+
+public:
+  explicit EventArena(std::size_t block_size = 64 * 1024);
+  ~EventArena();
+
+  EventArena(const EventArena&) = delete;
+  EventArena& operator=(const EventArena&) = delete;
+
+  void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+  {
+    if (current_block < blocks.size())
+    {
+      // Align the address rather than the offset: block storage is only max_align_t aligned
+      std::uintptr_t base = reinterpret_cast<std::uintptr_t>(blocks[current_block].storage.get());
+      std::size_t aligned = static_cast<std::size_t>(((base + offset + alignment - 1) & ~(alignment - 1)) - base);
+      if (aligned + bytes <= blocks[current_block].size)
+      {
+        offset = aligned + bytes;
+        used_bytes += bytes;
+        return blocks[current_block].storage.get() + aligned;
+      }
+    }
+    return allocate_slow(bytes, alignment);
+  }
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args)
+  {
+    void* memory = allocate(sizeof(T), alignof(T));
+    T* object = ::new (memory) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value)
+    {
+      Cleanup* cleanup = ::new (allocate(sizeof(Cleanup), alignof(Cleanup))) Cleanup{&destroy<T>, object, cleanups};
+      cleanups = cleanup;
+    }
+    return object;
+  }
+
+  // Uninitialised storage for count trivially destructible values
+  template <typename T>
+  ArenaSpan<T> allocate_array(std::size_t count)
+  {
+    static_assert(std::is_trivially_destructible<T>::value, "Arena arrays are released without running destructors");
+    return ArenaSpan<T>(static_cast<T*>(allocate(sizeof(T) * count, alignof(T))), count);
+  }
+
+  void reset();
+
+  std::size_t get_used_bytes() const { return used_bytes; } // Since the last reset
+  std::size_t get_capacity() const; // Total bytes held in blocks
+  std::size_t get_block_count() const { return blocks.size(); }
+};
+
+#endif
@@ -0,0 +1,511 @@
+// Description: Defines the EventExporter class, a buffered CSV and JSON-lines writer for whole event batches.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "EventExporter.h"
+#include "Electron.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "NumberFormat.h"
+#include "Tau.h"
+#include "TauNeutrino.h"
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+  // Longest row either format can produce: 13 numbers of at most 24 characters (plus
+  // NumberFormat's scratch room), four decay products and the names and punctuation around them
+  constexpr std::size_t max_row_bytes = 1024;
+  constexpr std::size_t min_chunk_bytes = 4096;
+
+  const char* csv_header = "event,particle,type,charge,mass,energy,px,py,pz,em1,em2,had1,had2,"
+                           "isolated,flavor,interacted,decay_mode,decay_products\n";
+
+  const char* type_token(ParticleType type)
+  {
+    switch (type)
+    {
+      case ParticleType::Electron: return "electron";
+      case ParticleType::Muon: return "muon";
+      case ParticleType::Neutrino: return "neutrino";
+      case ParticleType::TauNeutrino: return "tau_neutrino";
+      case ParticleType::Tau: return "tau";
+    }
+    return "unknown";
+  }
+
+  const char* decay_mode_token(TauDecayMode mode)
+  {
+    return mode == TauDecayMode::Leptonic ? "leptonic" : "hadronic";
+  }
+
+  char* put_text(char* out, const char* text)
+  {
+    std::size_t length = std::strlen(text);
+    std::memcpy(out, text, length);
+    return out + length;
+  }
+
+  char* put_integer(char* out, long long value)
+  {
+    if (value < 0)
+    {
+      *out++ = '-';
+    }
+    return format_unsigned(out, value < 0 ? 0 - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value));
+  }
+
+  // The default decimals of -1 give the shortest text that reads back exactly
+  char* put_number(char* out, double value, int decimals)
+  {
+    return decimals >= 0 ? format_fixed(out, value, decimals) : format_shortest(out, value);
+  }
+
+  // JSON has no spelling for NaN or infinity
+  char* put_json_number(char* out, double value, int decimals)
+  {
+    return std::isfinite(value) ? put_number(out, value, decimals) : put_text(out, "null");
+  }
+}
+
+struct EventExporter::Row
+{
+  std::uint32_t particle;
+  ParticleType type;
+  int charge;
+  double mass, energy, px, py, pz;
+  std::array<double, 4> layers; // Electron
+  bool isolated; // Muon
+  NeutrinoFlavor flavor; // Neutrino
+  bool interacted; // Neutrino and TauNeutrino
+  TauDecayMode decay_mode; // Tau
+  std::array<std::uint32_t, max_tau_decay_products> products;
+  std::size_t product_count;
+};
+
+EventExporter::EventExporter(const std::string& path, const ExportConfig& config)
+  : config(config), descriptor(-1), owns_descriptor(true), open(false), used(0), event_count(0), particle_count(0),
+    bytes_written(0), pending_size(0), stopping(false)
+{
+  if (config.decimals < -1 || config.decimals > 9 || config.chunk_bytes < min_chunk_bytes)
+  {
+    throw std::invalid_argument("Export decimals must be -1 to 9 and chunks at least 4 KiB");
+  }
+  descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (descriptor < 0)
+  {
+    throw std::runtime_error("Cannot create export file " + path + ": " + std::strerror(errno));
+  }
+  start();
+}
+
+EventExporter::EventExporter(int descriptor, const ExportConfig& config)
+  : config(config), descriptor(descriptor), owns_descriptor(false), open(false), used(0), event_count(0), particle_count(0),
+    bytes_written(0), pending_size(0), stopping(false)
+{
+  if (config.decimals < -1 || config.decimals > 9 || config.chunk_bytes < min_chunk_bytes)
+  {
+    throw std::invalid_argument("Export decimals must be -1 to 9 and chunks at least 4 KiB");
+  }
+  start();
+}
+
+EventExporter::~EventExporter()
+{
+  try
+  {
+    close();
+  }
+  catch (...)
+  {
+    // Destructors must not throw; call close() directly to see write errors
+  }
+}
+
+void EventExporter::start()
+{
+  buffer.resize(config.chunk_bytes);
+  if (config.background)
+  {
+    pending.resize(config.chunk_bytes);
+    writer = std::thread(&EventExporter::run_writer, this);
+  }
+  open = true;
+  if (config.format == ExportFormat::Csv)
+  {
+    append_text(csv_header);
+  }
+}
+
+void EventExporter::append_text(const char* text)
+{
+  std::size_t length = std::strlen(text);
+  if (buffer.size() - used < length)
+  {
+    flush_chunk();
+  }
+  std::memcpy(buffer.data() + used, text, length);
+  used += length;
+}
+
+void EventExporter::append(const Row& row)
+{
+  if (buffer.size() - used < max_row_bytes)
+  {
+    flush_chunk();
+  }
+  char* out = buffer.data() + used;
+  int decimals = config.decimals;
+
+  if (config.format == ExportFormat::Csv)
+  {
+    out = put_integer(out, static_cast<long long>(event_count));
+    *out++ = ',';
+    out = put_integer(out, row.particle);
+    *out++ = ',';
+    out = put_text(out, type_token(row.type));
+    *out++ = ',';
+    out = put_integer(out, row.charge);
+    for (double value : {row.mass, row.energy, row.px, row.py, row.pz})
+    {
+      *out++ = ',';
+      out = put_number(out, value, decimals);
+    }
+    for (double layer : row.layers)
+    {
+      *out++ = ',';
+      if (row.type == ParticleType::Electron)
+      {
+        out = put_number(out, layer, decimals);
+      }
+    }
+    out = put_text(out, row.type != ParticleType::Muon ? "," : row.isolated ? ",1" : ",0");
+    *out++ = ',';
+    if (row.type == ParticleType::Neutrino)
+    {
+      out = put_text(out, neutrino_flavor_name(row.flavor));
+    }
+    bool has_interaction = row.type == ParticleType::Neutrino || row.type == ParticleType::TauNeutrino;
+    out = put_text(out, !has_interaction ? "," : row.interacted ? ",1" : ",0");
+    *out++ = ',';
+    if (row.type == ParticleType::Tau)
+    {
+      out = put_text(out, decay_mode_token(row.decay_mode));
+    }
+    *out++ = ',';
+    for (std::size_t i = 0; i < row.product_count; ++i)
+    {
+      if (i > 0)
+      {
+        *out++ = ';';
+      }
+      out = put_integer(out, row.products[i]);
+    }
+  }
+  else
+  {
+    out = put_text(out, "{\"event\":");
+    out = put_integer(out, static_cast<long long>(event_count));
+    out = put_text(out, ",\"particle\":");
+    out = put_integer(out, row.particle);
+    out = put_text(out, ",\"type\":\"");
+    out = put_text(out, type_token(row.type));
+    out = put_text(out, "\",\"charge\":");
+    out = put_integer(out, row.charge);
+    out = put_text(out, ",\"mass\":");
+    out = put_json_number(out, row.mass, decimals);
+    out = put_text(out, ",\"energy\":");
+    out = put_json_number(out, row.energy, decimals);
+    out = put_text(out, ",\"px\":");
+    out = put_json_number(out, row.px, decimals);
+    out = put_text(out, ",\"py\":");
+    out = put_json_number(out, row.py, decimals);
+    out = put_text(out, ",\"pz\":");
+    out = put_json_number(out, row.pz, decimals);
+    switch (row.type)
+    {
+      case ParticleType::Electron:
+        out = put_text(out, ",\"layers\":[");
+        for (std::size_t layer = 0; layer < row.layers.size(); ++layer)
+        {
+          if (layer > 0)
+          {
+            *out++ = ',';
+          }
+          out = put_json_number(out, row.layers[layer], decimals);
+        }
+        *out++ = ']';
+        break;
+      case ParticleType::Muon:
+        out = put_text(out, row.isolated ? ",\"isolated\":true" : ",\"isolated\":false");
+        break;
+      case ParticleType::Neutrino:
+        out = put_text(out, ",\"flavor\":\"");
+        out = put_text(out, neutrino_flavor_name(row.flavor));
+        *out++ = '"';
+        out = put_text(out, row.interacted ? ",\"interacted\":true" : ",\"interacted\":false");
+        break;
+      case ParticleType::TauNeutrino:
+        out = put_text(out, row.interacted ? ",\"interacted\":true" : ",\"interacted\":false");
+        break;
+      case ParticleType::Tau:
+        out = put_text(out, ",\"decay_mode\":\"");
+        out = put_text(out, decay_mode_token(row.decay_mode));
+        out = put_text(out, "\",\"decay_products\":[");
+        for (std::size_t i = 0; i < row.product_count; ++i)
+        {
+          if (i > 0)
+          {
+            *out++ = ',';
+          }
+          out = put_integer(out, row.products[i]);
+        }
+        *out++ = ']';
+        break;
+    }
+    *out++ = '}';
+  }
+  *out++ = '\n';
+  used = static_cast<std::size_t>(out - buffer.data());
+  ++particle_count;
+}
+
+// Reads the store's columns directly rather than through ParticleView, which would
+// check the particle type again for every side field
+void EventExporter::write(const ParticleStore& event)
+{
+  if (!open)
+  {
+    throw std::runtime_error("EventExporter is closed");
+  }
+  Row row{};
+  for (ParticleStore::Index i = 0; i < event.size(); ++i)
+  {
+    row.particle = i;
+    row.type = event.type[i];
+    row.charge = event.charge[i];
+    row.mass = event.mass[i];
+    row.energy = event.energy[i];
+    row.px = event.px[i];
+    row.py = event.py[i];
+    row.pz = event.pz[i];
+    row.product_count = 0;
+    ParticleStore::Index extra = event.extra_index[i];
+    switch (row.type)
+    {
+      case ParticleType::Electron: row.layers = event.electron_layers[extra]; break;
+      case ParticleType::Muon: row.isolated = event.muon_isolated[extra] != 0; break;
+      case ParticleType::Neutrino:
+        row.flavor = event.neutrino_flavor[extra];
+        row.interacted = event.neutrino_interacted[extra] != 0;
+        break;
+      case ParticleType::TauNeutrino: row.interacted = event.tau_neutrino_interacted[extra] != 0; break;
+      case ParticleType::Tau:
+        row.decay_mode = event.tau_decay_mode[extra];
+        row.product_count = event.tau_product_count[extra];
+        row.products = event.tau_products[extra];
+        break;
+    }
+    append(row);
+  }
+  ++event_count;
+}
+
+void EventExporter::write(const std::vector<ParticleStore>& events)
+{
+  for (const auto& event : events)
+  {
+    write(event);
+  }
+}
+
+void EventExporter::write(const Lepton* const* particles, std::size_t count)
+{
+  if (!open)
+  {
+    throw std::runtime_error("EventExporter is closed");
+  }
+  Row row{};
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const Lepton& particle = *particles[i];
+    const FourMomentum& p = particle.get_four_momentum();
+    row.particle = static_cast<std::uint32_t>(i);
+    row.type = particle.get_type_id();
+    row.charge = particle.get_charge();
+    row.mass = particle.get_rest_mass();
+    row.energy = p.get_energy();
+    row.px = p.get_px();
+    row.py = p.get_py();
+    row.pz = p.get_pz();
+    row.product_count = 0;
+    switch (row.type)
+    {
+      case ParticleType::Electron: row.layers = static_cast<const Electron&>(particle).get_layer_energies(); break;
+      case ParticleType::Muon: row.isolated = static_cast<const Muon&>(particle).get_isolated(); break;
+      case ParticleType::Neutrino:
+      {
+        const auto& neutrino = static_cast<const Neutrino&>(particle);
+        row.flavor = neutrino.get_flavor();
+        row.interacted = neutrino.get_has_interacted();
+        break;
+      }
+      case ParticleType::TauNeutrino: row.interacted = static_cast<const TauNeutrino&>(particle).getHasInteracted(); break;
+      case ParticleType::Tau:
+      {
+        const auto& tau = static_cast<const Tau&>(particle);
+        row.decay_mode = tau.get_decay_mode();
+        for (const Lepton* product : tau.get_decay_products())
+        {
+          for (std::size_t j = 0; j < count; ++j)
+          {
+            if (particles[j] == product)
+            {
+              row.products[row.product_count++] = static_cast<std::uint32_t>(j);
+              break;
+            }
+          }
+        }
+        break;
+      }
+    }
+    append(row);
+  }
+  ++event_count;
+}
+
+void EventExporter::write_all(const char* data, std::size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t written = ::write(descriptor, data, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      throw std::runtime_error(std::string("Export write failed: ") + std::strerror(errno));
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+// Synchronously writes the chunk, or swaps it with the background writer's empty
+// buffer once that has finished with the previous chunk
+void EventExporter::flush_chunk()
+{
+  if (used == 0)
+  {
+    return;
+  }
+  bytes_written += used;
+  if (!config.background)
+  {
+    std::size_t size = used;
+    used = 0;
+    write_all(buffer.data(), size);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this] { return pending_size == 0; });
+  if (!write_error.empty())
+  {
+    throw std::runtime_error(write_error);
+  }
+  std::swap(buffer, pending);
+  pending_size = used;
+  used = 0;
+  changed.notify_all();
+}
+
+void EventExporter::run_writer()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    changed.wait(lock, [this] { return pending_size != 0 || stopping; });
+    if (pending_size == 0)
+    {
+      return;
+    }
+    lock.unlock(); // The producer only touches pending once pending_size is back to zero
+    std::string error;
+    try
+    {
+      write_all(pending.data(), pending_size);
+    }
+    catch (const std::exception& failure)
+    {
+      error = failure.what();
+    }
+    lock.lock();
+    if (write_error.empty())
+    {
+      write_error = error;
+    }
+    pending_size = 0;
+    changed.notify_all();
+  }
+}
+
+void EventExporter::stop_writer()
+{
+  if (writer.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+  }
+}
+
+void EventExporter::flush()
+{
+  flush_chunk();
+  if (config.background)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return pending_size == 0; });
+    if (!write_error.empty())
+    {
+      throw std::runtime_error(write_error);
+    }
+  }
+}
+
+void EventExporter::close()
+{
+  if (!open)
+  {
+    return;
+  }
+  open = false;
+  std::string error;
+  try
+  {
+    flush();
+  }
+  catch (const std::exception& failure)
+  {
+    error = failure.what();
+  }
+  stop_writer();
+  if (owns_descriptor && ::close(descriptor) != 0 && error.empty())
+  {
+    error = std::string("Closing export file failed: ") + std::strerror(errno);
+  }
+  if (!error.empty())
+  {
+    throw std::runtime_error(error);
+  }
+}
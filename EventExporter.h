@@ -0,0 +1,101 @@
+// Description: Defines the EventExporter class, a buffered CSV and JSON-lines writer for whole event batches.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef EVENTEXPORTER_H
+#define EVENTEXPORTER_H
+
+#include "ParticleStore.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Lepton;
+
+enum class ExportFormat : std::uint8_t { Csv, JsonLines };
+
+struct ExportConfig
+{
+  ExportFormat format = ExportFormat::Csv;
+  int decimals = -1; // Digits after the point (0-9); -1 writes the shortest text that reads back exactly
+  std::size_t chunk_bytes = 1 << 20; // Text handed to write() at a time, at least 4 KiB
+  bool background = false; // Write full chunks on a separate thread while the next one is formatted
+};
+
+// One row (CSV) or object (JSON lines) per particle, numbered by event and by row
+// within the event. CSV columns:
+//
+//   event,particle,type,charge,mass,energy,px,py,pz,em1,em2,had1,had2,
+//   isolated,flavor,interacted,decay_mode,decay_products
+//
+// with the subclass columns left empty where they do not apply, and decay products
+// given as ';'-separated row numbers. JSON objects carry only the fields of the
+// particle's own type. Text is formatted straight into a chunk buffer, and each full
+// chunk goes to the file in a single write().
+//
+// With the default decimals, numbers are written as std::to_chars would, shortest
+// text that reads back exactly, by NumberFormat's format_shortest. Fixed decimals (3
+// gives keV for MeV quantities) are quicker still; they round value * 10^decimals, so
+// a value within an ulp of a tie may end one unit in the last place away from printf's.
+class EventExporter
+{
+private:
+  struct Row; // One particle's fields, gathered from either a ParticleStore or Lepton objects
+
+  ExportConfig config;
+  int descriptor;
+  bool owns_descriptor;
+  bool open;
+  std::vector<char> buffer;
+  std::size_t used;
+  std::uint64_t event_count;
+  std::uint64_t particle_count;
+  std::uint64_t bytes_written;
+
+  // Background writer state: at most one chunk in flight while the other is being filled
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<char> pending;
+  std::size_t pending_size;
+  bool stopping;
+  std::string write_error;
+  std::thread writer;
+
+  void start();
+  void append(const Row& row);
+  void append_text(const char* text);
+  void flush_chunk();
+  void write_all(const char* data, std::size_t size);
+  void run_writer();
+  void stop_writer();
+
+public:
+  // Creates or truncates path. Throws std::runtime_error if it cannot be opened and
+  // std::invalid_argument for an out-of-range decimals or chunk size.
+  explicit EventExporter(const std::string& path, const ExportConfig& config = ExportConfig());
+  // Writes to an already open descriptor (e.g. STDOUT_FILENO), which is left open
+  explicit EventExporter(int descriptor, const ExportConfig& config = ExportConfig());
+  ~EventExporter(); // Closes the exporter if close() was not called
+
+  EventExporter(const EventExporter&) = delete;
+  EventExporter& operator=(const EventExporter&) = delete;
+
+  void write(const ParticleStore& event);
+  void write(const std::vector<ParticleStore>& events);
+  // One event held as objects, e.g. from ParticleStore::materialize. Tau decay products
+  // are numbered by their position in particles; products not in the array are omitted.
+  void write(const Lepton* const* particles, std::size_t count);
+
+  void flush(); // Hands the buffered text to write() and waits until it is out
+  void close(); // Flushes and, for a path, closes the file. Throws std::runtime_error on write errors
+
+  std::uint64_t get_event_count() const { return event_count; }
+  std::uint64_t get_particle_count() const { return particle_count; }
+  std::uint64_t get_bytes_written() const { return bytes_written; }
+};
+
+#endif
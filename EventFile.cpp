@@ -0,0 +1,574 @@
+// Description: Versioned binary columnar event file format, with a streaming writer and a memory-mapped reader.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "EventFile.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  constexpr char file_magic[8] = {'L', 'E', 'P', 'E', 'V', 'T', '\0', '\0'};
+  constexpr std::uint32_t byte_order_mark = 0x01020304;
+  constexpr std::uint32_t block_magic = 0x314B4C42; // "BLK1"
+  constexpr std::size_t column_alignment = 64;
+
+  struct FileHeader
+  {
+    char magic[8];
+    std::uint32_t byte_order;
+    std::uint32_t version;
+    std::uint64_t block_count;
+    std::uint64_t event_count;
+    std::uint64_t particle_count;
+    std::uint64_t index_offset;
+    unsigned char reserved[16];
+  };
+  static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the format");
+
+  struct BlockHeader
+  {
+    std::uint32_t magic;
+    std::uint32_t column_count;
+    std::uint64_t event_count;
+    std::uint64_t particle_count;
+    std::uint64_t block_size;
+  };
+  static_assert(sizeof(BlockHeader) == 32, "BlockHeader layout is part of the format");
+
+  struct ColumnEntry
+  {
+    std::uint32_t id;
+    std::uint32_t element_size;
+    std::uint64_t offset; // From the start of the block
+    std::uint64_t count;
+  };
+  static_assert(sizeof(ColumnEntry) == 24, "ColumnEntry layout is part of the format");
+
+  constexpr std::array<std::uint32_t, event_column_count> element_sizes{{
+    8,                                   // EventOffsets
+    8, 8, 8, 8, 8,                       // Energy, Px, Py, Pz, Mass
+    1, 1,                                // Charge, Type
+    4, 32,                               // ElectronRow, ElectronLayers
+    4, 1,                                // MuonRow, MuonIsolated
+    4, 1, 1,                             // NeutrinoRow, NeutrinoFlavor, NeutrinoInteracted
+    4, 1,                                // TauNeutrinoRow, TauNeutrinoInteracted
+    4, 1, 1, 4 * max_tau_decay_products  // TauRow, TauDecayMode, TauProductCount, TauProducts
+  }};
+
+  std::size_t align_up(std::size_t value, std::size_t alignment)
+  {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  [[noreturn]] void malformed(const std::string& reason)
+  {
+    throw std::runtime_error("Malformed event file: " + reason);
+  }
+}
+
+// EventFileWriter
+EventFileWriter::EventFileWriter(const std::string& path, std::size_t events_per_block)
+  : file(path, std::ios::binary | std::ios::trunc), path(path), events_per_block(events_per_block),
+    total_events(0), total_particles(0), open(true), block_events(0), block_particles(0)
+{
+  if (!file)
+  {
+    throw std::runtime_error("Cannot create event file: " + path);
+  }
+  if (events_per_block == 0)
+  {
+    throw std::invalid_argument("events_per_block must be greater than 0");
+  }
+  write_header(0); // Placeholder; an index offset of 0 marks a file that was never closed
+}
+
+EventFileWriter::~EventFileWriter()
+{
+  try
+  {
+    close();
+  }
+  catch (...)
+  {
+    // Destructors must not throw; call close() directly to see write errors
+  }
+}
+
+template <typename T>
+void EventFileWriter::append(EventColumn column, const T& value)
+{
+  auto& bytes = columns[static_cast<std::size_t>(column)];
+  const auto* raw = reinterpret_cast<const unsigned char*>(&value);
+  bytes.insert(bytes.end(), raw, raw + sizeof(T));
+}
+
+void EventFileWriter::write(const ParticleStore& event)
+{
+  if (!open)
+  {
+    throw std::logic_error("Event file is already closed");
+  }
+
+  // Rows are block-relative uint32, so a block is closed early rather than let them wrap;
+  // one event always fits, since ParticleStore indices are uint32 too
+  if (block_events > 0 && block_particles + event.size() > std::numeric_limits<std::uint32_t>::max())
+  {
+    flush_block();
+  }
+  if (block_events == 0)
+  {
+    append(EventColumn::EventOffsets, std::uint64_t{0});
+  }
+  const auto base = static_cast<std::uint32_t>(block_particles);
+
+  for (ParticleStore::Index i = 0; i < event.size(); ++i)
+  {
+    append(EventColumn::Energy, event.energy[i]);
+    append(EventColumn::Px, event.px[i]);
+    append(EventColumn::Py, event.py[i]);
+    append(EventColumn::Pz, event.pz[i]);
+    append(EventColumn::Mass, event.mass[i]);
+    append(EventColumn::Charge, event.charge[i]);
+    append(EventColumn::Type, event.type[i]);
+
+    std::uint32_t row = base + i;
+    ParticleStore::Index extra = event.extra_index[i];
+    switch (event.type[i])
+    {
+      case ParticleType::Electron:
+        append(EventColumn::ElectronRow, row);
+        append(EventColumn::ElectronLayers, event.electron_layers[extra]);
+        break;
+      case ParticleType::Muon:
+        append(EventColumn::MuonRow, row);
+        append(EventColumn::MuonIsolated, event.muon_isolated[extra]);
+        break;
+      case ParticleType::Neutrino:
+        append(EventColumn::NeutrinoRow, row);
+        append(EventColumn::NeutrinoFlavor, event.neutrino_flavor[extra]);
+        append(EventColumn::NeutrinoInteracted, event.neutrino_interacted[extra]);
+        break;
+      case ParticleType::TauNeutrino:
+        append(EventColumn::TauNeutrinoRow, row);
+        append(EventColumn::TauNeutrinoInteracted, event.tau_neutrino_interacted[extra]);
+        break;
+      case ParticleType::Tau:
+      {
+        append(EventColumn::TauRow, row);
+        append(EventColumn::TauDecayMode, event.tau_decay_mode[extra]);
+        append(EventColumn::TauProductCount, event.tau_product_count[extra]);
+        std::array<std::uint32_t, max_tau_decay_products> products{};
+        for (std::size_t product = 0; product < event.tau_product_count[extra]; ++product)
+        {
+          products[product] = base + event.tau_products[extra][product];
+        }
+        append(EventColumn::TauProducts, products);
+        break;
+      }
+    }
+  }
+
+  block_particles += event.size();
+  append(EventColumn::EventOffsets, block_particles);
+  ++block_events;
+  ++total_events;
+  total_particles += event.size();
+
+  if (block_events == events_per_block)
+  {
+    flush_block();
+  }
+}
+
+void EventFileWriter::flush_block()
+{
+  if (block_events == 0)
+  {
+    return;
+  }
+
+  // Lay the columns out after the header and column table, each on a 64-byte boundary
+  std::array<ColumnEntry, event_column_count> table;
+  std::size_t cursor = align_up(sizeof(BlockHeader) + sizeof(table), column_alignment);
+  for (std::size_t column = 0; column < event_column_count; ++column)
+  {
+    table[column] = ColumnEntry{static_cast<std::uint32_t>(column), element_sizes[column], cursor,
+                                columns[column].size() / element_sizes[column]};
+    cursor = align_up(cursor + columns[column].size(), column_alignment);
+  }
+  BlockHeader header{block_magic, static_cast<std::uint32_t>(event_column_count), block_events, block_particles, cursor};
+
+  // Blocks start 64-byte aligned in the file so mapped columns are aligned in memory
+  std::uint64_t block_start = align_up(static_cast<std::size_t>(file.tellp()), column_alignment);
+  static const char zeros[column_alignment] = {};
+  file.write(zeros, static_cast<std::streamsize>(block_start - static_cast<std::uint64_t>(file.tellp())));
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(table.data()), sizeof(table));
+  std::size_t written = sizeof(header) + sizeof(table);
+  for (std::size_t column = 0; column < event_column_count; ++column)
+  {
+    file.write(zeros, static_cast<std::streamsize>(table[column].offset - written));
+    file.write(reinterpret_cast<const char*>(columns[column].data()), static_cast<std::streamsize>(columns[column].size()));
+    written = table[column].offset + columns[column].size();
+    columns[column].clear();
+  }
+  file.write(zeros, static_cast<std::streamsize>(cursor - written));
+  if (!file)
+  {
+    throw std::runtime_error("Failed writing event file: " + path);
+  }
+
+  block_offsets.push_back(block_start);
+  block_events = 0;
+  block_particles = 0;
+}
+
+void EventFileWriter::write_header(std::uint64_t index_offset)
+{
+  FileHeader header{};
+  std::memcpy(header.magic, file_magic, sizeof(file_magic));
+  header.byte_order = byte_order_mark;
+  header.version = event_file_version;
+  header.block_count = block_offsets.size();
+  header.event_count = total_events;
+  header.particle_count = total_particles;
+  header.index_offset = index_offset;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void EventFileWriter::close()
+{
+  if (!open)
+  {
+    return;
+  }
+  open = false;
+  flush_block();
+
+  std::uint64_t index_offset = static_cast<std::uint64_t>(file.tellp());
+  file.write(reinterpret_cast<const char*>(block_offsets.data()),
+             static_cast<std::streamsize>(block_offsets.size() * sizeof(std::uint64_t)));
+  file.seekp(0);
+  write_header(index_offset);
+  file.close();
+  if (!file)
+  {
+    throw std::runtime_error("Failed writing event file: " + path);
+  }
+}
+
+// EventFileReader
+EventFileReader::EventFileReader(const std::string& path)
+  : mapping(nullptr), mapping_size(0), total_particles(0)
+{
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0)
+  {
+    throw std::runtime_error("Cannot open event file: " + path);
+  }
+  struct stat info;
+  if (::fstat(descriptor, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader))
+  {
+    ::close(descriptor);
+    throw std::runtime_error("Event file is too small: " + path);
+  }
+  mapping_size = static_cast<std::size_t>(info.st_size);
+  void* address = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, descriptor, 0);
+  ::close(descriptor); // The mapping stays valid after the descriptor is closed
+  if (address == MAP_FAILED)
+  {
+    throw std::runtime_error("Cannot map event file: " + path);
+  }
+  mapping = static_cast<const unsigned char*>(address);
+
+  try
+  {
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0)
+    {
+      malformed("bad magic");
+    }
+    if (header.byte_order != byte_order_mark)
+    {
+      malformed("written on a host with different byte order");
+    }
+    if (header.version != event_file_version)
+    {
+      malformed("unsupported version " + std::to_string(header.version));
+    }
+    if (header.index_offset == 0 || header.index_offset > mapping_size ||
+        header.block_count > (mapping_size - header.index_offset) / sizeof(std::uint64_t))
+    {
+      malformed("block index out of range (was the writer closed?)");
+    }
+
+    block_offsets.resize(header.block_count);
+    std::memcpy(block_offsets.data(), mapping + header.index_offset, header.block_count * sizeof(std::uint64_t));
+    block_first_event.push_back(0);
+    for (std::uint64_t offset : block_offsets)
+    {
+      if (offset > mapping_size || mapping_size - offset < sizeof(BlockHeader))
+      {
+        malformed("block offset out of range");
+      }
+      const auto* block = reinterpret_cast<const BlockHeader*>(mapping + offset);
+      if (block->magic != block_magic || block->column_count != event_column_count || block->block_size > mapping_size - offset)
+      {
+        malformed("bad block header");
+      }
+      const auto* table = reinterpret_cast<const ColumnEntry*>(block + 1);
+      for (std::size_t column = 0; column < event_column_count; ++column)
+      {
+        if (table[column].element_size != element_sizes[column] || table[column].offset > block->block_size ||
+            table[column].count > (block->block_size - table[column].offset) / element_sizes[column])
+        {
+          malformed("column out of range");
+        }
+      }
+      block_first_event.push_back(block_first_event.back() + block->event_count);
+      total_particles += block->particle_count;
+      validate_block(block_first_event.size() - 2);
+    }
+    if (block_first_event.back() != header.event_count || total_particles != header.particle_count)
+    {
+      malformed("event or particle count mismatch");
+    }
+  }
+  catch (...)
+  {
+    ::munmap(const_cast<unsigned char*>(mapping), mapping_size);
+    throw;
+  }
+}
+
+EventFileReader::~EventFileReader()
+{
+  ::munmap(const_cast<unsigned char*>(mapping), mapping_size);
+}
+
+const unsigned char* EventFileReader::column_data(std::size_t block, EventColumn column, std::size_t element_size, std::size_t& count) const
+{
+  if (block >= block_offsets.size())
+  {
+    throw std::out_of_range("Block index out of range");
+  }
+  const auto* header = reinterpret_cast<const BlockHeader*>(mapping + block_offsets[block]);
+  const ColumnEntry& entry = reinterpret_cast<const ColumnEntry*>(header + 1)[static_cast<std::size_t>(column)];
+  if (entry.element_size != element_size)
+  {
+    throw std::invalid_argument("Column element type does not match the file");
+  }
+  count = static_cast<std::size_t>(entry.count);
+  return mapping + block_offsets[block] + entry.offset;
+}
+
+// One pass over the offsets, types and side columns of a block, so a corrupt file fails
+// here instead of sending read_event or a column scan out of bounds
+void EventFileReader::validate_block(std::size_t block) const
+{
+  const auto* header = reinterpret_cast<const BlockHeader*>(mapping + block_offsets[block]);
+  const std::uint64_t particle_count = header->particle_count;
+  if (particle_count > std::numeric_limits<std::uint32_t>::max())
+  {
+    malformed("too many particles in a block for 32-bit rows");
+  }
+
+  auto offsets = column<std::uint64_t>(block, EventColumn::EventOffsets);
+  if (offsets.size != header->event_count + 1 || offsets[0] != 0 || offsets[offsets.size - 1] != particle_count)
+  {
+    malformed("event offsets do not span the block");
+  }
+  for (std::size_t event = 0; event + 1 < offsets.size; ++event)
+  {
+    if (offsets[event] > offsets[event + 1])
+    {
+      malformed("event offsets are not monotonic");
+    }
+  }
+
+  for (EventColumn id : {EventColumn::Energy, EventColumn::Px, EventColumn::Py, EventColumn::Pz, EventColumn::Mass,
+                         EventColumn::Charge, EventColumn::Type})
+  {
+    std::size_t count = 0;
+    column_data(block, id, element_sizes[static_cast<std::size_t>(id)], count);
+    if (count != particle_count)
+    {
+      malformed("particle column does not hold one entry per particle");
+    }
+  }
+
+  // Count each type, then every side column must hold exactly that many entries
+  auto type = column<ParticleType>(block, EventColumn::Type);
+  std::array<std::size_t, particle_type_count> type_counts{};
+  for (ParticleType particle : type)
+  {
+    if (static_cast<std::size_t>(particle) >= particle_type_count)
+    {
+      malformed("unknown particle type");
+    }
+    ++type_counts[static_cast<std::size_t>(particle)];
+  }
+  auto expect_entries = [&](ParticleType particle, std::initializer_list<EventColumn> ids)
+  {
+    for (EventColumn id : ids)
+    {
+      std::size_t count = 0;
+      column_data(block, id, element_sizes[static_cast<std::size_t>(id)], count);
+      if (count != type_counts[static_cast<std::size_t>(particle)])
+      {
+        malformed(std::string("side column does not hold one entry per ") + particle_type_name(particle));
+      }
+    }
+  };
+  expect_entries(ParticleType::Electron, {EventColumn::ElectronRow, EventColumn::ElectronLayers});
+  expect_entries(ParticleType::Muon, {EventColumn::MuonRow, EventColumn::MuonIsolated});
+  expect_entries(ParticleType::Neutrino, {EventColumn::NeutrinoRow, EventColumn::NeutrinoFlavor, EventColumn::NeutrinoInteracted});
+  expect_entries(ParticleType::TauNeutrino, {EventColumn::TauNeutrinoRow, EventColumn::TauNeutrinoInteracted});
+  expect_entries(ParticleType::Tau, {EventColumn::TauRow, EventColumn::TauDecayMode, EventColumn::TauProductCount, EventColumn::TauProducts});
+
+  for (NeutrinoFlavor flavor : column<NeutrinoFlavor>(block, EventColumn::NeutrinoFlavor))
+  {
+    if (flavor != NeutrinoFlavor::Electron && flavor != NeutrinoFlavor::Muon)
+    {
+      malformed("unknown neutrino flavor");
+    }
+  }
+  for (TauDecayMode mode : column<TauDecayMode>(block, EventColumn::TauDecayMode))
+  {
+    if (mode != TauDecayMode::Hadronic && mode != TauDecayMode::Leptonic)
+    {
+      malformed("unknown tau decay mode");
+    }
+  }
+
+  // The k-th entry of each row column must name the k-th particle of its type, and a
+  // tau's decay products must lie in the tau's own event
+  std::array<ColumnView<std::uint32_t>, particle_type_count> rows;
+  rows[static_cast<std::size_t>(ParticleType::Electron)] = column<std::uint32_t>(block, EventColumn::ElectronRow);
+  rows[static_cast<std::size_t>(ParticleType::Muon)] = column<std::uint32_t>(block, EventColumn::MuonRow);
+  rows[static_cast<std::size_t>(ParticleType::Neutrino)] = column<std::uint32_t>(block, EventColumn::NeutrinoRow);
+  rows[static_cast<std::size_t>(ParticleType::TauNeutrino)] = column<std::uint32_t>(block, EventColumn::TauNeutrinoRow);
+  rows[static_cast<std::size_t>(ParticleType::Tau)] = column<std::uint32_t>(block, EventColumn::TauRow);
+  auto product_count = column<std::uint8_t>(block, EventColumn::TauProductCount);
+  auto products = column<std::array<std::uint32_t, max_tau_decay_products>>(block, EventColumn::TauProducts);
+  std::array<std::size_t, particle_type_count> next_entry{};
+  for (std::size_t event = 0; event + 1 < offsets.size; ++event)
+  {
+    for (std::uint64_t i = offsets[event]; i < offsets[event + 1]; ++i)
+    {
+      auto kind = static_cast<std::size_t>(type[i]);
+      std::size_t entry = next_entry[kind]++;
+      if (rows[kind][entry] != i)
+      {
+        malformed("row column out of step with the particle types");
+      }
+      if (type[i] != ParticleType::Tau)
+      {
+        continue;
+      }
+      if (product_count[entry] > max_tau_decay_products)
+      {
+        malformed("too many tau decay products");
+      }
+      for (std::size_t product = 0; product < product_count[entry]; ++product)
+      {
+        if (products[entry][product] < offsets[event] || products[entry][product] >= offsets[event + 1])
+        {
+          malformed("tau decay product outside its event");
+        }
+      }
+    }
+  }
+}
+
+void EventFileReader::read_event(std::uint64_t event, ParticleStore& out) const
+{
+  if (event >= get_event_count())
+  {
+    throw std::out_of_range("Event number out of range");
+  }
+  out.clear();
+
+  auto next_block = std::upper_bound(block_first_event.begin(), block_first_event.end(), event);
+  std::size_t block = static_cast<std::size_t>(next_block - block_first_event.begin()) - 1;
+  std::size_t local_event = static_cast<std::size_t>(event - block_first_event[block]);
+
+  auto offsets = column<std::uint64_t>(block, EventColumn::EventOffsets);
+  auto begin = static_cast<std::uint32_t>(offsets[local_event]);
+  auto end = static_cast<std::uint32_t>(offsets[local_event + 1]);
+
+  auto energy = column<double>(block, EventColumn::Energy);
+  auto px = column<double>(block, EventColumn::Px);
+  auto py = column<double>(block, EventColumn::Py);
+  auto pz = column<double>(block, EventColumn::Pz);
+  auto mass = column<double>(block, EventColumn::Mass);
+  auto charge = column<std::int8_t>(block, EventColumn::Charge);
+  auto type = column<ParticleType>(block, EventColumn::Type);
+
+  // Row columns are sorted, so the event's first entry in each side table is a binary search away
+  auto first_entry = [this, block, begin](EventColumn rows)
+  {
+    auto view = column<std::uint32_t>(block, rows);
+    return static_cast<std::size_t>(std::lower_bound(view.begin(), view.end(), begin) - view.begin());
+  };
+  std::size_t electron = first_entry(EventColumn::ElectronRow);
+  std::size_t muon = first_entry(EventColumn::MuonRow);
+  std::size_t neutrino = first_entry(EventColumn::NeutrinoRow);
+  std::size_t tau_neutrino = first_entry(EventColumn::TauNeutrinoRow);
+  std::size_t tau = first_entry(EventColumn::TauRow);
+  std::size_t first_tau = tau;
+
+  auto layers = column<std::array<double, 4>>(block, EventColumn::ElectronLayers);
+  auto isolated = column<std::uint8_t>(block, EventColumn::MuonIsolated);
+  auto flavor = column<NeutrinoFlavor>(block, EventColumn::NeutrinoFlavor);
+  auto interacted = column<std::uint8_t>(block, EventColumn::NeutrinoInteracted);
+  auto tau_neutrino_interacted = column<std::uint8_t>(block, EventColumn::TauNeutrinoInteracted);
+  auto decay_mode = column<TauDecayMode>(block, EventColumn::TauDecayMode);
+
+  out.reserve(end - begin);
+  for (std::uint32_t i = begin; i < end; ++i)
+  {
+    switch (type[i])
+    {
+      case ParticleType::Electron:
+        out.add_electron(mass[i], charge[i], energy[i], px[i], py[i], pz[i], layers[electron++]);
+        break;
+      case ParticleType::Muon:
+        out.add_muon(mass[i], charge[i], energy[i], px[i], py[i], pz[i], isolated[muon++] != 0);
+        break;
+      case ParticleType::Neutrino:
+        out.add_neutrino(mass[i], charge[i], energy[i], px[i], py[i], pz[i], flavor[neutrino], interacted[neutrino] != 0);
+        ++neutrino;
+        break;
+      case ParticleType::TauNeutrino:
+        out.add_tau_neutrino(mass[i], charge[i], energy[i], px[i], py[i], pz[i], tau_neutrino_interacted[tau_neutrino++] != 0);
+        break;
+      case ParticleType::Tau:
+        out.add_tau(mass[i], charge[i], energy[i], px[i], py[i], pz[i], decay_mode[tau++]);
+        break;
+      default:
+        malformed("unknown particle type");
+    }
+  }
+
+  // Link decay products once every particle of the event exists
+  auto tau_rows = column<std::uint32_t>(block, EventColumn::TauRow);
+  auto product_count = column<std::uint8_t>(block, EventColumn::TauProductCount);
+  auto products = column<std::array<std::uint32_t, max_tau_decay_products>>(block, EventColumn::TauProducts);
+  for (std::size_t entry = first_tau; entry < tau; ++entry)
+  {
+    for (std::size_t product = 0; product < product_count[entry]; ++product)
+    {
+      out.add_decay_product(tau_rows[entry] - begin, products[entry][product] - begin);
+    }
+  }
+}
@@ -0,0 +1,138 @@
+// Description: Versioned binary columnar event file format, with a streaming writer and a memory-mapped reader.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef EVENTFILE_H
+#define EVENTFILE_H
+
+#include "ParticleStore.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// File layout (version 1, host byte order, checked on open):
+//
+//   FileHeader                      fixed 64 bytes, rewritten when the writer closes
+//   Block 0 .. Block N-1            each a BlockHeader, its column table and column data
+//   Block index                     N uint64 file offsets of the blocks
+//
+// Inside a block every column is contiguous and 64-byte aligned, so one field can be
+// scanned across many events without touching the others. Side columns hold one
+// entry per particle of that type, in particle order, with a *_ROW column giving
+// the block-relative particle index of each entry.
+enum class EventColumn : std::uint32_t
+{
+  EventOffsets,          // uint64, events + 1: first particle of each event within the block
+  Energy,                // double
+  Px,                    // double
+  Py,                    // double
+  Pz,                    // double
+  Mass,                  // double
+  Charge,                // int8
+  Type,                  // ParticleType (uint8)
+  ElectronRow,           // uint32
+  ElectronLayers,        // double[4]: EM_1, EM_2, HAD_1, HAD_2
+  MuonRow,               // uint32
+  MuonIsolated,          // uint8
+  NeutrinoRow,           // uint32
+  NeutrinoFlavor,        // NeutrinoFlavor (uint8)
+  NeutrinoInteracted,    // uint8
+  TauNeutrinoRow,        // uint32
+  TauNeutrinoInteracted, // uint8
+  TauRow,                // uint32
+  TauDecayMode,          // TauDecayMode (uint8)
+  TauProductCount,       // uint8
+  TauProducts,           // uint32[max_tau_decay_products]: block-relative particle indices
+  Count
+};
+constexpr std::size_t event_column_count = static_cast<std::size_t>(EventColumn::Count);
+
+constexpr std::uint32_t event_file_version = 1;
+
+class EventFileWriter
+{
+private:
+  std::ofstream file;
+  std::string path;
+  std::size_t events_per_block;
+  std::vector<std::uint64_t> block_offsets;
+  std::uint64_t total_events;
+  std::uint64_t total_particles;
+  bool open;
+
+  // Pending block, accumulated column by column
+  std::array<std::vector<unsigned char>, event_column_count> columns;
+  std::uint64_t block_events;
+  std::uint64_t block_particles;
+
+  template <typename T>
+  void append(EventColumn column, const T& value);
+  void flush_block();
+  void write_header(std::uint64_t index_offset);
+
+public:
+  explicit EventFileWriter(const std::string& path, std::size_t events_per_block = 4096); // Throws std::runtime_error if the file cannot be created
+  ~EventFileWriter(); // Closes the file if close() was not called
+
+  EventFileWriter(const EventFileWriter&) = delete;
+  EventFileWriter& operator=(const EventFileWriter&) = delete;
+
+  void write(const ParticleStore& event); // Starts the next block early rather than let a block pass 2^32 - 1 particles
+  void close(); // Flushes the last block and writes the index and final header
+
+  std::uint64_t get_event_count() const { return total_events; }
+};
+
+// Typed view of one column of one block, pointing straight into the mapping
+template <typename T>
+struct ColumnView
+{
+  const T* data;
+  std::size_t size;
+
+  const T* begin() const { return data; }
+  const T* end() const { return data + size; }
+  const T& operator[](std::size_t i) const { return data[i]; }
+};
+
+class EventFileReader
+{
+private:
+  const unsigned char* mapping;
+  std::size_t mapping_size;
+  std::vector<std::uint64_t> block_offsets;
+  std::vector<std::uint64_t> block_first_event; // Prefix sums, block_count + 1 entries
+  std::uint64_t total_particles;
+
+  const unsigned char* column_data(std::size_t block, EventColumn column, std::size_t element_size, std::size_t& count) const;
+  void validate_block(std::size_t block) const; // Checks the cross-column invariants read_event relies on
+
+public:
+  explicit EventFileReader(const std::string& path); // Throws std::runtime_error for unreadable or malformed files
+  ~EventFileReader();
+
+  EventFileReader(const EventFileReader&) = delete;
+  EventFileReader& operator=(const EventFileReader&) = delete;
+
+  std::size_t get_block_count() const { return block_offsets.size(); }
+  std::uint64_t get_event_count() const { return block_first_event.back(); }
+  std::uint64_t get_particle_count() const { return total_particles; }
+  std::uint64_t get_block_event_count(std::size_t block) const { return block_first_event[block + 1] - block_first_event[block]; }
+
+  // Zero-copy access; T must match the column's element size (e.g. std::array<double, 4> for ElectronLayers)
+  template <typename T>
+  ColumnView<T> column(std::size_t block, EventColumn id) const
+  {
+    std::size_t count = 0;
+    const unsigned char* data = column_data(block, id, sizeof(T), count);
+    return ColumnView<T>{reinterpret_cast<const T*>(data), count};
+  }
+
+  // Rebuilds a single event as a ParticleStore (cleared first)
+  void read_event(std::uint64_t event, ParticleStore& out) const;
+};
+
+#endif
@@ -0,0 +1,187 @@
+// Description: Defines the EventGenerator class, a Monte Carlo source of lepton events with sampled kinematics.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "EventGenerator.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+  constexpr double pi = 3.14159265358979323846;
+  constexpr std::size_t events_per_task = 64;
+  constexpr std::size_t kinematics_chunk = 16; // Primaries whose pT, eta and phi are drawn in one go
+
+  // Typical share of an electron shower in EM_1, EM_2, HAD_1 and HAD_2
+  constexpr std::array<double, 4> electron_layer_fractions{{0.30, 0.60, 0.07, 0.03}};
+
+  struct Kinematics
+  {
+    double energy, px, py, pz;
+  };
+
+  Kinematics from_pt_eta_phi(double pt, double eta, double phi, double mass)
+  {
+    Kinematics k;
+    k.px = pt * std::cos(phi);
+    k.py = pt * std::sin(phi);
+    k.pz = pt * std::sinh(eta);
+    k.energy = std::sqrt(k.px * k.px + k.py * k.py + k.pz * k.pz + mass * mass);
+    return k;
+  }
+
+  // Adds a tau decay product to the event and links it to its tau; the store keeps
+  // leptons only, so pions are left out (as are all products of hadronic taus)
+  void add_decay_product(ParticleStore& event, ParticleStore::Index tau, const DecayProduct& p)
+  {
+    ParticleStore::Index product;
+    switch (p.type)
+    {
+      case DecayProductType::Electron:
+      {
+        std::array<double, 4> layers;
+        for (std::size_t layer = 0; layer < layers.size(); ++layer)
+        {
+          layers[layer] = electron_layer_fractions[layer] * p.energy;
+        }
+        product = event.add_electron(p.mass, p.charge, p.energy, p.px, p.py, p.pz, layers);
+        break;
+      }
+      case DecayProductType::Muon:
+        product = event.add_muon(p.mass, p.charge, p.energy, p.px, p.py, p.pz);
+        break;
+      case DecayProductType::ElectronNeutrino:
+        product = event.add_neutrino(p.mass, 0, p.energy, p.px, p.py, p.pz, NeutrinoFlavor::Electron);
+        break;
+      case DecayProductType::MuonNeutrino:
+        product = event.add_neutrino(p.mass, 0, p.energy, p.px, p.py, p.pz, NeutrinoFlavor::Muon);
+        break;
+      case DecayProductType::TauNeutrino:
+        product = event.add_tau_neutrino(p.mass, 0, p.energy, p.px, p.py, p.pz);
+        break;
+      default:
+        return;
+    }
+    event.add_decay_product(tau, product);
+  }
+}
+
+EventGenerator::EventGenerator(const EventGeneratorConfig& config)
+  : config(config)
+{
+  if (config.min_particles > config.max_particles)
+  {
+    throw std::invalid_argument("min_particles must not exceed max_particles");
+  }
+  double total_weight = 0.0;
+  for (double weight : config.type_weights)
+  {
+    if (weight < 0)
+    {
+      throw std::invalid_argument("Particle type weights must not be negative");
+    }
+    total_weight += weight;
+  }
+  if (total_weight <= 0)
+  {
+    throw std::invalid_argument("At least one particle type weight must be positive");
+  }
+  if (config.mean_pt <= 0 || config.max_abs_eta < 0)
+  {
+    throw std::invalid_argument("mean_pt must be positive and max_abs_eta non-negative");
+  }
+}
+
+void EventGenerator::generate_event(std::uint64_t event_number, ParticleStore& event) const
+{
+  event.clear();
+  RandomEngine engine = make_event_engine(config.seed, event_number);
+  RandomEngine decay_engine = make_event_engine(config.seed, event_number, RandomStream::TauDecay); // Own stream, so decays never shift the kinematics
+
+  std::uniform_int_distribution<std::size_t> multiplicity(config.min_particles, config.max_particles);
+  std::discrete_distribution<int> type_choice(config.type_weights.begin(), config.type_weights.end());
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  // pT, eta and phi come from the batch samplers, a chunk of primaries at a time, so
+  // the Philox blocks for them are generated together rather than one draw at a time
+  std::array<double, kinematics_chunk> pt, eta, phi;
+  std::size_t primaries = multiplicity(engine);
+  event.reserve(primaries * 2);
+  for (std::size_t i = 0; i < primaries; ++i)
+  {
+    std::size_t slot = i % kinematics_chunk;
+    if (slot == 0)
+    {
+      std::size_t count = std::min(kinematics_chunk, primaries - i);
+      fill_exponential(engine, pt.data(), count, config.mean_pt);
+      fill_uniform(engine, eta.data(), count, -config.max_abs_eta, config.max_abs_eta);
+      fill_uniform(engine, phi.data(), count, -pi, pi);
+    }
+    ParticleType type = static_cast<ParticleType>(type_choice(engine));
+    double mass = particle_rest_mass(type);
+    Kinematics k = from_pt_eta_phi(pt[slot], eta[slot], phi[slot], mass);
+    int charge = unit(engine) < 0.5 ? -1 : 1;
+
+    switch (type)
+    {
+      case ParticleType::Electron:
+      {
+        std::array<double, 4> layers;
+        for (std::size_t layer = 0; layer < layers.size(); ++layer)
+        {
+          layers[layer] = electron_layer_fractions[layer] * k.energy;
+        }
+        event.add_electron(mass, charge, k.energy, k.px, k.py, k.pz, layers);
+        break;
+      }
+      case ParticleType::Muon:
+        event.add_muon(mass, charge, k.energy, k.px, k.py, k.pz);
+        break;
+      case ParticleType::Neutrino:
+        event.add_neutrino(mass, 0, k.energy, k.px, k.py, k.pz, unit(engine) < 0.5 ? NeutrinoFlavor::Electron : NeutrinoFlavor::Muon);
+        break;
+      case ParticleType::TauNeutrino:
+        event.add_tau_neutrino(mass, 0, k.energy, k.px, k.py, k.pz);
+        break;
+      case ParticleType::Tau:
+      {
+        bool leptonic = unit(engine) < config.leptonic_tau_fraction;
+        ParticleStore::Index tau = event.add_tau(mass, charge, k.energy, k.px, k.py, k.pz,
+                                                 leptonic ? TauDecayMode::Leptonic : TauDecayMode::Hadronic);
+        if (leptonic)
+        {
+          std::array<DecayProduct, max_tau_decay_multiplicity> products;
+          std::size_t count = decayer.decay(decayer.sample_channel(decay_engine, true), charge, k.energy, k.px, k.py, k.pz, decay_engine,
+                                             products.data());
+          for (std::size_t p = 0; p < count; ++p)
+          {
+            add_decay_product(event, tau, products[p]);
+          }
+        }
+        break;
+      }
+    }
+  }
+}
+
+void EventGenerator::generate(std::uint64_t first_event, std::vector<ParticleStore>& events, ThreadPool& pool) const
+{
+  pool.parallel_for(0, events.size(), events_per_task, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      generate_event(first_event + i, events[i]);
+    }
+  });
+}
+
+std::vector<ParticleStore> EventGenerator::generate(std::uint64_t first_event, std::size_t count, ThreadPool& pool) const
+{
+  std::vector<ParticleStore> events(count);
+  generate(first_event, events, pool);
+  return events;
+}
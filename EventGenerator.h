@@ -0,0 +1,50 @@
+// Description: Defines the EventGenerator class, a Monte Carlo source of lepton events with sampled kinematics.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef EVENTGENERATOR_H
+#define EVENTGENERATOR_H
+
+#include "ParticleStore.h"
+#include "ParticleType.h"
+#include "TauDecay.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+struct EventGeneratorConfig
+{
+  std::uint64_t seed = 1;
+  std::size_t min_particles = 2; // Primary particles per event, drawn uniformly
+  std::size_t max_particles = 8;
+  std::array<double, particle_type_count> type_weights{{0.30, 0.30, 0.15, 0.10, 0.15}}; // Electron, Muon, Neutrino, TauNeutrino, Tau
+  double mean_pt = 20000.0; // MeV/c, exponential spectrum
+  double max_abs_eta = 2.5;
+  double leptonic_tau_fraction = 0.35;
+};
+
+class EventGenerator
+{
+private:
+  EventGeneratorConfig config;
+  TauDecayer decayer; // Leptonic taus decay through it, with products in the tau rest frame boosted to the lab
+
+public:
+  explicit EventGenerator(const EventGeneratorConfig& config = EventGeneratorConfig()); // Throws std::invalid_argument for an unusable config
+
+  const EventGeneratorConfig& get_config() const { return config; }
+
+  // Fills event (after clearing it) with event number event_number. The result
+  // depends only on the seed and the event number.
+  void generate_event(std::uint64_t event_number, ParticleStore& event) const;
+
+  // Generates events first_event .. first_event + events.size() - 1 across the pool,
+  // reusing the stores' capacity. Output is identical for any number of threads;
+  // how throughput scales with the thread count has not been measured.
+  void generate(std::uint64_t first_event, std::vector<ParticleStore>& events, ThreadPool& pool) const;
+  std::vector<ParticleStore> generate(std::uint64_t first_event, std::size_t count, ThreadPool& pool) const;
+};
+
+#endif
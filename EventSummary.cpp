@@ -0,0 +1,323 @@
+// Description: Event-level quantities (missing transverse momentum, visible four-momentum, HT) and their reproducible sums over event samples.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "EventSummary.h"
+#include "Detector.h"
+#include "Lepton.h"
+#include "MomentumKernels.h"
+#include "ParticleStore.h"
+#include "Tau.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+
+#if LEPTON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+  constexpr std::size_t lanes = 4;
+  constexpr std::size_t events_per_task = 64;
+
+  // 1.0 for the particle types a sum takes and 0.0 otherwise, so the loop multiplies instead of branching
+  struct TypeWeights
+  {
+    std::array<double, particle_type_count> visible{};
+    std::array<double, particle_type_count> neutrino{};
+  };
+
+  constexpr TypeWeights make_type_weights()
+  {
+    TypeWeights weights;
+    for (std::size_t type = 0; type < particle_type_count; ++type)
+    {
+      ParticleType particle = static_cast<ParticleType>(type);
+      weights.visible[type] = Detector::acceptance_mask(particle) != 0 || particle == ParticleType::Tau ? 1.0 : 0.0; // Taus: see visible_weight
+      weights.neutrino[type] = particle == ParticleType::Neutrino || particle == ParticleType::TauNeutrino ? 1.0 : 0.0;
+    }
+    return weights;
+  }
+
+  constexpr TypeWeights type_weights = make_type_weights();
+
+  struct PartialSums
+  {
+    std::array<double, lanes> energy{};
+    std::array<double, lanes> px{};
+    std::array<double, lanes> py{};
+    std::array<double, lanes> pz{};
+    std::array<double, lanes> ht{};
+    std::array<double, lanes> neutrino_px{};
+    std::array<double, lanes> neutrino_py{};
+    std::array<std::uint32_t, lanes> visible_count{};
+    std::array<std::uint32_t, lanes> neutrino_count{};
+
+    static double combine(const std::array<double, lanes>& lane) { return (lane[0] + lane[1]) + (lane[2] + lane[3]); }
+    static std::uint32_t combine(const std::array<std::uint32_t, lanes>& lane) { return lane[0] + lane[1] + lane[2] + lane[3]; }
+  };
+
+  struct StoreRows
+  {
+    const ParticleStore* store;
+    const ParticleType* types;
+    const double* e;
+    const double* x;
+    const double* y;
+    const double* z;
+
+    ParticleType type(std::size_t i) const { return types[i]; }
+    double energy(std::size_t i) const { return e[i]; }
+    double px(std::size_t i) const { return x[i]; }
+    double py(std::size_t i) const { return y[i]; }
+    double pz(std::size_t i) const { return z[i]; }
+    bool leptonic_tau(std::size_t i) const { return (*store)[static_cast<ParticleStore::Index>(i)].get_decay_mode() == TauDecayMode::Leptonic; }
+  };
+
+  struct LeptonRows
+  {
+    const Lepton* const* particles;
+
+    ParticleType type(std::size_t i) const { return particles[i]->get_type_id(); }
+    double energy(std::size_t i) const { return particles[i]->get_four_momentum().get_energy(); }
+    double px(std::size_t i) const { return particles[i]->get_four_momentum().get_px(); }
+    double py(std::size_t i) const { return particles[i]->get_four_momentum().get_py(); }
+    double pz(std::size_t i) const { return particles[i]->get_four_momentum().get_pz(); }
+    bool leptonic_tau(std::size_t i) const { return static_cast<const Tau*>(particles[i])->get_decay_mode() == TauDecayMode::Leptonic; }
+  };
+
+  // A leptonic tau's decay products are rows of their own and carry its momentum, so
+  // the tau is left out. A hadronic tau has no product rows: its jet is what the
+  // calorimeter sees (Calorimeter::deposit_event), so the tau itself counts.
+  template <typename Rows>
+  double visible_weight(const Rows& rows, std::size_t i, std::size_t type)
+  {
+    return type == static_cast<std::size_t>(ParticleType::Tau) && rows.leptonic_tau(i) ? 0.0 : type_weights.visible[type];
+  }
+
+  template <typename Rows>
+  void accumulate(PartialSums& sums, std::size_t lane, const Rows& rows, std::size_t i)
+  {
+    std::size_t type = static_cast<std::size_t>(rows.type(i));
+    double visible = visible_weight(rows, i, type);
+    double neutrino = type_weights.neutrino[type];
+    double x = rows.px(i);
+    double y = rows.py(i);
+    sums.energy[lane] += visible * rows.energy(i);
+    sums.px[lane] += visible * x;
+    sums.py[lane] += visible * y;
+    sums.pz[lane] += visible * rows.pz(i);
+    sums.ht[lane] += visible * std::sqrt(x * x + y * y);
+    sums.neutrino_px[lane] += neutrino * x;
+    sums.neutrino_py[lane] += neutrino * y;
+    sums.visible_count[lane] += static_cast<std::uint32_t>(visible);
+    sums.neutrino_count[lane] += static_cast<std::uint32_t>(neutrino);
+  }
+
+  // Continues from row i, which must be a multiple of lanes
+  template <typename Rows>
+  void accumulate_rows(PartialSums& sums, const Rows& rows, std::size_t i, std::size_t count)
+  {
+    for (; i + lanes <= count; i += lanes)
+    {
+      for (std::size_t lane = 0; lane < lanes; ++lane)
+      {
+        accumulate(sums, lane, rows, i + lane);
+      }
+    }
+    for (std::size_t lane = 0; i < count; ++i, ++lane)
+    {
+      accumulate(sums, lane, rows, i);
+    }
+  }
+
+#if LEPTON_X86_KERNELS
+  // One register per partial sum array, lane k holding partial sum k, so the result is
+  // the scalar loop's bit for bit. Returns the first row left for the scalar tail.
+  // AVX-512 machines run this too: eight lanes would change the summation order.
+  __attribute__((target("avx2")))
+  std::size_t accumulate_avx2(PartialSums& sums, const StoreRows& rows, std::size_t count)
+  {
+    __m256d energy = _mm256_setzero_pd();
+    __m256d px = _mm256_setzero_pd();
+    __m256d py = _mm256_setzero_pd();
+    __m256d pz = _mm256_setzero_pd();
+    __m256d ht = _mm256_setzero_pd();
+    __m256d neutrino_px = _mm256_setzero_pd();
+    __m256d neutrino_py = _mm256_setzero_pd();
+    __m256d visible_count = _mm256_setzero_pd();
+    __m256d neutrino_count = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + lanes <= count; i += lanes)
+    {
+      std::size_t t0 = static_cast<std::size_t>(rows.types[i]);
+      std::size_t t1 = static_cast<std::size_t>(rows.types[i + 1]);
+      std::size_t t2 = static_cast<std::size_t>(rows.types[i + 2]);
+      std::size_t t3 = static_cast<std::size_t>(rows.types[i + 3]);
+      __m256d visible = _mm256_set_pd(visible_weight(rows, i + 3, t3), visible_weight(rows, i + 2, t2), visible_weight(rows, i + 1, t1),
+                                      visible_weight(rows, i, t0));
+      __m256d neutrino = _mm256_set_pd(type_weights.neutrino[t3], type_weights.neutrino[t2], type_weights.neutrino[t1], type_weights.neutrino[t0]);
+      __m256d x = _mm256_loadu_pd(rows.x + i);
+      __m256d y = _mm256_loadu_pd(rows.y + i);
+      energy = _mm256_add_pd(energy, _mm256_mul_pd(visible, _mm256_loadu_pd(rows.e + i)));
+      px = _mm256_add_pd(px, _mm256_mul_pd(visible, x));
+      py = _mm256_add_pd(py, _mm256_mul_pd(visible, y));
+      pz = _mm256_add_pd(pz, _mm256_mul_pd(visible, _mm256_loadu_pd(rows.z + i)));
+      __m256d pt = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)));
+      ht = _mm256_add_pd(ht, _mm256_mul_pd(visible, pt));
+      neutrino_px = _mm256_add_pd(neutrino_px, _mm256_mul_pd(neutrino, x));
+      neutrino_py = _mm256_add_pd(neutrino_py, _mm256_mul_pd(neutrino, y));
+      visible_count = _mm256_add_pd(visible_count, visible);
+      neutrino_count = _mm256_add_pd(neutrino_count, neutrino);
+    }
+    _mm256_storeu_pd(sums.energy.data(), energy);
+    _mm256_storeu_pd(sums.px.data(), px);
+    _mm256_storeu_pd(sums.py.data(), py);
+    _mm256_storeu_pd(sums.pz.data(), pz);
+    _mm256_storeu_pd(sums.ht.data(), ht);
+    _mm256_storeu_pd(sums.neutrino_px.data(), neutrino_px);
+    _mm256_storeu_pd(sums.neutrino_py.data(), neutrino_py);
+    alignas(32) double counts[2 * lanes];
+    _mm256_store_pd(counts, visible_count);
+    _mm256_store_pd(counts + lanes, neutrino_count);
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+      sums.visible_count[lane] = static_cast<std::uint32_t>(counts[lane]);
+      sums.neutrino_count[lane] = static_cast<std::uint32_t>(counts[lanes + lane]);
+    }
+    return i;
+  }
+#endif
+
+  EventSummary finish(const PartialSums& sums)
+  {
+    EventSummary summary;
+    double px = PartialSums::combine(sums.px);
+    double py = PartialSums::combine(sums.py);
+    summary.visible = FourMomentum(PartialSums::combine(sums.energy), px, py, PartialSums::combine(sums.pz));
+    summary.ht = PartialSums::combine(sums.ht);
+    summary.met_x = 0.0 - px; // Not -px: an empty event gets +0
+    summary.met_y = 0.0 - py;
+    summary.true_met_x = PartialSums::combine(sums.neutrino_px);
+    summary.true_met_y = PartialSums::combine(sums.neutrino_py);
+    summary.visible_count = PartialSums::combine(sums.visible_count);
+    summary.neutrino_count = PartialSums::combine(sums.neutrino_count);
+    return summary;
+  }
+
+  EventSampleTotals sum_block(const EventSummary* summaries, std::size_t count)
+  {
+    EventSampleTotals totals;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      totals.add(summaries[i]);
+    }
+    return totals;
+  }
+
+  // Pairwise over block index: 0+1, 2+3, ... then (0+1)+(2+3), ...
+  EventSampleTotals combine_blocks(std::vector<EventSampleTotals>& blocks)
+  {
+    for (std::size_t width = 1; width < blocks.size(); width *= 2)
+    {
+      for (std::size_t block = 0; block + width < blocks.size(); block += 2 * width)
+      {
+        blocks[block].merge(blocks[block + width]);
+      }
+    }
+    return blocks.empty() ? EventSampleTotals() : blocks.front();
+  }
+
+  std::size_t block_count(std::size_t summaries)
+  {
+    return (summaries + summary_block_size - 1) / summary_block_size;
+  }
+
+  std::size_t block_length(std::size_t block, std::size_t summaries)
+  {
+    return std::min(summary_block_size, summaries - block * summary_block_size);
+  }
+}
+
+void EventSampleTotals::add(const EventSummary& summary)
+{
+  ++events;
+  visible += summary.visible;
+  ht += summary.ht;
+  met += summary.get_met();
+  met_x += summary.met_x;
+  met_y += summary.met_y;
+  visible_count += summary.visible_count;
+  neutrino_count += summary.neutrino_count;
+}
+
+void EventSampleTotals::merge(const EventSampleTotals& other)
+{
+  events += other.events;
+  visible += other.visible;
+  ht += other.ht;
+  met += other.met;
+  met_x += other.met_x;
+  met_y += other.met_y;
+  visible_count += other.visible_count;
+  neutrino_count += other.neutrino_count;
+}
+
+EventSummary summarize_event(const ParticleStore& event)
+{
+  StoreRows rows{&event, event.type_column().data(), event.energy_column().data(), event.px_column().data(),
+                 event.py_column().data(), event.pz_column().data()};
+  PartialSums sums;
+  std::size_t first = 0;
+#if LEPTON_X86_KERNELS
+  if (get_kernel_simd_level() != SimdLevel::Scalar)
+  {
+    first = accumulate_avx2(sums, rows, event.size());
+  }
+#endif
+  accumulate_rows(sums, rows, first, event.size());
+  return finish(sums);
+}
+
+EventSummary summarize_event(const Lepton* const* particles, std::size_t count)
+{
+  PartialSums sums;
+  accumulate_rows(sums, LeptonRows{particles}, 0, count);
+  return finish(sums);
+}
+
+void summarize_events(const std::vector<ParticleStore>& events, std::vector<EventSummary>& summaries, ThreadPool& pool)
+{
+  summaries.resize(events.size());
+  pool.parallel_for(0, events.size(), events_per_task, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      summaries[i] = summarize_event(events[i]);
+    }
+  });
+}
+
+EventSampleTotals reduce_summaries(const std::vector<EventSummary>& summaries, ThreadPool& pool)
+{
+  std::vector<EventSampleTotals> blocks(block_count(summaries.size()));
+  pool.parallel_for(0, blocks.size(), 1, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t block = begin; block < end; ++block)
+    {
+      blocks[block] = sum_block(summaries.data() + block * summary_block_size, block_length(block, summaries.size()));
+    }
+  });
+  return combine_blocks(blocks);
+}
+
+EventSampleTotals reduce_summaries(const std::vector<EventSummary>& summaries)
+{
+  std::vector<EventSampleTotals> blocks(block_count(summaries.size()));
+  for (std::size_t block = 0; block < blocks.size(); ++block)
+  {
+    blocks[block] = sum_block(summaries.data() + block * summary_block_size, block_length(block, summaries.size()));
+  }
+  return combine_blocks(blocks);
+}
@@ -0,0 +1,73 @@
+// Description: Event-level quantities (missing transverse momentum, visible four-momentum, HT) and their reproducible sums over event samples.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef EVENTSUMMARY_H
+#define EVENTSUMMARY_H
+
+#include "FourMomentum.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Lepton;
+class ParticleStore;
+class ThreadPool;
+
+// A particle is visible if any Detector type accepts it. Neutrinos are not. A
+// leptonic tau is not either, as its decay products carry its momentum; a hadronic
+// tau has no product rows and counts as visible, as in Calorimeter::deposit_event.
+struct EventSummary
+{
+  FourMomentum visible; // Sum of the visible particles' four-momenta
+  double ht = 0.0; // Scalar sum of visible pT
+  double met_x = 0.0; // Missing transverse momentum: minus the visible px and py sums
+  double met_y = 0.0;
+  double true_met_x = 0.0; // Sum of the neutrinos' px and py, to compare the reconstruction against
+  double true_met_y = 0.0;
+  std::uint32_t visible_count = 0;
+  std::uint32_t neutrino_count = 0;
+
+  double get_met() const { return std::sqrt(met_x * met_x + met_y * met_y); }
+  double get_met_phi() const { return (met_x == 0.0 && met_y == 0.0) ? 0.0 : std::atan2(met_y, met_x); }
+};
+
+// Sums of EventSummary fields over a sample
+struct EventSampleTotals
+{
+  std::size_t events = 0;
+  FourMomentum visible;
+  double ht = 0.0;
+  double met = 0.0; // Sum of the events' get_met()
+  double met_x = 0.0;
+  double met_y = 0.0;
+  std::size_t visible_count = 0;
+  std::size_t neutrino_count = 0;
+
+  void add(const EventSummary& summary);
+  void merge(const EventSampleTotals& other);
+  double mean_ht() const { return events > 0 ? ht / static_cast<double>(events) : 0.0; }
+  double mean_met() const { return events > 0 ? met / static_cast<double>(events) : 0.0; }
+};
+
+// One pass over the event's columns, in AVX2 where the CPU has it. Particle i goes
+// into partial sum i % 4 and the partial sums are combined as (0 + 1) + (2 + 3), so
+// the scalar and SIMD paths, and every machine, give the same bits. pT is
+// sqrt(px^2 + py^2), which can differ from FourMomentum::get_pt (std::hypot) in the
+// last bit.
+EventSummary summarize_event(const ParticleStore& event);
+EventSummary summarize_event(const Lepton* const* particles, std::size_t count); // Same sums over Lepton objects
+
+// summaries[i] is the summary of events[i]; summaries is resized to match
+void summarize_events(const std::vector<ParticleStore>& events, std::vector<EventSummary>& summaries, ThreadPool& pool);
+
+// Totals over a sample, bit-identical for any thread count, including the serial
+// overload. Summaries are cut into fixed blocks of summary_block_size whatever the
+// pool size; each block is summed in order and the block totals are combined by a
+// pairwise tree over block index.
+constexpr std::size_t summary_block_size = 256;
+EventSampleTotals reduce_summaries(const std::vector<EventSummary>& summaries, ThreadPool& pool);
+EventSampleTotals reduce_summaries(const std::vector<EventSummary>& summaries);
+
+#endif
@@ -5,73 +5,137 @@
 #ifndef FOURMOMENTUM_H
 #define FOURMOMENTUM_H
 
-#include <vector>
+#include <array>
+#include <cmath>
 #include <stdexcept>
 
-class FourMomentum 
+// Fixed-size Lorentz vector held inline (no heap storage). The 32-byte alignment
+// lets the four components be loaded as a single AVX register.
+class alignas(32) FourMomentum
 {
 private:
-  std::vector<double> momentum; // Stores [energy, px, py, pz]
+  std::array<double, 4> momentum; // Stores [energy, px, py, pz]
 
 public:
-  FourMomentum(double energy = 0.0, double px = 0.0, double py = 0.0, double pz = 0.0)
-    : momentum{energy, px, py, pz} 
+  constexpr FourMomentum(double energy = 0.0, double px = 0.0, double py = 0.0, double pz = 0.0)
+    : momentum{energy, px, py, pz}
   {}
 
-  // Copy Constructor
-  FourMomentum(const FourMomentum& other) 
-    : momentum(other.momentum) 
-  {}
+  // Trivially copyable, so the compiler-generated copy and move are a plain 32-byte copy
+  constexpr FourMomentum(const FourMomentum& other) = default;
+  constexpr FourMomentum& operator=(const FourMomentum& other) = default;
+  constexpr FourMomentum(FourMomentum&& other) noexcept = default;
+  constexpr FourMomentum& operator=(FourMomentum&& other) noexcept = default;
+  ~FourMomentum() = default;
 
-  // Copy Assignment Operator
-  FourMomentum& operator=(const FourMomentum& other) 
+  // Setters
+  void set_energy(double energy)
   {
-    if (this != &other) 
+    if (energy > 0)
     {
-      momentum = other.momentum;
+      momentum[0] = energy;
+    }
+    else
+    {
+      throw std::invalid_argument("Energy must be greater than 0");
     }
-    return *this;
   }
+  void set_px(double px) { momentum[1] = px; }
+  void set_py(double py) { momentum[2] = py; }
+  void set_pz(double pz) { momentum[3] = pz; }
 
-  // Move Constructor
-  FourMomentum(FourMomentum&& other) noexcept 
-    : momentum(std::move(other.momentum)) 
-  {}
+  // Getters
+  constexpr double get_energy() const { return momentum[0]; }
+  constexpr double get_px() const { return momentum[1]; }
+  constexpr double get_py() const { return momentum[2]; }
+  constexpr double get_pz() const { return momentum[3]; }
 
-  // Move Assignment Operator
-  FourMomentum& operator=(FourMomentum&& other) noexcept 
+  // Minkowski dot product with the (+, -, -, -) metric
+  constexpr double dot(const FourMomentum& other) const
   {
-    if (this != &other) 
+    return momentum[0] * other.momentum[0] -
+           (momentum[1] * other.momentum[1] +
+            momentum[2] * other.momentum[2] +
+            momentum[3] * other.momentum[3]);
+  }
+
+  // Derived kinematics, recomputed on every call (CachedFourMomentum keeps them)
+  constexpr double get_mass_squared() const { return dot(*this); }
+  constexpr double get_pt_squared() const { return momentum[1] * momentum[1] + momentum[2] * momentum[2]; }
+  constexpr double get_p_squared() const { return get_pt_squared() + momentum[3] * momentum[3]; }
+
+  double get_mass() const
+  {
+    // Space-like vectors (from rounding or off-shell sums) report a negative mass
+    double mass_squared = get_mass_squared();
+    return mass_squared >= 0 ? std::sqrt(mass_squared) : -std::sqrt(-mass_squared);
+  }
+
+  double get_pt() const { return std::hypot(momentum[1], momentum[2]); }
+  double get_p() const { return std::sqrt(get_p_squared()); }
+  double get_phi() const { return (momentum[1] == 0.0 && momentum[2] == 0.0) ? 0.0 : std::atan2(momentum[2], momentum[1]); }
+
+  double get_eta() const { return get_eta_for_pt(get_pt()); }
+
+  // Pseudorapidity when get_pt() is already known, as in CachedFourMomentum
+  double get_eta_for_pt(double pt) const
+  {
+    if (pt == 0.0)
     {
-      momentum = std::move(other.momentum);
+      // Pseudorapidity diverges along the beam axis; clamp to a large finite value
+      return momentum[3] == 0.0 ? 0.0 : std::copysign(1e10, momentum[3]);
     }
-    return *this;
+    return std::asinh(momentum[3] / pt);
   }
 
-  // Destructor
-  ~FourMomentum() = default;
+  double get_rapidity() const
+  {
+    double e_plus_pz = momentum[0] + momentum[3];
+    double e_minus_pz = momentum[0] - momentum[3];
+    if (e_plus_pz <= 0.0 || e_minus_pz <= 0.0)
+    {
+      return momentum[3] == 0.0 ? 0.0 : std::copysign(1e10, momentum[3]);
+    }
+    return 0.5 * std::log(e_plus_pz / e_minus_pz);
+  }
 
-  // Setters
-  void set_energy(double energy) 
-  { 
-    if (energy > 0) 
+  // Arithmetic
+  constexpr FourMomentum& operator+=(const FourMomentum& other)
+  {
+    for (std::size_t i = 0; i < 4; ++i)
     {
-      momentum[0] = energy; 
-    } 
-    else 
+      momentum[i] += other.momentum[i];
+    }
+    return *this;
+  }
+
+  constexpr FourMomentum& operator-=(const FourMomentum& other)
+  {
+    for (std::size_t i = 0; i < 4; ++i)
     {
-      throw std::invalid_argument("Energy must be greater than 0");
+      momentum[i] -= other.momentum[i];
     }
+    return *this;
   }
-  void set_px(double px) { momentum[1] = px; }
-  void set_py(double py) { momentum[2] = py; }
-  void set_pz(double pz) { momentum[3] = pz; }
 
-  // Getters
-  double get_energy() const { return momentum[0]; }
-  double get_px() const { return momentum[1]; }
-  double get_py() const { return momentum[2]; }
-  double get_pz() const { return momentum[3]; }
+  constexpr FourMomentum& operator*=(double factor)
+  {
+    for (auto& component : momentum)
+    {
+      component *= factor;
+    }
+    return *this;
+  }
 };
 
-#endif 
+constexpr FourMomentum operator+(FourMomentum lhs, const FourMomentum& rhs) { return lhs += rhs; }
+constexpr FourMomentum operator-(FourMomentum lhs, const FourMomentum& rhs) { return lhs -= rhs; }
+constexpr FourMomentum operator*(FourMomentum lhs, double factor) { return lhs *= factor; }
+constexpr FourMomentum operator*(double factor, FourMomentum rhs) { return rhs *= factor; }
+
+// Vector-vector product is the Minkowski dot product, as in most HEP vector libraries
+constexpr double operator*(const FourMomentum& lhs, const FourMomentum& rhs) { return lhs.dot(rhs); }
+
+static_assert(sizeof(FourMomentum) == 32, "FourMomentum must stay a packed 32-byte value");
+
+#endif
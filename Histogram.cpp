@@ -0,0 +1,511 @@
+// Description: Defines BinAxis, Histogram1D and Histogram2D, weighted histograms filled concurrently through per-thread slots.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Histogram.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <thread>
+
+namespace
+{
+  constexpr char file_magic[8] = {'L', 'E', 'P', 'H', 'I', 'S', 'T', '\0'};
+  constexpr std::uint32_t byte_order_mark = 0x01020304;
+  constexpr std::uint32_t format_version = 1;
+  constexpr std::size_t fill_chunk = 256; // Bin indices computed per pass in the batch fills
+
+  // Writes a trivially copyable value in native byte order; the header records which
+  template <typename T>
+  void put(std::ostream& out, const T& value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T get(std::istream& in)
+  {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+    {
+      throw std::runtime_error("Malformed histogram file: unexpected end of data");
+    }
+    return value;
+  }
+
+  void put_doubles(std::ostream& out, const std::vector<double>& values)
+  {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+  }
+
+  std::vector<double> get_doubles(std::istream& in, std::size_t count)
+  {
+    std::vector<double> values(count);
+    if (!in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(double))))
+    {
+      throw std::runtime_error("Malformed histogram file: unexpected end of data");
+    }
+    return values;
+  }
+
+  void write_header(std::ostream& out, std::uint32_t dimensions, const std::string& name)
+  {
+    out.write(file_magic, sizeof(file_magic));
+    put(out, byte_order_mark);
+    put(out, format_version);
+    put(out, dimensions);
+    put(out, static_cast<std::uint32_t>(name.size()));
+    out.write(name.data(), static_cast<std::streamsize>(name.size()));
+  }
+
+  std::string read_header(std::istream& in, std::uint32_t dimensions)
+  {
+    char magic[sizeof(file_magic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, file_magic, sizeof(file_magic)) != 0)
+    {
+      throw std::runtime_error("Malformed histogram file: bad magic");
+    }
+    if (get<std::uint32_t>(in) != byte_order_mark)
+    {
+      throw std::runtime_error("Histogram file was written with a different byte order");
+    }
+    if (get<std::uint32_t>(in) != format_version)
+    {
+      throw std::runtime_error("Unsupported histogram file version");
+    }
+    if (get<std::uint32_t>(in) != dimensions)
+    {
+      throw std::runtime_error("Histogram file holds a histogram of a different dimension");
+    }
+    std::string name(get<std::uint32_t>(in), '\0');
+    if (!in.read(&name[0], static_cast<std::streamsize>(name.size())))
+    {
+      throw std::runtime_error("Malformed histogram file: unexpected end of data");
+    }
+    return name;
+  }
+
+  void write_axis(std::ostream& out, const BinAxis& axis)
+  {
+    put(out, static_cast<std::uint64_t>(axis.get_bin_count()));
+    put(out, static_cast<std::uint8_t>(axis.is_uniform()));
+    put_doubles(out, axis.get_edges());
+  }
+
+  BinAxis read_axis(std::istream& in)
+  {
+    std::uint64_t bins = get<std::uint64_t>(in);
+    bool uniform = get<std::uint8_t>(in) != 0;
+    if (bins == 0 || bins > (1ULL << 32))
+    {
+      throw std::runtime_error("Malformed histogram file: bad bin count");
+    }
+    std::vector<double> edges = get_doubles(in, static_cast<std::size_t>(bins) + 1);
+    // Rebuild uniform axes from their range so find_bin takes the arithmetic path again
+    return uniform ? BinAxis(static_cast<std::size_t>(bins), edges.front(), edges.back()) : BinAxis(std::move(edges));
+  }
+
+  void write_contents(std::ostream& out, const HistogramStorage& storage)
+  {
+    std::vector<double> sum_weights(storage.get_cell_count());
+    std::vector<double> sum_weights_squared(storage.get_cell_count());
+    for (std::size_t cell = 0; cell < storage.get_cell_count(); ++cell)
+    {
+      sum_weights[cell] = storage.get_sum_weights(cell);
+      sum_weights_squared[cell] = storage.get_sum_weights_squared(cell);
+    }
+    put(out, storage.get_entries());
+    put_doubles(out, sum_weights);
+    put_doubles(out, sum_weights_squared);
+    if (!out)
+    {
+      throw std::runtime_error("Failed to write histogram");
+    }
+  }
+
+  void read_contents(std::istream& in, HistogramStorage& storage)
+  {
+    double entries = get<double>(in);
+    std::vector<double> sum_weights = get_doubles(in, storage.get_cell_count());
+    std::vector<double> sum_weights_squared = get_doubles(in, storage.get_cell_count());
+    storage.set_totals(sum_weights, sum_weights_squared, entries);
+  }
+}
+
+// BinAxis
+BinAxis::BinAxis(std::size_t bins, double low, double high)
+  : low(low), high(high), inverse_width(0.0), uniform(true)
+{
+  if (bins == 0)
+  {
+    throw std::invalid_argument("A histogram axis needs at least one bin");
+  }
+  if (!(low < high) || !std::isfinite(low) || !std::isfinite(high))
+  {
+    throw std::invalid_argument("Histogram axis range must be finite with low < high");
+  }
+  inverse_width = bins / (high - low);
+  edges.resize(bins + 1);
+  for (std::size_t i = 0; i <= bins; ++i)
+  {
+    edges[i] = low + (high - low) * i / bins;
+  }
+  edges.back() = high;
+}
+
+BinAxis::BinAxis(std::vector<double> bin_edges)
+  : edges(std::move(bin_edges)), low(0.0), high(0.0), inverse_width(0.0), uniform(false)
+{
+  if (edges.size() < 2)
+  {
+    throw std::invalid_argument("A histogram axis needs at least two edges");
+  }
+  for (std::size_t i = 0; i < edges.size(); ++i)
+  {
+    if (!std::isfinite(edges[i]) || (i > 0 && !(edges[i - 1] < edges[i])))
+    {
+      throw std::invalid_argument("Histogram bin edges must be finite and strictly increasing");
+    }
+  }
+  low = edges.front();
+  high = edges.back();
+}
+
+double BinAxis::get_bin_low_edge(std::size_t bin) const
+{
+  if (bin > get_bin_count() + 1)
+  {
+    throw std::out_of_range("Histogram bin out of range");
+  }
+  return bin == 0 ? -std::numeric_limits<double>::infinity() : edges[bin - 1];
+}
+
+double BinAxis::get_bin_high_edge(std::size_t bin) const
+{
+  if (bin > get_bin_count() + 1)
+  {
+    throw std::out_of_range("Histogram bin out of range");
+  }
+  return bin == get_bin_count() + 1 ? std::numeric_limits<double>::infinity() : edges[bin];
+}
+
+// HistogramStorage
+HistogramStorage::HistogramStorage(std::size_t cells, std::size_t slots)
+  : base(0), cells(cells), slots(slots), slot_stride(0)
+{
+  if (slots == 0)
+  {
+    throw std::invalid_argument("A histogram needs at least one fill slot");
+  }
+  std::size_t slot_doubles = 2 * cells + 1; // Sum of weights, sum of squared weights, entries
+  slot_stride = (slot_doubles + line_doubles - 1) / line_doubles * line_doubles;
+  buffer.assign(slots * slot_stride + line_doubles, 0.0); // One spare line to align the first slot
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.data());
+  base = ((64 - address % 64) % 64) / sizeof(double);
+}
+
+HistogramStorage::HistogramStorage(const HistogramStorage& other)
+  : HistogramStorage(other.cells, other.slots)
+{
+  std::memcpy(slot_data(0), other.slot_data(0), slots * slot_stride * sizeof(double));
+}
+
+HistogramStorage& HistogramStorage::operator=(const HistogramStorage& other)
+{
+  if (this != &other)
+  {
+    HistogramStorage copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+void HistogramStorage::fill_cells(std::size_t slot, const std::size_t* cell_indices, const double* weights, std::size_t count)
+{
+  if (slot >= slots)
+  {
+    throw std::out_of_range("Histogram fill slot out of range");
+  }
+  double* data = slot_data(slot);
+  double* squares = data + cells;
+  if (weights == nullptr)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      data[cell_indices[i]] += 1.0;
+      squares[cell_indices[i]] += 1.0;
+    }
+  }
+  else
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      data[cell_indices[i]] += weights[i];
+      squares[cell_indices[i]] += weights[i] * weights[i];
+    }
+  }
+  data[2 * cells] += static_cast<double>(count);
+}
+
+double HistogramStorage::get_sum_weights(std::size_t cell) const
+{
+  double total = 0.0;
+  for (std::size_t slot = 0; slot < slots; ++slot)
+  {
+    total += slot_data(slot)[cell];
+  }
+  return total;
+}
+
+double HistogramStorage::get_sum_weights_squared(std::size_t cell) const
+{
+  double total = 0.0;
+  for (std::size_t slot = 0; slot < slots; ++slot)
+  {
+    total += slot_data(slot)[cells + cell];
+  }
+  return total;
+}
+
+double HistogramStorage::get_entries() const
+{
+  return get_sum_weights(2 * cells); // The entry count sits after both weight arrays
+}
+
+void HistogramStorage::merge()
+{
+  double* total = slot_data(0);
+  for (std::size_t slot = 1; slot < slots; ++slot)
+  {
+    double* data = slot_data(slot);
+    for (std::size_t i = 0; i <= 2 * cells; ++i)
+    {
+      total[i] += data[i];
+      data[i] = 0.0;
+    }
+  }
+}
+
+void HistogramStorage::add(const HistogramStorage& other)
+{
+  double* total = slot_data(0);
+  for (std::size_t slot = 0; slot < other.slots; ++slot)
+  {
+    const double* data = other.slot_data(slot);
+    for (std::size_t i = 0; i <= 2 * cells; ++i)
+    {
+      total[i] += data[i];
+    }
+  }
+}
+
+void HistogramStorage::reset()
+{
+  std::fill(buffer.begin(), buffer.end(), 0.0);
+}
+
+void HistogramStorage::set_totals(const std::vector<double>& sum_weights, const std::vector<double>& sum_weights_squared, double entries)
+{
+  reset();
+  double* total = slot_data(0);
+  std::copy(sum_weights.begin(), sum_weights.end(), total);
+  std::copy(sum_weights_squared.begin(), sum_weights_squared.end(), total + cells);
+  total[2 * cells] = entries;
+}
+
+std::size_t current_histogram_slot()
+{
+  return static_cast<std::size_t>(ThreadPool::current_worker_index() + 1);
+}
+
+std::size_t default_histogram_slots()
+{
+  return std::max<std::size_t>(std::thread::hardware_concurrency(), 1) + 1; // As ThreadPool sizes itself by default
+}
+
+void throw_histogram_slot_out_of_range(const std::string& name, std::size_t slot, std::size_t slots)
+{
+  throw std::out_of_range("Histogram '" + name + "' has " + std::to_string(slots) + " fill slots but was filled from ThreadPool worker " +
+                          std::to_string(slot - 1) + ", which uses slot " + std::to_string(slot) +
+                          "; construct it with pool.size() + 1 slots, or call fill_slot with a slot of your own");
+}
+
+// Histogram1D
+Histogram1D::Histogram1D(std::string name, const BinAxis& axis, std::size_t slots)
+  : name(std::move(name)), axis(axis), storage(axis.get_bin_count() + 2, slots)
+{
+}
+
+void Histogram1D::fill_batch_slot(std::size_t slot, const double* values, std::size_t count, const double* weights)
+{
+  std::size_t cells[fill_chunk];
+  for (std::size_t start = 0; start < count; start += fill_chunk)
+  {
+    std::size_t chunk = std::min(fill_chunk, count - start);
+    for (std::size_t i = 0; i < chunk; ++i)
+    {
+      cells[i] = axis.find_bin(values[start + i]);
+    }
+    storage.fill_cells(slot, cells, weights == nullptr ? nullptr : weights + start, chunk);
+  }
+}
+
+void Histogram1D::add(const Histogram1D& other)
+{
+  if (axis != other.axis)
+  {
+    throw std::invalid_argument("Cannot add histograms with different binning");
+  }
+  storage.add(other.storage);
+}
+
+double Histogram1D::get_bin_content(std::size_t bin) const
+{
+  if (bin >= storage.get_cell_count())
+  {
+    throw std::out_of_range("Histogram bin out of range");
+  }
+  return storage.get_sum_weights(bin);
+}
+
+double Histogram1D::get_bin_error(std::size_t bin) const
+{
+  if (bin >= storage.get_cell_count())
+  {
+    throw std::out_of_range("Histogram bin out of range");
+  }
+  return std::sqrt(storage.get_sum_weights_squared(bin));
+}
+
+double Histogram1D::get_integral() const
+{
+  double total = 0.0;
+  for (std::size_t bin = 1; bin <= axis.get_bin_count(); ++bin)
+  {
+    total += storage.get_sum_weights(bin);
+  }
+  return total;
+}
+
+void Histogram1D::write_csv(std::ostream& out) const
+{
+  out << "bin,low,high,content,error\n";
+  for (std::size_t bin = 0; bin < storage.get_cell_count(); ++bin)
+  {
+    out << bin << ',' << axis.get_bin_low_edge(bin) << ',' << axis.get_bin_high_edge(bin) << ','
+        << get_bin_content(bin) << ',' << get_bin_error(bin) << '\n';
+  }
+}
+
+void Histogram1D::write_binary(std::ostream& out) const
+{
+  write_header(out, 1, name);
+  write_axis(out, axis);
+  write_contents(out, storage);
+}
+
+Histogram1D Histogram1D::read_binary(std::istream& in)
+{
+  std::string name = read_header(in, 1);
+  BinAxis axis = read_axis(in);
+  Histogram1D histogram(std::move(name), axis);
+  read_contents(in, histogram.storage);
+  return histogram;
+}
+
+// Histogram2D
+Histogram2D::Histogram2D(std::string name, const BinAxis& x_axis, const BinAxis& y_axis, std::size_t slots)
+  : name(std::move(name)), x_axis(x_axis), y_axis(y_axis),
+    storage((x_axis.get_bin_count() + 2) * (y_axis.get_bin_count() + 2), slots)
+{
+}
+
+void Histogram2D::fill_batch_slot(std::size_t slot, const double* x, const double* y, std::size_t count, const double* weights)
+{
+  std::size_t cells[fill_chunk];
+  for (std::size_t start = 0; start < count; start += fill_chunk)
+  {
+    std::size_t chunk = std::min(fill_chunk, count - start);
+    for (std::size_t i = 0; i < chunk; ++i)
+    {
+      cells[i] = cell(x_axis.find_bin(x[start + i]), y_axis.find_bin(y[start + i]));
+    }
+    storage.fill_cells(slot, cells, weights == nullptr ? nullptr : weights + start, chunk);
+  }
+}
+
+void Histogram2D::add(const Histogram2D& other)
+{
+  if (x_axis != other.x_axis || y_axis != other.y_axis)
+  {
+    throw std::invalid_argument("Cannot add histograms with different binning");
+  }
+  storage.add(other.storage);
+}
+
+double Histogram2D::get_bin_content(std::size_t x_bin, std::size_t y_bin) const
+{
+  if (x_bin > x_axis.get_bin_count() + 1 || y_bin > y_axis.get_bin_count() + 1)
+  {
+    throw std::out_of_range("Histogram bin out of range");
+  }
+  return storage.get_sum_weights(cell(x_bin, y_bin));
+}
+
+double Histogram2D::get_bin_error(std::size_t x_bin, std::size_t y_bin) const
+{
+  if (x_bin > x_axis.get_bin_count() + 1 || y_bin > y_axis.get_bin_count() + 1)
+  {
+    throw std::out_of_range("Histogram bin out of range");
+  }
+  return std::sqrt(storage.get_sum_weights_squared(cell(x_bin, y_bin)));
+}
+
+double Histogram2D::get_integral() const
+{
+  double total = 0.0;
+  for (std::size_t y_bin = 1; y_bin <= y_axis.get_bin_count(); ++y_bin)
+  {
+    for (std::size_t x_bin = 1; x_bin <= x_axis.get_bin_count(); ++x_bin)
+    {
+      total += storage.get_sum_weights(cell(x_bin, y_bin));
+    }
+  }
+  return total;
+}
+
+void Histogram2D::write_csv(std::ostream& out) const
+{
+  out << "x_bin,y_bin,x_low,x_high,y_low,y_high,content,error\n";
+  for (std::size_t y_bin = 0; y_bin < y_axis.get_bin_count() + 2; ++y_bin)
+  {
+    for (std::size_t x_bin = 0; x_bin < x_axis.get_bin_count() + 2; ++x_bin)
+    {
+      out << x_bin << ',' << y_bin << ',' << x_axis.get_bin_low_edge(x_bin) << ',' << x_axis.get_bin_high_edge(x_bin) << ','
+          << y_axis.get_bin_low_edge(y_bin) << ',' << y_axis.get_bin_high_edge(y_bin) << ','
+          << get_bin_content(x_bin, y_bin) << ',' << get_bin_error(x_bin, y_bin) << '\n';
+    }
+  }
+}
+
+void Histogram2D::write_binary(std::ostream& out) const
+{
+  write_header(out, 2, name);
+  write_axis(out, x_axis);
+  write_axis(out, y_axis);
+  write_contents(out, storage);
+}
+
+Histogram2D Histogram2D::read_binary(std::istream& in)
+{
+  std::string name = read_header(in, 2);
+  BinAxis x_axis = read_axis(in);
+  BinAxis y_axis = read_axis(in);
+  Histogram2D histogram(std::move(name), x_axis, y_axis);
+  read_contents(in, histogram.storage);
+  return histogram;
+}
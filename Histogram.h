@@ -0,0 +1,224 @@
+// Description: Defines BinAxis, Histogram1D and Histogram2D, weighted histograms filled concurrently through per-thread slots.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Binning along one axis. Bin 0 is the underflow, bins 1..n the regular bins and
+// bin n + 1 the overflow; NaN goes to the underflow.
+class BinAxis
+{
+private:
+  std::vector<double> edges; // bin_count + 1 ascending edges
+  double low;
+  double high;
+  double inverse_width; // Bins per unit, used when the binning is uniform
+  bool uniform;
+
+public:
+  BinAxis(std::size_t bins, double low, double high); // Fixed-width bins
+  explicit BinAxis(std::vector<double> edges); // Variable-width bins
+
+  std::size_t get_bin_count() const { return edges.size() - 1; }
+  double get_low() const { return low; }
+  double get_high() const { return high; }
+  bool is_uniform() const { return uniform; }
+  const std::vector<double>& get_edges() const { return edges; }
+  double get_bin_low_edge(std::size_t bin) const; // -inf for the underflow
+  double get_bin_high_edge(std::size_t bin) const; // +inf for the overflow
+
+  std::size_t find_bin(double x) const
+  {
+    if (!(x >= low))
+    {
+      return 0;
+    }
+    if (x >= high)
+    {
+      return get_bin_count() + 1;
+    }
+    if (uniform)
+    {
+      std::size_t bin = 1 + static_cast<std::size_t>((x - low) * inverse_width);
+      return std::min(bin, get_bin_count()); // Rounding can push x just below high into bin n + 1
+    }
+    return static_cast<std::size_t>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+  }
+
+  bool operator==(const BinAxis& other) const { return edges == other.edges; }
+  bool operator!=(const BinAxis& other) const { return !(*this == other); }
+};
+
+// Bin contents for a number of fill slots. Each slot holds the sum of weights and
+// the sum of squared weights per cell plus an entry count, and starts on its own
+// cache line, so threads filling different slots never share a line and need no
+// locks or atomics.
+class HistogramStorage
+{
+private:
+  static constexpr std::size_t line_doubles = 64 / sizeof(double);
+
+  std::vector<double> buffer;
+  std::size_t base; // Offset of the first cache-line aligned double in buffer
+  std::size_t cells;
+  std::size_t slots;
+  std::size_t slot_stride; // Doubles per slot, a whole number of cache lines
+
+  double* slot_data(std::size_t slot) { return buffer.data() + base + slot * slot_stride; }
+  const double* slot_data(std::size_t slot) const { return buffer.data() + base + slot * slot_stride; }
+
+public:
+  HistogramStorage(std::size_t cells, std::size_t slots);
+  HistogramStorage(const HistogramStorage& other);
+  HistogramStorage& operator=(const HistogramStorage& other);
+  HistogramStorage(HistogramStorage&&) = default;
+  HistogramStorage& operator=(HistogramStorage&&) = default;
+
+  std::size_t get_cell_count() const { return cells; }
+  std::size_t get_slot_count() const { return slots; }
+
+  void fill(std::size_t slot, std::size_t cell, double weight)
+  {
+    if (slot >= slots)
+    {
+      throw std::out_of_range("Histogram fill slot out of range");
+    }
+    double* data = slot_data(slot);
+    data[cell] += weight;
+    data[cells + cell] += weight * weight;
+    data[2 * cells] += 1.0;
+  }
+  void fill_cells(std::size_t slot, const std::size_t* cell_indices, const double* weights, std::size_t count);
+
+  double get_sum_weights(std::size_t cell) const;
+  double get_sum_weights_squared(std::size_t cell) const;
+  double get_entries() const;
+
+  void merge(); // Folds every slot into slot 0
+  void add(const HistogramStorage& other);
+  void reset();
+  void set_totals(const std::vector<double>& sum_weights, const std::vector<double>& sum_weights_squared, double entries);
+};
+
+// Slot used by fill calls that do not name one: ThreadPool worker i fills slot i + 1
+// and any thread outside the pool fills slot 0. Threads that are not pool workers,
+// such as Pipeline stages, should pass their own worker index instead, because they
+// would otherwise all share slot 0.
+std::size_t current_histogram_slot();
+
+// Default slot count: slot 0 plus one per worker of a default-sized ThreadPool (one per
+// hardware thread). Histograms filled from a larger pool need pool.size() + 1 slots.
+std::size_t default_histogram_slots();
+
+// Raises the std::out_of_range fill() and fill_batch() throw when the calling thread has no slot
+[[noreturn]] void throw_histogram_slot_out_of_range(const std::string& name, std::size_t slot, std::size_t slots);
+
+class Histogram1D
+{
+private:
+  std::string name;
+  BinAxis axis;
+  HistogramStorage storage;
+
+  std::size_t thread_slot() const
+  {
+    std::size_t slot = current_histogram_slot();
+    if (slot >= storage.get_slot_count())
+    {
+      throw_histogram_slot_out_of_range(name, slot, storage.get_slot_count());
+    }
+    return slot;
+  }
+
+public:
+  // slots is the number of threads that fill concurrently; the default covers a
+  // default-sized ThreadPool, and a larger pool needs pool.size() + 1
+  Histogram1D(std::string name, const BinAxis& axis, std::size_t slots = default_histogram_slots());
+
+  void fill(double x, double weight = 1.0) { fill_slot(thread_slot(), x, weight); }
+  void fill_slot(std::size_t slot, double x, double weight = 1.0) { storage.fill(slot, axis.find_bin(x), weight); }
+  void fill_batch(const double* values, std::size_t count, const double* weights = nullptr)
+  {
+    fill_batch_slot(thread_slot(), values, count, weights);
+  }
+  void fill_batch_slot(std::size_t slot, const double* values, std::size_t count, const double* weights = nullptr);
+
+  // Totals are summed over all slots, so they are correct at any time once fills
+  // have stopped; merge() folds the slots together so later reads are cheaper.
+  void merge() { storage.merge(); }
+  void add(const Histogram1D& other); // Throws std::invalid_argument if the binning differs
+  void reset() { storage.reset(); }
+
+  const std::string& get_name() const { return name; }
+  const BinAxis& get_axis() const { return axis; }
+  std::size_t get_slot_count() const { return storage.get_slot_count(); }
+  double get_bin_content(std::size_t bin) const;
+  double get_bin_error(std::size_t bin) const; // sqrt of the summed squared weights
+  double get_entries() const { return storage.get_entries(); }
+  double get_integral() const; // Regular bins only
+
+  void write_csv(std::ostream& out) const; // bin,low,high,content,error including under- and overflow
+  void write_binary(std::ostream& out) const;
+  static Histogram1D read_binary(std::istream& in);
+};
+
+class Histogram2D
+{
+private:
+  std::string name;
+  BinAxis x_axis;
+  BinAxis y_axis;
+  HistogramStorage storage;
+
+  std::size_t cell(std::size_t x_bin, std::size_t y_bin) const { return y_bin * (x_axis.get_bin_count() + 2) + x_bin; }
+  std::size_t thread_slot() const
+  {
+    std::size_t slot = current_histogram_slot();
+    if (slot >= storage.get_slot_count())
+    {
+      throw_histogram_slot_out_of_range(name, slot, storage.get_slot_count());
+    }
+    return slot;
+  }
+
+public:
+  Histogram2D(std::string name, const BinAxis& x_axis, const BinAxis& y_axis, std::size_t slots = default_histogram_slots());
+
+  void fill(double x, double y, double weight = 1.0) { fill_slot(thread_slot(), x, y, weight); }
+  void fill_slot(std::size_t slot, double x, double y, double weight = 1.0)
+  {
+    storage.fill(slot, cell(x_axis.find_bin(x), y_axis.find_bin(y)), weight);
+  }
+  void fill_batch(const double* x, const double* y, std::size_t count, const double* weights = nullptr)
+  {
+    fill_batch_slot(thread_slot(), x, y, count, weights);
+  }
+  void fill_batch_slot(std::size_t slot, const double* x, const double* y, std::size_t count, const double* weights = nullptr);
+
+  void merge() { storage.merge(); }
+  void add(const Histogram2D& other); // Throws std::invalid_argument if the binning differs
+  void reset() { storage.reset(); }
+
+  const std::string& get_name() const { return name; }
+  const BinAxis& get_x_axis() const { return x_axis; }
+  const BinAxis& get_y_axis() const { return y_axis; }
+  std::size_t get_slot_count() const { return storage.get_slot_count(); }
+  double get_bin_content(std::size_t x_bin, std::size_t y_bin) const;
+  double get_bin_error(std::size_t x_bin, std::size_t y_bin) const;
+  double get_entries() const { return storage.get_entries(); }
+  double get_integral() const; // Regular bins only
+
+  void write_csv(std::ostream& out) const; // x_bin,y_bin,x_low,x_high,y_low,y_high,content,error
+  void write_binary(std::ostream& out) const;
+  static Histogram2D read_binary(std::istream& in);
+};
+
+#endif
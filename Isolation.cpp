@@ -0,0 +1,240 @@
+// Description: Defines the MuonIsolation class, computing muon cone isolation through a per-event eta-phi spatial index.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Isolation.h"
+#include "FourMomentum.h"
+#include "Lepton.h"
+#include "Muon.h"
+#include "ParticleStore.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+  constexpr double pi = 3.141592653589793;
+  constexpr double index_eta_extent = 2.5; // Detector acceptance; anything further out shares the edge cells
+
+  double delta_phi(double a, double b)
+  {
+    double difference = std::abs(a - b);
+    return difference > pi ? 2 * pi - difference : difference;
+  }
+
+  bool contributes(const IsolationConfig& config, ParticleType type, double pt)
+  {
+    return (config.type_mask & (1u << static_cast<unsigned>(type))) != 0 && pt >= config.min_pt;
+  }
+}
+
+MuonIsolation::MuonIsolation(const IsolationConfig& config)
+  : config(config), eta_extent(index_eta_extent + config.cone_size), eta_bins(1), phi_bins(1), eta_scale(0.0), phi_scale(0.0)
+{
+  if (!(config.cone_size > 0) || !std::isfinite(config.cone_size))
+  {
+    throw std::invalid_argument("Isolation cone size must be greater than 0");
+  }
+  // Cells at least one cone wide in both directions
+  eta_bins = std::max<std::size_t>(1, static_cast<std::size_t>(2 * eta_extent / config.cone_size));
+  phi_bins = std::max<std::size_t>(1, static_cast<std::size_t>(2 * pi / config.cone_size));
+  eta_scale = eta_bins / (2 * eta_extent);
+  phi_scale = phi_bins / (2 * pi);
+  cell_start.assign(eta_bins * phi_bins + 1, 0);
+}
+
+std::size_t MuonIsolation::eta_bin(double eta) const
+{
+  double position = (eta + eta_extent) * eta_scale;
+  if (!(position > 0))
+  {
+    return 0;
+  }
+  return std::min(static_cast<std::size_t>(position), eta_bins - 1);
+}
+
+std::size_t MuonIsolation::phi_bin(double phi) const
+{
+  return std::min(static_cast<std::size_t>((phi + pi) * phi_scale), phi_bins - 1); // atan2 gives [-pi, pi]
+}
+
+void MuonIsolation::stage(std::uint32_t row, double px, double py, double pz, ParticleType type)
+{
+  FourMomentum momentum(0.0, px, py, pz);
+  double pt = momentum.get_pt();
+  bool is_muon = type == ParticleType::Muon;
+  bool counts = contributes(config, type, pt);
+  if (is_muon || counts)
+  {
+    candidates.push_back(Candidate{momentum.get_eta(), momentum.get_phi(), pt, row, is_muon, counts});
+  }
+}
+
+// Counting sort of the contributing particles by cell into flat columns
+void MuonIsolation::build_index()
+{
+  std::size_t cells = eta_bins * phi_bins;
+  std::fill(cell_start.begin(), cell_start.end(), 0);
+  cell_of.resize(candidates.size());
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    const Candidate& candidate = candidates[i];
+    if (candidate.contributes)
+    {
+      std::uint32_t cell = static_cast<std::uint32_t>(eta_bin(candidate.eta) * phi_bins + phi_bin(candidate.phi));
+      cell_of[i] = cell;
+      ++cell_start[cell + 1];
+    }
+  }
+  for (std::size_t cell = 0; cell < cells; ++cell)
+  {
+    cell_start[cell + 1] += cell_start[cell];
+  }
+  std::size_t total = cell_start[cells];
+  sorted_eta.resize(total);
+  sorted_phi.resize(total);
+  sorted_pt.resize(total);
+  sorted_row.resize(total);
+  // cell_start[c] doubles as the insertion cursor for cell c and is restored afterwards
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    const Candidate& candidate = candidates[i];
+    if (candidate.contributes)
+    {
+      std::uint32_t slot = cell_start[cell_of[i]]++;
+      sorted_eta[slot] = candidate.eta;
+      sorted_phi[slot] = candidate.phi;
+      sorted_pt[slot] = candidate.pt;
+      sorted_row[slot] = candidate.row;
+    }
+  }
+  for (std::size_t cell = cells; cell > 0; --cell)
+  {
+    cell_start[cell] = cell_start[cell - 1];
+  }
+  cell_start[0] = 0;
+}
+
+void MuonIsolation::evaluate()
+{
+  build_index();
+  double cone_squared = config.cone_size * config.cone_size;
+  bool wrap_neighbors = phi_bins >= 3; // Otherwise every phi bin is within reach
+  for (const Candidate& muon : candidates)
+  {
+    if (!muon.is_muon)
+    {
+      continue;
+    }
+    std::size_t centre_eta = eta_bin(muon.eta);
+    std::size_t centre_phi = phi_bin(muon.phi);
+    std::size_t first_eta = centre_eta > 0 ? centre_eta - 1 : 0;
+    std::size_t last_eta = std::min(centre_eta + 1, eta_bins - 1);
+    double sum = 0.0;
+    for (std::size_t eta_cell = first_eta; eta_cell <= last_eta; ++eta_cell)
+    {
+      for (std::size_t step = 0; step < (wrap_neighbors ? 3 : phi_bins); ++step)
+      {
+        std::size_t phi_cell = wrap_neighbors ? (centre_phi + phi_bins - 1 + step) % phi_bins : step;
+        std::size_t cell = eta_cell * phi_bins + phi_cell;
+        for (std::uint32_t i = cell_start[cell]; i < cell_start[cell + 1]; ++i)
+        {
+          double d_eta = sorted_eta[i] - muon.eta;
+          double d_phi = delta_phi(sorted_phi[i], muon.phi);
+          if (d_eta * d_eta + d_phi * d_phi < cone_squared && sorted_row[i] != muon.row)
+          {
+            sum += sorted_pt[i];
+          }
+        }
+      }
+    }
+    cone_sums[muon.row] = sum;
+  }
+}
+
+void MuonIsolation::compute(const ParticleStore& event)
+{
+  candidates.clear();
+  const auto& xs = event.px_column();
+  const auto& ys = event.py_column();
+  const auto& zs = event.pz_column();
+  const auto& types = event.type_column();
+  for (std::size_t row = 0; row < event.size(); ++row)
+  {
+    stage(static_cast<std::uint32_t>(row), xs[row], ys[row], zs[row], types[row]);
+  }
+  cone_sums.assign(event.size(), 0.0);
+  evaluate();
+}
+
+void MuonIsolation::compute(const Lepton* const* particles, std::size_t count)
+{
+  candidates.clear();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const FourMomentum& momentum = particles[i]->get_four_momentum();
+    stage(static_cast<std::uint32_t>(i), momentum.get_px(), momentum.get_py(), momentum.get_pz(), particles[i]->get_type_id());
+  }
+  cone_sums.assign(count, 0.0);
+  evaluate();
+}
+
+std::size_t MuonIsolation::apply(ParticleStore& event)
+{
+  compute(event);
+  std::size_t isolated = 0;
+  for (const Candidate& muon : candidates)
+  {
+    if (muon.is_muon)
+    {
+      bool flag = is_isolated(cone_sums[muon.row], muon.pt);
+      event.set_isolated(muon.row, flag);
+      isolated += flag;
+    }
+  }
+  return isolated;
+}
+
+std::size_t MuonIsolation::apply(Lepton* const* particles, std::size_t count)
+{
+  compute(particles, count);
+  std::size_t isolated = 0;
+  for (const Candidate& muon : candidates)
+  {
+    if (muon.is_muon)
+    {
+      bool flag = is_isolated(cone_sums[muon.row], muon.pt);
+      static_cast<Muon*>(particles[muon.row])->set_isolated(flag); // The type id says it is a Muon
+      isolated += flag;
+    }
+  }
+  return isolated;
+}
+
+void compute_isolation_brute_force(const ParticleStore& event, const IsolationConfig& config, std::vector<double>& cone_sums)
+{
+  cone_sums.assign(event.size(), 0.0);
+  double cone_squared = config.cone_size * config.cone_size;
+  for (std::size_t muon = 0; muon < event.size(); ++muon)
+  {
+    if (event[muon].get_type() != ParticleType::Muon)
+    {
+      continue;
+    }
+    FourMomentum muon_momentum = event[muon].get_four_momentum();
+    for (std::size_t other = 0; other < event.size(); ++other)
+    {
+      FourMomentum momentum = event[other].get_four_momentum();
+      if (other == muon || !contributes(config, event[other].get_type(), momentum.get_pt()))
+      {
+        continue;
+      }
+      double d_eta = momentum.get_eta() - muon_momentum.get_eta();
+      double d_phi = delta_phi(momentum.get_phi(), muon_momentum.get_phi());
+      if (d_eta * d_eta + d_phi * d_phi < cone_squared)
+      {
+        cone_sums[muon] += momentum.get_pt();
+      }
+    }
+  }
+}
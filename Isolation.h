@@ -0,0 +1,90 @@
+// Description: Defines the MuonIsolation class, computing muon cone isolation through a per-event eta-phi spatial index.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef ISOLATION_H
+#define ISOLATION_H
+
+#include "ParticleType.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Lepton;
+class ParticleStore;
+
+struct IsolationConfig
+{
+  double cone_size = 0.3; // Delta R of the cone around each muon
+  double threshold = 0.15; // Largest cone sum for an isolated muon
+  bool relative = true; // Threshold applies to cone sum / muon pT rather than the cone sum in MeV
+  double min_pt = 500.0; // Particles softer than this (MeV) do not count towards cone sums
+  // Particle types that contribute; neutrinos leave nothing to sum
+  std::uint8_t type_mask = (1u << static_cast<unsigned>(ParticleType::Electron)) |
+                           (1u << static_cast<unsigned>(ParticleType::Muon)) |
+                           (1u << static_cast<unsigned>(ParticleType::Tau));
+};
+
+// Each event's contributing particles are bucketed by a counting sort into an
+// eta-phi grid whose cells are at least one cone wide, so every cone lies within
+// the 3x3 block of cells around its muon (phi wraps, eta is clamped at the edges).
+// Cone sums then cost O(muons x nearby particles) instead of O(muons x particles).
+//
+// Not thread-safe: use one instance per thread.
+class MuonIsolation
+{
+private:
+  IsolationConfig config;
+  double eta_extent; // The grid spans |eta| < eta_extent; particles beyond go in the edge cells
+  std::size_t eta_bins;
+  std::size_t phi_bins;
+  double eta_scale; // Bins per unit eta
+  double phi_scale; // Bins per radian
+
+  // Per-event scratch, kept between events
+  struct Candidate
+  {
+    double eta, phi, pt;
+    std::uint32_t row;
+    bool is_muon;
+    bool contributes;
+  };
+  std::vector<Candidate> candidates;
+  std::vector<std::uint32_t> cell_start; // Prefix sums over cells, eta_bins * phi_bins + 1 entries
+  std::vector<std::uint32_t> cell_of;
+  std::vector<double> sorted_eta;
+  std::vector<double> sorted_phi;
+  std::vector<double> sorted_pt;
+  std::vector<std::uint32_t> sorted_row;
+  std::vector<double> cone_sums;
+
+  void stage(std::uint32_t row, double px, double py, double pz, ParticleType type);
+  void build_index();
+  void evaluate();
+  std::size_t eta_bin(double eta) const;
+  std::size_t phi_bin(double phi) const;
+
+public:
+  explicit MuonIsolation(const IsolationConfig& config = IsolationConfig());
+
+  const IsolationConfig& get_config() const { return config; }
+  bool is_isolated(double cone_sum, double muon_pt) const
+  {
+    return (config.relative ? cone_sum / muon_pt : cone_sum) < config.threshold;
+  }
+
+  // Cone sums for every muon of the event; get_cone_sums()[row] holds the muon's sum
+  // (0 for rows that are not muons)
+  void compute(const ParticleStore& event);
+  void compute(const Lepton* const* particles, std::size_t count);
+  const std::vector<double>& get_cone_sums() const { return cone_sums; }
+
+  // Compute, then set each muon's isolation flag; return how many are isolated
+  std::size_t apply(ParticleStore& event);
+  std::size_t apply(Lepton* const* particles, std::size_t count);
+};
+
+// Reference O(N^2) implementation with the same selection, for validation and benchmarks
+void compute_isolation_brute_force(const ParticleStore& event, const IsolationConfig& config, std::vector<double>& cone_sums);
+
+#endif
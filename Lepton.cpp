@@ -3,69 +3,75 @@
 // Date: 18/04/2024
 
 #include "Lepton.h"
+#include "Logger.h"
+#include "LorentzBoost.h"
+#include "Metrics.h"
 #include <iostream>
-#include <vector>
-#include <memory> // Include for smart pointers
 
 // Speed of light
 const double Lepton::light_speed = 2.99792458e8;
 
 // Default constructor initializing default values for a Lepton object
 Lepton::Lepton()
-  : rest_mass(0.511), charge(-1), four_momentum(std::make_unique<FourMomentum>(0.0, 0.0, 0.0, 0.0))
+  : rest_mass(0.511), charge(-1), four_momentum(0.0, 0.0, 0.0, 0.0), type_id(ParticleType::Electron)
 {
-  std::cout << "Default Lepton constructor called. Initialized with mass: " << rest_mass << ", charge: " << charge << ", and four_momentum: [0, 0, 0, 0]" << std::endl;
+  LEPTON_METRIC_COUNT(MetricCounter::LeptonConstructed);
+  LEPTON_LOG_DEBUG(LogCategory::Lifecycle, "Default Lepton constructor called. Initialized with mass: " << rest_mass << ", charge: " << charge << ", and four_momentum: [0, 0, 0, 0]");
 }
 
 // Parameterized constructor for custom initialization of a Lepton object
-Lepton::Lepton(double mass, int charge, double energy, double px, double py, double pz)
-  : rest_mass(mass), charge(charge), four_momentum(std::make_unique<FourMomentum>(energy, px, py, pz))
+Lepton::Lepton(ParticleType type, double mass, int charge, double energy, double px, double py, double pz)
+  : rest_mass(mass), charge(charge), four_momentum(energy, px, py, pz), type_id(type)
 {
-  std::cout << "Parameterized Lepton constructor called. Initialized with mass: " << rest_mass << ", charge: " << charge << ", and four_momentum: [" << energy << ", " << px << ", " << py << ", " << pz << "]" << std::endl;
+  LEPTON_METRIC_COUNT(MetricCounter::LeptonConstructed);
+  LEPTON_LOG_DEBUG(LogCategory::Lifecycle, "Parameterized Lepton constructor called. Initialized with mass: " << rest_mass << ", charge: " << charge << ", and four_momentum: [" << energy << ", " << px << ", " << py << ", " << pz << "]");
 }
 
 // Copy constructor for creating a deep copy of another Lepton object
 Lepton::Lepton(const Lepton& other)
-  : rest_mass(other.rest_mass), charge(other.charge), four_momentum(std::make_unique<FourMomentum>(*other.four_momentum))
+  : rest_mass(other.rest_mass), charge(other.charge), four_momentum(other.four_momentum), type_id(other.type_id)
 {
-  std::cout << "Calling Copy Constructor" << std::endl;
+  LEPTON_METRIC_COUNT(MetricCounter::LeptonCopied);
+  LEPTON_LOG_DEBUG(LogCategory::Lifecycle, "Calling Copy Constructor");
 }
 
 // Copy assignment operator for assigning one Lepton object to another
 Lepton& Lepton::operator=(const Lepton& other)
 {
-  std::cout << "Calling Assignment Operator" << std::endl;
+  LEPTON_METRIC_COUNT(MetricCounter::LeptonCopyAssigned);
+  LEPTON_LOG_DEBUG(LogCategory::Lifecycle, "Calling Assignment Operator");
   if(this != &other) 
   {
     rest_mass = other.rest_mass;
     charge = other.charge;
-    four_momentum = std::make_unique<FourMomentum>(*other.four_momentum);
+    four_momentum = other.four_momentum;
   }
   return *this;
 }
 
-// Move constructor for transferring ownership of resources from one Lepton object to another
+// Move constructor; the inline four-momentum is simply copied
 Lepton::Lepton(Lepton&& other) noexcept
-  : rest_mass(other.rest_mass), charge(other.charge), four_momentum(std::move(other.four_momentum))
+  : rest_mass(other.rest_mass), charge(other.charge), four_momentum(other.four_momentum), type_id(other.type_id)
 {
-  // Logging the use of the move constructor
-  std::cout << "Calling Move Constructor" << std::endl;
+  LEPTON_METRIC_COUNT(MetricCounter::LeptonMoved);
+  LEPTON_LOG_DEBUG(LogCategory::Lifecycle, "Calling Move Constructor");
 }
 
 // Move assignment operator for transferring ownership of resources between Lepton objects
 Lepton& Lepton::operator=(Lepton&& other) noexcept
 {
-  std::cout << "Calling Move Assignment Operator" << std::endl;
+  LEPTON_METRIC_COUNT(MetricCounter::LeptonMoveAssigned);
+  LEPTON_LOG_DEBUG(LogCategory::Lifecycle, "Calling Move Assignment Operator");
   if(this != &other) 
   {
     rest_mass = other.rest_mass;
     charge = other.charge;
-    four_momentum = std::move(other.four_momentum);
+    four_momentum = other.four_momentum;
   }
   return *this;
 }
 
-// Destructor for cleaning up dynamically allocated memory
+// Destructor; no dynamically allocated members remain
 Lepton::~Lepton() 
 {
 }
@@ -76,83 +82,88 @@ void Lepton::set_rest_mass(double mass)
   if(mass > 0) 
   {
     rest_mass = mass;
-    std::cout << "Rest mass set to: " << mass << std::endl;
+    LEPTON_LOG_DEBUG(LogCategory::Accessor, "Rest mass set to: " << mass);
   } 
   else 
   {
-    std::cout << "Invalid mass. It must be positive.\n";
+    LEPTON_LOG_WARNING(LogCategory::Accessor, "Invalid mass. It must be positive.");
   }
 }
 
 void Lepton::set_charge(int charge) 
 {
   this->charge = charge;
-  std::cout << "Charge set to: " << charge << std::endl;
+  LEPTON_LOG_DEBUG(LogCategory::Accessor, "Charge set to: " << charge);
 }
 
 void Lepton::set_four_momentum(double energy, double px, double py, double pz) 
 {
   if(energy > 0) 
   {
-    four_momentum->set_energy(energy);
-    four_momentum->set_px(px);
-    four_momentum->set_py(py);
-    four_momentum->set_pz(pz);
-    std::cout << "Four_momentum set to: [" << energy << ", " << px << ", " << py << ", " << pz << "]" << std::endl;
+    four_momentum.set(FourMomentum(energy, px, py, pz));
+    LEPTON_LOG_DEBUG(LogCategory::Accessor, "Four_momentum set to: [" << energy << ", " << px << ", " << py << ", " << pz << "]");
   }
   else 
   {
-    std::cout << "Invalid energy. It must be positive.\n";
+    LEPTON_LOG_WARNING(LogCategory::Accessor, "Invalid energy. It must be positive.");
   }
 }
 
+void Lepton::boost(const LorentzBoost& boost) 
+{
+  four_momentum.set(boost.apply(four_momentum.get()));
+  LEPTON_LOG_DEBUG(LogCategory::Accessor, "Boosted four_momentum to: [" << four_momentum.get_energy() << ", " << four_momentum.get_px() << ", "
+                   << four_momentum.get_py() << ", " << four_momentum.get_pz() << "]");
+}
+
 // Getter methods for accessing Lepton object attributes
 double Lepton::get_e() const 
 {
-  std::cout << "Getting energy: " << four_momentum->get_energy() << std::endl;
-  return four_momentum->get_energy();
+  LEPTON_LOG_TRACE(LogCategory::Accessor, "Getting energy: " << four_momentum.get_energy());
+  return four_momentum.get_energy();
 }
 
 double Lepton::get_px() const 
 { 
-  std::cout << "Getting Px: " << four_momentum->get_px() << std::endl;
-  return four_momentum->get_px(); 
+  LEPTON_LOG_TRACE(LogCategory::Accessor, "Getting Px: " << four_momentum.get_px());
+  return four_momentum.get_px(); 
 }
 
 double Lepton::get_py() const 
 { 
-  std::cout << "Getting Py: " << four_momentum->get_py() << std::endl;
-  return four_momentum->get_py(); 
+  LEPTON_LOG_TRACE(LogCategory::Accessor, "Getting Py: " << four_momentum.get_py());
+  return four_momentum.get_py(); 
 }
 
 double Lepton::get_pz() const 
 { 
-  std::cout << "Getting Pz: " << four_momentum->get_pz() << std::endl;
-  return four_momentum->get_pz(); 
+  LEPTON_LOG_TRACE(LogCategory::Accessor, "Getting Pz: " << four_momentum.get_pz());
+  return four_momentum.get_pz(); 
 }
 
 double Lepton::get_rest_mass() const 
 {
-  std::cout << "Getting rest mass: " << rest_mass << std::endl;
+  LEPTON_LOG_TRACE(LogCategory::Accessor, "Getting rest mass: " << rest_mass);
   return rest_mass;
 }
 
 int Lepton::get_charge() const 
 {
-  std::cout << "Getting charge: " << charge << std::endl;
+  LEPTON_LOG_TRACE(LogCategory::Accessor, "Getting charge: " << charge);
   return charge;
 }
 
-// Method for printing detailed information about the Lepton object
+// Method for printing detailed information about the Lepton object; reads the fields
+// directly so the logging getters add nothing to the output. EventExporter is the bulk path.
 void Lepton::print_info() const 
 {
   std::cout << "Particle Type: " << get_particle_type()
             << "\nRest Mass (MeV): " << rest_mass
             << "\nCharge: " << charge
-            << "\nEnergy (MeV): " << get_e()
-            << "\nMomentum px (MeV/c): " << get_px()
-            << "\nMomentum py (MeV/c): " << get_py()
-            << "\nMomentum pz (MeV/c): " << get_pz() << '\n';
+            << "\nEnergy (MeV): " << four_momentum.get_energy()
+            << "\nMomentum px (MeV/c): " << four_momentum.get_px()
+            << "\nMomentum py (MeV/c): " << four_momentum.get_py()
+            << "\nMomentum pz (MeV/c): " << four_momentum.get_pz() << '\n';
 }
 
 // Friend function definition for summing two four-vectors
@@ -7,29 +7,39 @@
 
 #include <string>
 #include <iostream>
-#include <memory> // For smart pointers
-#include "FourMomentum.h"
+#include <memory>
+#include <type_traits>
+#include "CachedFourMomentum.h"
+#include "MomentumExpression.h"
+#include "ParticleType.h"
+
+class LorentzBoost;
+template <typename Particle>
+class LeptonRef;
 
 class Lepton 
 {
 protected:
   double rest_mass;
   int charge; // +1 for particles, -1 for antiparticles
-  std::unique_ptr<FourMomentum> four_momentum; // Using std::unique_ptr for FourMomentum
+  CachedFourMomentum four_momentum; // Held by value, no separate heap allocation; keeps pT, eta, phi and mass once computed
+  const ParticleType type_id; // Fixed by the concrete class; not changed by assignment
+
+  Lepton(ParticleType type, double mass, int charge, double energy, double px, double py, double pz); // Parameterized constructor, used by subclasses
 
 public:
   Lepton(); // Default constructor
-  Lepton(double mass, int charge, double energy, double px, double py, double pz); // Parameterized constructor
   Lepton(const Lepton& other); // Copy constructor
   Lepton& operator=(const Lepton& other); // Copy assignment operator
   Lepton(Lepton&& other) noexcept; // Move constructor
   Lepton& operator=(Lepton&& other) noexcept; // Move assignment operator
-  ~Lepton(); // Destructor
+  virtual ~Lepton(); // Destructor, virtual so subclasses are destroyed correctly through Lepton pointers
 
   // Setters
   void set_rest_mass(double mass);
   void set_charge(int charge);
   void set_four_momentum(double energy, double px, double py, double pz);
+  void boost(const LorentzBoost& boost); // Replaces the four-momentum with its boosted value
 
   // Getters
   double get_rest_mass() const;
@@ -38,10 +48,12 @@ public:
   double get_px() const;
   double get_py() const;
   double get_pz() const;
+  const FourMomentum& get_four_momentum() const { return four_momentum.get(); } // Direct, non-logging access
+  const CachedFourMomentum& get_kinematics() const { return four_momentum; } // Cached pT, eta, phi and mass, non-logging
 
   // Other member functions
   virtual void print_info() const; // Make this method virtual and public
-  FourMomentum operator+(const Lepton& other) const; // Overloaded "+" operator for summing four-vectors
+  MomentumSum<LeptonRef<Lepton>, LeptonRef<Lepton>> operator+(const Lepton& other) const; // Lazy sum of the two four-vectors, defined below
   double dot_product(const Lepton& other) const; // Function for the dot product of two particle four-vectors
   std::string get_particle_kind() const 
   {
@@ -49,12 +61,120 @@ public:
   }
 
   virtual std::string get_particle_type() const = 0; // Pure virtual function
+  ParticleType get_type_id() const { return type_id; } // Non-virtual, for hot paths
 
   // Friend function declarations
   friend FourMomentum sum_four_momenta(const Lepton& lepton1, const Lepton& lepton2);
   friend double dot_product_four_momenta(const Lepton& lepton1, const Lepton& lepton2);
+  friend class ParticleStore; // materialize() primes the kinematics cache from precomputed columns
+  template <typename Particle>
+  friend class LeptonRef; // Reads the fields without the logging getters
 
   static const double light_speed;
 };
 
+// Leaf: one lepton, referred to rather than copied. Particle is the type it was added
+// as, so a sum of Muons can become a Muon again and a mixed sum cannot.
+template <typename Particle>
+class LeptonRef : public MomentumExpression<LeptonRef<Particle>>
+{
+private:
+  const Particle* lepton;
+
+public:
+  explicit LeptonRef(const Particle& lepton) : lepton(&lepton) {}
+
+  double energy() const { return lepton->get_four_momentum().get_energy(); } // Non-logging, as are the rest
+  double px() const { return lepton->get_four_momentum().get_px(); }
+  double py() const { return lepton->get_four_momentum().get_py(); }
+  double pz() const { return lepton->get_four_momentum().get_pz(); }
+  double summed_rest_mass() const { return static_cast<const Lepton*>(lepton)->rest_mass; }
+  int summed_charge() const { return static_cast<const Lepton*>(lepton)->charge; }
+  const Particle& get_lepton() const { return *lepton; }
+};
+
+// True if every leaf of the expression is a Particle added as a Particle
+template <typename Particle, typename Expression>
+struct is_lepton_sum_of : std::false_type {};
+
+template <typename Particle>
+struct is_lepton_sum_of<Particle, LeptonRef<Particle>> : std::true_type {};
+
+template <typename Particle, typename Left, typename Right>
+struct is_lepton_sum_of<Particle, MomentumSum<Left, Right>>
+  : std::integral_constant<bool, is_lepton_sum_of<Particle, Left>::value && is_lepton_sum_of<Particle, Right>::value> {};
+
+// A concrete lepton class, which keeps its type in a sum
+template <typename Particle>
+using enable_if_lepton = std::enable_if_t<std::is_base_of<Lepton, Particle>::value>;
+
+// a + b + c over leptons is a lazy momentum sum: (a + b + c).get_mass() reads each
+// four-momentum once and builds no intermediate particle or vector. The result converts
+// to FourMomentum, and a sum of leptons of one type to that type, as the old Electron
+// and Muon operators returned.
+inline MomentumSum<LeptonRef<Lepton>, LeptonRef<Lepton>> Lepton::operator+(const Lepton& other) const
+{
+  return MomentumSum<LeptonRef<Lepton>, LeptonRef<Lepton>>(LeptonRef<Lepton>(*this), LeptonRef<Lepton>(other));
+}
+
+// Preferred over the member for two leptons of the same static type; mixed types
+// deduce no Particle and take the member
+template <typename Particle, typename = enable_if_lepton<Particle>>
+MomentumSum<LeptonRef<Particle>, LeptonRef<Particle>> operator+(const Particle& left, const Particle& right)
+{
+  return MomentumSum<LeptonRef<Particle>, LeptonRef<Particle>>(LeptonRef<Particle>(left), LeptonRef<Particle>(right));
+}
+
+template <typename Left, typename Particle, typename = enable_if_lepton<Particle>>
+MomentumSum<Left, LeptonRef<Particle>> operator+(const MomentumExpression<Left>& left, const Particle& right)
+{
+  return MomentumSum<Left, LeptonRef<Particle>>(left.derived(), LeptonRef<Particle>(right));
+}
+
+template <typename Particle, typename Right, typename = enable_if_lepton<Particle>>
+MomentumSum<LeptonRef<Particle>, Right> operator+(const Particle& left, const MomentumExpression<Right>& right)
+{
+  return MomentumSum<LeptonRef<Particle>, Right>(LeptonRef<Particle>(left), right.derived());
+}
+
+inline MomentumDifference<LeptonRef<Lepton>, LeptonRef<Lepton>> operator-(const Lepton& left, const Lepton& right)
+{
+  return MomentumDifference<LeptonRef<Lepton>, LeptonRef<Lepton>>(LeptonRef<Lepton>(left), LeptonRef<Lepton>(right));
+}
+
+template <typename Left>
+MomentumDifference<Left, LeptonRef<Lepton>> operator-(const MomentumExpression<Left>& left, const Lepton& right)
+{
+  return MomentumDifference<Left, LeptonRef<Lepton>>(left.derived(), LeptonRef<Lepton>(right));
+}
+
+template <typename Right>
+MomentumDifference<LeptonRef<Lepton>, Right> operator-(const Lepton& left, const MomentumExpression<Right>& right)
+{
+  return MomentumDifference<LeptonRef<Lepton>, Right>(LeptonRef<Lepton>(left), right.derived());
+}
+
+// The four-momentum behind each kind of element sum_momenta accepts
+inline const FourMomentum& momentum_of(const FourMomentum& momentum) { return momentum; }
+inline const FourMomentum& momentum_of(const Lepton& lepton) { return lepton.get_four_momentum(); }
+inline const FourMomentum& momentum_of(const Lepton* lepton) { return lepton->get_four_momentum(); }
+template <typename T, typename Deleter>
+const FourMomentum& momentum_of(const std::unique_ptr<T, Deleter>& lepton) { return lepton->get_four_momentum(); }
+template <typename T>
+const FourMomentum& momentum_of(const std::shared_ptr<T>& lepton) { return lepton->get_four_momentum(); }
+
+// Total four-momentum of a collection of leptons, lepton pointers, smart pointers or
+// FourMomentum values, in one pass with no logging. Summed in order, so the result is
+// bit-identical to repeated operator+= (and to total_momentum for Particle vectors).
+template <typename Range>
+FourMomentum sum_momenta(const Range& particles)
+{
+  FourMomentum total;
+  for (const auto& particle : particles)
+  {
+    total += momentum_of(particle);
+  }
+  return total;
+}
+
 #endif 
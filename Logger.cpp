@@ -0,0 +1,236 @@
+// Description: Defines the Logger class, a levelled and categorised diagnostic log with an asynchronous sink.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr std::size_t ring_capacity = 4096; // Power of two
+  constexpr std::size_t sink_batch_bytes = 64 * 1024;
+
+  // Spin briefly, then yield, then sleep, as the pipeline stages wait
+  void back_off(unsigned& attempts)
+  {
+    if (++attempts < 64)
+    {
+      return;
+    }
+    if (attempts < 256)
+    {
+      std::this_thread::yield();
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+
+  const char* level_name(LogLevel level)
+  {
+    switch (level)
+    {
+      case LogLevel::Trace: return "TRACE";
+      case LogLevel::Debug: return "DEBUG";
+      case LogLevel::Info: return "INFO";
+      case LogLevel::Warning: return "WARNING";
+      case LogLevel::Error: return "ERROR";
+      case LogLevel::Off: break;
+    }
+    return "OFF";
+  }
+
+  const char* category_name(LogCategory category)
+  {
+    switch (category)
+    {
+      case LogCategory::Lifecycle: return "lifecycle";
+      case LogCategory::Accessor: return "accessor";
+      case LogCategory::Detector: return "detector";
+      case LogCategory::General: return "general";
+    }
+    return "general";
+  }
+
+  LogLevel initial_level()
+  {
+    const char* setting = std::getenv("LEPTON_LOG_LEVEL");
+    if (setting == nullptr)
+    {
+      return LogLevel::Info;
+    }
+    std::string level(setting);
+    if (level == "trace") return LogLevel::Trace;
+    if (level == "debug") return LogLevel::Debug;
+    if (level == "warning") return LogLevel::Warning;
+    if (level == "error") return LogLevel::Error;
+    if (level == "off") return LogLevel::Off;
+    return LogLevel::Info;
+  }
+}
+
+struct Logger::Cell
+{
+  std::atomic<std::size_t> sequence;
+  LogLevel level;
+  LogCategory category;
+  std::uint16_t length;
+  char text[LogRecord::capacity];
+};
+
+LogRecord::~LogRecord()
+{
+  Logger::instance().submit(level, category, text.data(), length);
+}
+
+Logger::Logger()
+  : ring(new Cell[ring_capacity]), ring_mask(ring_capacity - 1), enqueue_position(0), dequeue_position(0),
+    written_count(0), dropped_count(0), min_level(static_cast<std::uint8_t>(initial_level())),
+    category_mask((1u << log_category_count) - 1), running(true)
+{
+  for (std::size_t i = 0; i < ring_capacity; ++i)
+  {
+    ring[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  sink_thread = std::thread(&Logger::run_sink, this);
+}
+
+Logger::~Logger()
+{
+  running.store(false, std::memory_order_release);
+  if (sink_thread.joinable())
+  {
+    sink_thread.join();
+  }
+  while (drain() != 0) // Each call stops after sink_batch_bytes, and the ring can hold more
+  {
+  }
+  std::fflush(stderr);
+}
+
+Logger& Logger::instance()
+{
+  static Logger logger;
+  return logger;
+}
+
+void Logger::enable_category(LogCategory category, bool enabled)
+{
+  std::uint32_t bit = 1u << static_cast<unsigned>(category);
+  if (enabled)
+  {
+    category_mask.fetch_or(bit, std::memory_order_relaxed);
+  }
+  else
+  {
+    category_mask.fetch_and(~bit, std::memory_order_relaxed);
+  }
+}
+
+// Bounded multi-producer queue (Vyukov): each cell's sequence number tells a producer
+// whether the slot is free for its ticket, so no locks are taken on the logging path.
+bool Logger::submit(LogLevel level, LogCategory category, const char* text, std::size_t length)
+{
+  std::size_t position = enqueue_position.load(std::memory_order_relaxed);
+  Cell* cell;
+  for (;;)
+  {
+    cell = &ring[position & ring_mask];
+    std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+    if (difference == 0)
+    {
+      if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (difference < 0)
+    {
+      dropped_count.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    else
+    {
+      position = enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->level = level;
+  cell->category = category;
+  cell->length = static_cast<std::uint16_t>(length);
+  std::memcpy(cell->text, text, length);
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+// Writes every record that is ready; only ever called from one thread at a time
+std::size_t Logger::drain()
+{
+  std::vector<char> batch;
+  batch.reserve(sink_batch_bytes);
+  std::size_t drained = 0;
+
+  for (;;)
+  {
+    Cell& cell = ring[dequeue_position & ring_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != dequeue_position + 1)
+    {
+      break;
+    }
+
+    char prefix[32];
+    int prefix_length = std::snprintf(prefix, sizeof(prefix), "[%s] [%s] ", level_name(cell.level), category_name(cell.category));
+    batch.insert(batch.end(), prefix, prefix + prefix_length);
+    batch.insert(batch.end(), cell.text, cell.text + cell.length);
+    batch.push_back('\n');
+
+    cell.sequence.store(dequeue_position + ring_mask + 1, std::memory_order_release);
+    ++dequeue_position;
+    ++drained;
+
+    if (batch.size() >= sink_batch_bytes)
+    {
+      break;
+    }
+  }
+
+  if (!batch.empty())
+  {
+    std::fwrite(batch.data(), 1, batch.size(), stderr);
+    std::fflush(stderr);
+    written_count.fetch_add(drained, std::memory_order_release);
+  }
+  return drained;
+}
+
+void Logger::run_sink()
+{
+  while (running.load(std::memory_order_acquire))
+  {
+    if (drain() == 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+void Logger::flush()
+{
+  std::size_t target = enqueue_position.load(std::memory_order_acquire);
+  if (!running.load(std::memory_order_acquire))
+  {
+    while (drain() != 0)
+    {
+    }
+    return;
+  }
+  unsigned attempts = 0;
+  while (written_count.load(std::memory_order_acquire) < target && running.load(std::memory_order_acquire))
+  {
+    back_off(attempts); // The sink sleeps for up to a millisecond when idle
+  }
+}
@@ -0,0 +1,159 @@
+// Description: Defines the Logger class, a levelled and categorised diagnostic log with an asynchronous sink.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+enum class LogLevel : std::uint8_t { Trace, Debug, Info, Warning, Error, Off };
+enum class LogCategory : std::uint8_t { Lifecycle, Accessor, Detector, General };
+constexpr std::size_t log_category_count = 4;
+
+// Compile-time ceiling: statements below this level expand to nothing.
+// 0 = Trace, 1 = Debug, 2 = Info, 3 = Warning, 4 = Error, 5 = Off.
+// Release (NDEBUG) builds keep only warnings and errors by default.
+#ifndef LEPTON_LOG_MAX_LEVEL
+#ifdef NDEBUG
+#define LEPTON_LOG_MAX_LEVEL 3
+#else
+#define LEPTON_LOG_MAX_LEVEL 0
+#endif
+#endif
+
+// One formatted log line, built on the stack and handed to the sink in a single copy
+class LogRecord
+{
+public:
+  static constexpr std::size_t capacity = 240;
+
+private:
+  LogLevel level;
+  LogCategory category;
+  std::size_t length;
+  std::array<char, capacity> text;
+
+  void append(const char* data, std::size_t count)
+  {
+    std::size_t space = capacity - length;
+    count = count < space ? count : space;
+    std::memcpy(text.data() + length, data, count);
+    length += count;
+  }
+
+public:
+  LogRecord(LogLevel level, LogCategory category) : level(level), category(category), length(0) {}
+  ~LogRecord();
+
+  LogRecord& operator<<(const char* value) { append(value, std::strlen(value)); return *this; }
+  LogRecord& operator<<(const std::string& value) { append(value.data(), value.size()); return *this; }
+  LogRecord& operator<<(char value) { append(&value, 1); return *this; }
+  LogRecord& operator<<(bool value) { return *this << (value ? "true" : "false"); }
+
+  template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+  LogRecord& operator<<(T value)
+  {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+    return *this;
+  }
+};
+
+class Logger
+{
+private:
+  struct Cell; // Ring-buffer slot holding one record and its sequence number
+
+  std::unique_ptr<Cell[]> ring;
+  std::size_t ring_mask;
+  alignas(64) std::atomic<std::size_t> enqueue_position;
+  alignas(64) std::size_t dequeue_position; // Only touched by the sink thread
+  std::atomic<std::size_t> written_count;
+  std::atomic<std::size_t> dropped_count;
+
+  std::atomic<std::uint8_t> min_level;
+  std::atomic<std::uint32_t> category_mask;
+  std::atomic<bool> running;
+  std::thread sink_thread;
+
+  Logger();
+  void run_sink();
+  std::size_t drain();
+
+public:
+  static Logger& instance();
+  ~Logger();
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  // Runtime filtering, applied after the compile-time ceiling. The initial level is
+  // Info, or the value of the LEPTON_LOG_LEVEL environment variable (trace, debug, ...).
+  void set_level(LogLevel level) { min_level.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed); }
+  LogLevel get_level() const { return static_cast<LogLevel>(min_level.load(std::memory_order_relaxed)); }
+  void enable_category(LogCategory category, bool enabled = true);
+  bool is_enabled(LogLevel level, LogCategory category) const
+  {
+    return static_cast<std::uint8_t>(level) >= min_level.load(std::memory_order_relaxed) &&
+           (category_mask.load(std::memory_order_relaxed) & (1u << static_cast<unsigned>(category))) != 0;
+  }
+
+  // Lock-free hand-off to the sink thread; returns false (and counts a drop) if the ring is full
+  bool submit(LogLevel level, LogCategory category, const char* text, std::size_t length);
+
+  void flush(); // Blocks until every submitted record has been written, or the sink has stopped (the destructor writes the rest)
+  std::size_t get_dropped_count() const { return dropped_count.load(std::memory_order_relaxed); }
+};
+
+#define LEPTON_LOG(level, category, message)                  \
+  do                                                          \
+  {                                                           \
+    if (Logger::instance().is_enabled(level, category))       \
+    {                                                         \
+      LogRecord lepton_log_record_(level, category);          \
+      lepton_log_record_ << message;                          \
+    }                                                         \
+  } while (0)
+
+#if LEPTON_LOG_MAX_LEVEL <= 0
+#define LEPTON_LOG_TRACE(category, message) LEPTON_LOG(LogLevel::Trace, category, message)
+#else
+#define LEPTON_LOG_TRACE(category, message) ((void)0)
+#endif
+
+#if LEPTON_LOG_MAX_LEVEL <= 1
+#define LEPTON_LOG_DEBUG(category, message) LEPTON_LOG(LogLevel::Debug, category, message)
+#else
+#define LEPTON_LOG_DEBUG(category, message) ((void)0)
+#endif
+
+#if LEPTON_LOG_MAX_LEVEL <= 2
+#define LEPTON_LOG_INFO(category, message) LEPTON_LOG(LogLevel::Info, category, message)
+#else
+#define LEPTON_LOG_INFO(category, message) ((void)0)
+#endif
+
+#if LEPTON_LOG_MAX_LEVEL <= 3
+#define LEPTON_LOG_WARNING(category, message) LEPTON_LOG(LogLevel::Warning, category, message)
+#else
+#define LEPTON_LOG_WARNING(category, message) ((void)0)
+#endif
+
+#if LEPTON_LOG_MAX_LEVEL <= 4
+#define LEPTON_LOG_ERROR(category, message) LEPTON_LOG(LogLevel::Error, category, message)
+#else
+#define LEPTON_LOG_ERROR(category, message) ((void)0)
+#endif
+
+#endif
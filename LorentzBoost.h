@@ -0,0 +1,83 @@
+// Description: Defines the LorentzBoost class, a pure boost with precomputed beta and gamma.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef LORENTZBOOST_H
+#define LORENTZBOOST_H
+
+#include "FourMomentum.h"
+#include <cmath>
+#include <stdexcept>
+
+// Boost by velocity beta (in units of c): a particle at rest ends up moving with
+// velocity beta. gamma and gamma^2 / (gamma + 1) are computed once, so applying the
+// boost costs one dot product and a handful of multiply-adds.
+//
+// apply() performs the same operations in the same order as boost_batch, so the
+// batch kernels reproduce it bit for bit.
+class LorentzBoost
+{
+private:
+  double beta_x;
+  double beta_y;
+  double beta_z;
+  double gamma;
+  double gamma_factor; // gamma^2 / (gamma + 1), i.e. (gamma - 1) / beta^2 without the 0/0 at rest
+
+  LorentzBoost(double beta_x, double beta_y, double beta_z, double gamma)
+    : beta_x(beta_x), beta_y(beta_y), beta_z(beta_z), gamma(gamma), gamma_factor(gamma * gamma / (gamma + 1))
+  {}
+
+  // From the parent's own energy and mass, which keeps gamma accurate for highly boosted parents
+  static LorentzBoost from_parent(const FourMomentum& parent, double sign)
+  {
+    double energy = parent.get_energy();
+    double mass_squared = parent.get_mass_squared();
+    if (!(energy > 0) || !(mass_squared > 0))
+    {
+      throw std::invalid_argument("A rest frame needs a time-like four-momentum with positive energy");
+    }
+    return LorentzBoost(sign * parent.get_px() / energy, sign * parent.get_py() / energy, sign * parent.get_pz() / energy,
+                        energy / std::sqrt(mass_squared));
+  }
+
+public:
+  LorentzBoost() : LorentzBoost(0.0, 0.0, 0.0, 1.0) {} // Identity
+
+  LorentzBoost(double beta_x, double beta_y, double beta_z)
+    : LorentzBoost(beta_x, beta_y, beta_z, 1.0)
+  {
+    double beta_squared = beta_x * beta_x + beta_y * beta_y + beta_z * beta_z;
+    if (!(beta_squared < 1))
+    {
+      throw std::invalid_argument("Boost velocity must be below the speed of light");
+    }
+    gamma = 1.0 / std::sqrt(1.0 - beta_squared);
+    gamma_factor = gamma * gamma / (gamma + 1);
+  }
+
+  // Takes four-vectors into the parent's rest frame, and back out of it
+  static LorentzBoost to_rest_frame(const FourMomentum& parent) { return from_parent(parent, -1.0); }
+  static LorentzBoost from_rest_frame(const FourMomentum& parent) { return from_parent(parent, 1.0); }
+
+  LorentzBoost inverse() const { return LorentzBoost(-beta_x, -beta_y, -beta_z, gamma); }
+
+  double get_beta_x() const { return beta_x; }
+  double get_beta_y() const { return beta_y; }
+  double get_beta_z() const { return beta_z; }
+  double get_gamma() const { return gamma; }
+  double get_gamma_factor() const { return gamma_factor; }
+
+  FourMomentum apply(const FourMomentum& momentum) const
+  {
+    double e = momentum.get_energy();
+    double x = momentum.get_px();
+    double y = momentum.get_py();
+    double z = momentum.get_pz();
+    double beta_dot_p = (beta_x * x + beta_y * y) + beta_z * z;
+    double shift = gamma_factor * beta_dot_p + gamma * e; // Momentum added along beta
+    return FourMomentum(gamma * (e + beta_dot_p), x + beta_x * shift, y + beta_y * shift, z + beta_z * shift);
+  }
+};
+
+#endif
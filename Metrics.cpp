@@ -0,0 +1,229 @@
+// Description: Defines the Metrics registry, per-thread hot-path counters and TSC-based section timers with snapshot output.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Metrics.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+  // Prometheus family, label and help text for each counter
+  struct CounterInfo
+  {
+    const char* family;
+    const char* label;
+    const char* value;
+  };
+
+  constexpr std::array<CounterInfo, metric_counter_count> counter_info = {{
+    {"lepton_lifecycle_total", "operation", "construct"},
+    {"lepton_lifecycle_total", "operation", "copy"},
+    {"lepton_lifecycle_total", "operation", "move"},
+    {"lepton_lifecycle_total", "operation", "copy_assign"},
+    {"lepton_lifecycle_total", "operation", "move_assign"},
+    {"detector_checked_total", "detector", "tracker"},
+    {"detector_checked_total", "detector", "calorimeter"},
+    {"detector_checked_total", "detector", "muon_chamber"},
+    {"detector_accepted_total", "detector", "tracker"},
+    {"detector_accepted_total", "detector", "calorimeter"},
+    {"detector_accepted_total", "detector", "muon_chamber"},
+  }};
+
+  constexpr std::array<const char*, metric_timer_count> timer_sections = {"generation", "detection", "analysis", "wait"};
+
+  const char* family_help(const std::string& family)
+  {
+    if (family == "lepton_lifecycle_total") return "Lepton constructions, copies and moves";
+    if (family == "detector_checked_total") return "Particles offered to each detector";
+    return "Particles each detector saw";
+  }
+
+  // Releases the thread's shard when the thread exits
+  struct ShardRelease
+  {
+    ~ShardRelease()
+    {
+      if (metrics_shard != nullptr)
+      {
+        Metrics::instance().detach_thread(metrics_shard);
+        metrics_shard = nullptr;
+      }
+    }
+  };
+
+  thread_local ShardRelease shard_release;
+}
+
+std::string MetricsSnapshot::to_prometheus() const
+{
+  std::ostringstream out;
+  const char* previous = nullptr;
+  for (std::size_t i = 0; i < metric_counter_count; ++i)
+  {
+    const CounterInfo& info = counter_info[i];
+    if (previous == nullptr || std::string(previous) != info.family)
+    {
+      out << "# HELP " << info.family << ' ' << family_help(info.family) << "\n# TYPE " << info.family << " counter\n";
+      previous = info.family;
+    }
+    out << info.family << '{' << info.label << "=\"" << info.value << "\"} " << counters[i] << '\n';
+  }
+  out << "# HELP pipeline_section_calls_total Timed pipeline sections\n# TYPE pipeline_section_calls_total counter\n";
+  for (std::size_t i = 0; i < metric_timer_count; ++i)
+  {
+    out << "pipeline_section_calls_total{section=\"" << timer_sections[i] << "\"} " << timer_calls[i] << '\n';
+  }
+  out << "# HELP pipeline_section_seconds_total Time spent in each pipeline section\n# TYPE pipeline_section_seconds_total counter\n";
+  out.precision(9);
+  for (std::size_t i = 0; i < metric_timer_count; ++i)
+  {
+    out << "pipeline_section_seconds_total{section=\"" << timer_sections[i] << "\"} " << timer_seconds[i] << '\n';
+  }
+  return out.str();
+}
+
+std::string MetricsSnapshot::to_json() const
+{
+  std::ostringstream out;
+  out.precision(9);
+  out << "{\"counters\":{";
+  for (std::size_t i = 0; i < metric_counter_count; ++i)
+  {
+    out << (i > 0 ? "," : "") << '"' << counter_info[i].family << '.' << counter_info[i].value << "\":" << counters[i];
+  }
+  out << "},\"timers\":{";
+  for (std::size_t i = 0; i < metric_timer_count; ++i)
+  {
+    out << (i > 0 ? "," : "") << "\"pipeline." << timer_sections[i] << "\":{\"calls\":" << timer_calls[i]
+        << ",\"seconds\":" << timer_seconds[i] << '}';
+  }
+  out << "}}\n";
+  return out.str();
+}
+
+Metrics::Metrics()
+  : start_ticks(read_ticks()), start_time(std::chrono::steady_clock::now())
+{}
+
+Metrics::~Metrics()
+{
+  const char* path = std::getenv("LEPTON_METRICS_FILE");
+  if (path == nullptr || *path == '\0')
+  {
+    return;
+  }
+  std::string name(path);
+  bool json = name.size() >= 5 && name.compare(name.size() - 5, 5, ".json") == 0;
+  try
+  {
+    write_snapshot(name, json ? MetricsFormat::Json : MetricsFormat::Prometheus);
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Could not write metrics: " << error.what() << "\n";
+  }
+}
+
+Metrics& Metrics::instance()
+{
+  static Metrics metrics;
+  return metrics;
+}
+
+MetricsShard* Metrics::attach_thread()
+{
+  MetricsShard* shard = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& candidate : shards)
+    {
+      if (!candidate->attached)
+      {
+        shard = candidate.get();
+        break;
+      }
+    }
+    if (shard == nullptr)
+    {
+      shards.push_back(std::make_unique<MetricsShard>());
+      shard = shards.back().get();
+    }
+    shard->attached = true;
+  }
+  metrics_shard = shard;
+  (void)shard_release; // Touching it registers the thread-exit release
+  return shard;
+}
+
+void Metrics::detach_thread(MetricsShard* shard)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  shard->attached = false;
+}
+
+MetricsSnapshot Metrics::snapshot() const
+{
+  MetricsSnapshot snapshot;
+  std::array<std::uint64_t, metric_timer_count> ticks{};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& shard : shards)
+    {
+      for (std::size_t i = 0; i < metric_counter_count; ++i)
+      {
+        snapshot.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+      }
+      for (std::size_t i = 0; i < metric_timer_count; ++i)
+      {
+        snapshot.timer_calls[i] += shard->timer_calls[i].load(std::memory_order_relaxed);
+        ticks[i] += shard->timer_ticks[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // The tick rate over the registry's lifetime; needs no calibration pause at startup
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  std::uint64_t elapsed_ticks = read_ticks() - start_ticks;
+  double seconds_per_tick = elapsed > 0.0 && elapsed_ticks > 0 ? elapsed / static_cast<double>(elapsed_ticks) : 0.0;
+  for (std::size_t i = 0; i < metric_timer_count; ++i)
+  {
+    snapshot.timer_seconds[i] = static_cast<double>(ticks[i]) * seconds_per_tick;
+  }
+  return snapshot;
+}
+
+void Metrics::write_snapshot(const std::string& path, MetricsFormat format) const
+{
+  MetricsSnapshot current = snapshot();
+  std::ofstream file(path);
+  if (!file)
+  {
+    throw std::runtime_error("Could not open " + path + " for writing");
+  }
+  file << (format == MetricsFormat::Json ? current.to_json() : current.to_prometheus());
+  if (!file)
+  {
+    throw std::runtime_error("Could not write " + path);
+  }
+}
+
+void Metrics::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto& shard : shards)
+  {
+    for (auto& counter : shard->counters)
+    {
+      counter.store(0, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < metric_timer_count; ++i)
+    {
+      shard->timer_calls[i].store(0, std::memory_order_relaxed);
+      shard->timer_ticks[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
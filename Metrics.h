@@ -0,0 +1,170 @@
+// Description: Defines the Metrics registry, per-thread hot-path counters and TSC-based section timers with snapshot output.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "CpuFeatures.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if LEPTON_X86_KERNELS
+#include <x86intrin.h>
+#endif
+
+// Compile-time switch: 0 turns every LEPTON_METRIC_* statement into nothing
+#ifndef LEPTON_METRICS
+#define LEPTON_METRICS 1
+#endif
+
+enum class MetricCounter : std::uint8_t
+{
+  LeptonConstructed, // Default and parameterized constructors
+  LeptonCopied,
+  LeptonMoved,
+  LeptonCopyAssigned,
+  LeptonMoveAssigned,
+  DetectorChecked, // One per DetectorType, in enum order: particles offered to a detector
+  DetectorAccepted = DetectorChecked + 3, // ... and particles it saw
+  Count = DetectorAccepted + 3
+};
+constexpr std::size_t metric_counter_count = static_cast<std::size_t>(MetricCounter::Count);
+
+// Offset by the detector's DetectorType value
+constexpr MetricCounter detector_checked_counter(std::size_t detector)
+{
+  return static_cast<MetricCounter>(static_cast<std::size_t>(MetricCounter::DetectorChecked) + detector);
+}
+constexpr MetricCounter detector_accepted_counter(std::size_t detector)
+{
+  return static_cast<MetricCounter>(static_cast<std::size_t>(MetricCounter::DetectorAccepted) + detector);
+}
+
+enum class MetricTimer : std::uint8_t { PipelineGeneration, PipelineDetection, PipelineAnalysis, PipelineWait, Count };
+constexpr std::size_t metric_timer_count = static_cast<std::size_t>(MetricTimer::Count);
+
+enum class MetricsFormat : std::uint8_t { Prometheus, Json };
+
+// Totals over every thread at one moment
+struct MetricsSnapshot
+{
+  std::array<std::uint64_t, metric_counter_count> counters{};
+  std::array<std::uint64_t, metric_timer_count> timer_calls{};
+  std::array<double, metric_timer_count> timer_seconds{};
+
+  std::uint64_t get(MetricCounter counter) const { return counters[static_cast<std::size_t>(counter)]; }
+  std::string to_prometheus() const; // Text exposition format, one metric family per quantity
+  std::string to_json() const;
+};
+
+// One thread's counters. Only its owning thread writes them, with relaxed load and
+// store rather than a locked read-modify-write; snapshots read them concurrently.
+struct alignas(64) MetricsShard
+{
+  std::array<std::atomic<std::uint64_t>, metric_counter_count> counters{};
+  std::array<std::atomic<std::uint64_t>, metric_timer_count> timer_calls{};
+  std::array<std::atomic<std::uint64_t>, metric_timer_count> timer_ticks{};
+  bool attached = false; // Guarded by the registry mutex
+
+  static void add(std::atomic<std::uint64_t>& value, std::uint64_t amount)
+  {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+};
+
+// The calling thread's shard; null until its first metric
+inline thread_local MetricsShard* metrics_shard = nullptr;
+
+// Process-wide registry of shards. A thread takes a shard on first use and gives it
+// back when it exits; its counts stay in the totals and the next thread reuses it.
+//
+// If LEPTON_METRICS_FILE is set, a snapshot is written there when the process exits,
+// as JSON for a ".json" name and Prometheus text otherwise.
+class Metrics
+{
+private:
+  mutable std::mutex mutex; // Guards shards and their attached flags
+  std::vector<std::unique_ptr<MetricsShard>> shards;
+  std::uint64_t start_ticks;
+  std::chrono::steady_clock::time_point start_time;
+
+  Metrics();
+
+public:
+  static Metrics& instance();
+  ~Metrics();
+
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+
+  MetricsShard* attach_thread(); // Slow path of the first metric on a thread
+  void detach_thread(MetricsShard* shard);
+
+  MetricsSnapshot snapshot() const;
+  // Throws std::runtime_error if path cannot be written
+  void write_snapshot(const std::string& path, MetricsFormat format) const;
+  void reset(); // Zeroes every shard; only meaningful while no thread is recording
+
+  static std::uint64_t read_ticks()
+  {
+#if LEPTON_X86_KERNELS
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  static MetricsShard& local_shard()
+  {
+    MetricsShard* shard = metrics_shard;
+    return shard != nullptr ? *shard : *instance().attach_thread();
+  }
+
+  static void count(MetricCounter counter, std::uint64_t amount = 1)
+  {
+    MetricsShard::add(local_shard().counters[static_cast<std::size_t>(counter)], amount);
+  }
+
+  static void record_time(MetricTimer timer, std::uint64_t ticks)
+  {
+    MetricsShard& shard = local_shard();
+    MetricsShard::add(shard.timer_calls[static_cast<std::size_t>(timer)], 1);
+    MetricsShard::add(shard.timer_ticks[static_cast<std::size_t>(timer)], ticks);
+  }
+};
+
+// Adds the time from construction to destruction to a timer, in TSC ticks; snapshots
+// convert to seconds with the tick rate measured since the registry started
+class ScopedMetricTimer
+{
+private:
+  MetricTimer timer;
+  std::uint64_t start;
+
+public:
+  explicit ScopedMetricTimer(MetricTimer timer) : timer(timer), start(Metrics::read_ticks()) {}
+  ~ScopedMetricTimer() { Metrics::record_time(timer, Metrics::read_ticks() - start); }
+
+  ScopedMetricTimer(const ScopedMetricTimer&) = delete;
+  ScopedMetricTimer& operator=(const ScopedMetricTimer&) = delete;
+};
+
+#if LEPTON_METRICS
+#define LEPTON_METRIC_COUNT(counter) Metrics::count(counter)
+#define LEPTON_METRIC_ADD(counter, amount) Metrics::count(counter, amount)
+#define LEPTON_METRIC_TIME(timer) ScopedMetricTimer lepton_metric_timer_(timer) // At most one per scope
+#else
+#define LEPTON_METRIC_COUNT(counter) ((void)0)
+#define LEPTON_METRIC_ADD(counter, amount) ((void)0)
+#define LEPTON_METRIC_TIME(timer) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+// Description: Non-owning views over columnar (structure-of-arrays) four-momentum and boost data.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef MOMENTUMCOLUMNS_H
+#define MOMENTUMCOLUMNS_H
+
+#include <cstddef>
+
+// Read-only view: element i is (energy[i], px[i], py[i], pz[i])
+struct MomentumColumns
+{
+  const double* energy;
+  const double* px;
+  const double* py;
+  const double* pz;
+  std::size_t size;
+};
+
+// Writable view with the same layout, used for kernel outputs
+struct MutableMomentumColumns
+{
+  double* energy;
+  double* px;
+  double* py;
+  double* pz;
+  std::size_t size;
+
+  operator MomentumColumns() const { return MomentumColumns{energy, px, py, pz, size}; }
+};
+
+// Derived kinematics per element, as FourMomentum::get_pt, get_eta, get_phi and get_mass
+// return them. Only a writable form is needed; the columns are read back as plain arrays.
+struct MutableKinematicsColumns
+{
+  double* pt;
+  double* eta;
+  double* phi;
+  double* mass;
+  std::size_t size;
+};
+
+// Per-element boosts, as LorentzBoost holds them: element i is the boost by velocity
+// (beta_x[i], beta_y[i], beta_z[i]) with gamma[i] and gamma_factor[i] = gamma^2 / (gamma + 1)
+struct BoostColumns
+{
+  const double* beta_x;
+  const double* beta_y;
+  const double* beta_z;
+  const double* gamma;
+  const double* gamma_factor;
+  std::size_t size;
+};
+
+struct MutableBoostColumns
+{
+  double* beta_x;
+  double* beta_y;
+  double* beta_z;
+  double* gamma;
+  double* gamma_factor;
+  std::size_t size;
+
+  operator BoostColumns() const { return BoostColumns{beta_x, beta_y, beta_z, gamma, gamma_factor, size}; }
+};
+
+#endif
@@ -0,0 +1,139 @@
+// Description: Expression templates for sums and differences of four-momenta, evaluated in one pass with no intermediate vectors.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef MOMENTUMEXPRESSION_H
+#define MOMENTUMEXPRESSION_H
+
+#include "FourMomentum.h"
+
+// An unevaluated combination of four-momenta. Asking it for a component, a derived
+// quantity or a FourMomentum walks the whole tree once: a + b + c yields one energy
+// (a.e + b.e) + c.e, and so on, with no vector built for a + b. The additions happen
+// in the same order as repeated FourMomentum::operator+, so results are bit-identical.
+//
+// FourMomentum operands are copied into the expression. Lepton operands are referred
+// to (see LeptonRef in Lepton.h), so an expression must not outlive the leptons in it;
+// convert it to FourMomentum to keep the result.
+template <typename Derived>
+class MomentumExpression
+{
+public:
+  const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+  FourMomentum evaluate() const
+  {
+    const Derived& expression = derived();
+    return FourMomentum(expression.energy(), expression.px(), expression.py(), expression.pz());
+  }
+  operator FourMomentum() const { return evaluate(); }
+
+  double get_energy() const { return derived().energy(); }
+  double get_px() const { return derived().px(); }
+  double get_py() const { return derived().py(); }
+  double get_pz() const { return derived().pz(); }
+
+  double get_mass_squared() const { return evaluate().get_mass_squared(); }
+  double get_mass() const { return evaluate().get_mass(); }
+  double get_pt() const { return evaluate().get_pt(); }
+  double get_p() const { return evaluate().get_p(); }
+  double get_eta() const { return evaluate().get_eta(); }
+  double get_phi() const { return evaluate().get_phi(); }
+  double get_rapidity() const { return evaluate().get_rapidity(); }
+  double mass() const { return get_mass(); } // Short alias for get_mass()
+};
+
+// Leaf: a FourMomentum held by value, so temporaries such as
+// a + b + FourMomentum(...) stay valid for the expression's lifetime
+class MomentumValue : public MomentumExpression<MomentumValue>
+{
+private:
+  FourMomentum momentum;
+
+public:
+  explicit MomentumValue(const FourMomentum& momentum) : momentum(momentum) {}
+
+  double energy() const { return momentum.get_energy(); }
+  double px() const { return momentum.get_px(); }
+  double py() const { return momentum.get_py(); }
+  double pz() const { return momentum.get_pz(); }
+};
+
+// Inner nodes hold their children by value; the children are leaves or other small nodes
+template <typename Left, typename Right>
+class MomentumSum : public MomentumExpression<MomentumSum<Left, Right>>
+{
+private:
+  Left left;
+  Right right;
+
+public:
+  MomentumSum(const Left& left, const Right& right) : left(left), right(right) {}
+
+  double energy() const { return left.energy() + right.energy(); }
+  double px() const { return left.px() + right.px(); }
+  double py() const { return left.py() + right.py(); }
+  double pz() const { return left.pz() + right.pz(); }
+
+  const Left& get_left() const { return left; }
+  const Right& get_right() const { return right; }
+
+  // Only defined when every leaf is a lepton; used to turn a sum back into a particle
+  double summed_rest_mass() const { return left.summed_rest_mass() + right.summed_rest_mass(); }
+  int summed_charge() const { return left.summed_charge() + right.summed_charge(); }
+};
+
+template <typename Left, typename Right>
+class MomentumDifference : public MomentumExpression<MomentumDifference<Left, Right>>
+{
+private:
+  Left left;
+  Right right;
+
+public:
+  MomentumDifference(const Left& left, const Right& right) : left(left), right(right) {}
+
+  double energy() const { return left.energy() - right.energy(); }
+  double px() const { return left.px() - right.px(); }
+  double py() const { return left.py() - right.py(); }
+  double pz() const { return left.pz() - right.pz(); }
+};
+
+template <typename Left, typename Right>
+MomentumSum<Left, Right> operator+(const MomentumExpression<Left>& left, const MomentumExpression<Right>& right)
+{
+  return MomentumSum<Left, Right>(left.derived(), right.derived());
+}
+
+template <typename Left, typename Right>
+MomentumDifference<Left, Right> operator-(const MomentumExpression<Left>& left, const MomentumExpression<Right>& right)
+{
+  return MomentumDifference<Left, Right>(left.derived(), right.derived());
+}
+
+// Mixing in a plain FourMomentum; FourMomentum + FourMomentum keeps its eager operator
+template <typename Left>
+MomentumSum<Left, MomentumValue> operator+(const MomentumExpression<Left>& left, const FourMomentum& right)
+{
+  return MomentumSum<Left, MomentumValue>(left.derived(), MomentumValue(right));
+}
+
+template <typename Right>
+MomentumSum<MomentumValue, Right> operator+(const FourMomentum& left, const MomentumExpression<Right>& right)
+{
+  return MomentumSum<MomentumValue, Right>(MomentumValue(left), right.derived());
+}
+
+template <typename Left>
+MomentumDifference<Left, MomentumValue> operator-(const MomentumExpression<Left>& left, const FourMomentum& right)
+{
+  return MomentumDifference<Left, MomentumValue>(left.derived(), MomentumValue(right));
+}
+
+template <typename Right>
+MomentumDifference<MomentumValue, Right> operator-(const FourMomentum& left, const MomentumExpression<Right>& right)
+{
+  return MomentumDifference<MomentumValue, Right>(MomentumValue(left), right.derived());
+}
+
+#endif
@@ -0,0 +1,479 @@
+// Description: Batch versions of sum_four_momenta, dot_product_four_momenta, derived kinematics and Lorentz boosts over columnar momenta.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "MomentumKernels.h"
+#include "FourMomentum.h"
+#include "LorentzBoost.h"
+#include <atomic>
+#include <stdexcept>
+
+#if LEPTON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+  std::atomic<SimdLevel> kernel_level{detect_simd_level()};
+
+  void check_sizes(std::size_t a, std::size_t b, std::size_t out)
+  {
+    if (a != b || a != out)
+    {
+      throw std::invalid_argument("Batch inputs and outputs must have the same size");
+    }
+  }
+
+  // Scalar reference kernels; also used for the tails of the SIMD loops. They are kept
+  // out of line so the tails are not recompiled (and FMA-contracted) inside the
+  // AVX-512 target functions. GCC turns those tail calls into jumps without clearing
+  // the upper vector state, so the SIMD kernels issue vzeroupper themselves; otherwise
+  // the SSE code that follows runs with a transition penalty on every call.
+  __attribute__((noinline)) void sum_scalar(const MomentumColumns& a, const MomentumColumns& b, const MutableMomentumColumns& out, std::size_t i)
+  {
+    for (; i < a.size; ++i)
+    {
+      out.energy[i] = a.energy[i] + b.energy[i];
+      out.px[i] = a.px[i] + b.px[i];
+      out.py[i] = a.py[i] + b.py[i];
+      out.pz[i] = a.pz[i] + b.pz[i];
+    }
+  }
+
+  __attribute__((noinline)) void dot_scalar(const MomentumColumns& a, const MomentumColumns& b, double* out, std::size_t i)
+  {
+    for (; i < a.size; ++i)
+    {
+      out[i] = a.energy[i] * b.energy[i] - (a.px[i] * b.px[i] + a.py[i] * b.py[i] + a.pz[i] * b.pz[i]);
+    }
+  }
+
+  __attribute__((noinline)) void mass_scalar(const MomentumColumns& a, const MomentumColumns& b, double* out, std::size_t i)
+  {
+    for (; i < a.size; ++i)
+    {
+      FourMomentum sum(a.energy[i] + b.energy[i], a.px[i] + b.px[i], a.py[i] + b.py[i], a.pz[i] + b.pz[i]);
+      out[i] = sum.get_mass();
+    }
+  }
+
+  // Mass of each element on its own, as FourMomentum::get_mass
+  __attribute__((noinline)) void own_mass_scalar(const MomentumColumns& in, double* out, std::size_t i)
+  {
+    for (; i < in.size; ++i)
+    {
+      out[i] = FourMomentum(in.energy[i], in.px[i], in.py[i], in.pz[i]).get_mass();
+    }
+  }
+
+  // hypot, asinh and atan2 have no exact vector forms, so these stay libm calls
+  void angles_scalar(const MomentumColumns& in, const MutableKinematicsColumns& out)
+  {
+    for (std::size_t i = 0; i < in.size; ++i)
+    {
+      FourMomentum momentum(in.energy[i], in.px[i], in.py[i], in.pz[i]);
+      double pt = momentum.get_pt();
+      out.pt[i] = pt;
+      out.eta[i] = momentum.get_eta_for_pt(pt);
+      out.phi[i] = momentum.get_phi();
+    }
+  }
+
+  // Boost kernels follow LorentzBoost::apply operation for operation. Each element is
+  // read completely before it is written, so out may alias in.
+  __attribute__((noinline)) void boost_scalar(const LorentzBoost& boost, const MomentumColumns& in, const MutableMomentumColumns& out, std::size_t i)
+  {
+    const double bx = boost.get_beta_x(), by = boost.get_beta_y(), bz = boost.get_beta_z();
+    const double gamma = boost.get_gamma(), gamma_factor = boost.get_gamma_factor();
+    for (; i < in.size; ++i)
+    {
+      double e = in.energy[i], x = in.px[i], y = in.py[i], z = in.pz[i];
+      double beta_dot_p = (bx * x + by * y) + bz * z;
+      double shift = gamma_factor * beta_dot_p + gamma * e;
+      out.energy[i] = gamma * (e + beta_dot_p);
+      out.px[i] = x + bx * shift;
+      out.py[i] = y + by * shift;
+      out.pz[i] = z + bz * shift;
+    }
+  }
+
+  __attribute__((noinline)) void boost_each_scalar(const BoostColumns& boosts, const MomentumColumns& in, const MutableMomentumColumns& out, std::size_t i)
+  {
+    for (; i < in.size; ++i)
+    {
+      double bx = boosts.beta_x[i], by = boosts.beta_y[i], bz = boosts.beta_z[i];
+      double e = in.energy[i], x = in.px[i], y = in.py[i], z = in.pz[i];
+      double beta_dot_p = (bx * x + by * y) + bz * z;
+      double shift = boosts.gamma_factor[i] * beta_dot_p + boosts.gamma[i] * e;
+      out.energy[i] = boosts.gamma[i] * (e + beta_dot_p);
+      out.px[i] = x + bx * shift;
+      out.py[i] = y + by * shift;
+      out.pz[i] = z + bz * shift;
+    }
+  }
+
+  void fill_boosts(const MomentumColumns& parents, const MutableBoostColumns& out, bool to_rest_frame)
+  {
+    check_sizes(parents.size, out.size, out.size);
+    for (std::size_t i = 0; i < parents.size; ++i)
+    {
+      FourMomentum parent(parents.energy[i], parents.px[i], parents.py[i], parents.pz[i]);
+      LorentzBoost boost = to_rest_frame ? LorentzBoost::to_rest_frame(parent) : LorentzBoost::from_rest_frame(parent);
+      out.beta_x[i] = boost.get_beta_x();
+      out.beta_y[i] = boost.get_beta_y();
+      out.beta_z[i] = boost.get_beta_z();
+      out.gamma[i] = boost.get_gamma();
+      out.gamma_factor[i] = boost.get_gamma_factor();
+    }
+  }
+
+#if LEPTON_X86_KERNELS
+  __attribute__((target("avx2")))
+  void sum_avx2(const MomentumColumns& a, const MomentumColumns& b, const MutableMomentumColumns& out)
+  {
+    std::size_t i = 0;
+    for (; i + 4 <= a.size; i += 4)
+    {
+      _mm256_storeu_pd(out.energy + i, _mm256_add_pd(_mm256_loadu_pd(a.energy + i), _mm256_loadu_pd(b.energy + i)));
+      _mm256_storeu_pd(out.px + i, _mm256_add_pd(_mm256_loadu_pd(a.px + i), _mm256_loadu_pd(b.px + i)));
+      _mm256_storeu_pd(out.py + i, _mm256_add_pd(_mm256_loadu_pd(a.py + i), _mm256_loadu_pd(b.py + i)));
+      _mm256_storeu_pd(out.pz + i, _mm256_add_pd(_mm256_loadu_pd(a.pz + i), _mm256_loadu_pd(b.pz + i)));
+    }
+    _mm256_zeroupper();
+    sum_scalar(a, b, out, i);
+  }
+
+  __attribute__((target("avx2")))
+  void dot_avx2(const MomentumColumns& a, const MomentumColumns& b, double* out)
+  {
+    std::size_t i = 0;
+    for (; i + 4 <= a.size; i += 4)
+    {
+      __m256d time_part = _mm256_mul_pd(_mm256_loadu_pd(a.energy + i), _mm256_loadu_pd(b.energy + i));
+      __m256d space_part = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(a.px + i), _mm256_loadu_pd(b.px + i)),
+                                         _mm256_mul_pd(_mm256_loadu_pd(a.py + i), _mm256_loadu_pd(b.py + i)));
+      space_part = _mm256_add_pd(space_part, _mm256_mul_pd(_mm256_loadu_pd(a.pz + i), _mm256_loadu_pd(b.pz + i)));
+      _mm256_storeu_pd(out + i, _mm256_sub_pd(time_part, space_part));
+    }
+    _mm256_zeroupper();
+    dot_scalar(a, b, out, i);
+  }
+
+  __attribute__((target("avx2")))
+  void mass_avx2(const MomentumColumns& a, const MomentumColumns& b, double* out)
+  {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    std::size_t i = 0;
+    for (; i + 4 <= a.size; i += 4)
+    {
+      __m256d e = _mm256_add_pd(_mm256_loadu_pd(a.energy + i), _mm256_loadu_pd(b.energy + i));
+      __m256d x = _mm256_add_pd(_mm256_loadu_pd(a.px + i), _mm256_loadu_pd(b.px + i));
+      __m256d y = _mm256_add_pd(_mm256_loadu_pd(a.py + i), _mm256_loadu_pd(b.py + i));
+      __m256d z = _mm256_add_pd(_mm256_loadu_pd(a.pz + i), _mm256_loadu_pd(b.pz + i));
+      __m256d space_part = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z));
+      __m256d mass_squared = _mm256_sub_pd(_mm256_mul_pd(e, e), space_part);
+      // sign(m^2) * sqrt(|m^2|), matching FourMomentum::get_mass for space-like sums
+      __m256d magnitude = _mm256_sqrt_pd(_mm256_andnot_pd(sign_mask, mass_squared));
+      _mm256_storeu_pd(out + i, _mm256_or_pd(magnitude, _mm256_and_pd(sign_mask, mass_squared)));
+    }
+    _mm256_zeroupper();
+    mass_scalar(a, b, out, i);
+  }
+
+  __attribute__((target("avx2"))) inline void boost_step_avx2(__m256d bx, __m256d by, __m256d bz, __m256d gamma, __m256d gamma_factor,
+                                                              const MomentumColumns& in, const MutableMomentumColumns& out, std::size_t i)
+  {
+    __m256d e = _mm256_loadu_pd(in.energy + i);
+    __m256d x = _mm256_loadu_pd(in.px + i);
+    __m256d y = _mm256_loadu_pd(in.py + i);
+    __m256d z = _mm256_loadu_pd(in.pz + i);
+    __m256d beta_dot_p = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(bx, x), _mm256_mul_pd(by, y)), _mm256_mul_pd(bz, z));
+    __m256d shift = _mm256_add_pd(_mm256_mul_pd(gamma_factor, beta_dot_p), _mm256_mul_pd(gamma, e));
+    _mm256_storeu_pd(out.energy + i, _mm256_mul_pd(gamma, _mm256_add_pd(e, beta_dot_p)));
+    _mm256_storeu_pd(out.px + i, _mm256_add_pd(x, _mm256_mul_pd(bx, shift)));
+    _mm256_storeu_pd(out.py + i, _mm256_add_pd(y, _mm256_mul_pd(by, shift)));
+    _mm256_storeu_pd(out.pz + i, _mm256_add_pd(z, _mm256_mul_pd(bz, shift)));
+  }
+
+  __attribute__((target("avx2")))
+  void boost_avx2(const LorentzBoost& boost, const MomentumColumns& in, const MutableMomentumColumns& out)
+  {
+    const __m256d bx = _mm256_set1_pd(boost.get_beta_x());
+    const __m256d by = _mm256_set1_pd(boost.get_beta_y());
+    const __m256d bz = _mm256_set1_pd(boost.get_beta_z());
+    const __m256d gamma = _mm256_set1_pd(boost.get_gamma());
+    const __m256d gamma_factor = _mm256_set1_pd(boost.get_gamma_factor());
+    std::size_t i = 0;
+    for (; i + 4 <= in.size; i += 4)
+    {
+      boost_step_avx2(bx, by, bz, gamma, gamma_factor, in, out, i);
+    }
+    _mm256_zeroupper();
+    boost_scalar(boost, in, out, i);
+  }
+
+  __attribute__((target("avx2")))
+  void boost_each_avx2(const BoostColumns& boosts, const MomentumColumns& in, const MutableMomentumColumns& out)
+  {
+    std::size_t i = 0;
+    for (; i + 4 <= in.size; i += 4)
+    {
+      boost_step_avx2(_mm256_loadu_pd(boosts.beta_x + i), _mm256_loadu_pd(boosts.beta_y + i), _mm256_loadu_pd(boosts.beta_z + i),
+                      _mm256_loadu_pd(boosts.gamma + i), _mm256_loadu_pd(boosts.gamma_factor + i), in, out, i);
+    }
+    _mm256_zeroupper();
+    boost_each_scalar(boosts, in, out, i);
+  }
+
+  __attribute__((target("avx2")))
+  void own_mass_avx2(const MomentumColumns& in, double* out)
+  {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    std::size_t i = 0;
+    for (; i + 4 <= in.size; i += 4)
+    {
+      __m256d e = _mm256_loadu_pd(in.energy + i);
+      __m256d x = _mm256_loadu_pd(in.px + i);
+      __m256d y = _mm256_loadu_pd(in.py + i);
+      __m256d z = _mm256_loadu_pd(in.pz + i);
+      __m256d space_part = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z));
+      __m256d mass_squared = _mm256_sub_pd(_mm256_mul_pd(e, e), space_part);
+      __m256d magnitude = _mm256_sqrt_pd(_mm256_andnot_pd(sign_mask, mass_squared));
+      _mm256_storeu_pd(out + i, _mm256_or_pd(magnitude, _mm256_and_pd(sign_mask, mass_squared)));
+    }
+    _mm256_zeroupper();
+    own_mass_scalar(in, out, i);
+  }
+
+  // GCC lowers the plain AVX-512 arithmetic intrinsics to generic vector operations,
+  // which -ffp-contract=fast may fuse into FMA. The explicit-rounding forms map to
+  // dedicated builtins and keep every product and sum rounded separately.
+  __attribute__((target("avx512f"))) inline __m512d add512(__m512d a, __m512d b) { return _mm512_add_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+  __attribute__((target("avx512f"))) inline __m512d sub512(__m512d a, __m512d b) { return _mm512_sub_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+  __attribute__((target("avx512f"))) inline __m512d mul512(__m512d a, __m512d b) { return _mm512_mul_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+
+  __attribute__((target("avx512f")))
+  void sum_avx512(const MomentumColumns& a, const MomentumColumns& b, const MutableMomentumColumns& out)
+  {
+    std::size_t i = 0;
+    for (; i + 8 <= a.size; i += 8)
+    {
+      _mm512_storeu_pd(out.energy + i, add512(_mm512_loadu_pd(a.energy + i), _mm512_loadu_pd(b.energy + i)));
+      _mm512_storeu_pd(out.px + i, add512(_mm512_loadu_pd(a.px + i), _mm512_loadu_pd(b.px + i)));
+      _mm512_storeu_pd(out.py + i, add512(_mm512_loadu_pd(a.py + i), _mm512_loadu_pd(b.py + i)));
+      _mm512_storeu_pd(out.pz + i, add512(_mm512_loadu_pd(a.pz + i), _mm512_loadu_pd(b.pz + i)));
+    }
+    _mm256_zeroupper();
+    sum_scalar(a, b, out, i);
+  }
+
+  __attribute__((target("avx512f")))
+  void dot_avx512(const MomentumColumns& a, const MomentumColumns& b, double* out)
+  {
+    std::size_t i = 0;
+    for (; i + 8 <= a.size; i += 8)
+    {
+      __m512d time_part = mul512(_mm512_loadu_pd(a.energy + i), _mm512_loadu_pd(b.energy + i));
+      __m512d space_part = add512(mul512(_mm512_loadu_pd(a.px + i), _mm512_loadu_pd(b.px + i)),
+                                  mul512(_mm512_loadu_pd(a.py + i), _mm512_loadu_pd(b.py + i)));
+      space_part = add512(space_part, mul512(_mm512_loadu_pd(a.pz + i), _mm512_loadu_pd(b.pz + i)));
+      _mm512_storeu_pd(out + i, sub512(time_part, space_part));
+    }
+    _mm256_zeroupper();
+    dot_scalar(a, b, out, i);
+  }
+
+  __attribute__((target("avx512f")))
+  void mass_avx512(const MomentumColumns& a, const MomentumColumns& b, double* out)
+  {
+    const __m512i sign_mask = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+    std::size_t i = 0;
+    for (; i + 8 <= a.size; i += 8)
+    {
+      __m512d e = add512(_mm512_loadu_pd(a.energy + i), _mm512_loadu_pd(b.energy + i));
+      __m512d x = add512(_mm512_loadu_pd(a.px + i), _mm512_loadu_pd(b.px + i));
+      __m512d y = add512(_mm512_loadu_pd(a.py + i), _mm512_loadu_pd(b.py + i));
+      __m512d z = add512(_mm512_loadu_pd(a.pz + i), _mm512_loadu_pd(b.pz + i));
+      __m512d space_part = add512(add512(mul512(x, x), mul512(y, y)), mul512(z, z));
+      __m512i mass_squared = _mm512_castpd_si512(sub512(mul512(e, e), space_part));
+      // Integer bit operations keep this within AVX-512F (the pd logic ops need AVX-512DQ)
+      __m512d magnitude = _mm512_sqrt_pd(_mm512_castsi512_pd(_mm512_andnot_si512(sign_mask, mass_squared)));
+      __m512i sign = _mm512_and_si512(sign_mask, mass_squared);
+      _mm512_storeu_pd(out + i, _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(magnitude), sign)));
+    }
+    _mm256_zeroupper();
+    mass_scalar(a, b, out, i);
+  }
+  __attribute__((target("avx512f"))) inline void boost_step_avx512(__m512d bx, __m512d by, __m512d bz, __m512d gamma, __m512d gamma_factor,
+                                                                   const MomentumColumns& in, const MutableMomentumColumns& out, std::size_t i)
+  {
+    __m512d e = _mm512_loadu_pd(in.energy + i);
+    __m512d x = _mm512_loadu_pd(in.px + i);
+    __m512d y = _mm512_loadu_pd(in.py + i);
+    __m512d z = _mm512_loadu_pd(in.pz + i);
+    __m512d beta_dot_p = add512(add512(mul512(bx, x), mul512(by, y)), mul512(bz, z));
+    __m512d shift = add512(mul512(gamma_factor, beta_dot_p), mul512(gamma, e));
+    _mm512_storeu_pd(out.energy + i, mul512(gamma, add512(e, beta_dot_p)));
+    _mm512_storeu_pd(out.px + i, add512(x, mul512(bx, shift)));
+    _mm512_storeu_pd(out.py + i, add512(y, mul512(by, shift)));
+    _mm512_storeu_pd(out.pz + i, add512(z, mul512(bz, shift)));
+  }
+
+  __attribute__((target("avx512f")))
+  void boost_avx512(const LorentzBoost& boost, const MomentumColumns& in, const MutableMomentumColumns& out)
+  {
+    const __m512d bx = _mm512_set1_pd(boost.get_beta_x());
+    const __m512d by = _mm512_set1_pd(boost.get_beta_y());
+    const __m512d bz = _mm512_set1_pd(boost.get_beta_z());
+    const __m512d gamma = _mm512_set1_pd(boost.get_gamma());
+    const __m512d gamma_factor = _mm512_set1_pd(boost.get_gamma_factor());
+    std::size_t i = 0;
+    for (; i + 8 <= in.size; i += 8)
+    {
+      boost_step_avx512(bx, by, bz, gamma, gamma_factor, in, out, i);
+    }
+    _mm256_zeroupper();
+    boost_scalar(boost, in, out, i);
+  }
+
+  __attribute__((target("avx512f")))
+  void boost_each_avx512(const BoostColumns& boosts, const MomentumColumns& in, const MutableMomentumColumns& out)
+  {
+    std::size_t i = 0;
+    for (; i + 8 <= in.size; i += 8)
+    {
+      boost_step_avx512(_mm512_loadu_pd(boosts.beta_x + i), _mm512_loadu_pd(boosts.beta_y + i), _mm512_loadu_pd(boosts.beta_z + i),
+                        _mm512_loadu_pd(boosts.gamma + i), _mm512_loadu_pd(boosts.gamma_factor + i), in, out, i);
+    }
+    _mm256_zeroupper();
+    boost_each_scalar(boosts, in, out, i);
+  }
+
+  __attribute__((target("avx512f")))
+  void own_mass_avx512(const MomentumColumns& in, double* out)
+  {
+    const __m512i sign_mask = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+    std::size_t i = 0;
+    for (; i + 8 <= in.size; i += 8)
+    {
+      __m512d e = _mm512_loadu_pd(in.energy + i);
+      __m512d x = _mm512_loadu_pd(in.px + i);
+      __m512d y = _mm512_loadu_pd(in.py + i);
+      __m512d z = _mm512_loadu_pd(in.pz + i);
+      __m512d space_part = add512(add512(mul512(x, x), mul512(y, y)), mul512(z, z));
+      __m512i mass_squared = _mm512_castpd_si512(sub512(mul512(e, e), space_part));
+      __m512d magnitude = _mm512_sqrt_pd(_mm512_castsi512_pd(_mm512_andnot_si512(sign_mask, mass_squared)));
+      __m512i sign = _mm512_and_si512(sign_mask, mass_squared);
+      _mm512_storeu_pd(out + i, _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(magnitude), sign)));
+    }
+    _mm256_zeroupper();
+    own_mass_scalar(in, out, i);
+  }
+#endif
+}
+
+SimdLevel get_kernel_simd_level()
+{
+  return kernel_level.load(std::memory_order_relaxed);
+}
+
+void set_kernel_simd_level(SimdLevel level)
+{
+  SimdLevel supported = detect_simd_level();
+  kernel_level.store(static_cast<int>(level) > static_cast<int>(supported) ? supported : level, std::memory_order_relaxed);
+}
+
+void sum_four_momenta_batch(const MomentumColumns& a, const MomentumColumns& b, const MutableMomentumColumns& out)
+{
+  check_sizes(a.size, b.size, out.size);
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: sum_avx512(a, b, out); return;
+    case SimdLevel::Avx2: sum_avx2(a, b, out); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  sum_scalar(a, b, out, 0);
+}
+
+void dot_product_four_momenta_batch(const MomentumColumns& a, const MomentumColumns& b, double* out)
+{
+  check_sizes(a.size, b.size, a.size);
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: dot_avx512(a, b, out); return;
+    case SimdLevel::Avx2: dot_avx2(a, b, out); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  dot_scalar(a, b, out, 0);
+}
+
+void invariant_mass_batch(const MomentumColumns& a, const MomentumColumns& b, double* out)
+{
+  check_sizes(a.size, b.size, a.size);
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: mass_avx512(a, b, out); return;
+    case SimdLevel::Avx2: mass_avx2(a, b, out); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  mass_scalar(a, b, out, 0);
+}
+
+void kinematics_batch(const MomentumColumns& in, const MutableKinematicsColumns& out)
+{
+  check_sizes(in.size, out.size, out.size);
+  angles_scalar(in, out);
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: own_mass_avx512(in, out.mass); return;
+    case SimdLevel::Avx2: own_mass_avx2(in, out.mass); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  own_mass_scalar(in, out.mass, 0);
+}
+
+void boost_batch(const LorentzBoost& boost, const MomentumColumns& in, const MutableMomentumColumns& out)
+{
+  check_sizes(in.size, out.size, out.size);
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: boost_avx512(boost, in, out); return;
+    case SimdLevel::Avx2: boost_avx2(boost, in, out); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  boost_scalar(boost, in, out, 0);
+}
+
+void boost_batch(const BoostColumns& boosts, const MomentumColumns& in, const MutableMomentumColumns& out)
+{
+  check_sizes(boosts.size, in.size, out.size);
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: boost_each_avx512(boosts, in, out); return;
+    case SimdLevel::Avx2: boost_each_avx2(boosts, in, out); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  boost_each_scalar(boosts, in, out, 0);
+}
+
+void to_rest_frame_boosts(const MomentumColumns& parents, const MutableBoostColumns& out)
+{
+  fill_boosts(parents, out, true);
+}
+
+void from_rest_frame_boosts(const MomentumColumns& parents, const MutableBoostColumns& out)
+{
+  fill_boosts(parents, out, false);
+}
@@ -0,0 +1,48 @@
+// Description: Batch versions of sum_four_momenta, dot_product_four_momenta, derived kinematics and Lorentz boosts over columnar momenta.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef MOMENTUMKERNELS_H
+#define MOMENTUMKERNELS_H
+
+#include "CpuFeatures.h"
+#include "MomentumColumns.h"
+
+class LorentzBoost;
+
+// Element-wise over pairs (a[i], b[i]); all views must have the same size or
+// std::invalid_argument is thrown. Outputs may alias either input.
+//
+// The SIMD kernels perform the same operations in the same order as the scalar
+// Lepton functions, so results are bit-identical to sum_four_momenta,
+// dot_product_four_momenta and FourMomentum::get_mass as long as the scalar code
+// is not compiled with floating-point contraction into FMA.
+void sum_four_momenta_batch(const MomentumColumns& a, const MomentumColumns& b, const MutableMomentumColumns& out);
+void dot_product_four_momenta_batch(const MomentumColumns& a, const MomentumColumns& b, double* out);
+void invariant_mass_batch(const MomentumColumns& a, const MomentumColumns& b, double* out); // Mass of a[i] + b[i]
+
+// pT, eta, phi and mass of every element in one pass, bit-identical to the
+// FourMomentum getters (and so to what CachedFourMomentum would compute). The mass
+// runs in SIMD; pT, eta and phi call the same libm functions as the getters.
+// Sizes must match (std::invalid_argument otherwise).
+void kinematics_batch(const MomentumColumns& in, const MutableKinematicsColumns& out);
+
+// Boosts every element by one boost, or element i by boosts[i], matching
+// LorentzBoost::apply bit for bit. Sizes must match (std::invalid_argument
+// otherwise); out may alias in, for boosting in place.
+void boost_batch(const LorentzBoost& boost, const MomentumColumns& in, const MutableMomentumColumns& out);
+void boost_batch(const BoostColumns& boosts, const MomentumColumns& in, const MutableMomentumColumns& out);
+
+// Boost i takes four-vectors into (or out of) the rest frame of parents[i], as
+// LorentzBoost::to_rest_frame / from_rest_frame; throws like them for a parent
+// that is not time-like
+void to_rest_frame_boosts(const MomentumColumns& parents, const MutableBoostColumns& out);
+void from_rest_frame_boosts(const MomentumColumns& parents, const MutableBoostColumns& out);
+
+// The instruction set is picked from the running CPU on first use. It can be
+// lowered (e.g. to compare against the scalar path) but never raised above
+// what the CPU supports.
+SimdLevel get_kernel_simd_level();
+void set_kernel_simd_level(SimdLevel level);
+
+#endif
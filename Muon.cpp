@@ -3,9 +3,16 @@
 // Date: 18/04/2024
 
 #include "Muon.h"
+#include "Logger.h"
 
 Muon::Muon(double mass, int charge, double energy, double px, double py, double pz, bool isolated)
-    : Lepton(mass, charge, energy, px, py, pz), is_isolated(isolated) {}
+    : Lepton(static_type_id, mass, charge, energy, px, py, pz), is_isolated(isolated) {}
+
+void Muon::set_isolated(bool isolated) 
+{
+    is_isolated = isolated;
+    LEPTON_LOG_DEBUG(LogCategory::Accessor, "Isolation set to: " << isolated);
+}
 
 bool Muon::get_isolated() const 
 {
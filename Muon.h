@@ -2,34 +2,42 @@
 // Author: Leo Feasby
 // Date: 18/04/2024
 
+#ifndef MUON_H
+#define MUON_H
+
 #include "Lepton.h"
 
-class Muon : public Lepton 
+class Muon final : public Lepton 
 {
 private:
   bool is_isolated;
 
+  // A sum of muons is isolated only if every muon in it is
+  static bool all_isolated(const LeptonRef<Muon>& muon) { return muon.get_lepton().is_isolated; }
+  template <typename Left, typename Right>
+  static bool all_isolated(const MomentumSum<Left, Right>& sum) { return all_isolated(sum.get_left()) && all_isolated(sum.get_right()); }
+
 public:
+  static constexpr ParticleType static_type_id = ParticleType::Muon;
+
   // Declaration of Muon constructor
   Muon(double mass, int charge, double energy, double px, double py, double pz, bool isolated = false);
 
+  // Muon combined = a + b + ...: rest masses, charges and four-momenta of the muons added,
+  // isolated if all of them are. Only sums of Muons convert.
+  template <typename Left, typename Right, typename = std::enable_if_t<is_lepton_sum_of<Muon, MomentumSum<Left, Right>>::value>>
+  Muon(const MomentumSum<Left, Right>& sum)
+    : Muon(sum.summed_rest_mass(), sum.summed_charge(), sum.get_energy(), sum.get_px(), sum.get_py(), sum.get_pz(), all_isolated(sum))
+  {}
+
   void set_isolated(bool isolated);
 
   bool get_isolated() const;
 
   std::string get_particle_type() const override 
   {
-    return "Muon";
-  }
-
-  Muon operator+(const Muon& other) const 
-  {
-    return Muon(this->get_rest_mass() + other.get_rest_mass(),
-                this->get_charge() + other.get_charge(),
-                this->get_e() + other.get_e(),
-                this->get_px() + other.get_px(),
-                this->get_py() + other.get_py(),
-                this->get_pz() + other.get_pz(),
-                this->is_isolated && other.is_isolated);
+    return particle_type_name(static_type_id);
   }
 };
+
+#endif
@@ -7,15 +7,23 @@
 
 #include "Lepton.h"
 
-class Neutrino : public Lepton 
+class Neutrino final : public Lepton 
 {
 private:
-  std::string flavor; // "muon" or "electron"
+  NeutrinoFlavor flavor;
   bool has_interacted;
 
 public:
+  static constexpr ParticleType static_type_id = ParticleType::Neutrino;
+
+  Neutrino(double mass, int charge, double energy, double px, double py, double pz, NeutrinoFlavor flavor, bool interacted = false)
+    : Lepton(static_type_id, mass, charge, energy, px, py, pz), flavor(flavor), has_interacted(interacted) 
+  {
+  }
+
+  // Flavor given by name: "muon" or "electron"
   Neutrino(double mass, int charge, double energy, double px, double py, double pz, const std::string& flavor, bool interacted = false)
-    : Lepton(mass, charge, energy, px, py, pz), flavor(flavor), has_interacted(interacted) 
+    : Neutrino(mass, charge, energy, px, py, pz, neutrino_flavor_from_string(flavor), interacted) 
   {
   }
 
@@ -29,9 +37,14 @@ public:
     return has_interacted;
   }
 
+  NeutrinoFlavor get_flavor() const
+  {
+    return flavor;
+  }
+
   std::string get_particle_type() const override 
   {
-    return flavor + " neutrino";
+    return particle_type_name(static_type_id, flavor);
   }
 };
 
@@ -0,0 +1,293 @@
+// Description: Solves the neutrino pz of W -> lepton + neutrino decays from the W mass constraint, in batches over columnar momenta.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "NeutrinoReconstruction.h"
+#include "EventSummary.h"
+#include "MomentumKernels.h"
+#include "Neutrino.h"
+#include <cmath>
+#include <stdexcept>
+
+#if LEPTON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+  struct SolutionColumns
+  {
+    double* plus;
+    double* minus;
+    double* chosen;
+    NeutrinoSolution* solution;
+  };
+
+  // Indexed by 2 * complex + took_minus; a complex solution never takes the minus root
+  constexpr NeutrinoSolution solution_codes[4] = {NeutrinoSolution::Plus, NeutrinoSolution::Minus,
+                                                  NeutrinoSolution::Complex, NeutrinoSolution::Complex};
+
+  void check_config(const NeutrinoSolverConfig& config)
+  {
+    if (!(config.w_mass > 0.0) || !std::isfinite(config.w_mass))
+    {
+      throw std::invalid_argument("The W mass must be positive and finite");
+    }
+  }
+
+  // With the lepton mass m^2 = E^2 - p^2 and mu = (m_W^2 - m^2) / 2 + pT(lepton) . MET,
+  // pz = centre +- sqrt(centre^2 - (E^2 MET^2 - mu^2) / (E^2 - pz^2)), centre = mu pz / (E^2 - pz^2).
+  // The SIMD kernels perform these operations in this order. Kept out of line, like
+  // the MomentumKernels tails, so it is not contracted into FMA inside the AVX-512 code.
+  __attribute__((noinline)) void solve_scalar(const MomentumColumns& leptons, const double* met_x, const double* met_y,
+                                              const SolutionColumns& out, double w_mass_squared, std::size_t i)
+  {
+    for (; i < leptons.size; ++i)
+    {
+      double e = leptons.energy[i], x = leptons.px[i], y = leptons.py[i], z = leptons.pz[i];
+      double mx = met_x[i], my = met_y[i];
+      double e_squared = e * e;
+      double z_squared = z * z;
+      double mass_squared = e_squared - ((x * x + y * y) + z_squared);
+      double transverse = e_squared - z_squared;
+      double mu = (w_mass_squared - mass_squared) * 0.5 + (x * mx + y * my);
+      double centre = mu * z / transverse;
+      double discriminant = centre * centre - (e_squared * (mx * mx + my * my) - mu * mu) / transverse;
+      double root = std::sqrt(discriminant > 0.0 ? discriminant : 0.0);
+      double plus = centre + root;
+      double minus = centre - root;
+      bool took_minus = std::abs(minus) < std::abs(plus);
+      out.plus[i] = plus;
+      out.minus[i] = minus;
+      out.chosen[i] = took_minus ? minus : plus;
+      out.solution[i] = solution_codes[2 * (discriminant < 0.0) + took_minus];
+    }
+  }
+
+#if LEPTON_X86_KERNELS
+  __attribute__((target("avx2")))
+  void solve_avx2(const MomentumColumns& leptons, const double* met_x, const double* met_y,
+                  const SolutionColumns& out, double w_mass_squared)
+  {
+    const __m256d w2 = _mm256_set1_pd(w_mass_squared);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    std::size_t i = 0;
+    for (; i + 4 <= leptons.size; i += 4)
+    {
+      __m256d e = _mm256_loadu_pd(leptons.energy + i);
+      __m256d x = _mm256_loadu_pd(leptons.px + i);
+      __m256d y = _mm256_loadu_pd(leptons.py + i);
+      __m256d z = _mm256_loadu_pd(leptons.pz + i);
+      __m256d mx = _mm256_loadu_pd(met_x + i);
+      __m256d my = _mm256_loadu_pd(met_y + i);
+      __m256d e_squared = _mm256_mul_pd(e, e);
+      __m256d z_squared = _mm256_mul_pd(z, z);
+      __m256d mass_squared = _mm256_sub_pd(e_squared, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), z_squared));
+      __m256d transverse = _mm256_sub_pd(e_squared, z_squared);
+      __m256d mu = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(w2, mass_squared), half),
+                                 _mm256_add_pd(_mm256_mul_pd(x, mx), _mm256_mul_pd(y, my)));
+      __m256d centre = _mm256_div_pd(_mm256_mul_pd(mu, z), transverse);
+      __m256d met_squared = _mm256_add_pd(_mm256_mul_pd(mx, mx), _mm256_mul_pd(my, my));
+      __m256d discriminant = _mm256_sub_pd(_mm256_mul_pd(centre, centre),
+                                           _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(e_squared, met_squared), _mm256_mul_pd(mu, mu)), transverse));
+      // max returns its second operand for NaN, as the scalar comparison does
+      __m256d root = _mm256_sqrt_pd(_mm256_max_pd(discriminant, zero));
+      __m256d plus = _mm256_add_pd(centre, root);
+      __m256d minus = _mm256_sub_pd(centre, root);
+      __m256d took_minus = _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, minus), _mm256_andnot_pd(sign_mask, plus), _CMP_LT_OQ);
+      __m256d complex = _mm256_cmp_pd(discriminant, zero, _CMP_LT_OQ);
+      _mm256_storeu_pd(out.plus + i, plus);
+      _mm256_storeu_pd(out.minus + i, minus);
+      _mm256_storeu_pd(out.chosen + i, _mm256_blendv_pd(plus, minus, took_minus));
+      int minus_bits = _mm256_movemask_pd(took_minus);
+      int complex_bits = _mm256_movemask_pd(complex);
+      for (std::size_t lane = 0; lane < 4; ++lane)
+      {
+        out.solution[i + lane] = solution_codes[2 * ((complex_bits >> lane) & 1) + ((minus_bits >> lane) & 1)];
+      }
+    }
+    _mm256_zeroupper();
+    solve_scalar(leptons, met_x, met_y, out, w_mass_squared, i);
+  }
+
+  // Explicit-rounding forms so -ffp-contract=fast cannot fuse them, as in MomentumKernels
+  __attribute__((target("avx512f"))) inline __m512d add512(__m512d a, __m512d b) { return _mm512_add_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+  __attribute__((target("avx512f"))) inline __m512d sub512(__m512d a, __m512d b) { return _mm512_sub_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+  __attribute__((target("avx512f"))) inline __m512d mul512(__m512d a, __m512d b) { return _mm512_mul_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+  __attribute__((target("avx512f"))) inline __m512d div512(__m512d a, __m512d b) { return _mm512_div_round_pd(a, b, _MM_FROUND_CUR_DIRECTION); }
+
+  __attribute__((target("avx512f")))
+  void solve_avx512(const MomentumColumns& leptons, const double* met_x, const double* met_y,
+                    const SolutionColumns& out, double w_mass_squared)
+  {
+    const __m512d w2 = _mm512_set1_pd(w_mass_squared);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d zero = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= leptons.size; i += 8)
+    {
+      __m512d e = _mm512_loadu_pd(leptons.energy + i);
+      __m512d x = _mm512_loadu_pd(leptons.px + i);
+      __m512d y = _mm512_loadu_pd(leptons.py + i);
+      __m512d z = _mm512_loadu_pd(leptons.pz + i);
+      __m512d mx = _mm512_loadu_pd(met_x + i);
+      __m512d my = _mm512_loadu_pd(met_y + i);
+      __m512d e_squared = mul512(e, e);
+      __m512d z_squared = mul512(z, z);
+      __m512d mass_squared = sub512(e_squared, add512(add512(mul512(x, x), mul512(y, y)), z_squared));
+      __m512d transverse = sub512(e_squared, z_squared);
+      __m512d mu = add512(mul512(sub512(w2, mass_squared), half), add512(mul512(x, mx), mul512(y, my)));
+      __m512d centre = div512(mul512(mu, z), transverse);
+      __m512d met_squared = add512(mul512(mx, mx), mul512(my, my));
+      __m512d discriminant = sub512(mul512(centre, centre), div512(sub512(mul512(e_squared, met_squared), mul512(mu, mu)), transverse));
+      __m512d root = _mm512_sqrt_pd(_mm512_max_pd(discriminant, zero));
+      __m512d plus = add512(centre, root);
+      __m512d minus = sub512(centre, root);
+      __mmask8 took_minus = _mm512_cmp_pd_mask(_mm512_abs_pd(minus), _mm512_abs_pd(plus), _CMP_LT_OQ);
+      __mmask8 complex = _mm512_cmp_pd_mask(discriminant, zero, _CMP_LT_OQ);
+      _mm512_storeu_pd(out.plus + i, plus);
+      _mm512_storeu_pd(out.minus + i, minus);
+      _mm512_storeu_pd(out.chosen + i, _mm512_mask_blend_pd(took_minus, plus, minus));
+      for (std::size_t lane = 0; lane < 8; ++lane)
+      {
+        out.solution[i + lane] = solution_codes[2 * ((complex >> lane) & 1) + ((took_minus >> lane) & 1)];
+      }
+    }
+    _mm256_zeroupper();
+    solve_scalar(leptons, met_x, met_y, out, w_mass_squared, i);
+  }
+#endif
+
+  NeutrinoFlavor flavor_of(ParticleType lepton)
+  {
+    return lepton == ParticleType::Electron ? NeutrinoFlavor::Electron : NeutrinoFlavor::Muon;
+  }
+
+  double neutrino_energy(double met_x, double met_y, double pz)
+  {
+    return std::sqrt((met_x * met_x + met_y * met_y) + pz * pz);
+  }
+}
+
+void solve_neutrino_pz(const MomentumColumns& leptons, const double* met_x, const double* met_y, NeutrinoSolutions& out,
+                       const NeutrinoSolverConfig& config)
+{
+  check_config(config);
+  out.resize(leptons.size);
+  SolutionColumns columns{out.pz_plus.data(), out.pz_minus.data(), out.pz.data(), out.solution.data()};
+  double w_mass_squared = config.w_mass * config.w_mass;
+#if LEPTON_X86_KERNELS
+  switch (get_kernel_simd_level())
+  {
+    case SimdLevel::Avx512: solve_avx512(leptons, met_x, met_y, columns, w_mass_squared); return;
+    case SimdLevel::Avx2: solve_avx2(leptons, met_x, met_y, columns, w_mass_squared); return;
+    case SimdLevel::Scalar: break;
+  }
+#endif
+  solve_scalar(leptons, met_x, met_y, columns, w_mass_squared, 0);
+}
+
+Neutrino make_neutrino_candidate(const Lepton& lepton, double met_x, double met_y, NeutrinoSolution* solution,
+                                 const NeutrinoSolverConfig& config)
+{
+  check_config(config);
+  ParticleType type = lepton.get_type_id();
+  if (type != ParticleType::Electron && type != ParticleType::Muon)
+  {
+    throw std::invalid_argument("Neutrino candidates need an electron or muon, not a " + lepton.get_particle_type());
+  }
+  const FourMomentum& momentum = lepton.get_four_momentum();
+  double e = momentum.get_energy(), x = momentum.get_px(), y = momentum.get_py(), z = momentum.get_pz();
+  double plus = 0.0, minus = 0.0, pz = 0.0;
+  NeutrinoSolution chosen = NeutrinoSolution::Plus;
+  solve_scalar(MomentumColumns{&e, &x, &y, &z, 1}, &met_x, &met_y, SolutionColumns{&plus, &minus, &pz, &chosen},
+               config.w_mass * config.w_mass, 0);
+  if (solution != nullptr)
+  {
+    *solution = chosen;
+  }
+  return Neutrino(0.0, 0, neutrino_energy(met_x, met_y, pz), met_x, met_y, pz, flavor_of(type));
+}
+
+NeutrinoReconstruction::NeutrinoReconstruction(const NeutrinoSolverConfig& config)
+  : config(config)
+{
+  check_config(config);
+}
+
+std::size_t NeutrinoReconstruction::reconstruct(const std::vector<ParticleStore>& events, const std::vector<EventSummary>& summaries,
+                                                WCandidates& out)
+{
+  if (events.size() != summaries.size())
+  {
+    throw std::invalid_argument("Every event needs its summary for neutrino reconstruction");
+  }
+  out.clear();
+  energy.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  met_x.clear();
+  met_y.clear();
+  flavor.clear();
+
+  for (std::size_t e = 0; e < events.size(); ++e)
+  {
+    const ParticleStore& event = events[e];
+    const std::vector<ParticleType>& types = event.type_column();
+    const std::vector<double>& event_px = event.px_column();
+    const std::vector<double>& event_py = event.py_column();
+    std::size_t leading = event.size();
+    double leading_pt_squared = -1.0;
+    for (std::size_t row = 0; row < event.size(); ++row)
+    {
+      double pt_squared = event_px[row] * event_px[row] + event_py[row] * event_py[row];
+      if ((types[row] == ParticleType::Electron || types[row] == ParticleType::Muon) && pt_squared > leading_pt_squared)
+      {
+        leading = row;
+        leading_pt_squared = pt_squared;
+      }
+    }
+    if (leading == event.size())
+    {
+      continue;
+    }
+    out.event.push_back(static_cast<std::uint32_t>(e));
+    out.lepton.push_back(static_cast<std::uint32_t>(leading));
+    energy.push_back(event.energy_column()[leading]);
+    px.push_back(event_px[leading]);
+    py.push_back(event_py[leading]);
+    pz.push_back(event.pz_column()[leading]);
+    met_x.push_back(summaries[e].met_x);
+    met_y.push_back(summaries[e].met_y);
+    flavor.push_back(flavor_of(types[leading]));
+  }
+
+  solve_neutrino_pz(MomentumColumns{energy.data(), px.data(), py.data(), pz.data(), energy.size()}, met_x.data(), met_y.data(),
+                    out.solutions, config);
+  out.neutrinos.reserve(out.size());
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < out.size(); ++i)
+  {
+    double neutrino_pz = out.solutions.pz[i];
+    double neutrino_e = neutrino_energy(met_x[i], met_y[i], neutrino_pz);
+    if (!std::isfinite(neutrino_e) || neutrino_e == 0.0) // A lepton with E = |pz| gives NaN or infinity; no MET and pz = 0 gives 0
+    {
+      continue;
+    }
+    out.event[kept] = out.event[i];
+    out.lepton[kept] = out.lepton[i];
+    out.solutions.pz_plus[kept] = out.solutions.pz_plus[i];
+    out.solutions.pz_minus[kept] = out.solutions.pz_minus[i];
+    out.solutions.pz[kept] = neutrino_pz;
+    out.solutions.solution[kept] = out.solutions.solution[i];
+    out.neutrinos.add_neutrino(0.0, 0, neutrino_e, met_x[i], met_y[i], neutrino_pz, flavor[i]);
+    ++kept;
+  }
+  out.event.resize(kept);
+  out.lepton.resize(kept);
+  out.solutions.resize(kept);
+  return kept;
+}
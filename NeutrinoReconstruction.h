@@ -0,0 +1,112 @@
+// Description: Solves the neutrino pz of W -> lepton + neutrino decays from the W mass constraint, in batches over columnar momenta.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef NEUTRINORECONSTRUCTION_H
+#define NEUTRINORECONSTRUCTION_H
+
+#include "MomentumColumns.h"
+#include "ParticleStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Lepton;
+class Neutrino;
+struct EventSummary;
+
+struct NeutrinoSolverConfig
+{
+  double w_mass = 80379.0; // MeV
+};
+
+// Which root a candidate took. With two real roots the one of smaller |pz| is kept.
+enum class NeutrinoSolution : std::uint8_t
+{
+  Plus, // centre + root
+  Minus, // centre - root
+  Complex // No real root: both share the real part, which is kept
+};
+
+// Entry i solves lepton i. Setting the neutrino pT to the MET and requiring
+// (lepton + neutrino)^2 = m_W^2 leaves a quadratic in pz with roots centre +- root.
+struct NeutrinoSolutions
+{
+  std::vector<double> pz_plus;
+  std::vector<double> pz_minus;
+  std::vector<double> pz; // The chosen root
+  std::vector<NeutrinoSolution> solution;
+
+  std::size_t size() const { return pz.size(); }
+  void resize(std::size_t count)
+  {
+    pz_plus.resize(count);
+    pz_minus.resize(count);
+    pz.resize(count);
+    solution.resize(count);
+  }
+  void clear() { resize(0); }
+};
+
+// Solves lepton i with missing momentum (met_x[i], met_y[i]). The AVX2 and AVX-512
+// kernels select with masks instead of branching and give the scalar results bit for
+// bit. A lepton with E = |pz| (no transverse momentum and no mass) gives NaN or
+// infinity. Like the other functions here, throws std::invalid_argument unless
+// config.w_mass > 0.
+void solve_neutrino_pz(const MomentumColumns& leptons, const double* met_x, const double* met_y, NeutrinoSolutions& out,
+                       const NeutrinoSolverConfig& config = NeutrinoSolverConfig());
+
+// The chosen neutrino for one Lepton object: massless, with pT equal to the MET and the
+// flavor of the lepton. Throws std::invalid_argument unless lepton is an electron or muon.
+Neutrino make_neutrino_candidate(const Lepton& lepton, double met_x, double met_y, NeutrinoSolution* solution = nullptr,
+                                 const NeutrinoSolverConfig& config = NeutrinoSolverConfig());
+
+// One W candidate per event that has an electron or muon: its leading one, by pT,
+// paired with the event's missing transverse momentum
+struct WCandidates
+{
+  std::vector<std::uint32_t> event;
+  std::vector<std::uint32_t> lepton; // Row of the charged lepton in its event
+  NeutrinoSolutions solutions;
+  ParticleStore neutrinos; // Row i is candidate i's chosen neutrino
+
+  std::size_t size() const { return event.size(); }
+  void clear()
+  {
+    event.clear();
+    lepton.clear();
+    solutions.clear();
+    neutrinos.clear();
+  }
+};
+
+// Gathers the candidates of a whole sample into scratch columns, kept between calls,
+// and solves them in one batch.
+//
+// Not thread-safe: use one instance per thread.
+class NeutrinoReconstruction
+{
+private:
+  NeutrinoSolverConfig config;
+
+  std::vector<double> energy;
+  std::vector<double> px;
+  std::vector<double> py;
+  std::vector<double> pz;
+  std::vector<double> met_x;
+  std::vector<double> met_y;
+  std::vector<NeutrinoFlavor> flavor;
+
+public:
+  explicit NeutrinoReconstruction(const NeutrinoSolverConfig& config = NeutrinoSolverConfig()); // Throws std::invalid_argument unless w_mass > 0
+
+  const NeutrinoSolverConfig& get_config() const { return config; }
+
+  // Replaces out with the candidates of events, taking the MET of events[i] from
+  // summaries[i]. Candidates whose neutrino gets no finite, positive energy, as from
+  // a lepton with E = |pz|, are left out. Throws std::invalid_argument if the
+  // sizes differ.
+  std::size_t reconstruct(const std::vector<ParticleStore>& events, const std::vector<EventSummary>& summaries, WCandidates& out);
+};
+
+#endif
@@ -0,0 +1,380 @@
+// Description: Double-to-text conversions for the exporters: the shortest text that reads back exactly, and fixed decimals.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "NumberFormat.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  __extension__ using uint128 = unsigned __int128;
+
+  constexpr std::array<std::uint64_t, 20> powers_of_ten = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+                                                           100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+                                                           1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+                                                           1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+                                                           1000000000000000000ULL, 10000000000000000000ULL};
+
+  constexpr char digit_pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                 "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                 "8081828384858687888990919293949596979899";
+
+  // Decimal digits in value (at least one), from its bit length without a loop
+  int count_digits(std::uint64_t value)
+  {
+    value |= 1; // Leaves every power-of-ten threshold in place
+    int guess = ((64 - __builtin_clzll(value)) * 1233) >> 12; // floor(log10(2^bits)); 1233 / 4096 ~ log10(2)
+    return guess + (value >= powers_of_ten[guess]);
+  }
+
+  // The eight digits of value < 10^8, zero-padded. On little-endian machines all eight
+  // are split at once in 16-bit lanes of one register: halves, then pairs, then digits.
+  void put_8_digits(char* out, std::uint32_t value)
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    std::uint64_t halves = (value / 10000) | (static_cast<std::uint64_t>(value % 10000) << 32);
+    std::uint64_t hundreds = ((halves * 10486) >> 20) & 0x0000007F0000007FULL; // x * 10486 >> 20 is x / 100 below 10^4
+    std::uint64_t pairs = (halves - 100 * hundreds) << 16 | hundreds;
+    std::uint64_t tens = ((pairs * 103) >> 10) & 0x000F000F000F000FULL; // x * 103 >> 10 is x / 10 below 100
+    std::uint64_t digits = ((pairs - 10 * tens) << 8 | tens) + 0x3030303030303030ULL;
+    std::memcpy(out, &digits, 8);
+#else
+    for (int pair = 3; pair >= 0; --pair, value /= 100)
+    {
+      std::memcpy(out + 2 * pair, digit_pairs + 2 * (value % 100), 2);
+    }
+#endif
+  }
+
+  // The seventeen digits of value < 10^17, zero-padded
+  void put_17_digits(char* out, std::uint64_t value)
+  {
+    std::uint64_t high = value / 100000000;
+    put_8_digits(out + 9, static_cast<std::uint32_t>(value - high * 100000000));
+    put_8_digits(out + 1, static_cast<std::uint32_t>(high % 100000000));
+    out[0] = static_cast<char>('0' + high / 100000000);
+  }
+
+  // Fixed-size copies: callers leave number_room bytes free, so these may run past the text
+  void copy_24(char* to, const char* from) { std::memcpy(to, from, 24); }
+
+  // Schubfach. A double is c * 2^q; its rounding interval, scaled by 10^-k and 4, is
+  // computed with a 126-bit approximation g of 10^-k, and the shortest decimal is
+  // picked from the few candidates the interval can hold.
+  constexpr int k_min = -324;
+  constexpr int k_max = 292;
+  constexpr std::uint64_t hidden_bit = 1ULL << 52;
+  constexpr int q_min = -1074;
+  constexpr std::uint64_t low_63_bits = (1ULL << 63) - 1;
+
+  // floor(q log10 2), floor(log10(3/4 2^q)) and floor(e log2 10), exact over the double range
+  int floor_log10_pow2(int q) { return static_cast<int>((static_cast<std::int64_t>(q) * 661971961083LL) >> 41); }
+  int floor_log10_three_quarters_pow2(int q) { return static_cast<int>((static_cast<std::int64_t>(q) * 661971961083LL - 274743187321LL) >> 41); }
+  int floor_log2_pow10(int e) { return static_cast<int>((static_cast<std::int64_t>(e) * 913124641741LL) >> 38); }
+
+  struct PowerOfTen
+  {
+    std::uint64_t high; // g = high * 2^63 + low, with 2^125 <= g < 2^126
+    std::uint64_t low;
+  };
+
+  // Non-negative integer in 32-bit words, least significant first; just enough to build the table
+  class BigInteger
+  {
+  private:
+    std::vector<std::uint32_t> words;
+
+  public:
+    explicit BigInteger(int power_of_two) : words(static_cast<std::size_t>(power_of_two / 32 + 1), 0)
+    {
+      words.back() = 1u << (power_of_two % 32);
+    }
+
+    void multiply(std::uint32_t factor)
+    {
+      std::uint64_t carry = 0;
+      for (std::uint32_t& word : words)
+      {
+        std::uint64_t product = static_cast<std::uint64_t>(word) * factor + carry;
+        word = static_cast<std::uint32_t>(product);
+        carry = product >> 32;
+      }
+      if (carry != 0)
+      {
+        words.push_back(static_cast<std::uint32_t>(carry));
+      }
+    }
+
+    void divide(std::uint32_t divisor) // Rounds down; floor(floor(x / a) / b) = floor(x / ab)
+    {
+      std::uint64_t remainder = 0;
+      for (std::size_t i = words.size(); i-- > 0;)
+      {
+        std::uint64_t value = remainder << 32 | words[i];
+        words[i] = static_cast<std::uint32_t>(value / divisor);
+        remainder = value % divisor;
+      }
+    }
+
+    uint128 bits(int shift) const // floor(x / 2^shift) mod 2^128, for shift >= 0
+    {
+      uint128 result = 0;
+      for (int bit = shift + 127; bit >= shift; --bit)
+      {
+        std::size_t word = static_cast<std::size_t>(bit / 32);
+        result = result << 1 | (word < words.size() ? (words[word] >> (bit % 32)) & 1 : 0);
+      }
+      return result;
+    }
+  };
+
+  // g(k) = floor(10^-k 2^(125 - floor_log2_pow10(-k))) + 1, built once, exactly
+  struct PowerTable
+  {
+    std::array<PowerOfTen, k_max - k_min + 1> powers;
+
+    PowerTable()
+    {
+      for (int k = k_min; k <= k_max; ++k)
+      {
+        int shift = 125 - floor_log2_pow10(-k);
+        uint128 g;
+        if (k <= 0)
+        {
+          BigInteger power(0);
+          for (int i = 0; i < -k; ++i)
+          {
+            power.multiply(10);
+          }
+          g = shift >= 0 ? power.bits(0) << shift : power.bits(-shift);
+        }
+        else
+        {
+          BigInteger power(shift);
+          for (int i = 0; i < k; ++i)
+          {
+            power.divide(10);
+          }
+          g = power.bits(0);
+        }
+        g += 1;
+        powers[static_cast<std::size_t>(k - k_min)] = PowerOfTen{static_cast<std::uint64_t>(g >> 63), static_cast<std::uint64_t>(g) & low_63_bits};
+      }
+    }
+  };
+
+  const PowerOfTen& power_of_ten(int k)
+  {
+    static const PowerTable table;
+    return table.powers[static_cast<std::size_t>(k - k_min)];
+  }
+
+  std::uint64_t multiply_high(std::uint64_t a, std::uint64_t b)
+  {
+    return static_cast<std::uint64_t>(static_cast<uint128>(a) * b >> 64);
+  }
+
+  // g * cp / 2^127, rounded to odd
+  std::uint64_t round_to_odd(const PowerOfTen& g, std::uint64_t cp)
+  {
+    std::uint64_t x1 = multiply_high(g.low, cp);
+    std::uint64_t y0 = g.high * cp;
+    std::uint64_t y1 = multiply_high(g.high, cp);
+    std::uint64_t z = (y0 >> 1) + x1;
+    std::uint64_t vbp = y1 + (z >> 63);
+    return vbp | (((z & low_63_bits) + low_63_bits) >> 63);
+  }
+
+  struct Decimal
+  {
+    std::uint64_t digits; // value = digits * 10^exponent
+    int exponent;
+  };
+
+  Decimal to_decimal(int q, std::uint64_t c)
+  {
+    std::uint64_t out = c & 1; // Odd significands exclude the interval's ends
+    std::uint64_t cb = c << 2;
+    std::uint64_t cbr = cb + 2;
+    std::uint64_t cbl;
+    int k;
+    if (c != hidden_bit || q == q_min)
+    {
+      cbl = cb - 2;
+      k = floor_log10_pow2(q);
+    }
+    else
+    {
+      cbl = cb - 1; // A power of two: the gap below is half the gap above
+      k = floor_log10_three_quarters_pow2(q);
+    }
+    int h = q + floor_log2_pow10(-k) + 2;
+    const PowerOfTen& g = power_of_ten(k);
+    std::uint64_t vb = round_to_odd(g, cb << h);
+    std::uint64_t vbl = round_to_odd(g, cbl << h);
+    std::uint64_t vbr = round_to_odd(g, cbr << h);
+
+    std::uint64_t s = vb >> 2;
+    if (s >= 10) // One digit fewer, if exactly one multiple of ten is inside the interval
+    {
+      std::uint64_t sp10 = s / 10 * 10;
+      std::uint64_t tp10 = sp10 + 10;
+      bool lower_inside = vbl + out <= sp10 << 2;
+      bool upper_inside = (tp10 << 2) + out <= vbr;
+      if (lower_inside != upper_inside)
+      {
+        return Decimal{lower_inside ? sp10 : tp10, k};
+      }
+    }
+    std::uint64_t t = s + 1;
+    bool lower_inside = vbl + out <= s << 2;
+    bool upper_inside = (t << 2) + out <= vbr;
+    if (lower_inside != upper_inside)
+    {
+      return Decimal{lower_inside ? s : t, k};
+    }
+    // Both inside: the closer one, and the even one on a tie
+    std::int64_t distance = static_cast<std::int64_t>(vb - ((s + t) << 1));
+    return Decimal{distance < 0 || (distance == 0 && (s & 1) == 0) ? s : t, k};
+  }
+}
+
+char* format_unsigned(char* out, unsigned long long value)
+{
+  char digits[48];
+  int count = count_digits(value);
+  if (value < powers_of_ten[17])
+  {
+    put_17_digits(digits, value);
+    copy_24(out, digits + 17 - count);
+    return out + count;
+  }
+  return std::to_chars(out, out + number_room, value).ptr;
+}
+
+char* format_shortest(char* out, double value)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  int biased_exponent = static_cast<int>(bits >> 52) & 0x7FF;
+  if (biased_exponent == 0 || biased_exponent == 0x7FF)
+  {
+    return std::to_chars(out, out + number_room, value).ptr;
+  }
+  if (bits >> 63)
+  {
+    *out++ = '-';
+  }
+  std::uint64_t c = hidden_bit | (bits & (hidden_bit - 1));
+  int q = biased_exponent - 1075;
+  bool integer = q < 0 && q > -53 && (c & ((1ULL << -q) - 1)) == 0; // Below 2^53, so its digits are exact
+  Decimal decimal = integer ? Decimal{c >> -q, 0} : to_decimal(q, c);
+  while (decimal.digits % 10 == 0)
+  {
+    decimal.digits /= 10;
+    ++decimal.exponent;
+  }
+
+  // std::to_chars picks the shorter of %f and %e style, and %f on a tie
+  int count = count_digits(decimal.digits);
+  int e = decimal.exponent;
+  int scientific_exponent = e + count - 1;
+  int scientific_length = count + (count > 1) + 2 + (scientific_exponent >= 100 || scientific_exponent <= -100 ? 3 : 2);
+  int fixed_length = e >= 0 ? count + e : count + e > 0 ? count + 1 : 2 - e;
+
+  char digits[48];
+  put_17_digits(digits, decimal.digits);
+  const char* first = digits + 17 - count;
+  if (fixed_length <= scientific_length)
+  {
+    if (e >= 0)
+    {
+      if (e > 0 && !integer)
+      {
+        return std::to_chars(out, out + number_room, std::abs(value)).ptr; // libstdc++ writes every digit of these
+      }
+      copy_24(out, first);
+      std::memset(out + count, '0', static_cast<std::size_t>(e));
+      return out + count + e;
+    }
+    if (count + e > 0)
+    {
+      int whole = count + e;
+      copy_24(out, first);
+      out[whole] = '.';
+      copy_24(out + whole + 1, first + whole);
+      return out + count + 1;
+    }
+    out[0] = '0';
+    out[1] = '.';
+    std::memset(out + 2, '0', static_cast<std::size_t>(-e - count));
+    copy_24(out + 2 - e - count, first);
+    return out + 2 - e;
+  }
+
+  out[0] = first[0];
+  if (count > 1)
+  {
+    out[1] = '.';
+    copy_24(out + 2, first + 1);
+    out += count + 1;
+  }
+  else
+  {
+    out += 1;
+  }
+  *out++ = 'e';
+  *out++ = scientific_exponent < 0 ? '-' : '+';
+  int magnitude = std::abs(scientific_exponent);
+  if (magnitude >= 100)
+  {
+    *out++ = static_cast<char>('0' + magnitude / 100);
+    magnitude %= 100;
+  }
+  std::memcpy(out, digit_pairs + 2 * magnitude, 2);
+  return out + 2;
+}
+
+char* format_fixed(char* out, double value, int decimals)
+{
+  double scaled = value * static_cast<double>(powers_of_ten[static_cast<std::size_t>(decimals)]);
+  if (!(std::abs(scaled) < 9.0e15))
+  {
+    return format_shortest(out, value);
+  }
+  double magnitude = std::abs(scaled);
+  std::uint64_t units = static_cast<std::uint64_t>(magnitude);
+  units += magnitude - static_cast<double>(units) >= 0.5; // Exact: both terms are below 2^53
+  if (units != 0 && scaled < 0)
+  {
+    *out++ = '-';
+  }
+  char digits[48];
+  const char* end = digits + 17;
+  if (units < 100000000 && decimals < 8)
+  {
+    put_8_digits(digits, static_cast<std::uint32_t>(units)); // Most values; half the work
+    end = digits + 8;
+  }
+  else
+  {
+    put_17_digits(digits, units);
+  }
+  int count = std::max(count_digits(units), decimals + 1); // Leading zeros up to "0."
+  const char* first = end - count;
+  int whole = count - decimals;
+  copy_24(out, first);
+  if (decimals == 0)
+  {
+    return out + whole;
+  }
+  out[whole] = '.';
+  copy_24(out + whole + 1, first + whole);
+  return out + count + 1;
+}
@@ -0,0 +1,31 @@
+// Description: Double-to-text conversions for the exporters: the shortest text that reads back exactly, and fixed decimals.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <cstddef>
+
+// Bytes each function needs free at out. The text is at most 24 characters; the rest
+// lets digits be moved with fixed-size copies that may run past its end.
+constexpr std::size_t number_room = 48;
+
+// Writes exactly what std::to_chars(out, out + number_room, value) would: the
+// shortest decimal that reads back as value, in fixed or scientific notation,
+// whichever is shorter. Finite nonzero normal values are converted with Schubfach
+// (R. Giulietti, "The Schubfach way to render doubles"), about twice as fast as
+// libstdc++'s Ryu. Zero, subnormals, infinities, NaN and the integers above 2^53 that
+// libstdc++ prints digit for digit are handed to std::to_chars.
+char* format_shortest(char* out, double value);
+
+// value * 10^decimals rounded half away from zero, written with decimals (0-9) digits
+// after the point. Within an ulp of a tie the result can end one unit in the last
+// place away from printf's. Magnitudes of 9e15 / 10^decimals and above, infinities
+// and NaN go to the shortest form.
+char* format_fixed(char* out, double value, int decimals);
+
+// Decimal digits of an integer, without a sign
+char* format_unsigned(char* out, unsigned long long value);
+
+#endif
@@ -0,0 +1,142 @@
+// Description: Conversions to the std::variant Particle representation and the algorithms that run over whole events of it.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Particle.h"
+#include "ParticleStore.h"
+#include <stdexcept>
+
+namespace
+{
+  // Tau i of particles takes over the products of sources[i], each product pointing
+  // at the particle whose source it was
+  void link_products(std::vector<Particle>& particles, const std::vector<const Lepton*>& sources)
+  {
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+      Tau* tau = std::get_if<Tau>(&particles[i]);
+      if (tau == nullptr)
+      {
+        continue;
+      }
+      tau->clear_decay_products();
+      for (const Lepton* product : static_cast<const Tau*>(sources[i])->get_decay_products())
+      {
+        for (std::size_t j = 0; j < sources.size(); ++j)
+        {
+          if (sources[j] == product)
+          {
+            tau->add_decay_product(&as_lepton(particles[j]));
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+std::vector<Particle> make_particles(const Lepton* const* particles, std::size_t count)
+{
+  std::vector<Particle> result;
+  result.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const Lepton& particle = *particles[i];
+    switch (particle.get_type_id())
+    {
+      case ParticleType::Electron: result.emplace_back(static_cast<const Electron&>(particle)); break;
+      case ParticleType::Muon: result.emplace_back(static_cast<const Muon&>(particle)); break;
+      case ParticleType::Tau: result.emplace_back(static_cast<const Tau&>(particle)); break;
+      case ParticleType::Neutrino: result.emplace_back(static_cast<const Neutrino&>(particle)); break;
+      case ParticleType::TauNeutrino: result.emplace_back(static_cast<const TauNeutrino&>(particle)); break;
+      default: throw std::invalid_argument("Unsupported particle type: " + particle.get_particle_type());
+    }
+  }
+  link_products(result, std::vector<const Lepton*>(particles, particles + count));
+  return result;
+}
+
+std::vector<Particle> make_particles(const ParticleStore& store)
+{
+  std::vector<Particle> result;
+  result.reserve(store.size());
+  for (ParticleView view : store)
+  {
+    switch (view.get_type())
+    {
+      case ParticleType::Electron:
+        result.emplace_back(Electron(view.get_rest_mass(), view.get_charge(), view.get_e(), view.get_px(), view.get_py(), view.get_pz(),
+                                     view.get_layer_energies()));
+        break;
+      case ParticleType::Muon:
+        result.emplace_back(Muon(view.get_rest_mass(), view.get_charge(), view.get_e(), view.get_px(), view.get_py(), view.get_pz(),
+                                 view.get_isolated()));
+        break;
+      case ParticleType::Tau:
+        result.emplace_back(Tau(view.get_rest_mass(), view.get_charge(), view.get_e(), view.get_px(), view.get_py(), view.get_pz(),
+                                view.get_decay_mode()));
+        break;
+      case ParticleType::Neutrino:
+        result.emplace_back(Neutrino(view.get_rest_mass(), view.get_charge(), view.get_e(), view.get_px(), view.get_py(), view.get_pz(),
+                                     view.get_flavor(), view.get_has_interacted()));
+        break;
+      case ParticleType::TauNeutrino:
+        result.emplace_back(TauNeutrino(view.get_rest_mass(), view.get_charge(), view.get_e(), view.get_px(), view.get_py(),
+                                        view.get_pz(), view.get_has_interacted()));
+        break;
+    }
+  }
+
+  // Products may come after their tau, so link once every particle is in place
+  for (ParticleView view : store)
+  {
+    if (view.get_type() == ParticleType::Tau)
+    {
+      Tau& tau = std::get<Tau>(result[view.get_index()]);
+      for (std::size_t product = 0; product < view.get_decay_product_count(); ++product)
+      {
+        tau.add_decay_product(&as_lepton(result[view.get_decay_product(product).get_index()]));
+      }
+    }
+  }
+  return result;
+}
+
+void relink_decay_products(std::vector<Particle>& particles, const std::vector<Particle>& original)
+{
+  if (particles.size() != original.size())
+  {
+    throw std::invalid_argument("Decay products can only be relinked between vectors of the same size");
+  }
+  std::vector<const Lepton*> sources;
+  sources.reserve(original.size());
+  for (const Particle& particle : original)
+  {
+    sources.push_back(&as_lepton(particle));
+  }
+  link_products(particles, sources);
+}
+
+std::size_t detect_particles(const Detector& detector, const std::vector<Particle>& particles)
+{
+  if (!detector.get_status())
+  {
+    return 0;
+  }
+  std::size_t detected = 0;
+  for (const Particle& particle : particles)
+  {
+    detected += Detector::accepts(detector.get_type(), get_type_id(particle));
+  }
+  return detected;
+}
+
+FourMomentum total_momentum(const std::vector<Particle>& particles)
+{
+  FourMomentum total;
+  for (const Particle& particle : particles)
+  {
+    total += as_lepton(particle).get_four_momentum();
+  }
+  return total;
+}
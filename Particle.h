@@ -0,0 +1,101 @@
+// Description: Defines Particle, a std::variant over the closed set of lepton classes, and visit-based algorithms on it.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef PARTICLE_H
+#define PARTICLE_H
+
+#include "Detector.h"
+#include "Electron.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "Tau.h"
+#include "TauNeutrino.h"
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+class ParticleStore;
+
+// Value-semantic particle: one of the five concrete classes held inline, so a
+// std::vector<Particle> keeps an event contiguous with no per-particle allocation.
+// The classes are final, so calls made through std::visit on the concrete type are
+// resolved at compile time instead of through the vtable.
+using Particle = std::variant<Electron, Muon, Tau, Neutrino, TauNeutrino>;
+
+// Adapter for code written against Lepton: every alternative is a Lepton. Written as a
+// switch rather than std::visit because every case yields the same address, which the
+// compiler folds into one predictable branch; std::visit keeps a data-dependent jump.
+inline const Lepton& as_lepton(const Particle& particle)
+{
+  switch (particle.index())
+  {
+    case 0: return *std::get_if<0>(&particle);
+    case 1: return *std::get_if<1>(&particle);
+    case 2: return *std::get_if<2>(&particle);
+    case 3: return *std::get_if<3>(&particle);
+    case 4: return *std::get_if<4>(&particle);
+  }
+  throw std::bad_variant_access(); // Valueless after an exception during assignment
+}
+
+inline Lepton& as_lepton(Particle& particle)
+{
+  return const_cast<Lepton&>(as_lepton(static_cast<const Particle&>(particle)));
+}
+
+// Copies of the given objects, element i from particles[i]. Tau decay products are
+// relinked to the copies; products not in the array are dropped. Throws
+// std::invalid_argument for a class outside the closed set.
+std::vector<Particle> make_particles(const Lepton* const* particles, std::size_t count);
+// Builds the particles of an event directly from its columns, as ParticleStore::materialize
+std::vector<Particle> make_particles(const ParticleStore& store);
+// Tau products point into the vector, so after it is copied or has grown they must be
+// linked again, e.g. with this
+void relink_decay_products(std::vector<Particle>& particles, const std::vector<Particle>& original);
+
+// Algorithms
+inline ParticleType get_type_id(const Particle& particle)
+{
+  return std::visit([](const auto& lepton) { return std::decay_t<decltype(lepton)>::static_type_id; }, particle);
+}
+
+// Same text as get_particle_type(), without building a std::string
+inline const char* get_particle_type_name(const Particle& particle)
+{
+  return std::visit([](const auto& lepton)
+  {
+    using Type = std::decay_t<decltype(lepton)>;
+    if constexpr (std::is_same_v<Type, Neutrino>)
+    {
+      return particle_type_name(Type::static_type_id, lepton.get_flavor());
+    }
+    else
+    {
+      return particle_type_name(Type::static_type_id);
+    }
+  }, particle);
+}
+
+inline void print_info(const Particle& particle)
+{
+  std::visit([](const auto& lepton) { lepton.print_info(); }, particle);
+}
+
+// As Detector::detect_particle, without the per-particle log line
+inline int detect_particle(const Detector& detector, const Particle& particle)
+{
+  return detector.get_status() && Detector::accepts(detector.get_type(), get_type_id(particle)) ? 1 : 0;
+}
+
+std::size_t detect_particles(const Detector& detector, const std::vector<Particle>& particles);
+
+// Kinematics live in the Lepton base, so these need no dispatch at all
+inline const CachedFourMomentum& get_kinematics(const Particle& particle)
+{
+  return as_lepton(particle).get_kinematics();
+}
+
+FourMomentum total_momentum(const std::vector<Particle>& particles); // Summed in order, as repeated operator+=
+
+#endif
@@ -0,0 +1,355 @@
+// Description: Defines the ParticleStore class, a structure-of-arrays container for the particles of an event.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "ParticleStore.h"
+#include "Electron.h"
+#include "MomentumKernels.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "Tau.h"
+#include "TauNeutrino.h"
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+// ParticleView: common columns
+double ParticleView::get_rest_mass() const { return store->mass[index]; }
+int ParticleView::get_charge() const { return store->charge[index]; }
+double ParticleView::get_e() const { return store->energy[index]; }
+double ParticleView::get_px() const { return store->px[index]; }
+double ParticleView::get_py() const { return store->py[index]; }
+double ParticleView::get_pz() const { return store->pz[index]; }
+ParticleType ParticleView::get_type() const { return store->type[index]; }
+
+FourMomentum ParticleView::get_four_momentum() const
+{
+  return FourMomentum(store->energy[index], store->px[index], store->py[index], store->pz[index]);
+}
+
+std::string ParticleView::get_particle_type() const
+{
+  ParticleType particle_type = get_type();
+  if (particle_type == ParticleType::Neutrino)
+  {
+    return particle_type_name(particle_type, get_flavor());
+  }
+  return particle_type_name(particle_type);
+}
+
+// ParticleView: side columns
+std::array<double, 4> ParticleView::get_layer_energies() const
+{
+  return store->electron_layers[store->extra_for(index, ParticleType::Electron)];
+}
+
+bool ParticleView::get_isolated() const
+{
+  return store->muon_isolated[store->extra_for(index, ParticleType::Muon)] != 0;
+}
+
+NeutrinoFlavor ParticleView::get_flavor() const
+{
+  return store->neutrino_flavor[store->extra_for(index, ParticleType::Neutrino)];
+}
+
+bool ParticleView::get_has_interacted() const
+{
+  if (get_type() == ParticleType::TauNeutrino)
+  {
+    return store->tau_neutrino_interacted[store->extra_index[index]] != 0;
+  }
+  return store->neutrino_interacted[store->extra_for(index, ParticleType::Neutrino)] != 0;
+}
+
+TauDecayMode ParticleView::get_decay_mode() const
+{
+  return store->tau_decay_mode[store->extra_for(index, ParticleType::Tau)];
+}
+
+std::size_t ParticleView::get_decay_product_count() const
+{
+  return store->tau_product_count[store->extra_for(index, ParticleType::Tau)];
+}
+
+ParticleView ParticleView::get_decay_product(std::size_t product) const
+{
+  ParticleStore::Index tau = store->extra_for(index, ParticleType::Tau);
+  if (product >= store->tau_product_count[tau])
+  {
+    throw std::out_of_range("Decay product index out of range");
+  }
+  return ParticleView(*store, store->tau_products[tau][product]);
+}
+
+// Same layout as Lepton::print_info, with the subclass fields appended
+void ParticleView::print_info() const
+{
+  std::cout << "Particle Type: " << get_particle_type()
+            << "\nRest Mass (MeV): " << get_rest_mass()
+            << "\nCharge: " << get_charge()
+            << "\nEnergy (MeV): " << get_e()
+            << "\nMomentum px (MeV/c): " << get_px()
+            << "\nMomentum py (MeV/c): " << get_py()
+            << "\nMomentum pz (MeV/c): " << get_pz() << '\n';
+  if (get_type() == ParticleType::Electron)
+  {
+    std::cout << "Calorimeter Layers: [";
+    for (const auto& layer : get_layer_energies())
+    {
+      std::cout << layer << " ";
+    }
+    std::cout << "]\n";
+  }
+}
+
+// ParticleStore
+void ParticleStore::reserve(std::size_t particles)
+{
+  energy.reserve(particles);
+  px.reserve(particles);
+  py.reserve(particles);
+  pz.reserve(particles);
+  mass.reserve(particles);
+  charge.reserve(particles);
+  type.reserve(particles);
+  extra_index.reserve(particles);
+}
+
+void ParticleStore::clear()
+{
+  energy.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  mass.clear();
+  charge.clear();
+  type.clear();
+  extra_index.clear();
+  electron_layers.clear();
+  muon_isolated.clear();
+  neutrino_flavor.clear();
+  neutrino_interacted.clear();
+  tau_neutrino_interacted.clear();
+  tau_decay_mode.clear();
+  tau_products.clear();
+  tau_product_count.clear();
+  drop_kinematics();
+}
+
+ParticleStore::Index ParticleStore::push_common(ParticleType particle_type, double rest_mass, int particle_charge,
+                                                double e, double momentum_x, double momentum_y, double momentum_z,
+                                                std::size_t extra)
+{
+  if (size() >= std::numeric_limits<Index>::max())
+  {
+    throw std::length_error("ParticleStore is full");
+  }
+  if (!(e > 0)) // NaN fails too
+  {
+    throw std::invalid_argument("Energy must be greater than 0"); // Checked here so every add_* validates alike
+  }
+  energy.push_back(e);
+  px.push_back(momentum_x);
+  py.push_back(momentum_y);
+  pz.push_back(momentum_z);
+  mass.push_back(rest_mass);
+  charge.push_back(static_cast<std::int8_t>(particle_charge));
+  type.push_back(particle_type);
+  extra_index.push_back(static_cast<Index>(extra));
+  return static_cast<Index>(size() - 1);
+}
+
+ParticleStore::Index ParticleStore::extra_for(Index particle, ParticleType expected) const
+{
+  if (type[particle] != expected)
+  {
+    throw std::invalid_argument(std::string("Particle is not of type ") + particle_type_name(expected));
+  }
+  return extra_index[particle];
+}
+
+ParticleStore::Index ParticleStore::add_electron(double mass, int charge, double energy, double px, double py, double pz,
+                                                 const std::array<double, 4>& layers)
+{
+  Index particle = push_common(ParticleType::Electron, mass, charge, energy, px, py, pz, electron_layers.size());
+  electron_layers.push_back(layers);
+  return particle;
+}
+
+ParticleStore::Index ParticleStore::add_muon(double mass, int charge, double energy, double px, double py, double pz, bool isolated)
+{
+  Index particle = push_common(ParticleType::Muon, mass, charge, energy, px, py, pz, muon_isolated.size());
+  muon_isolated.push_back(isolated);
+  return particle;
+}
+
+ParticleStore::Index ParticleStore::add_neutrino(double mass, int charge, double energy, double px, double py, double pz,
+                                                 NeutrinoFlavor flavor, bool interacted)
+{
+  Index particle = push_common(ParticleType::Neutrino, mass, charge, energy, px, py, pz, neutrino_flavor.size());
+  neutrino_flavor.push_back(flavor);
+  neutrino_interacted.push_back(interacted);
+  return particle;
+}
+
+ParticleStore::Index ParticleStore::add_tau_neutrino(double mass, int charge, double energy, double px, double py, double pz, bool interacted)
+{
+  Index particle = push_common(ParticleType::TauNeutrino, mass, charge, energy, px, py, pz, tau_neutrino_interacted.size());
+  tau_neutrino_interacted.push_back(interacted);
+  return particle;
+}
+
+ParticleStore::Index ParticleStore::add_tau(double mass, int charge, double energy, double px, double py, double pz, TauDecayMode mode)
+{
+  Index particle = push_common(ParticleType::Tau, mass, charge, energy, px, py, pz, tau_decay_mode.size());
+  tau_decay_mode.push_back(mode);
+  tau_products.push_back({});
+  tau_product_count.push_back(0);
+  return particle;
+}
+
+void ParticleStore::add_decay_product(Index tau, Index product)
+{
+  Index row = extra_for(tau, ParticleType::Tau);
+  if (product >= size())
+  {
+    throw std::out_of_range("Decay product index out of range");
+  }
+  if (tau_decay_mode[row] != TauDecayMode::Leptonic)
+  {
+    return;
+  }
+  if (tau_product_count[row] == max_tau_decay_products)
+  {
+    throw std::invalid_argument("Tau already holds the maximum number of decay products");
+  }
+  tau_products[row][tau_product_count[row]++] = product;
+}
+
+ParticleStore::Index ParticleStore::add(const Lepton& particle)
+{
+  const FourMomentum& p = particle.get_four_momentum();
+  double rest_mass = particle.get_rest_mass();
+  int particle_charge = particle.get_charge();
+
+  switch (particle.get_type_id())
+  {
+    case ParticleType::Electron:
+      return add_electron(rest_mass, particle_charge, p.get_energy(), p.get_px(), p.get_py(), p.get_pz(),
+                          static_cast<const Electron&>(particle).get_layer_energies());
+    case ParticleType::Muon:
+      return add_muon(rest_mass, particle_charge, p.get_energy(), p.get_px(), p.get_py(), p.get_pz(),
+                      static_cast<const Muon&>(particle).get_isolated());
+    case ParticleType::Neutrino:
+    {
+      const auto& neutrino = static_cast<const Neutrino&>(particle);
+      return add_neutrino(rest_mass, particle_charge, p.get_energy(), p.get_px(), p.get_py(), p.get_pz(),
+                          neutrino.get_flavor(), neutrino.get_has_interacted());
+    }
+    case ParticleType::TauNeutrino:
+      return add_tau_neutrino(rest_mass, particle_charge, p.get_energy(), p.get_px(), p.get_py(), p.get_pz(),
+                              static_cast<const TauNeutrino&>(particle).getHasInteracted());
+    case ParticleType::Tau:
+    {
+      const auto& tau = static_cast<const Tau&>(particle);
+      Index tau_index = add_tau(rest_mass, particle_charge, p.get_energy(), p.get_px(), p.get_py(), p.get_pz(), tau.get_decay_mode());
+      for (const auto& product : tau.get_decay_products())
+      {
+        add_decay_product(tau_index, add(*product));
+      }
+      return tau_index;
+    }
+  }
+  throw std::invalid_argument("Unsupported particle type: " + particle.get_particle_type());
+}
+
+ArenaSpan<Lepton*> ParticleStore::materialize(EventArena& arena) const
+{
+  ArenaSpan<Lepton*> particles = arena.allocate_array<Lepton*>(size());
+  for (Index i = 0; i < size(); ++i)
+  {
+    Index extra = extra_index[i];
+    switch (type[i])
+    {
+      case ParticleType::Electron:
+        particles[i] = arena.create<Electron>(mass[i], charge[i], energy[i], px[i], py[i], pz[i], electron_layers[extra]);
+        break;
+      case ParticleType::Muon:
+        particles[i] = arena.create<Muon>(mass[i], charge[i], energy[i], px[i], py[i], pz[i], muon_isolated[extra] != 0);
+        break;
+      case ParticleType::Neutrino:
+        particles[i] = arena.create<Neutrino>(mass[i], charge[i], energy[i], px[i], py[i], pz[i],
+                                              neutrino_flavor[extra], neutrino_interacted[extra] != 0);
+        break;
+      case ParticleType::TauNeutrino:
+        particles[i] = arena.create<TauNeutrino>(mass[i], charge[i], energy[i], px[i], py[i], pz[i], tau_neutrino_interacted[extra] != 0);
+        break;
+      case ParticleType::Tau:
+        particles[i] = arena.create<Tau>(mass[i], charge[i], energy[i], px[i], py[i], pz[i], tau_decay_mode[extra]);
+        break;
+    }
+  }
+
+  if (has_kinematics())
+  {
+    for (Index i = 0; i < size(); ++i)
+    {
+      particles[i]->four_momentum.prime(kinematic_pt[i], kinematic_eta[i], kinematic_phi[i], kinematic_mass[i]);
+    }
+  }
+
+  // Products may come after their tau, so link once every object exists
+  for (Index i = 0; i < size(); ++i)
+  {
+    if (type[i] == ParticleType::Tau)
+    {
+      auto* tau = static_cast<Tau*>(particles[i]);
+      Index extra = extra_index[i];
+      for (std::uint8_t product = 0; product < tau_product_count[extra]; ++product)
+      {
+        tau->add_decay_product(particles[tau_products[extra][product]]);
+      }
+    }
+  }
+  return particles;
+}
+
+void ParticleStore::set_four_momentum(Index particle, double e, double momentum_x, double momentum_y, double momentum_z)
+{
+  if (!(e > 0))
+  {
+    throw std::invalid_argument("Energy must be greater than 0");
+  }
+  energy[particle] = e;
+  px[particle] = momentum_x;
+  py[particle] = momentum_y;
+  pz[particle] = momentum_z;
+  drop_kinematics();
+}
+
+void ParticleStore::precompute_kinematics()
+{
+  kinematic_pt.resize(size());
+  kinematic_eta.resize(size());
+  kinematic_phi.resize(size());
+  kinematic_mass.resize(size());
+  kinematics_batch(momenta(), MutableKinematicsColumns{kinematic_pt.data(), kinematic_eta.data(), kinematic_phi.data(),
+                                                       kinematic_mass.data(), size()});
+}
+
+// Matches Electron::set_layer_energies: any mismatch with the energy is spread evenly over the layers
+void ParticleStore::set_layer_energies(Index particle, const std::array<double, 4>& layers)
+{
+  auto& stored_layers = electron_layers[extra_for(particle, ParticleType::Electron)];
+  double energy_difference = energy[particle] - std::accumulate(layers.begin(), layers.end(), 0.0);
+  for (std::size_t layer = 0; layer < layers.size(); ++layer)
+  {
+    stored_layers[layer] = layers[layer] + energy_difference / layers.size();
+  }
+}
+
+void ParticleStore::set_isolated(Index particle, bool isolated)
+{
+  muon_isolated[extra_for(particle, ParticleType::Muon)] = isolated;
+}
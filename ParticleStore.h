@@ -0,0 +1,183 @@
+// Description: Defines the ParticleStore class, a structure-of-arrays container for the particles of an event.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef PARTICLESTORE_H
+#define PARTICLESTORE_H
+
+#include "EventArena.h"
+#include "FourMomentum.h"
+#include "MomentumColumns.h"
+#include "ParticleType.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Lepton;
+class ParticleStore;
+
+// Lightweight read-only proxy for one row of a ParticleStore. It mirrors the
+// Lepton getter API so code written against Lepton objects ports over directly.
+class ParticleView
+{
+private:
+  const ParticleStore* store;
+  std::uint32_t index;
+
+public:
+  ParticleView(const ParticleStore& store, std::uint32_t index)
+    : store(&store), index(index)
+  {}
+
+  std::uint32_t get_index() const { return index; }
+
+  // Lepton API
+  double get_rest_mass() const;
+  int get_charge() const;
+  double get_e() const;
+  double get_px() const;
+  double get_py() const;
+  double get_pz() const;
+  FourMomentum get_four_momentum() const;
+  ParticleType get_type() const;
+  std::string get_particle_type() const;
+  std::string get_particle_kind() const
+  {
+    return get_charge() > 0 ? "Antiparticle" : "Particle";
+  }
+  void print_info() const;
+
+  // Subclass-specific fields; each throws std::invalid_argument if the row is of another type
+  std::array<double, 4> get_layer_energies() const; // Electron
+  bool get_isolated() const; // Muon
+  NeutrinoFlavor get_flavor() const; // Neutrino
+  bool get_has_interacted() const; // Neutrino and TauNeutrino
+  TauDecayMode get_decay_mode() const; // Tau
+  std::size_t get_decay_product_count() const; // Tau
+  ParticleView get_decay_product(std::size_t product) const; // Tau
+};
+
+class ParticleStore
+{
+public:
+  using Index = std::uint32_t;
+
+  class const_iterator
+  {
+  private:
+    const ParticleStore* store;
+    Index index;
+
+  public:
+    const_iterator(const ParticleStore* store, Index index) : store(store), index(index) {}
+    ParticleView operator*() const { return ParticleView(*store, index); }
+    const_iterator& operator++() { ++index; return *this; }
+    bool operator==(const const_iterator& other) const { return index == other.index; }
+    bool operator!=(const const_iterator& other) const { return index != other.index; }
+  };
+
+private:
+  // Common columns, one entry per particle
+  std::vector<double> energy;
+  std::vector<double> px;
+  std::vector<double> py;
+  std::vector<double> pz;
+  std::vector<double> mass;
+  std::vector<std::int8_t> charge;
+  std::vector<ParticleType> type;
+  std::vector<Index> extra_index; // Row in the side columns for this particle's type
+
+  // Side columns, one entry per particle of the given type
+  std::vector<std::array<double, 4>> electron_layers; // EM_1, EM_2, HAD_1, HAD_2
+  std::vector<std::uint8_t> muon_isolated;
+  std::vector<NeutrinoFlavor> neutrino_flavor;
+  std::vector<std::uint8_t> neutrino_interacted;
+  std::vector<std::uint8_t> tau_neutrino_interacted;
+  std::vector<TauDecayMode> tau_decay_mode;
+  std::vector<std::array<Index, max_tau_decay_products>> tau_products;
+  std::vector<std::uint8_t> tau_product_count;
+
+  // Derived kinematics from precompute_kinematics(); valid while they have one entry per particle
+  std::vector<double> kinematic_pt;
+  std::vector<double> kinematic_eta;
+  std::vector<double> kinematic_phi;
+  std::vector<double> kinematic_mass;
+
+  void drop_kinematics()
+  {
+    kinematic_pt.clear();
+    kinematic_eta.clear();
+    kinematic_phi.clear();
+    kinematic_mass.clear();
+  }
+
+  Index push_common(ParticleType particle_type, double rest_mass, int particle_charge,
+                    double e, double momentum_x, double momentum_y, double momentum_z, std::size_t extra);
+  Index extra_for(Index particle, ParticleType expected) const;
+
+  friend class ParticleView;
+  friend class EventFileWriter;
+  friend class EventExporter;
+
+public:
+  ParticleStore() = default;
+
+  void reserve(std::size_t particles);
+  void clear(); // Keeps capacity so the store can be reused event after event
+  std::size_t size() const { return type.size(); }
+  bool empty() const { return type.empty(); }
+
+  // Appending particles; each add_* throws std::invalid_argument unless energy > 0
+  Index add_electron(double mass, int charge, double energy, double px, double py, double pz,
+                     const std::array<double, 4>& layers = {0, 0, 0, 0});
+  Index add_muon(double mass, int charge, double energy, double px, double py, double pz, bool isolated = false);
+  Index add_neutrino(double mass, int charge, double energy, double px, double py, double pz,
+                     NeutrinoFlavor flavor, bool interacted = false);
+  Index add_tau_neutrino(double mass, int charge, double energy, double px, double py, double pz, bool interacted = false);
+  Index add_tau(double mass, int charge, double energy, double px, double py, double pz, TauDecayMode mode);
+  void add_decay_product(Index tau, Index product); // Ignored for hadronic taus, as in Tau
+  Index add(const Lepton& particle); // Copies a Lepton object, including any tau decay products
+
+  // Builds a Lepton object for every row inside arena, with tau decay products linked
+  // to the corresponding objects. Element i of the result is row i.
+  ArenaSpan<Lepton*> materialize(EventArena& arena) const;
+
+  // Opt-in bulk pass: pT, eta, phi and mass for every row at once (kinematics_batch).
+  // While they are current, materialize() hands them to the objects' caches. Adding a
+  // particle or changing a momentum makes them stale until the next call.
+  void precompute_kinematics();
+  bool has_kinematics() const { return kinematic_pt.size() == size(); }
+
+  // Updating particles in place
+  void set_four_momentum(Index particle, double energy, double px, double py, double pz);
+  void set_layer_energies(Index particle, const std::array<double, 4>& layers);
+  void set_isolated(Index particle, bool isolated);
+
+  // Proxy access
+  ParticleView operator[](Index particle) const { return ParticleView(*this, particle); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, static_cast<Index>(size())); }
+
+  // Column access for bulk scans
+  const std::vector<double>& energy_column() const { return energy; }
+  const std::vector<double>& px_column() const { return px; }
+  const std::vector<double>& py_column() const { return py; }
+  const std::vector<double>& pz_column() const { return pz; }
+  const std::vector<double>& mass_column() const { return mass; }
+  const std::vector<std::int8_t>& charge_column() const { return charge; }
+  const std::vector<ParticleType>& type_column() const { return type; }
+  MomentumColumns momenta() const { return MomentumColumns{energy.data(), px.data(), py.data(), pz.data(), size()}; }
+  MutableMomentumColumns mutable_momenta() // For in-place batch updates; drops precomputed kinematics
+  {
+    drop_kinematics();
+    return MutableMomentumColumns{energy.data(), px.data(), py.data(), pz.data(), size()};
+  }
+  // Precomputed kinematics; stale unless has_kinematics()
+  const std::vector<double>& pt_column() const { return kinematic_pt; }
+  const std::vector<double>& eta_column() const { return kinematic_eta; }
+  const std::vector<double>& phi_column() const { return kinematic_phi; }
+  const std::vector<double>& kinematic_mass_column() const { return kinematic_mass; } // Invariant mass, not the rest mass column
+};
+
+#endif
@@ -0,0 +1,75 @@
+// Description: Compact identifiers for the particle kinds and their enumerated properties.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef PARTICLETYPE_H
+#define PARTICLETYPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+enum class ParticleType : std::uint8_t { Electron, Muon, Neutrino, TauNeutrino, Tau };
+constexpr std::size_t particle_type_count = 5;
+
+// Bit of a type in the std::uint8_t type masks used by selections
+constexpr std::uint8_t particle_type_bit(ParticleType type)
+{
+  return static_cast<std::uint8_t>(1u << static_cast<unsigned>(type));
+}
+
+enum class NeutrinoFlavor : std::uint8_t { Electron, Muon };
+
+enum class TauDecayMode : std::uint8_t { Hadronic, Leptonic };
+
+// Rest masses in MeV, as used throughout main.cpp
+constexpr double particle_rest_mass(ParticleType type)
+{
+  switch (type)
+  {
+    case ParticleType::Electron: return 0.511;
+    case ParticleType::Muon: return 105.7;
+    case ParticleType::Tau: return 1776.86;
+    case ParticleType::Neutrino:
+    case ParticleType::TauNeutrino: return 0.0;
+  }
+  return 0.0;
+}
+
+// A leptonic tau decays to a charged lepton and two neutrinos; one spare slot is kept
+constexpr std::size_t max_tau_decay_products = 4;
+
+inline NeutrinoFlavor neutrino_flavor_from_string(const std::string& flavor)
+{
+  if (flavor == "electron")
+  {
+    return NeutrinoFlavor::Electron;
+  }
+  if (flavor == "muon")
+  {
+    return NeutrinoFlavor::Muon;
+  }
+  throw std::invalid_argument("Neutrino flavor must be \"electron\" or \"muon\"");
+}
+
+constexpr const char* neutrino_flavor_name(NeutrinoFlavor flavor)
+{
+  return flavor == NeutrinoFlavor::Electron ? "electron" : "muon";
+}
+
+// Names match the strings returned by the classes' get_particle_type()
+constexpr const char* particle_type_name(ParticleType type, NeutrinoFlavor flavor = NeutrinoFlavor::Electron)
+{
+  switch (type)
+  {
+    case ParticleType::Electron: return "Electron";
+    case ParticleType::Muon: return "Muon";
+    case ParticleType::Neutrino: return flavor == NeutrinoFlavor::Electron ? "electron neutrino" : "muon neutrino";
+    case ParticleType::TauNeutrino: return "tau neutrino";
+    case ParticleType::Tau: return "Tau";
+  }
+  return "unknown";
+}
+
+#endif
@@ -0,0 +1,351 @@
+// Description: Defines the Pipeline class, running generation, detector response and analysis as concurrent stages.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Pipeline.h"
+#include "Metrics.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+  using BatchPointer = std::unique_ptr<EventBatch>;
+  using BatchQueue = SpscQueue<BatchPointer>;
+
+  double seconds_since(Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  // Spin briefly, then yield, then sleep, so waiting threads give the cores back
+  void back_off(unsigned& attempts)
+  {
+    if (++attempts < 64)
+    {
+      return;
+    }
+    if (attempts < 256)
+    {
+      std::this_thread::yield();
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+
+  struct SharedState
+  {
+    std::atomic<std::uint64_t> next_batch{0};
+    std::atomic<std::size_t> generators_done{0};
+    std::atomic<std::size_t> detectors_done{0};
+    std::atomic<bool> abort{false};
+
+    std::mutex mutex; // Guards everything below
+    std::exception_ptr error;
+    StageStats generation, detection, analysis;
+    double latency_sum = 0.0;
+    double latency_max = 0.0;
+    std::uint64_t latency_count = 0;
+
+    void fail()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+      abort.store(true, std::memory_order_release);
+    }
+
+    void merge(StageStats& stage, const StageStats& local)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stage.batches += local.batches;
+      stage.events += local.events;
+      stage.busy_seconds += local.busy_seconds;
+      stage.max_batch_seconds = std::max(stage.max_batch_seconds, local.max_batch_seconds);
+      stage.stall_seconds += local.stall_seconds;
+      stage.idle_seconds += local.idle_seconds;
+    }
+  };
+
+  // Hands batch to one of the queues, starting at the round-robin cursor; waits while all are full
+  void push_batch(BatchPointer& batch, BatchQueue* const* queues, std::size_t count, std::size_t& cursor,
+                  StageStats& stats, const SharedState& shared)
+  {
+    LEPTON_METRIC_TIME(MetricTimer::PipelineWait);
+    Clock::time_point start = Clock::now();
+    unsigned attempts = 0;
+    for (;;)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        std::size_t queue = (cursor + i) % count;
+        if (queues[queue]->try_push(batch))
+        {
+          cursor = queue + 1;
+          stats.stall_seconds += seconds_since(start);
+          return;
+        }
+      }
+      if (shared.abort.load(std::memory_order_acquire))
+      {
+        return;
+      }
+      back_off(attempts);
+    }
+  }
+
+  // Takes the next batch from any input queue; returns false once upstream has finished and drained
+  bool pop_batch(BatchPointer& batch, BatchQueue* const* queues, std::size_t count, std::size_t& cursor,
+                 const std::atomic<std::size_t>& upstream_done, std::size_t upstream_count,
+                 StageStats& stats, const SharedState& shared)
+  {
+    LEPTON_METRIC_TIME(MetricTimer::PipelineWait);
+    Clock::time_point start = Clock::now();
+    unsigned attempts = 0;
+    for (;;)
+    {
+      // Read the done flag first: if upstream had finished, anything it pushed is now visible
+      bool finished = upstream_done.load(std::memory_order_acquire) == upstream_count;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        std::size_t queue = (cursor + i) % count;
+        if (queues[queue]->try_pop(batch))
+        {
+          cursor = queue + 1;
+          stats.idle_seconds += seconds_since(start);
+          return true;
+        }
+      }
+      if (finished || shared.abort.load(std::memory_order_acquire))
+      {
+        stats.idle_seconds += seconds_since(start);
+        return false;
+      }
+      back_off(attempts);
+    }
+  }
+}
+
+Pipeline::Pipeline(const EventGenerator& generator, const std::vector<Detector>& detectors, AnalysisFunction analyze,
+                   const PipelineConfig& config)
+  : generator(generator), detectors(detectors), analyze(std::move(analyze)), config(config)
+{
+  if (config.batch_size == 0 || config.generator_threads == 0 || config.detector_threads == 0 ||
+      config.analysis_threads == 0 || config.queue_capacity == 0)
+  {
+    throw std::invalid_argument("Pipeline batch size, thread counts and queue capacity must be greater than 0");
+  }
+  if (!this->analyze)
+  {
+    throw std::invalid_argument("Pipeline needs an analysis function");
+  }
+}
+
+PipelineStats Pipeline::run()
+{
+  const std::size_t generators = config.generator_threads;
+  const std::size_t detector_workers = config.detector_threads;
+  const std::size_t analysers = config.analysis_threads;
+  const std::uint64_t batch_count = (config.total_events + config.batch_size - 1) / config.batch_size;
+
+  // Queue [producer * consumers + consumer] for each stage boundary
+  std::vector<std::unique_ptr<BatchQueue>> generated_queues;
+  std::vector<std::unique_ptr<BatchQueue>> detected_queues;
+  for (std::size_t i = 0; i < generators * detector_workers; ++i)
+  {
+    generated_queues.push_back(std::make_unique<BatchQueue>(config.queue_capacity));
+  }
+  for (std::size_t i = 0; i < detector_workers * analysers; ++i)
+  {
+    detected_queues.push_back(std::make_unique<BatchQueue>(config.queue_capacity));
+  }
+
+  // Only detectors that are switched on respond
+  std::uint8_t active_detectors = 0;
+  for (const auto& detector : detectors)
+  {
+    if (detector.get_status())
+    {
+      active_detectors |= static_cast<std::uint8_t>(1u << static_cast<unsigned>(detector.get_type()));
+    }
+  }
+
+  SharedState shared;
+  Clock::time_point run_start = Clock::now();
+
+  auto generation_worker = [&](std::size_t worker)
+  {
+    StageStats local;
+    try
+    {
+      std::vector<BatchQueue*> outputs;
+      for (std::size_t consumer = 0; consumer < detector_workers; ++consumer)
+      {
+        outputs.push_back(generated_queues[worker * detector_workers + consumer].get());
+      }
+      std::size_t cursor = worker; // Stagger the workers' starting queues
+      for (;;)
+      {
+        std::uint64_t batch_index = shared.next_batch.fetch_add(1, std::memory_order_relaxed);
+        if (batch_index >= batch_count || shared.abort.load(std::memory_order_acquire))
+        {
+          break;
+        }
+        Clock::time_point start = Clock::now();
+        auto batch = std::make_unique<EventBatch>();
+        batch->created = start;
+        batch->first_event = batch_index * config.batch_size;
+        std::uint64_t size = std::min<std::uint64_t>(config.batch_size, config.total_events - batch->first_event);
+        batch->events.resize(static_cast<std::size_t>(size));
+        {
+          LEPTON_METRIC_TIME(MetricTimer::PipelineGeneration);
+          for (std::size_t i = 0; i < batch->events.size(); ++i)
+          {
+            generator.generate_event(batch->first_event + i, batch->events[i]);
+          }
+        }
+        local.add_batch(seconds_since(start), size);
+        push_batch(batch, outputs.data(), outputs.size(), cursor, local, shared);
+      }
+    }
+    catch (...)
+    {
+      shared.fail();
+    }
+    shared.merge(shared.generation, local);
+    shared.generators_done.fetch_add(1, std::memory_order_release);
+  };
+
+  auto detection_worker = [&](std::size_t worker)
+  {
+    StageStats local;
+    try
+    {
+      std::vector<BatchQueue*> inputs;
+      std::vector<BatchQueue*> outputs;
+      for (std::size_t producer = 0; producer < generators; ++producer)
+      {
+        inputs.push_back(generated_queues[producer * detector_workers + worker].get());
+      }
+      for (std::size_t consumer = 0; consumer < analysers; ++consumer)
+      {
+        outputs.push_back(detected_queues[worker * analysers + consumer].get());
+      }
+      std::size_t input_cursor = 0;
+      std::size_t output_cursor = worker;
+      BatchPointer batch;
+      while (pop_batch(batch, inputs.data(), inputs.size(), input_cursor, shared.generators_done, generators, local, shared))
+      {
+        Clock::time_point start = Clock::now();
+        {
+          LEPTON_METRIC_TIME(MetricTimer::PipelineDetection);
+          batch->mask_offsets.assign(1, 0);
+          for (const auto& event : batch->events)
+          {
+            batch->mask_offsets.push_back(batch->mask_offsets.back() + event.size());
+          }
+          batch->hit_masks.resize(batch->mask_offsets.back());
+          for (std::size_t i = 0; i < batch->events.size(); ++i)
+          {
+            const ParticleStore& event = batch->events[i];
+            std::uint8_t* masks = batch->hit_masks.data() + batch->mask_offsets[i];
+            Detector::acceptance_masks(event.type_column().data(), event.size(), masks);
+            for (std::size_t particle = 0; particle < event.size(); ++particle)
+            {
+              masks[particle] &= active_detectors;
+            }
+          }
+        }
+        local.add_batch(seconds_since(start), batch->events.size());
+        push_batch(batch, outputs.data(), outputs.size(), output_cursor, local, shared);
+      }
+    }
+    catch (...)
+    {
+      shared.fail();
+    }
+    shared.merge(shared.detection, local);
+    shared.detectors_done.fetch_add(1, std::memory_order_release);
+  };
+
+  auto analysis_worker = [&](std::size_t worker)
+  {
+    StageStats local;
+    double latency_sum = 0.0;
+    double latency_max = 0.0;
+    try
+    {
+      std::vector<BatchQueue*> inputs;
+      for (std::size_t producer = 0; producer < detector_workers; ++producer)
+      {
+        inputs.push_back(detected_queues[producer * analysers + worker].get());
+      }
+      std::size_t cursor = 0;
+      BatchPointer batch;
+      while (pop_batch(batch, inputs.data(), inputs.size(), cursor, shared.detectors_done, detector_workers, local, shared))
+      {
+        Clock::time_point start = Clock::now();
+        {
+          LEPTON_METRIC_TIME(MetricTimer::PipelineAnalysis);
+          analyze(*batch, worker);
+        }
+        local.add_batch(seconds_since(start), batch->events.size());
+        double latency = seconds_since(batch->created);
+        latency_sum += latency;
+        latency_max = std::max(latency_max, latency);
+      }
+    }
+    catch (...)
+    {
+      shared.fail();
+    }
+    shared.merge(shared.analysis, local);
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.latency_sum += latency_sum;
+    shared.latency_max = std::max(shared.latency_max, latency_max);
+    shared.latency_count += local.batches;
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < generators; ++i)
+  {
+    threads.emplace_back(generation_worker, i);
+  }
+  for (std::size_t i = 0; i < detector_workers; ++i)
+  {
+    threads.emplace_back(detection_worker, i);
+  }
+  for (std::size_t i = 0; i < analysers; ++i)
+  {
+    threads.emplace_back(analysis_worker, i);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  if (shared.error)
+  {
+    std::rethrow_exception(shared.error);
+  }
+
+  PipelineStats stats;
+  stats.generation = shared.generation;
+  stats.detection = shared.detection;
+  stats.analysis = shared.analysis;
+  stats.generation.threads = generators;
+  stats.detection.threads = detector_workers;
+  stats.analysis.threads = analysers;
+  stats.wall_seconds = seconds_since(run_start);
+  stats.mean_latency_seconds = shared.latency_count > 0 ? shared.latency_sum / shared.latency_count : 0.0;
+  stats.max_latency_seconds = shared.latency_max;
+  return stats;
+}
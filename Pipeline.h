@@ -0,0 +1,96 @@
+// Description: Defines the Pipeline class, running generation, detector response and analysis as concurrent stages.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "Detector.h"
+#include "EventGenerator.h"
+#include "ParticleStore.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// A batch of consecutive events as it moves through the stages
+struct EventBatch
+{
+  std::uint64_t first_event;
+  std::vector<ParticleStore> events;
+  std::vector<std::uint8_t> hit_masks; // Detector response: bit d set if detector type d saw the particle
+  std::vector<std::size_t> mask_offsets; // hit_masks range of event i is [mask_offsets[i], mask_offsets[i + 1])
+  std::chrono::steady_clock::time_point created;
+};
+
+struct PipelineConfig
+{
+  std::uint64_t total_events = 100000;
+  std::size_t batch_size = 256; // Events per batch
+  std::size_t generator_threads = 1;
+  std::size_t detector_threads = 1;
+  std::size_t analysis_threads = 1;
+  std::size_t queue_capacity = 8; // Batches per stage-to-stage queue
+};
+
+struct StageStats
+{
+  std::size_t threads = 0;
+  std::uint64_t batches = 0;
+  std::uint64_t events = 0;
+  double busy_seconds = 0.0; // Summed over the stage's threads
+  double max_batch_seconds = 0.0; // Longest time the stage's own work took on one batch
+  double stall_seconds = 0.0; // Blocked on a full downstream queue (backpressure)
+  double idle_seconds = 0.0; // Waiting for upstream batches
+
+  void add_batch(double seconds, std::uint64_t batch_events)
+  {
+    batches += 1;
+    events += batch_events;
+    busy_seconds += seconds;
+    max_batch_seconds = seconds > max_batch_seconds ? seconds : max_batch_seconds;
+  }
+
+  // Time the stage's own work took per batch, excluding queue waits
+  double get_mean_batch_seconds() const { return batches > 0 ? busy_seconds / batches : 0.0; }
+
+  // Events per second this stage could sustain if it were never starved or blocked
+  double get_capacity() const { return busy_seconds > 0 ? events * threads / busy_seconds : 0.0; }
+};
+
+struct PipelineStats
+{
+  StageStats generation;
+  StageStats detection;
+  StageStats analysis;
+  double wall_seconds = 0.0;
+  double mean_latency_seconds = 0.0; // From the start of a batch's generation to the end of its analysis
+  double max_latency_seconds = 0.0;
+
+  double get_throughput() const { return wall_seconds > 0 ? analysis.events / wall_seconds : 0.0; }
+};
+
+// Stages are connected by grids of single-producer/single-consumer ring buffers:
+// every upstream worker has its own queue to every downstream worker, so each stage
+// can be given its own thread count. A producer that finds all of its queues full
+// waits, which throttles faster stages to the pace of the slowest one.
+class Pipeline
+{
+public:
+  using AnalysisFunction = std::function<void(const EventBatch& batch, std::size_t worker)>;
+
+private:
+  EventGenerator generator;
+  std::vector<Detector> detectors;
+  AnalysisFunction analyze;
+  PipelineConfig config;
+
+public:
+  // analyze runs concurrently on config.analysis_threads threads; worker is 0 .. analysis_threads - 1
+  Pipeline(const EventGenerator& generator, const std::vector<Detector>& detectors, AnalysisFunction analyze,
+           const PipelineConfig& config = PipelineConfig()); // Throws std::invalid_argument for zero-sized settings
+
+  PipelineStats run(); // Rethrows the first exception raised in any stage
+};
+
+#endif
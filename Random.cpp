@@ -0,0 +1,200 @@
+// Description: Batch samplers over Philox random streams, with AVX2/AVX-512 block generation.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Random.h"
+#include "MomentumKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if LEPTON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+  constexpr double two_pi = 6.283185307179586;
+  constexpr std::size_t blocks_per_chunk = 256; // 4 KiB of output on the stack per pass
+
+  using RoundKeys = std::array<PhiloxKey, 10>;
+
+  RoundKeys make_round_keys(PhiloxKey key)
+  {
+    RoundKeys keys;
+    for (auto& round_key : keys)
+    {
+      round_key = key;
+      key[0] += 0x9E3779B9u;
+      key[1] += 0xBB67AE85u;
+    }
+    return keys;
+  }
+
+  // Writes blocks first[0] .. first[0] + count - 1 as two 64-bit values each, in the
+  // same order as RandomEngine::operator() returns them
+  __attribute__((noinline)) void blocks_scalar(const PhiloxCounter& first, const PhiloxKey& key, std::uint64_t* out, std::size_t count, std::size_t b)
+  {
+    for (; b < count; ++b)
+    {
+      PhiloxCounter counter = first;
+      counter[0] += static_cast<std::uint32_t>(b);
+      PhiloxCounter output = philox4x32_10(counter, key);
+      out[2 * b] = (static_cast<std::uint64_t>(output[1]) << 32) | output[0];
+      out[2 * b + 1] = (static_cast<std::uint64_t>(output[3]) << 32) | output[2];
+    }
+  }
+
+#if LEPTON_X86_KERNELS
+  // Each 64-bit lane carries one 32-bit counter word of its own block, so mul_epu32
+  // yields the full 32 x 32 -> 64-bit products Philox needs
+  __attribute__((target("avx2")))
+  void blocks_avx2(const PhiloxCounter& first, const PhiloxKey& key, std::uint64_t* out, std::size_t count)
+  {
+    const RoundKeys keys = make_round_keys(key);
+    const __m256i low_mask = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    const __m256i multiplier0 = _mm256_set1_epi64x(0xD2511F53LL);
+    const __m256i multiplier1 = _mm256_set1_epi64x(0xCD9E8D57LL);
+    std::size_t b = 0;
+    for (; b + 4 <= count; b += 4)
+    {
+      std::uint64_t block = first[0] + b;
+      __m256i c0 = _mm256_set_epi64x(block + 3, block + 2, block + 1, block);
+      __m256i c1 = _mm256_set1_epi64x(first[1]);
+      __m256i c2 = _mm256_set1_epi64x(first[2]);
+      __m256i c3 = _mm256_set1_epi64x(first[3]);
+      for (const PhiloxKey& round_key : keys)
+      {
+        __m256i product0 = _mm256_mul_epu32(multiplier0, c0);
+        __m256i product1 = _mm256_mul_epu32(multiplier1, c2);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), c1), _mm256_set1_epi64x(round_key[0]));
+        c1 = _mm256_and_si256(product1, low_mask);
+        c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), c3), _mm256_set1_epi64x(round_key[1]));
+        c3 = _mm256_and_si256(product0, low_mask);
+      }
+      __m256i first_values = _mm256_or_si256(_mm256_slli_epi64(c1, 32), c0);
+      __m256i second_values = _mm256_or_si256(_mm256_slli_epi64(c3, 32), c2);
+      __m256i low = _mm256_unpacklo_epi64(first_values, second_values); // Blocks 0 and 2
+      __m256i high = _mm256_unpackhi_epi64(first_values, second_values); // Blocks 1 and 3
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * b), _mm256_permute2x128_si256(low, high, 0x20));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * b + 4), _mm256_permute2x128_si256(low, high, 0x31));
+    }
+    _mm256_zeroupper();
+    blocks_scalar(first, key, out, count, b);
+  }
+
+  __attribute__((target("avx512f")))
+  void blocks_avx512(const PhiloxCounter& first, const PhiloxKey& key, std::uint64_t* out, std::size_t count)
+  {
+    const RoundKeys keys = make_round_keys(key);
+    const __m512i low_mask = _mm512_set1_epi64(0xFFFFFFFFLL);
+    const __m512i multiplier0 = _mm512_set1_epi64(0xD2511F53LL);
+    const __m512i multiplier1 = _mm512_set1_epi64(0xCD9E8D57LL);
+    const __m512i interleave_low = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+    const __m512i interleave_high = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+    std::size_t b = 0;
+    for (; b + 8 <= count; b += 8)
+    {
+      __m512i c0 = _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(first[0] + b)), _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0));
+      __m512i c1 = _mm512_set1_epi64(first[1]);
+      __m512i c2 = _mm512_set1_epi64(first[2]);
+      __m512i c3 = _mm512_set1_epi64(first[3]);
+      for (const PhiloxKey& round_key : keys)
+      {
+        __m512i product0 = _mm512_mul_epu32(multiplier0, c0);
+        __m512i product1 = _mm512_mul_epu32(multiplier1, c2);
+        c0 = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(product1, 32), c1), _mm512_set1_epi64(round_key[0]));
+        c1 = _mm512_and_si512(product1, low_mask);
+        c2 = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(product0, 32), c3), _mm512_set1_epi64(round_key[1]));
+        c3 = _mm512_and_si512(product0, low_mask);
+      }
+      __m512i first_values = _mm512_or_si512(_mm512_slli_epi64(c1, 32), c0);
+      __m512i second_values = _mm512_or_si512(_mm512_slli_epi64(c3, 32), c2);
+      _mm512_storeu_si512(out + 2 * b, _mm512_permutex2var_epi64(first_values, interleave_low, second_values));
+      _mm512_storeu_si512(out + 2 * b + 8, _mm512_permutex2var_epi64(first_values, interleave_high, second_values));
+    }
+    _mm256_zeroupper();
+    blocks_scalar(first, key, out, count, b);
+  }
+#endif
+
+  void generate_blocks(const PhiloxCounter& first, const PhiloxKey& key, std::uint64_t* out, std::size_t count)
+  {
+#if LEPTON_X86_KERNELS
+    switch (get_kernel_simd_level())
+    {
+      case SimdLevel::Avx512: blocks_avx512(first, key, out, count); return;
+      case SimdLevel::Avx2: blocks_avx2(first, key, out, count); return;
+      case SimdLevel::Scalar: break;
+    }
+#endif
+    blocks_scalar(first, key, out, count, 0);
+  }
+
+  // Reserves the blocks for count values (two per block) and hands each chunk of raw
+  // values to transform(bits, values, offset), where bits holds an even number of values
+  template <typename Transform>
+  void sample(RandomEngine& engine, std::size_t count, Transform transform)
+  {
+    std::size_t blocks = (count + 1) / 2;
+    PhiloxCounter first = engine.reserve_blocks(blocks);
+    std::uint64_t bits[2 * blocks_per_chunk];
+    for (std::size_t done = 0; done < blocks; done += blocks_per_chunk)
+    {
+      std::size_t chunk = std::min(blocks_per_chunk, blocks - done);
+      PhiloxCounter counter = first;
+      counter[0] += static_cast<std::uint32_t>(done);
+      generate_blocks(counter, engine.get_key(), bits, chunk);
+      std::size_t offset = 2 * done;
+      transform(bits, std::min(2 * chunk, count - offset), offset);
+    }
+  }
+}
+
+void fill_random_bits(RandomEngine& engine, std::uint64_t* out, std::size_t count)
+{
+  sample(engine, count, [out](const std::uint64_t* bits, std::size_t values, std::size_t offset)
+  {
+    std::copy(bits, bits + values, out + offset);
+  });
+}
+
+void fill_uniform(RandomEngine& engine, double* out, std::size_t count, double low, double high)
+{
+  double width = high - low;
+  sample(engine, count, [=](const std::uint64_t* bits, std::size_t values, std::size_t offset)
+  {
+    for (std::size_t i = 0; i < values; ++i)
+    {
+      out[offset + i] = low + width * to_unit_interval(bits[i]);
+    }
+  });
+}
+
+void fill_gaussian(RandomEngine& engine, double* out, std::size_t count, double mean, double sigma)
+{
+  // Each block's two values give one Box-Muller pair
+  sample(engine, count, [=](const std::uint64_t* bits, std::size_t values, std::size_t offset)
+  {
+    for (std::size_t i = 0; i < values; i += 2)
+    {
+      double radius = sigma * std::sqrt(-2.0 * std::log(1.0 - to_unit_interval(bits[i]))); // 1 - u is in (0, 1]
+      double angle = two_pi * to_unit_interval(bits[i + 1]);
+      out[offset + i] = mean + radius * std::cos(angle);
+      if (i + 1 < values)
+      {
+        out[offset + i + 1] = mean + radius * std::sin(angle);
+      }
+    }
+  });
+}
+
+void fill_exponential(RandomEngine& engine, double* out, std::size_t count, double mean)
+{
+  sample(engine, count, [=](const std::uint64_t* bits, std::size_t values, std::size_t offset)
+  {
+    for (std::size_t i = 0; i < values; ++i)
+    {
+      out[offset + i] = -mean * std::log(1.0 - to_unit_interval(bits[i]));
+    }
+  });
+}
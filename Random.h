@@ -0,0 +1,139 @@
+// Description: Counter-based Philox4x32-10 random streams keyed by run seed, event number and stream id.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// SplitMix64 finaliser: scatters nearby inputs (consecutive seeds) across the key space
+constexpr std::uint64_t splitmix64(std::uint64_t value)
+{
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+// Independent streams within one event, so e.g. adding a tau decay draw does not
+// shift every kinematic draw after it
+enum class RandomStream : std::uint32_t { Generation, TauDecay, DetectorResponse };
+
+using PhiloxKey = std::array<std::uint32_t, 2>;
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+
+// Philox4x32 with 10 rounds (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+inline PhiloxCounter philox4x32_10(PhiloxCounter counter, PhiloxKey key)
+{
+  for (int round = 0; round < 10; ++round)
+  {
+    std::uint64_t product0 = static_cast<std::uint64_t>(0xD2511F53u) * counter[0];
+    std::uint64_t product1 = static_cast<std::uint64_t>(0xCD9E8D57u) * counter[2];
+    counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<std::uint32_t>(product1),
+               static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<std::uint32_t>(product0)};
+    key[0] += 0x9E3779B9u;
+    key[1] += 0xBB67AE85u;
+  }
+  return counter;
+}
+
+// Counter-based engine: block b of stream s of event e under seed k is
+// philox(counter = {b, s, e low, e high}, key = splitmix64(k)), so every value is a
+// pure function of (seed, event, stream, position). Any event can be regenerated in
+// isolation and results cannot depend on which thread ran it or in what order.
+//
+// Satisfies UniformRandomBitGenerator, so it also drives the <random> distributions.
+// Each block yields two 64-bit values; a stream holds 2^32 blocks.
+class RandomEngine
+{
+private:
+  PhiloxKey key;
+  PhiloxCounter counter; // counter[0] is the next block
+  std::uint64_t next_block;
+  std::array<std::uint64_t, 2> buffer;
+  unsigned buffered; // Values of buffer not yet returned, taken from the front
+
+  void refill()
+  {
+    PhiloxCounter output = philox4x32_10(reserve_blocks(1), key);
+    buffer[0] = (static_cast<std::uint64_t>(output[1]) << 32) | output[0];
+    buffer[1] = (static_cast<std::uint64_t>(output[3]) << 32) | output[2];
+    buffered = 2;
+  }
+
+public:
+  using result_type = std::uint64_t;
+
+  RandomEngine(std::uint64_t seed, std::uint64_t event_number, std::uint32_t stream = 0)
+    : key{static_cast<std::uint32_t>(splitmix64(seed)), static_cast<std::uint32_t>(splitmix64(seed) >> 32)},
+      counter{0, stream, static_cast<std::uint32_t>(event_number), static_cast<std::uint32_t>(event_number >> 32)},
+      next_block(0), buffer{}, buffered(0)
+  {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+  result_type operator()()
+  {
+    if (buffered == 0)
+    {
+      refill();
+    }
+    return buffer[2 - buffered--];
+  }
+
+  const PhiloxKey& get_key() const { return key; }
+
+  // Hands out the counter of the next count blocks for bulk generation (block
+  // counter[0] + i for i < count) and skips past them. Values still buffered from a
+  // partly used block are dropped, so bulk output always starts on a block boundary.
+  PhiloxCounter reserve_blocks(std::uint64_t count)
+  {
+    if (count > (std::uint64_t(1) << 32) - next_block)
+    {
+      throw std::out_of_range("Random stream exhausted: a stream holds 2^32 blocks");
+    }
+    PhiloxCounter first = counter;
+    first[0] = static_cast<std::uint32_t>(next_block);
+    next_block += count;
+    buffered = 0;
+    return first;
+  }
+};
+
+inline RandomEngine make_event_engine(std::uint64_t seed, std::uint64_t event_number, RandomStream stream = RandomStream::Generation)
+{
+  return RandomEngine(seed, event_number, static_cast<std::uint32_t>(stream));
+}
+
+// The top 52 bits as a double in [0, 1): the exponent of 1.0 plus a random mantissa,
+// minus 1. The batch samplers use the same mapping, so they reproduce single draws.
+inline double to_unit_interval(std::uint64_t bits)
+{
+  std::uint64_t pattern = (bits >> 12) | 0x3FF0000000000000ULL;
+  double value;
+  std::memcpy(&value, &pattern, sizeof(value));
+  return value - 1.0;
+}
+
+inline double uniform_unit(RandomEngine& engine)
+{
+  return to_unit_interval(engine());
+}
+
+// Batch samplers for filling columns. Each consumes (count + 1) / 2 whole blocks from
+// the engine's next block boundary and value i comes from the i-th 64-bit output
+// (Gaussian pairs from one block each), so results match single draws from a fresh
+// block and do not depend on the SIMD level. The Philox blocks themselves come from
+// AVX2/AVX-512 kernels where the CPU has them; the transforms use the C library.
+void fill_uniform(RandomEngine& engine, double* out, std::size_t count, double low = 0.0, double high = 1.0);
+void fill_gaussian(RandomEngine& engine, double* out, std::size_t count, double mean = 0.0, double sigma = 1.0); // Box-Muller
+void fill_exponential(RandomEngine& engine, double* out, std::size_t count, double mean = 1.0);
+void fill_random_bits(RandomEngine& engine, std::uint64_t* out, std::size_t count);
+
+#endif
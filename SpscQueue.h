@@ -0,0 +1,89 @@
+// Description: Bounded single-producer/single-consumer lock-free ring buffer.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Exactly one thread may push and exactly one (other) thread may pop. Each side
+// keeps a cached copy of the other's index so the shared cache lines are only read
+// when the queue looks full (producer) or empty (consumer).
+template <typename T>
+class SpscQueue
+{
+private:
+  std::unique_ptr<T[]> slots;
+  std::size_t mask;
+
+  alignas(64) std::atomic<std::size_t> head; // Next slot to pop, written by the consumer
+  std::size_t cached_tail;
+  alignas(64) std::atomic<std::size_t> tail; // Next slot to push, written by the producer
+  std::size_t cached_head;
+
+  static std::size_t round_up_power_of_two(std::size_t value)
+  {
+    std::size_t power = 2;
+    while (power < value)
+    {
+      power <<= 1;
+    }
+    return power;
+  }
+
+public:
+  explicit SpscQueue(std::size_t capacity)
+    : slots(new T[round_up_power_of_two(capacity)]), mask(round_up_power_of_two(capacity) - 1),
+      head(0), cached_tail(0), tail(0), cached_head(0)
+  {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  std::size_t capacity() const { return mask + 1; }
+
+  // Producer side; returns false without moving from value if the queue is full
+  bool try_push(T& value)
+  {
+    std::size_t position = tail.load(std::memory_order_relaxed);
+    if (position - cached_head > mask)
+    {
+      cached_head = head.load(std::memory_order_acquire);
+      if (position - cached_head > mask)
+      {
+        return false;
+      }
+    }
+    slots[position & mask] = std::move(value);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side; returns false if the queue is empty
+  bool try_pop(T& value)
+  {
+    std::size_t position = head.load(std::memory_order_relaxed);
+    if (position == cached_tail)
+    {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (position == cached_tail)
+      {
+        return false;
+      }
+    }
+    value = std::move(slots[position & mask]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const
+  {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+};
+
+#endif
@@ -6,20 +6,40 @@
 #define TAU_H
 
 #include "Lepton.h"
-#include <memory>
-#include <vector>
+#include "ParticleType.h"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
 
-enum class TauDecayMode { Hadronic, Leptonic };
+// Read-only range over a tau's decay products
+class DecayProductList
+{
+private:
+  const Lepton* const* first;
+  std::size_t count;
+
+public:
+  DecayProductList(const Lepton* const* first, std::size_t count) : first(first), count(count) {}
+
+  const Lepton* const* begin() const { return first; }
+  const Lepton* const* end() const { return first + count; }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const Lepton* operator[](std::size_t i) const { return first[i]; }
+};
 
-class Tau : public Lepton 
+class Tau final : public Lepton 
 {
 private:
   TauDecayMode decay_mode;
-  std::vector<std::shared_ptr<Lepton>> decay_products;
+  std::array<const Lepton*, max_tau_decay_products> decay_products; // Non-owning, typically into an EventArena
+  std::uint8_t decay_product_count;
 
 public:
+  static constexpr ParticleType static_type_id = ParticleType::Tau;
+
   Tau(double mass, int charge, double energy, double px, double py, double pz, TauDecayMode mode)
-    : Lepton(mass, charge, energy, px, py, pz), decay_mode(mode) {}
+    : Lepton(static_type_id, mass, charge, energy, px, py, pz), decay_mode(mode), decay_products{}, decay_product_count(0) {}
 
   void set_decay_mode(TauDecayMode mode) 
   {
@@ -31,23 +51,34 @@ public:
     return decay_mode;
   }
 
-  void add_decay_product(std::shared_ptr<Lepton> product) 
+  // The tau does not own its products: they must outlive it, e.g. by being created
+  // in the same EventArena. Ignored for hadronic taus.
+  void add_decay_product(const Lepton* product) 
   {
     if (decay_mode == TauDecayMode::Leptonic) 
     {
-      decay_products.push_back(product);
+      if (decay_product_count == max_tau_decay_products) 
+      {
+        throw std::invalid_argument("Tau already holds the maximum number of decay products");
+      }
+      decay_products[decay_product_count++] = product;
     }
   }
 
-  const std::vector<std::shared_ptr<Lepton>>& get_decay_products() const 
+  void clear_decay_products() 
+  {
+    decay_product_count = 0;
+  }
+
+  DecayProductList get_decay_products() const 
   {
-    return decay_products;
+    return DecayProductList(decay_products.data(), decay_product_count);
   }
 
   std::string get_particle_type() const override 
   {
-    return "Tau";
+    return particle_type_name(static_type_id);
   }
 };
 
-#endif // TAU_H
\ No newline at end of file
+#endif // TAU_H
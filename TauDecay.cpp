@@ -0,0 +1,288 @@
+// Description: Defines the TauDecayer class, a phase-space generator for leptonic and hadronic tau decays.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TauDecay.h"
+#include "Electron.h"
+#include "EventArena.h"
+#include "LorentzBoost.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "ParticleType.h"
+#include "TauNeutrino.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  constexpr double pi = 3.14159265358979323846;
+  constexpr double tau_mass = particle_rest_mass(ParticleType::Tau);
+  constexpr double charged_pion_mass = 139.57;
+  constexpr double neutral_pion_mass = 134.98;
+  constexpr std::size_t weight_grid = 256; // Points per free cut when tabulating the maximum weight
+  constexpr double weight_margin = 1.05;
+
+  struct ChannelSpec
+  {
+    double branching_ratio; // PDG values; the channels left out are absorbed by normalisation
+    std::size_t count;
+    std::array<DecayProductType, max_tau_decay_multiplicity> types;
+    std::array<std::int8_t, max_tau_decay_multiplicity> charge_signs;
+  };
+
+  using T = DecayProductType;
+  constexpr std::array<ChannelSpec, tau_decay_channel_count> channel_specs{{
+    {0.1782, 3, {{T::Electron, T::ElectronNeutrino, T::TauNeutrino}}, {{1, 0, 0}}},
+    {0.1739, 3, {{T::Muon, T::MuonNeutrino, T::TauNeutrino}}, {{1, 0, 0}}},
+    {0.1082, 2, {{T::ChargedPion, T::TauNeutrino}}, {{1, 0}}},
+    {0.2549, 3, {{T::ChargedPion, T::NeutralPion, T::TauNeutrino}}, {{1, 0, 0}}},
+    {0.0926, 4, {{T::ChargedPion, T::NeutralPion, T::NeutralPion, T::TauNeutrino}}, {{1, 0, 0, 0}}},
+    {0.0931, 4, {{T::ChargedPion, T::ChargedPion, T::ChargedPion, T::TauNeutrino}}, {{1, 1, -1, 0}}},
+  }};
+
+  constexpr double product_mass(DecayProductType type)
+  {
+    switch (type)
+    {
+      case DecayProductType::Electron: return particle_rest_mass(ParticleType::Electron);
+      case DecayProductType::Muon: return particle_rest_mass(ParticleType::Muon);
+      case DecayProductType::ChargedPion: return charged_pion_mass;
+      case DecayProductType::NeutralPion: return neutral_pion_mass;
+      case DecayProductType::ElectronNeutrino:
+      case DecayProductType::MuonNeutrino:
+      case DecayProductType::TauNeutrino: return 0.0;
+    }
+    return 0.0;
+  }
+
+  // Momentum of either daughter when a system of mass a splits into masses b and c
+  double two_body_momentum(double a, double b, double c)
+  {
+    double product = (a - b - c) * (a + b + c) * (a - b + c) * (a + b - c);
+    return product > 0 ? std::sqrt(product) / (2 * a) : 0.0;
+  }
+
+  // Phase-space weight of one set of sorted cuts in [0, 1]: the product of the two-body
+  // momenta as each intermediate system of the first i + 1 products splits off the next
+  double phase_space_weight(const double* masses, std::size_t count, double kinetic_energy, const double* cuts,
+                            double* invariant, double* momenta)
+  {
+    double mass_sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      mass_sum += masses[i];
+      invariant[i] = cuts[i] * kinetic_energy + mass_sum;
+    }
+    double weight = 1.0;
+    for (std::size_t i = 0; i + 1 < count; ++i)
+    {
+      momenta[i] = two_body_momentum(invariant[i + 1], invariant[i], masses[i + 1]);
+      weight *= momenta[i];
+    }
+    return weight;
+  }
+}
+
+TauDecayer::TauDecayer()
+  : channels{}, cumulative{}, leptonic_fraction(0.0)
+{
+  double total = 0.0;
+  for (const ChannelSpec& spec : channel_specs)
+  {
+    total += spec.branching_ratio;
+  }
+  double running = 0.0;
+  for (std::size_t c = 0; c < tau_decay_channel_count; ++c)
+  {
+    const ChannelSpec& spec = channel_specs[c];
+    Channel& channel = channels[c];
+    channel.types = spec.types;
+    channel.charge_signs = spec.charge_signs;
+    channel.count = spec.count;
+    double mass_sum = 0.0;
+    for (std::size_t i = 0; i < spec.count; ++i)
+    {
+      channel.masses[i] = product_mass(spec.types[i]);
+      mass_sum += channel.masses[i];
+    }
+    channel.kinetic_energy = tau_mass - mass_sum;
+
+    // Maximum weight from a scan over a grid of the free cuts. It is several times
+    // tighter than the analytic GENBOD bound, which only accepts about 5% of the
+    // four-body proposals; the margin covers the grid spacing.
+    static_assert(max_tau_decay_multiplicity <= 4, "The weight scan covers at most two free cuts");
+    std::array<double, max_tau_decay_multiplicity> cuts{}, invariant{}, momenta{};
+    cuts[spec.count - 1] = 1.0;
+    std::size_t free_cuts = spec.count - 2;
+    channel.max_weight = 0.0;
+    for (std::size_t a = 0; a <= (free_cuts >= 1 ? weight_grid : 0); ++a)
+    {
+      for (std::size_t b = a; b <= (free_cuts == 2 ? weight_grid : a); ++b)
+      {
+        if (free_cuts >= 1)
+        {
+          cuts[1] = static_cast<double>(a) / weight_grid;
+        }
+        if (free_cuts == 2)
+        {
+          cuts[2] = static_cast<double>(b) / weight_grid;
+        }
+        double weight = phase_space_weight(channel.masses.data(), spec.count, channel.kinetic_energy, cuts.data(),
+                                           invariant.data(), momenta.data());
+        channel.max_weight = std::max(channel.max_weight, weight);
+      }
+    }
+    channel.max_weight *= weight_margin;
+
+    channel.branching_ratio = spec.branching_ratio / total;
+    running += channel.branching_ratio;
+    cumulative[c] = running;
+    if (is_leptonic(static_cast<TauDecayChannel>(c)))
+    {
+      leptonic_fraction = running;
+    }
+  }
+  cumulative.back() = 1.0; // Guard against rounding in the running sum
+}
+
+TauDecayChannel TauDecayer::sample_channel(RandomEngine& engine) const
+{
+  double u = uniform_unit(engine);
+  std::size_t c = 0;
+  while (c + 1 < tau_decay_channel_count && u >= cumulative[c])
+  {
+    ++c;
+  }
+  return static_cast<TauDecayChannel>(c);
+}
+
+TauDecayChannel TauDecayer::sample_channel(RandomEngine& engine, bool leptonic) const
+{
+  // Leptonic channels sit first, so the restriction maps u into their share of the range
+  double u = uniform_unit(engine);
+  u = leptonic ? u * leptonic_fraction : leptonic_fraction + u * (1.0 - leptonic_fraction);
+  std::size_t c = leptonic ? 0 : 2;
+  std::size_t last = leptonic ? 1 : tau_decay_channel_count - 1;
+  while (c < last && u >= cumulative[c])
+  {
+    ++c;
+  }
+  return static_cast<TauDecayChannel>(c);
+}
+
+std::size_t TauDecayer::decay(TauDecayChannel channel_id, int tau_charge, double energy, double px, double py, double pz,
+                              RandomEngine& engine, DecayProduct* out) const
+{
+  const Channel& channel = channels[static_cast<std::size_t>(channel_id)];
+  const std::size_t n = channel.count;
+  const double* masses = channel.masses.data();
+
+  // Invariant masses of the first 1, 2, ..., n products, accepted with probability
+  // proportional to the phase-space weight
+  std::array<double, max_tau_decay_multiplicity> invariant;
+  std::array<double, max_tau_decay_multiplicity> momenta; // momenta[i]: split of invariant[i + 1]
+  while (true)
+  {
+    std::array<double, max_tau_decay_multiplicity> cuts;
+    cuts[0] = 0.0;
+    for (std::size_t i = 1; i + 1 < n; ++i)
+    {
+      // Insertion keeps the (at most two) free cuts sorted
+      double cut = uniform_unit(engine);
+      std::size_t j = i;
+      for (; j > 1 && cuts[j - 1] > cut; --j)
+      {
+        cuts[j] = cuts[j - 1];
+      }
+      cuts[j] = cut;
+    }
+    cuts[n - 1] = 1.0;
+    double weight = phase_space_weight(masses, n, channel.kinetic_energy, cuts.data(), invariant.data(), momenta.data());
+    if (n == 2 || uniform_unit(engine) * channel.max_weight <= weight)
+    {
+      break;
+    }
+  }
+
+  // Rest-frame momenta: split the first pair back to back, then repeatedly rotate the
+  // system built so far randomly, boost it along y and add the next product along -y
+  std::array<double, max_tau_decay_multiplicity> e, x, y, z;
+  x[0] = 0.0;
+  y[0] = momenta[0];
+  z[0] = 0.0;
+  e[0] = std::sqrt(momenta[0] * momenta[0] + masses[0] * masses[0]);
+  x[1] = 0.0;
+  y[1] = -momenta[0];
+  z[1] = 0.0;
+  e[1] = std::sqrt(momenta[0] * momenta[0] + masses[1] * masses[1]);
+  for (std::size_t i = 1;; ++i)
+  {
+    double cos_z = 2 * uniform_unit(engine) - 1;
+    double sin_z = std::sqrt(1 - cos_z * cos_z);
+    double angle_y = 2 * pi * uniform_unit(engine);
+    double cos_y = std::cos(angle_y);
+    double sin_y = std::sin(angle_y);
+    for (std::size_t j = 0; j <= i; ++j)
+    {
+      double x0 = x[j];
+      x[j] = cos_z * x0 - sin_z * y[j];
+      y[j] = sin_z * x0 + cos_z * y[j];
+      double x1 = x[j];
+      x[j] = cos_y * x1 - sin_y * z[j];
+      z[j] = sin_y * x1 + cos_y * z[j];
+    }
+    if (i + 1 == n)
+    {
+      break;
+    }
+    double beta = momenta[i] / std::sqrt(momenta[i] * momenta[i] + invariant[i] * invariant[i]);
+    double gamma = 1.0 / std::sqrt(1 - beta * beta);
+    for (std::size_t j = 0; j <= i; ++j)
+    {
+      double e0 = e[j];
+      e[j] = gamma * (e0 + beta * y[j]);
+      y[j] = gamma * (y[j] + beta * e0);
+    }
+    x[i + 1] = 0.0;
+    y[i + 1] = -momenta[i];
+    z[i + 1] = 0.0;
+    e[i + 1] = std::sqrt(momenta[i] * momenta[i] + masses[i + 1] * masses[i + 1]);
+  }
+
+  // Boost from the tau rest frame to the lab
+  LorentzBoost to_lab = LorentzBoost::from_rest_frame(FourMomentum(energy, px, py, pz));
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    FourMomentum lab = to_lab.apply(FourMomentum(e[i], x[i], y[i], z[i]));
+    DecayProduct& product = out[i];
+    product.type = channel.types[i];
+    product.charge = static_cast<std::int8_t>(channel.charge_signs[i] * tau_charge);
+    product.mass = masses[i];
+    product.energy = lab.get_energy();
+    product.px = lab.get_px();
+    product.py = lab.get_py();
+    product.pz = lab.get_pz();
+  }
+  return n;
+}
+
+std::size_t TauDecayer::decay(int tau_charge, double energy, double px, double py, double pz, RandomEngine& engine, DecayProduct* out) const
+{
+  return decay(sample_channel(engine), tau_charge, energy, px, py, pz, engine, out);
+}
+
+const Lepton* create_decay_lepton(EventArena& arena, const DecayProduct& p)
+{
+  switch (p.type)
+  {
+    case DecayProductType::Electron: return arena.create<Electron>(p.mass, p.charge, p.energy, p.px, p.py, p.pz);
+    case DecayProductType::Muon: return arena.create<Muon>(p.mass, p.charge, p.energy, p.px, p.py, p.pz);
+    case DecayProductType::ElectronNeutrino:
+      return arena.create<Neutrino>(p.mass, p.charge, p.energy, p.px, p.py, p.pz, NeutrinoFlavor::Electron);
+    case DecayProductType::MuonNeutrino: return arena.create<Neutrino>(p.mass, p.charge, p.energy, p.px, p.py, p.pz, NeutrinoFlavor::Muon);
+    case DecayProductType::TauNeutrino: return arena.create<TauNeutrino>(p.mass, p.charge, p.energy, p.px, p.py, p.pz);
+    case DecayProductType::ChargedPion:
+    case DecayProductType::NeutralPion: break;
+  }
+  return nullptr;
+}
@@ -0,0 +1,78 @@
+// Description: Defines the TauDecayer class, a phase-space generator for leptonic and hadronic tau decays.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef TAUDECAY_H
+#define TAUDECAY_H
+
+#include "Random.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class EventArena;
+class Lepton;
+
+// Leptonic channels come first
+enum class TauDecayChannel : std::uint8_t { ElectronNeutrinos, MuonNeutrinos, PionNeutrino, RhoNeutrino, PionTwoPi0Neutrino, ThreePionNeutrino };
+constexpr std::size_t tau_decay_channel_count = 6;
+constexpr std::size_t max_tau_decay_multiplicity = 4; // Three pions and the tau neutrino
+
+enum class DecayProductType : std::uint8_t { Electron, Muon, ElectronNeutrino, MuonNeutrino, TauNeutrino, ChargedPion, NeutralPion };
+
+struct DecayProduct
+{
+  DecayProductType type;
+  std::int8_t charge;
+  double mass; // MeV
+  double energy, px, py, pz;
+};
+
+// Samples unweighted N-body phase-space decays (GENBOD: sorted invariant masses,
+// accept-reject against a per-channel maximum weight) in the tau rest frame and
+// boosts them to the lab. Channel masses, branching ratios and maximum weights are
+// tabulated once in the constructor; decay() itself allocates nothing.
+//
+// Read-only after construction, so one instance can be shared between threads.
+class TauDecayer
+{
+private:
+  struct Channel
+  {
+    std::array<DecayProductType, max_tau_decay_multiplicity> types;
+    std::array<std::int8_t, max_tau_decay_multiplicity> charge_signs; // Relative to the tau charge
+    std::array<double, max_tau_decay_multiplicity> masses;
+    std::size_t count;
+    double kinetic_energy; // Tau mass minus the product masses
+    double max_weight;
+    double branching_ratio; // Normalised over the channels above
+  };
+  std::array<Channel, tau_decay_channel_count> channels;
+  std::array<double, tau_decay_channel_count> cumulative; // Running sums of the branching ratios
+  double leptonic_fraction;
+
+public:
+  TauDecayer();
+
+  double get_branching_ratio(TauDecayChannel channel) const { return channels[static_cast<std::size_t>(channel)].branching_ratio; }
+  double get_leptonic_fraction() const { return leptonic_fraction; }
+  std::size_t get_multiplicity(TauDecayChannel channel) const { return channels[static_cast<std::size_t>(channel)].count; }
+  static bool is_leptonic(TauDecayChannel channel) { return channel <= TauDecayChannel::MuonNeutrinos; }
+
+  // Channel drawn from the branching ratios, optionally restricted to leptonic or hadronic channels
+  TauDecayChannel sample_channel(RandomEngine& engine) const;
+  TauDecayChannel sample_channel(RandomEngine& engine, bool leptonic) const;
+
+  // Decays a tau of the given charge and lab four-momentum (assumed on shell at the
+  // tau mass) and writes the products to out, which must hold max_tau_decay_multiplicity
+  // entries. Returns the number of products; their four-momenta sum to the tau's.
+  // Throws std::invalid_argument if the four-momentum is not time-like.
+  std::size_t decay(TauDecayChannel channel, int tau_charge, double energy, double px, double py, double pz,
+                    RandomEngine& engine, DecayProduct* out) const;
+  std::size_t decay(int tau_charge, double energy, double px, double py, double pz, RandomEngine& engine, DecayProduct* out) const;
+};
+
+// Builds the Lepton object for a leptonic decay product inside arena; nullptr for pions
+const Lepton* create_decay_lepton(EventArena& arena, const DecayProduct& product);
+
+#endif
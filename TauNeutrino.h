@@ -7,14 +7,16 @@
 
 #include "Lepton.h"
 
-class TauNeutrino : public Lepton 
+class TauNeutrino final : public Lepton 
 {
 private:
     bool hasInteracted;
 
 public:
+    static constexpr ParticleType static_type_id = ParticleType::TauNeutrino;
+
     TauNeutrino(double mass, int charge, double energy, double px, double py, double pz, bool interacted = false)
-        : Lepton(mass, charge, energy, px, py, pz), hasInteracted(interacted) 
+        : Lepton(static_type_id, mass, charge, energy, px, py, pz), hasInteracted(interacted) 
         {}
 
     void setHasInteracted(bool interacted) 
@@ -29,7 +31,7 @@ public:
 
     std::string get_particle_type() const override 
     {
-        return "tau neutrino";
+        return particle_type_name(static_type_id);
     }
 };
 
@@ -0,0 +1,196 @@
+// Description: Defines the ThreadPool class, a work-stealing pool that spreads simulation work over worker threads.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "ThreadPool.h"
+#include <chrono>
+#include <exception>
+
+namespace
+{
+  thread_local const ThreadPool* current_pool = nullptr;
+  thread_local int current_index = -1;
+}
+
+ThreadPool::ThreadPool(std::size_t threads)
+  : pending(0), next_queue(0), stopping(false)
+{
+  if (threads == 0)
+  {
+    threads = 1;
+  }
+  for (std::size_t i = 0; i < threads; ++i)
+  {
+    queues.push_back(std::make_unique<WorkQueue>());
+  }
+  for (std::size_t i = 0; i < threads; ++i)
+  {
+    workers.emplace_back(&ThreadPool::worker_loop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+int ThreadPool::current_worker_index()
+{
+  return current_index;
+}
+
+void ThreadPool::submit(Task task)
+{
+  // Work spawned by a worker stays on its own deque; outside work is dealt round-robin
+  std::size_t queue = current_pool == this ? static_cast<std::size_t>(current_index)
+                                           : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+  {
+    std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+    queues[queue]->tasks.push_back(std::move(task));
+  }
+  pending.fetch_add(1, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex); // Pairs with the predicate check in worker_loop
+  }
+  wake.notify_one();
+}
+
+bool ThreadPool::try_pop(std::size_t queue, Task& task)
+{
+  std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+  if (queues[queue]->tasks.empty())
+  {
+    return false;
+  }
+  task = std::move(queues[queue]->tasks.back());
+  queues[queue]->tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::try_steal(std::size_t thief, Task& task)
+{
+  for (std::size_t offset = 1; offset <= queues.size(); ++offset)
+  {
+    WorkQueue& victim = *queues[(thief + offset) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty())
+    {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::run_one(std::size_t home_queue)
+{
+  Task task;
+  if (!try_pop(home_queue, task) && !try_steal(home_queue, task))
+  {
+    return false;
+  }
+  pending.fetch_sub(1, std::memory_order_relaxed);
+  task();
+  return true;
+}
+
+void ThreadPool::worker_loop(std::size_t index)
+{
+  current_pool = this;
+  current_index = static_cast<int>(index);
+  for (;;)
+  {
+    if (run_one(index))
+    {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+    if (stopping && pending.load(std::memory_order_acquire) == 0)
+    {
+      return;
+    }
+  }
+}
+
+void ThreadPool::parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                              const std::function<void(std::size_t, std::size_t)>& body)
+{
+  if (begin >= end)
+  {
+    return;
+  }
+  if (grain == 0)
+  {
+    grain = 1;
+  }
+
+  // Guarded by its mutex, so a finishing chunk is done with it before the caller can return
+  struct Completion
+  {
+    std::size_t remaining;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+  Completion completion;
+  completion.remaining = (end - begin + grain - 1) / grain;
+
+  for (std::size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain)
+  {
+    std::size_t chunk_end = end - chunk_begin > grain ? chunk_begin + grain : end;
+    submit([&completion, &body, chunk_begin, chunk_end]
+    {
+      try
+      {
+        body(chunk_begin, chunk_end);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(completion.mutex);
+        if (!completion.error)
+        {
+          completion.error = std::current_exception();
+        }
+      }
+      std::lock_guard<std::mutex> lock(completion.mutex);
+      if (--completion.remaining == 0)
+      {
+        completion.done.notify_all();
+      }
+    });
+  }
+
+  // Help out rather than block, so nested parallel_for calls from workers cannot deadlock
+  std::size_t home_queue = current_pool == this ? static_cast<std::size_t>(current_index) : 0;
+  for (;;)
+  {
+    {
+      std::lock_guard<std::mutex> lock(completion.mutex);
+      if (completion.remaining == 0)
+      {
+        break;
+      }
+    }
+    if (!run_one(home_queue))
+    {
+      std::unique_lock<std::mutex> lock(completion.mutex);
+      completion.done.wait_for(lock, std::chrono::microseconds(100), [&completion] { return completion.remaining == 0; });
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(completion.mutex);
+  if (completion.error)
+  {
+    std::rethrow_exception(completion.error);
+  }
+}
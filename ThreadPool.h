@@ -0,0 +1,67 @@
+// Description: Defines the ThreadPool class, a work-stealing pool that spreads simulation work over worker threads.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each worker owns a deque: it pushes and pops its own work at the back (LIFO, cache
+// warm) and, when idle, steals from the front of the other workers' deques (FIFO,
+// oldest and usually largest pieces first).
+class ThreadPool
+{
+public:
+  using Task = std::function<void()>;
+
+private:
+  struct alignas(64) WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<std::size_t> pending; // Queued tasks not yet picked up
+  std::atomic<std::size_t> next_queue; // Round-robin target for submissions from outside the pool
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping;
+
+  bool try_pop(std::size_t queue, Task& task);
+  bool try_steal(std::size_t thief, Task& task);
+  bool run_one(std::size_t home_queue); // Runs one task from home_queue or a victim; false if none found
+  void worker_loop(std::size_t index);
+
+public:
+  explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t size() const { return workers.size(); }
+
+  void submit(Task task);
+
+  // Calls body(chunk_begin, chunk_end) over [begin, end) in chunks of at most grain
+  // items and returns once all chunks are done. The calling thread helps run tasks
+  // while it waits. The first exception thrown by body is rethrown here.
+  void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                    const std::function<void(std::size_t, std::size_t)>& body);
+
+  // Index of the pool worker running the caller, or -1 outside any pool
+  static int current_worker_index();
+};
+
+#endif
@@ -0,0 +1,206 @@
+// Description: Defines the Trigger class, a two-level event filter run on columnar events before any Lepton objects exist.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "Trigger.h"
+#include "Random.h"
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double seconds_since(Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  // Candidates of one path in one event and their charge sum; given the event's
+  // detector masks, also how many candidates every required detector saw
+  struct CandidateCount
+  {
+    std::size_t candidates = 0;
+    std::size_t detected = 0;
+    int charge_sum = 0;
+  };
+
+  CandidateCount count_candidates(const TriggerPathConfig& path, double max_pz_over_pt_squared, const ParticleStore& event,
+                                  const std::uint8_t* masks)
+  {
+    const double* px = event.px_column().data();
+    const double* py = event.py_column().data();
+    const double* pz = event.pz_column().data();
+    const std::int8_t* charge = event.charge_column().data();
+    const ParticleType* type = event.type_column().data();
+    double min_pt_squared = path.min_pt * path.min_pt;
+    bool eta_cut = std::isfinite(max_pz_over_pt_squared);
+
+    CandidateCount count;
+    for (std::size_t i = 0; i < event.size(); ++i)
+    {
+      if ((path.particle_types & particle_type_bit(type[i])) == 0)
+      {
+        continue;
+      }
+      double pt_squared = px[i] * px[i] + py[i] * py[i];
+      if (pt_squared < min_pt_squared || (eta_cut && pz[i] * pz[i] > max_pz_over_pt_squared * pt_squared))
+      {
+        continue;
+      }
+      ++count.candidates;
+      count.charge_sum += charge[i];
+      if (masks != nullptr && (masks[i] & path.required_detectors) == path.required_detectors)
+      {
+        ++count.detected;
+      }
+    }
+    return count;
+  }
+
+  bool keeps_prescaled(std::uint32_t prescale, std::uint64_t event_number, std::size_t path)
+  {
+    return prescale == 1 || splitmix64(event_number ^ splitmix64(path + 1)) % prescale == 0;
+  }
+}
+
+void TriggerStats::merge(const TriggerStats& other)
+{
+  if (paths.size() != other.paths.size())
+  {
+    throw std::invalid_argument("Trigger statistics from different path sets cannot be merged");
+  }
+  events += other.events;
+  accepted += other.accepted;
+  response_seconds += other.response_seconds;
+  for (std::size_t p = 0; p < paths.size(); ++p)
+  {
+    paths[p].level1 += other.paths[p].level1;
+    paths[p].high_level += other.paths[p].high_level;
+    paths[p].accepted += other.paths[p].accepted;
+    paths[p].level1_seconds += other.paths[p].level1_seconds;
+    paths[p].high_level_seconds += other.paths[p].high_level_seconds;
+  }
+}
+
+Trigger::Trigger(const std::vector<TriggerPathConfig>& paths, const std::vector<Detector>& detectors)
+  : paths(paths), active_detectors(0)
+{
+  if (paths.empty() || paths.size() > max_trigger_paths)
+  {
+    throw std::invalid_argument("A trigger needs between 1 and 32 paths");
+  }
+  for (const auto& path : paths)
+  {
+    if (path.prescale == 0)
+    {
+      throw std::invalid_argument("Trigger path " + path.name + " has a zero prescale");
+    }
+    double ratio = std::sinh(path.max_abs_eta); // |eta| <= max  <=>  |pz| <= sinh(max) * pT
+    max_pz_over_pt_squared.push_back(ratio * ratio);
+  }
+  for (const auto& detector : detectors)
+  {
+    if (detector.get_status())
+    {
+      active_detectors |= detector_type_bit(detector.get_type());
+    }
+  }
+}
+
+TriggerStats Trigger::make_stats() const
+{
+  TriggerStats stats;
+  stats.paths.resize(paths.size());
+  return stats;
+}
+
+std::size_t Trigger::filter(std::uint64_t first_event, const std::vector<ParticleStore>& events, std::vector<TriggerDecision>& decisions,
+                            TriggerStats& stats) const
+{
+  if (stats.paths.size() != paths.size())
+  {
+    throw std::invalid_argument("Trigger statistics must come from make_stats()");
+  }
+  decisions.assign(events.size(), TriggerDecision());
+
+  // Level 1, one path at a time so each path's cost is measured on its own
+  for (std::size_t p = 0; p < paths.size(); ++p)
+  {
+    const TriggerPathConfig& path = paths[p];
+    Clock::time_point start = Clock::now();
+    std::uint32_t bit = 1u << p;
+    std::uint64_t passed = 0;
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+      CandidateCount count = count_candidates(path, max_pz_over_pt_squared[p], events[e], nullptr);
+      if (count.candidates >= path.min_candidates && std::abs(count.charge_sum) <= path.max_abs_charge_sum)
+      {
+        decisions[e].level1 |= bit;
+        ++passed;
+      }
+    }
+    stats.paths[p].level1 += passed;
+    stats.paths[p].level1_seconds += seconds_since(start);
+  }
+
+  // Detector response, only for the events level 1 kept
+  Clock::time_point response_start = Clock::now();
+  std::vector<std::size_t> mask_offsets(events.size() + 1, 0);
+  for (std::size_t e = 0; e < events.size(); ++e)
+  {
+    mask_offsets[e + 1] = mask_offsets[e] + (decisions[e].level1 != 0 ? events[e].size() : 0);
+  }
+  std::vector<std::uint8_t> masks(mask_offsets.back());
+  for (std::size_t e = 0; e < events.size(); ++e)
+  {
+    if (decisions[e].level1 != 0)
+    {
+      std::uint8_t* event_masks = masks.data() + mask_offsets[e];
+      Detector::acceptance_masks(events[e].type_column().data(), events[e].size(), event_masks);
+      for (std::size_t i = 0; i < events[e].size(); ++i)
+      {
+        event_masks[i] &= active_detectors;
+      }
+    }
+  }
+  stats.response_seconds += seconds_since(response_start);
+
+  // High level and prescales
+  for (std::size_t p = 0; p < paths.size(); ++p)
+  {
+    const TriggerPathConfig& path = paths[p];
+    Clock::time_point start = Clock::now();
+    std::uint32_t bit = 1u << p;
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+      if ((decisions[e].level1 & bit) == 0)
+      {
+        continue;
+      }
+      CandidateCount count = count_candidates(path, max_pz_over_pt_squared[p], events[e], masks.data() + mask_offsets[e]);
+      if (count.detected < path.min_detected)
+      {
+        continue;
+      }
+      decisions[e].high_level |= bit;
+      ++stats.paths[p].high_level;
+      if (keeps_prescaled(path.prescale, first_event + e, p))
+      {
+        decisions[e].accepted |= bit;
+        ++stats.paths[p].accepted;
+      }
+    }
+    stats.paths[p].high_level_seconds += seconds_since(start);
+  }
+
+  std::size_t accepted = 0;
+  for (const auto& decision : decisions)
+  {
+    accepted += decision.is_accepted();
+  }
+  stats.events += events.size();
+  stats.accepted += accepted;
+  return accepted;
+}
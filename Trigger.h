@@ -0,0 +1,99 @@
+// Description: Defines the Trigger class, a two-level event filter run on columnar events before any Lepton objects exist.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "Detector.h"
+#include "ParticleStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+constexpr std::size_t max_trigger_paths = 32; // One bit per path in TriggerDecision
+
+// One trigger path. A particle is a candidate if its type is in particle_types and it
+// passes the pT and |eta| cuts; the path fires if both levels pass and the prescale keeps it.
+struct TriggerPathConfig
+{
+  std::string name;
+
+  // Level 1: raw kinematics from the store's columns
+  std::uint8_t particle_types = particle_type_bit(ParticleType::Electron) | particle_type_bit(ParticleType::Muon);
+  double min_pt = 0.0; // MeV/c
+  double max_abs_eta = std::numeric_limits<double>::infinity();
+  std::size_t min_candidates = 1;
+  int max_abs_charge_sum = std::numeric_limits<int>::max(); // Over the candidates; 0 asks for neutral combinations
+
+  // High level: candidates must have been seen by every detector in required_detectors
+  // (bit d for DetectorType d; detectors that are switched off see nothing)
+  std::uint8_t required_detectors = 0;
+  std::size_t min_detected = 0;
+
+  // Keeps one in prescale of the events that pass both levels. The choice is a hash
+  // of the event number, so it does not depend on batch order or thread count.
+  std::uint32_t prescale = 1;
+};
+
+struct TriggerDecision
+{
+  std::uint32_t level1 = 0; // Bit p set if path p passed level 1
+  std::uint32_t high_level = 0; // ... and the high-level stage
+  std::uint32_t accepted = 0; // ... and its prescale
+
+  bool is_accepted() const { return accepted != 0; }
+};
+
+struct TriggerPathStats
+{
+  std::uint64_t level1 = 0;
+  std::uint64_t high_level = 0;
+  std::uint64_t accepted = 0;
+  double level1_seconds = 0.0;
+  double high_level_seconds = 0.0;
+};
+
+// Counters for one or more filter() calls; keep one per thread and merge() at the end
+struct TriggerStats
+{
+  std::uint64_t events = 0;
+  std::uint64_t accepted = 0; // Events accepted by at least one path
+  double response_seconds = 0.0; // Detector response for the events level 1 kept
+  std::vector<TriggerPathStats> paths;
+
+  void merge(const TriggerStats& other);
+  double get_accept_rate() const { return events > 0 ? static_cast<double>(accepted) / events : 0.0; }
+  double get_accept_rate(std::size_t path) const { return events > 0 ? static_cast<double>(paths[path].accepted) / events : 0.0; }
+};
+
+// Level 1 runs path by path over the whole batch using only the energy, momentum,
+// charge and type columns. Detector responses are computed only for events some
+// path kept, and the high-level stage then re-checks those. Rejected events are
+// never turned into Lepton objects; callers materialize the accepted ones.
+//
+// Read-only after construction, so one instance can be shared between threads.
+class Trigger
+{
+private:
+  std::vector<TriggerPathConfig> paths;
+  std::vector<double> max_pz_over_pt_squared; // sinh^2(max_abs_eta) per path, the |eta| cut without a logarithm
+  std::uint8_t active_detectors;
+
+public:
+  // Throws std::invalid_argument for no paths, more than max_trigger_paths, or a zero prescale
+  Trigger(const std::vector<TriggerPathConfig>& paths, const std::vector<Detector>& detectors);
+
+  std::size_t get_path_count() const { return paths.size(); }
+  const TriggerPathConfig& get_path(std::size_t path) const { return paths[path]; }
+  TriggerStats make_stats() const; // Zeroed counters sized for the paths
+
+  // Decides events first_event .. first_event + events.size() - 1 into decisions and
+  // returns how many were accepted. stats must come from make_stats().
+  std::size_t filter(std::uint64_t first_event, const std::vector<ParticleStore>& events, std::vector<TriggerDecision>& decisions,
+                     TriggerStats& stats) const;
+};
+
+#endif
@@ -0,0 +1,185 @@
+// Description: Minimal microbenchmark harness reporting ns/op and items/sec as text and JSON.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Keeps the compiler from discarding a value that is computed only for timing
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Forces pending writes to memory to be treated as observed
+inline void clobber_memory()
+{
+  asm volatile("" : : : "memory");
+}
+
+struct BenchResult
+{
+  std::string name;
+  std::size_t batch_size; // Items processed by one call of the benchmark body
+  std::uint64_t iterations; // Calls of the body in the reported repetition
+  double ns_per_op; // Per item, not per call
+  double items_per_second;
+};
+
+// Runs a set of named benchmarks. Each body processes batch_size items per call; the
+// harness grows the call count until a repetition takes at least min_seconds, then
+// reports the fastest of several repetitions.
+//
+// Command line: --json <file> writes the report, --min-time <seconds> sets the target
+// repetition time, --filter <text> runs only benchmarks whose name contains the text.
+class BenchSuite
+{
+private:
+  using Clock = std::chrono::steady_clock;
+
+  std::string suite_name;
+  std::string json_path;
+  std::string filter;
+  double min_seconds = 0.1;
+  int repetitions = 3;
+  std::vector<BenchResult> results;
+
+  template <typename Body>
+  static double time_calls(Body& body, std::uint64_t calls)
+  {
+    Clock::time_point start = Clock::now();
+    for (std::uint64_t i = 0; i < calls; ++i)
+    {
+      body();
+      clobber_memory();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  static std::string escape(const std::string& text)
+  {
+    std::string escaped;
+    for (char c : text)
+    {
+      if (c == '"' || c == '\\')
+      {
+        escaped += '\\';
+      }
+      escaped += c;
+    }
+    return escaped;
+  }
+
+public:
+  BenchSuite(std::string name, int argc, char** argv) : suite_name(std::move(name))
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      bool has_value = i + 1 < argc;
+      if (std::strcmp(argv[i], "--json") == 0 && has_value)
+      {
+        json_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--min-time") == 0 && has_value)
+      {
+        min_seconds = std::atof(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--filter") == 0 && has_value)
+      {
+        filter = argv[++i];
+      }
+      else
+      {
+        throw std::invalid_argument(std::string("Unknown benchmark option: ") + argv[i]);
+      }
+    }
+    if (min_seconds <= 0)
+    {
+      throw std::invalid_argument("--min-time must be greater than 0");
+    }
+  }
+
+  template <typename Body>
+  void run(const std::string& name, std::size_t batch_size, Body body)
+  {
+    if (!filter.empty() && name.find(filter) == std::string::npos)
+    {
+      return;
+    }
+    if (batch_size == 0)
+    {
+      throw std::invalid_argument("Benchmark batch size must be greater than 0");
+    }
+
+    // Warm caches and branch predictors, then calibrate the call count
+    time_calls(body, 1);
+    std::uint64_t calls = 1;
+    double elapsed = time_calls(body, calls);
+    while (elapsed < min_seconds && calls < (1ULL << 40))
+    {
+      double scale = elapsed > 0 ? 1.4 * min_seconds / elapsed : 10.0;
+      calls = std::max(calls + 1, static_cast<std::uint64_t>(calls * std::min(scale, 10.0)));
+      elapsed = time_calls(body, calls);
+    }
+
+    double best = elapsed;
+    for (int repetition = 1; repetition < repetitions; ++repetition)
+    {
+      best = std::min(best, time_calls(body, calls));
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.batch_size = batch_size;
+    result.iterations = calls;
+    result.ns_per_op = best * 1e9 / (static_cast<double>(calls) * batch_size);
+    result.items_per_second = result.ns_per_op > 0 ? 1e9 / result.ns_per_op : 0.0;
+    results.push_back(result);
+
+    std::cout << std::left << std::setw(44) << name << std::right << std::setw(8) << batch_size
+              << std::fixed << std::setprecision(2) << std::setw(12) << result.ns_per_op << " ns/op"
+              << std::setprecision(0) << std::setw(16) << result.items_per_second << " items/s\n";
+  }
+
+  const std::vector<BenchResult>& get_results() const { return results; }
+
+  // Writes the JSON report if one was requested; returns the process exit code
+  int finish() const
+  {
+    if (json_path.empty())
+    {
+      return 0;
+    }
+    std::ofstream out(json_path);
+    if (!out)
+    {
+      std::cerr << "Could not open " << json_path << " for writing\n";
+      return 1;
+    }
+    out << std::setprecision(6) << "{\n  \"suite\": \"" << escape(suite_name) << "\",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const BenchResult& result = results[i];
+      out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << escape(result.name) << "\", \"batch_size\": " << result.batch_size
+          << ", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.ns_per_op
+          << ", \"items_per_second\": " << result.items_per_second << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out ? 0 : 1;
+  }
+};
+
+#endif
@@ -0,0 +1,136 @@
+// Description: Microbenchmarks for LorentzBoost and the batched boost kernels.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "LorentzBoost.h"
+#include "MomentumKernels.h"
+#include "Muon.h"
+#include "ParticleStore.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace
+{
+  // One generated event and one EventFile block
+  constexpr std::array<std::size_t, 2> batch_sizes = {8, 4096};
+
+  // A Z boson moving along the beam, and the muons to take into its rest frame
+  const FourMomentum parent(std::sqrt(91187.6 * 91187.6 + 60000.0 * 60000.0 + 250000.0 * 250000.0), 60000.0, 0.0, 250000.0);
+
+  ParticleStore make_muons(std::size_t count, std::uint64_t seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::normal_distribution<double> momentum(0.0, 40000.0);
+    ParticleStore muons;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      double px = momentum(engine);
+      double py = momentum(engine);
+      double pz = momentum(engine);
+      muons.add_muon(105.7, i % 2 == 0 ? -1 : 1, std::sqrt(px * px + py * py + pz * pz + 105.7 * 105.7), px, py, pz);
+    }
+    return muons;
+  }
+
+  // What analysis code wrote before: the boost rebuilt from the parent for every
+  // lepton. direction -1 goes into the parent's rest frame, +1 back out.
+  void naive_boost(Lepton& lepton, const Lepton& parent_lepton, double direction)
+  {
+    double bx = direction * parent_lepton.get_px() / parent_lepton.get_e();
+    double by = direction * parent_lepton.get_py() / parent_lepton.get_e();
+    double bz = direction * parent_lepton.get_pz() / parent_lepton.get_e();
+    double beta_squared = bx * bx + by * by + bz * bz;
+    double gamma = 1.0 / std::sqrt(1.0 - beta_squared);
+    double beta_dot_p = bx * lepton.get_px() + by * lepton.get_py() + bz * lepton.get_pz();
+    double shift = (gamma - 1.0) / beta_squared * beta_dot_p + gamma * lepton.get_e();
+    lepton.set_four_momentum(gamma * (lepton.get_e() + beta_dot_p), lepton.get_px() + bx * shift, lepton.get_py() + by * shift,
+                             lepton.get_pz() + bz * shift);
+  }
+
+  void bench_boosts(BenchSuite& suite, std::size_t batch)
+  {
+    ParticleStore muons = make_muons(batch, 1);
+    ParticleStore parents = make_muons(batch, 2);
+    std::string suffix = "/" + std::to_string(batch);
+    LorentzBoost to_rest = LorentzBoost::to_rest_frame(parent);
+
+    std::vector<double> bx(batch), by(batch), bz(batch), gamma(batch), gamma_factor(batch);
+    MutableBoostColumns boosts{bx.data(), by.data(), bz.data(), gamma.data(), gamma_factor.data(), batch};
+    to_rest_frame_boosts(parents.momenta(), boosts);
+    std::vector<double> e(batch), x(batch), y(batch), z(batch);
+    MutableMomentumColumns out{e.data(), x.data(), y.data(), z.data(), batch};
+    Muon parent_lepton(91187.6, 0, parent.get_energy(), parent.get_px(), parent.get_py(), parent.get_pz()); // Stands in for the Z
+    std::vector<std::unique_ptr<Lepton>> copies;
+    for (const auto& muon : muons)
+    {
+      const FourMomentum& momentum = muon.get_four_momentum();
+      copies.push_back(std::make_unique<Muon>(105.7, muon.get_charge(), momentum.get_energy(), momentum.get_px(), momentum.get_py(),
+                                              momentum.get_pz()));
+    }
+    // The object loops boost into the rest frame and back, so repeated runs stay bounded
+    suite.run("naive Lepton round trip" + suffix, 2 * batch, [&]
+    {
+      for (auto& lepton : copies)
+      {
+        naive_boost(*lepton, parent_lepton, -1.0);
+      }
+      for (auto& lepton : copies)
+      {
+        naive_boost(*lepton, parent_lepton, 1.0);
+      }
+      clobber_memory();
+    });
+    LorentzBoost from_rest = to_rest.inverse();
+    suite.run("Lepton::boost round trip" + suffix, 2 * batch, [&]
+    {
+      for (auto& lepton : copies)
+      {
+        lepton->boost(to_rest);
+      }
+      for (auto& lepton : copies)
+      {
+        lepton->boost(from_rest);
+      }
+      clobber_memory();
+    });
+
+    std::string level = simd_level_name(get_kernel_simd_level());
+    suite.run("boost_batch round trip[" + level + "]" + suffix, 2 * batch, [&]
+    {
+      boost_batch(to_rest, muons.momenta(), out);
+      boost_batch(from_rest, out, out);
+      do_not_optimize(e.data());
+    });
+    suite.run("boost_batch per-element[" + level + "]" + suffix, batch, [&]
+    {
+      boost_batch(boosts, muons.momenta(), out);
+      do_not_optimize(e.data());
+    });
+    suite.run("to_rest_frame_boosts" + suffix, batch, [&]
+    {
+      to_rest_frame_boosts(parents.momenta(), boosts);
+      do_not_optimize(bx.data());
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("boost", argc, argv);
+    for (std::size_t batch : batch_sizes)
+    {
+      bench_boosts(suite, batch);
+    }
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
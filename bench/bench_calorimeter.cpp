@@ -0,0 +1,97 @@
+// Description: Microbenchmarks for calorimeter deposition, topological clustering and per-event reset.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "Calorimeter.h"
+#include "EventGenerator.h"
+#include "ParticleStore.h"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+  constexpr std::size_t events_per_batch = 256;
+
+  std::vector<ParticleStore> make_events(std::size_t min_particles, std::size_t max_particles)
+  {
+    EventGeneratorConfig config;
+    config.min_particles = min_particles;
+    config.max_particles = max_particles;
+    EventGenerator generator(config);
+    std::vector<ParticleStore> events(events_per_batch);
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+      generator.generate_event(i, events[i]);
+    }
+    return events;
+  }
+
+  void bench_events(BenchSuite& suite, const std::string& label, const std::vector<ParticleStore>& events)
+  {
+    Calorimeter calorimeter;
+    std::vector<CaloCluster> clusters;
+
+    suite.run("deposit_event+reset/" + label, events.size(), [&]
+    {
+      for (const auto& event : events)
+      {
+        calorimeter.reset();
+        calorimeter.deposit_event(event);
+      }
+      do_not_optimize(calorimeter.get_touched_count());
+    });
+
+    suite.run("deposit_event+cluster/" + label, events.size(), [&]
+    {
+      for (const auto& event : events)
+      {
+        calorimeter.reset();
+        calorimeter.deposit_event(event);
+        calorimeter.cluster(clusters);
+      }
+      do_not_optimize(clusters.data());
+    });
+
+    std::vector<ParticleStore> copies = events;
+    suite.run("full chain+electron feedback/" + label, events.size(), [&]
+    {
+      std::size_t matched = 0;
+      for (auto& event : copies)
+      {
+        calorimeter.reset();
+        calorimeter.deposit_event(event);
+        calorimeter.cluster(clusters);
+        matched += calorimeter.update_electron_layers(event, clusters);
+      }
+      do_not_optimize(matched);
+    });
+
+    // What reset() avoids: clearing every cell of the grid between events
+    std::vector<double> grid(calorimeter.get_cell_count());
+    suite.run("full grid clear (reference)/" + label, events.size(), [&]
+    {
+      for (std::size_t i = 0; i < events.size(); ++i)
+      {
+        std::fill(grid.begin(), grid.end(), 0.0);
+        do_not_optimize(grid.data());
+      }
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("calorimeter", argc, argv);
+    bench_events(suite, "2-8 particles", make_events(2, 8));
+    bench_events(suite, "50-100 particles", make_events(50, 100));
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,202 @@
+// Description: Microbenchmarks comparing the Combinatorics engine with nested loops over Lepton sums; tests/test_combinatorics checks that they agree.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "Combinatorics.h"
+#include "Muon.h"
+#include "ParticleStore.h"
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace
+{
+  // A typical dimuon event, a busy event and a heavy-ion-like one
+  constexpr std::array<std::size_t, 3> lepton_counts = {8, 100, 400};
+
+  std::vector<Muon> make_muons(std::size_t count)
+  {
+    std::mt19937_64 engine(count);
+    std::exponential_distribution<double> transverse(1.0 / 20000.0);
+    std::uniform_real_distribution<double> angle(-3.141592653589793, 3.141592653589793);
+    std::uniform_real_distribution<double> pseudorapidity(-2.5, 2.5);
+    std::vector<Muon> muons;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      double pt = transverse(engine);
+      double phi = angle(engine);
+      double pz = pt * std::sinh(pseudorapidity(engine));
+      double px = pt * std::cos(phi);
+      double py = pt * std::sin(phi);
+      double energy = std::sqrt(px * px + py * py + pz * pz + 105.7 * 105.7);
+      muons.emplace_back(105.7, i % 2 == 0 ? -1 : 1, energy, px, py, pz);
+    }
+    return muons;
+  }
+
+  // What Muon::operator+ used to do: a whole new Muon per addition, built through the logging getters
+  Muon combine(const Muon& first, const Muon& second)
+  {
+    return Muon(first.get_rest_mass() + second.get_rest_mass(), first.get_charge() + second.get_charge(),
+                first.get_e() + second.get_e(), first.get_px() + second.get_px(), first.get_py() + second.get_py(),
+                first.get_pz() + second.get_pz(), first.get_isolated() && second.get_isolated());
+  }
+
+  void bench_pairs(BenchSuite& suite, std::size_t count)
+  {
+    std::vector<Muon> muons = make_muons(count);
+    std::vector<const Lepton*> leptons;
+    ParticleStore store;
+    for (const auto& muon : muons)
+    {
+      leptons.push_back(&muon);
+      store.add(muon);
+    }
+    std::size_t pairs = count * (count - 1) / 2;
+    std::string suffix = "/" + std::to_string(count);
+
+    CandidateSelection selection;
+    selection.min_mass = 60000.0;
+    selection.max_mass = 120000.0;
+
+    // Baseline: what analysis code wrote before, one Muon object per pair
+    std::vector<double> masses;
+    masses.reserve(pairs);
+    suite.run("pairs Muon object per pair" + suffix, pairs, [&]
+    {
+      masses.clear();
+      for (std::size_t i = 0; i < muons.size(); ++i)
+      {
+        for (std::size_t j = i + 1; j < muons.size(); ++j)
+        {
+          if (muons[i].get_charge() != -muons[j].get_charge())
+          {
+            continue;
+          }
+          double mass = combine(muons[i], muons[j]).get_four_momentum().get_mass();
+          if (mass >= selection.min_mass && mass <= selection.max_mass)
+          {
+            masses.push_back(mass);
+          }
+        }
+      }
+      do_not_optimize(masses.data());
+    });
+
+    // The same loop over the lazy operator+
+    std::vector<double> expression_masses;
+    expression_masses.reserve(pairs);
+    suite.run("pairs operator+ expression" + suffix, pairs, [&]
+    {
+      expression_masses.clear();
+      for (std::size_t i = 0; i < muons.size(); ++i)
+      {
+        for (std::size_t j = i + 1; j < muons.size(); ++j)
+        {
+          if (muons[i].get_charge() != -muons[j].get_charge())
+          {
+            continue;
+          }
+          double mass = (muons[i] + muons[j]).get_mass();
+          if (mass >= selection.min_mass && mass <= selection.max_mass)
+          {
+            expression_masses.push_back(mass);
+          }
+        }
+      }
+      do_not_optimize(expression_masses.data());
+    });
+
+    Combinatorics combinatorics(selection);
+    PairCandidates candidates;
+    suite.run("pairs Combinatorics(store)" + suffix, pairs, [&]
+    {
+      candidates.clear();
+      combinatorics.find_pairs(store, candidates);
+      do_not_optimize(candidates.mass.data());
+    });
+    suite.run("pairs Combinatorics(leptons)" + suffix, pairs, [&]
+    {
+      candidates.clear();
+      combinatorics.find_pairs(leptons.data(), leptons.size(), candidates);
+      do_not_optimize(candidates.mass.data());
+    });
+
+    // Leading lepton above 25 GeV, second above 15 GeV: the sorted loops stop early
+    CandidateSelection thresholds = selection;
+    thresholds.min_pt = {25000.0, 15000.0, 0.0};
+    combinatorics.set_selection(thresholds);
+    suite.run("pairs Combinatorics(store, pT cuts)" + suffix, pairs, [&]
+    {
+      candidates.clear();
+      combinatorics.find_pairs(store, candidates);
+      do_not_optimize(candidates.mass.data());
+    });
+  }
+
+  // Total momentum of the whole event; items are muons
+  void bench_system(BenchSuite& suite, std::size_t count)
+  {
+    std::vector<Muon> muons = make_muons(count);
+    std::string suffix = "/" + std::to_string(count);
+
+    suite.run("system chained Muon objects" + suffix, count, [&]
+    {
+      Muon sum = muons[0];
+      for (std::size_t i = 1; i < muons.size(); ++i)
+      {
+        sum = combine(sum, muons[i]);
+      }
+      do_not_optimize(sum.get_four_momentum().get_mass());
+    });
+    suite.run("system sum_momenta" + suffix, count, [&]
+    {
+      do_not_optimize(sum_momenta(muons).get_mass());
+    });
+  }
+
+  void bench_triplets(BenchSuite& suite, std::size_t count)
+  {
+    std::vector<Muon> muons = make_muons(count);
+    ParticleStore store;
+    for (const auto& muon : muons)
+    {
+      store.add(muon);
+    }
+    std::size_t triplets = count * (count - 1) * (count - 2) / 6;
+    std::string suffix = "/" + std::to_string(count);
+
+    CandidateSelection selection;
+    selection.min_mass = 5000.0;
+    selection.max_mass = 15000.0;
+    Combinatorics combinatorics(selection);
+    TripletCandidates candidates;
+    suite.run("triplets Combinatorics(store)" + suffix, triplets, [&]
+    {
+      candidates.clear();
+      combinatorics.find_triplets(store, candidates);
+      do_not_optimize(candidates.mass.data());
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("combinatorics", argc, argv);
+    for (std::size_t count : lepton_counts)
+    {
+      bench_pairs(suite, count);
+      bench_system(suite, count);
+      bench_triplets(suite, count);
+    }
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,129 @@
+// Description: Microbenchmarks for event summaries (MET, visible momentum, HT) and their reductions over a sample.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "EventGenerator.h"
+#include "EventSummary.h"
+#include "MomentumKernels.h"
+#include "ThreadPool.h"
+#include <cstring>
+
+namespace
+{
+  constexpr std::size_t event_count = 20000;
+
+  // What analysis code wrote before: one loop per event over the row proxies
+  EventSummary summarize_views(const ParticleStore& event)
+  {
+    EventSummary summary;
+    for (ParticleView view : event)
+    {
+      ParticleType type = view.get_type();
+      if (type == ParticleType::Electron || type == ParticleType::Muon)
+      {
+        summary.visible += view.get_four_momentum();
+        summary.ht += view.get_four_momentum().get_pt();
+        ++summary.visible_count;
+      }
+      else if (type == ParticleType::Neutrino || type == ParticleType::TauNeutrino)
+      {
+        summary.true_met_x += view.get_px();
+        summary.true_met_y += view.get_py();
+        ++summary.neutrino_count;
+      }
+    }
+    summary.met_x = 0.0 - summary.visible.get_px();
+    summary.met_y = 0.0 - summary.visible.get_py();
+    return summary;
+  }
+
+  bool same_bits(const EventSampleTotals& first, const EventSampleTotals& second)
+  {
+    return std::memcmp(&first, &second, sizeof(EventSampleTotals)) == 0;
+  }
+
+  void bench_summaries(BenchSuite& suite, const std::vector<ParticleStore>& events, ThreadPool& pool)
+  {
+    std::size_t particles = 0;
+    for (const auto& event : events)
+    {
+      particles += event.size();
+    }
+    std::vector<EventSummary> summaries(events.size());
+
+    // Items are particles. AVX-512 machines run the AVX2 kernel, so the levels compared stop there.
+    suite.run("ParticleView loop", particles, [&]
+    {
+      for (std::size_t i = 0; i < events.size(); ++i)
+      {
+        summaries[i] = summarize_views(events[i]);
+      }
+      do_not_optimize(summaries.data());
+    });
+
+    SimdLevel detected = get_kernel_simd_level();
+    std::vector<std::vector<EventSummary>> by_level;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2})
+    {
+      if (level > detected)
+      {
+        continue;
+      }
+      set_kernel_simd_level(level);
+      suite.run("summarize_event[" + std::string(simd_level_name(level)) + "]", particles, [&]
+      {
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+          summaries[i] = summarize_event(events[i]);
+        }
+        do_not_optimize(summaries.data());
+      });
+      by_level.push_back(summaries);
+    }
+    set_kernel_simd_level(detected);
+    if (by_level.size() > 1 && std::memcmp(by_level[0].data(), by_level[1].data(), summaries.size() * sizeof(EventSummary)) != 0)
+    {
+      throw std::runtime_error("Scalar and AVX2 event summaries differ");
+    }
+
+    suite.run("summarize_events(pool)", particles, [&]
+    {
+      summarize_events(events, summaries, pool);
+      do_not_optimize(summaries.data());
+    });
+
+    // Items are summaries
+    EventSampleTotals serial = reduce_summaries(summaries);
+    ThreadPool single(1);
+    if (!same_bits(serial, reduce_summaries(summaries, pool)) || !same_bits(serial, reduce_summaries(summaries, single)))
+    {
+      throw std::runtime_error("Event sample totals depend on the thread count");
+    }
+    suite.run("reduce_summaries(serial)", summaries.size(), [&]
+    {
+      do_not_optimize(reduce_summaries(summaries).ht);
+    });
+    suite.run("reduce_summaries(pool)", summaries.size(), [&]
+    {
+      do_not_optimize(reduce_summaries(summaries, pool).ht);
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("event_summary", argc, argv);
+    ThreadPool pool;
+    std::vector<ParticleStore> events = EventGenerator().generate(0, event_count, pool);
+    bench_summaries(suite, events, pool);
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
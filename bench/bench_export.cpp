@@ -0,0 +1,167 @@
+// Description: Microbenchmarks comparing EventExporter CSV and JSON-lines output with per-particle print_info.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "EventArena.h"
+#include "EventExporter.h"
+#include "EventGenerator.h"
+#include "Lepton.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+  constexpr std::size_t event_count = 20000;
+  const char* export_path = "bench_export.tmp"; // Real file, so the timings include the write() calls
+
+  std::size_t count_particles(const std::vector<ParticleStore>& events)
+  {
+    std::size_t particles = 0;
+    for (const auto& event : events)
+    {
+      particles += event.size();
+    }
+    return particles;
+  }
+
+  std::string read_file(const std::string& path)
+  {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+  }
+
+  std::string export_store(const std::vector<ParticleStore>& events, const ExportConfig& config)
+  {
+    EventExporter exporter(export_path, config);
+    exporter.write(events);
+    exporter.close();
+    return read_file(export_path);
+  }
+
+  std::string export_objects(const std::vector<ParticleStore>& events, const ExportConfig& config)
+  {
+    EventExporter exporter(export_path, config);
+    EventArena arena;
+    for (const auto& event : events)
+    {
+      ArenaSpan<Lepton*> objects = event.materialize(arena);
+      exporter.write(objects.data(), objects.size());
+      arena.reset();
+    }
+    exporter.close();
+    return read_file(export_path);
+  }
+
+  // Background writing must not change the output, and objects must export exactly
+  // as their store does
+  void check_exports(const std::vector<ParticleStore>& events)
+  {
+    for (ExportFormat format : {ExportFormat::Csv, ExportFormat::JsonLines})
+    {
+      ExportConfig config;
+      config.format = format;
+      config.chunk_bytes = 4096; // Many chunk hand-offs
+      std::string direct = export_store(events, config);
+      if (export_objects(events, config) != direct)
+      {
+        throw std::runtime_error("Exports of the store and of its objects differ");
+      }
+      config.background = true;
+      if (export_store(events, config) != direct)
+      {
+        throw std::runtime_error("Background export differs from direct export");
+      }
+      config.decimals = 6;
+      if (export_objects(events, config) != export_store(events, config))
+      {
+        throw std::runtime_error("Exports of the store and of its objects differ");
+      }
+    }
+  }
+
+  void bench_exports(BenchSuite& suite, const std::vector<ParticleStore>& events)
+  {
+    std::size_t particles = count_particles(events);
+
+    // What main.cpp did before: every particle through print_info into std::cout
+    EventArena arena;
+    std::vector<ArenaSpan<Lepton*>> objects;
+    for (const auto& event : events)
+    {
+      objects.push_back(event.materialize(arena));
+    }
+    suite.run("print_info to file", particles, [&]
+    {
+      std::ofstream file(export_path);
+      std::streambuf* console = std::cout.rdbuf(file.rdbuf());
+      for (const auto& event : objects)
+      {
+        for (const Lepton* particle : event)
+        {
+          particle->print_info();
+        }
+      }
+      std::cout.rdbuf(console);
+    });
+
+    struct Variant
+    {
+      const char* name;
+      ExportFormat format;
+      int decimals;
+      bool background;
+    };
+    for (const Variant& variant : {Variant{"EventExporter CSV", ExportFormat::Csv, -1, false},
+                                   Variant{"EventExporter CSV background", ExportFormat::Csv, -1, true},
+                                   Variant{"EventExporter CSV 3 decimals", ExportFormat::Csv, 3, false},
+                                   Variant{"EventExporter CSV 3 decimals background", ExportFormat::Csv, 3, true},
+                                   Variant{"EventExporter JSON lines", ExportFormat::JsonLines, -1, false},
+                                   Variant{"EventExporter JSON lines 3 decimals", ExportFormat::JsonLines, 3, false}})
+    {
+      ExportConfig config;
+      config.format = variant.format;
+      config.decimals = variant.decimals;
+      config.background = variant.background;
+      suite.run(variant.name, particles, [&]
+      {
+        EventExporter exporter(export_path, config);
+        exporter.write(events);
+        exporter.close();
+      });
+    }
+    suite.run("EventExporter CSV from objects", particles, [&]
+    {
+      EventExporter exporter(export_path);
+      for (const auto& event : objects)
+      {
+        exporter.write(event.data(), event.size());
+      }
+      exporter.close();
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("export", argc, argv);
+    ThreadPool pool(1);
+    std::vector<ParticleStore> events = EventGenerator().generate(0, event_count, pool);
+    check_exports(events);
+    bench_exports(suite, events);
+    std::remove(export_path);
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::remove(export_path);
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
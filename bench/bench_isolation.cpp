@@ -0,0 +1,85 @@
+// Description: Microbenchmarks comparing spatial-index muon isolation with the brute-force O(N^2) cone sums.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "Isolation.h"
+#include "ParticleStore.h"
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace
+{
+  // A typical event, a busy event and a heavy-ion-like one
+  constexpr std::array<std::size_t, 3> particle_counts = {8, 100, 1000};
+
+  // One muon in four; the rest split between electrons and electron neutrinos
+  ParticleStore make_event(std::size_t count)
+  {
+    std::mt19937_64 engine(count);
+    std::exponential_distribution<double> transverse(1.0 / 10000.0);
+    std::uniform_real_distribution<double> angle(-3.141592653589793, 3.141592653589793);
+    std::uniform_real_distribution<double> pseudorapidity(-2.5, 2.5);
+    ParticleStore event;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      double pt = transverse(engine);
+      double phi = angle(engine);
+      double pz = pt * std::sinh(pseudorapidity(engine));
+      double px = pt * std::cos(phi);
+      double py = pt * std::sin(phi);
+      double energy = std::sqrt(px * px + py * py + pz * pz + 105.7 * 105.7);
+      int charge = i % 2 == 0 ? -1 : 1;
+      switch (i % 4)
+      {
+        case 0: event.add_muon(105.7, charge, energy, px, py, pz); break;
+        case 3: event.add_neutrino(0.0, 0, energy, px, py, pz, NeutrinoFlavor::Electron); break;
+        default: event.add_electron(0.511, charge, energy, px, py, pz); break;
+      }
+    }
+    return event;
+  }
+
+  void bench_cone_sums(BenchSuite& suite, std::size_t count)
+  {
+    ParticleStore event = make_event(count);
+    std::string suffix = "/" + std::to_string(count);
+    IsolationConfig config;
+
+    MuonIsolation isolation(config); // tests/test_isolation checks it against the brute force
+    std::vector<double> cone_sums;
+    suite.run("cone sums brute force" + suffix, count, [&]
+    {
+      compute_isolation_brute_force(event, config, cone_sums);
+      do_not_optimize(cone_sums.data());
+    });
+    suite.run("cone sums MuonIsolation" + suffix, count, [&]
+    {
+      isolation.compute(event);
+      do_not_optimize(isolation.get_cone_sums().data());
+    });
+    suite.run("apply MuonIsolation" + suffix, count, [&]
+    {
+      do_not_optimize(isolation.apply(event));
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("isolation", argc, argv);
+    for (std::size_t count : particle_counts)
+    {
+      bench_cone_sums(suite, count);
+    }
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,367 @@
+// Description: Microbenchmarks for the lepton, four-momentum and detector hot paths.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "Detector.h"
+#include "Electron.h"
+#include "MomentumKernels.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "ParticleStore.h"
+#include "Tau.h"
+#include "TauNeutrino.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace
+{
+  // One generated event and one EventFile block
+  constexpr std::array<std::size_t, 2> batch_sizes = {8, 4096};
+
+  struct Kinematics
+  {
+    double energy, px, py, pz;
+  };
+
+  std::vector<Kinematics> make_kinematics(std::size_t count, std::uint64_t seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::normal_distribution<double> momentum(0.0, 20000.0);
+    std::vector<Kinematics> rows(count);
+    for (auto& row : rows)
+    {
+      row.px = momentum(engine);
+      row.py = momentum(engine);
+      row.pz = momentum(engine);
+      row.energy = std::sqrt(row.px * row.px + row.py * row.py + row.pz * row.pz + 105.7 * 105.7);
+    }
+    return rows;
+  }
+
+  std::vector<Electron> make_electrons(const std::vector<Kinematics>& rows)
+  {
+    std::vector<Electron> electrons;
+    electrons.reserve(rows.size());
+    for (const auto& row : rows)
+    {
+      electrons.emplace_back(0.511, -1, row.energy, row.px, row.py, row.pz);
+      electrons.back().set_layer_energies({0.3 * row.energy, 0.6 * row.energy, 0.07 * row.energy, 0.02 * row.energy});
+    }
+    return electrons;
+  }
+
+  // A realistic mix of types behind Lepton pointers, as detect_particle sees them
+  std::vector<std::unique_ptr<Lepton>> make_mixed(const std::vector<Kinematics>& rows)
+  {
+    std::vector<std::unique_ptr<Lepton>> particles;
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      const Kinematics& row = rows[i];
+      switch (i % 5)
+      {
+        case 0: particles.push_back(std::make_unique<Electron>(0.511, -1, row.energy, row.px, row.py, row.pz)); break;
+        case 1: particles.push_back(std::make_unique<Muon>(105.7, 1, row.energy, row.px, row.py, row.pz)); break;
+        case 2: particles.push_back(std::make_unique<Neutrino>(0, 0, row.energy, row.px, row.py, row.pz, NeutrinoFlavor::Muon)); break;
+        case 3: particles.push_back(std::make_unique<TauNeutrino>(0, 0, row.energy, row.px, row.py, row.pz)); break;
+        default: particles.push_back(std::make_unique<Tau>(1776.86, -1, row.energy, row.px, row.py, row.pz, TauDecayMode::Hadronic)); break;
+      }
+    }
+    return particles;
+  }
+
+  void bench_construction(BenchSuite& suite, std::size_t batch)
+  {
+    std::vector<Kinematics> rows = make_kinematics(batch, 1);
+    std::string suffix = "/" + std::to_string(batch);
+
+    std::vector<Electron> electrons;
+    electrons.reserve(batch);
+    suite.run("Electron construct" + suffix, batch, [&]
+    {
+      electrons.clear();
+      for (const auto& row : rows)
+      {
+        electrons.emplace_back(0.511, -1, row.energy, row.px, row.py, row.pz);
+      }
+      do_not_optimize(electrons.data());
+    });
+
+    std::vector<Muon> muons;
+    muons.reserve(batch);
+    suite.run("Muon construct" + suffix, batch, [&]
+    {
+      muons.clear();
+      for (const auto& row : rows)
+      {
+        muons.emplace_back(105.7, -1, row.energy, row.px, row.py, row.pz, true);
+      }
+      do_not_optimize(muons.data());
+    });
+
+    std::vector<Tau> taus;
+    taus.reserve(batch);
+    suite.run("Tau construct" + suffix, batch, [&]
+    {
+      taus.clear();
+      for (const auto& row : rows)
+      {
+        taus.emplace_back(1776.86, -1, row.energy, row.px, row.py, row.pz, TauDecayMode::Leptonic);
+      }
+      do_not_optimize(taus.data());
+    });
+
+    // Copies and moves go into reserved storage so only the element operations are timed
+    std::vector<Electron> source = make_electrons(rows);
+    std::vector<Electron> target;
+    target.reserve(batch);
+    suite.run("Electron copy" + suffix, batch, [&]
+    {
+      target.clear();
+      for (const auto& electron : source)
+      {
+        target.push_back(electron);
+      }
+      do_not_optimize(target.data());
+    });
+    suite.run("Electron move" + suffix, batch, [&]
+    {
+      target.clear();
+      for (auto& electron : source)
+      {
+        target.push_back(std::move(electron));
+      }
+      do_not_optimize(target.data());
+    });
+
+    std::vector<Muon> muon_target;
+    muon_target.reserve(batch);
+    suite.run("Muon copy" + suffix, batch, [&]
+    {
+      muon_target.clear();
+      for (const auto& muon : muons)
+      {
+        muon_target.push_back(muon);
+      }
+      do_not_optimize(muon_target.data());
+    });
+
+    std::vector<Tau> tau_target;
+    tau_target.reserve(batch);
+    suite.run("Tau copy" + suffix, batch, [&]
+    {
+      tau_target.clear();
+      for (const auto& tau : taus)
+      {
+        tau_target.push_back(tau);
+      }
+      do_not_optimize(tau_target.data());
+    });
+  }
+
+  void bench_kinematics(BenchSuite& suite, std::size_t batch)
+  {
+    std::vector<Kinematics> rows = make_kinematics(2 * batch, 2);
+    std::vector<Electron> electrons = make_electrons(rows);
+    std::string suffix = "/" + std::to_string(batch);
+
+    std::vector<FourMomentum> sums(batch);
+    std::vector<double> dots(batch);
+    for (std::size_t i = 0; i < batch; ++i)
+    {
+      sums[i] = sum_four_momenta(electrons[2 * i], electrons[2 * i + 1]);
+      dots[i] = dot_product_four_momenta(electrons[2 * i], electrons[2 * i + 1]);
+    }
+
+    suite.run("sum_four_momenta" + suffix, batch, [&]
+    {
+      for (std::size_t i = 0; i < batch; ++i)
+      {
+        sums[i] = sum_four_momenta(electrons[2 * i], electrons[2 * i + 1]);
+      }
+      do_not_optimize(sums.data());
+    });
+
+    suite.run("dot_product_four_momenta" + suffix, batch, [&]
+    {
+      for (std::size_t i = 0; i < batch; ++i)
+      {
+        dots[i] = dot_product_four_momenta(electrons[2 * i], electrons[2 * i + 1]);
+      }
+      do_not_optimize(dots.data());
+    });
+
+    suite.run("Electron::adjust_layer_energies" + suffix, batch, [&]
+    {
+      for (std::size_t i = 0; i < batch; ++i)
+      {
+        electrons[i].adjust_layer_energies();
+      }
+      do_not_optimize(electrons.data());
+    });
+
+    // The columnar kernels on the same pairs, for comparison with the object versions
+    ParticleStore first, second;
+    for (std::size_t i = 0; i < batch; ++i)
+    {
+      const Kinematics& a = rows[2 * i];
+      const Kinematics& b = rows[2 * i + 1];
+      first.add_electron(0.511, -1, a.energy, a.px, a.py, a.pz);
+      second.add_electron(0.511, -1, b.energy, b.px, b.py, b.pz);
+    }
+    std::vector<double> e(batch), x(batch), y(batch), z(batch);
+    MutableMomentumColumns out{e.data(), x.data(), y.data(), z.data(), batch};
+    std::vector<double> batch_dots(batch);
+
+    sum_four_momenta_batch(first.momenta(), second.momenta(), out);
+    dot_product_four_momenta_batch(first.momenta(), second.momenta(), batch_dots.data());
+    for (std::size_t i = 0; i < batch; ++i)
+    {
+      if (e[i] != sums[i].get_energy() || x[i] != sums[i].get_px() || batch_dots[i] != dots[i])
+      {
+        throw std::runtime_error("Batch kernels disagree with sum_four_momenta/dot_product_four_momenta");
+      }
+    }
+
+    std::string level = simd_level_name(get_kernel_simd_level());
+    suite.run("sum_four_momenta_batch[" + level + "]" + suffix, batch, [&]
+    {
+      sum_four_momenta_batch(first.momenta(), second.momenta(), out);
+      do_not_optimize(e.data());
+    });
+    suite.run("dot_product_four_momenta_batch[" + level + "]" + suffix, batch, [&]
+    {
+      dot_product_four_momenta_batch(first.momenta(), second.momenta(), batch_dots.data());
+      do_not_optimize(batch_dots.data());
+    });
+  }
+
+  // Three selections asking each particle for the same derived quantities, as analysis
+  // loops do: recomputed each time, cached on first use, or filled in one batch pass
+  void bench_derived(BenchSuite& suite, std::size_t batch)
+  {
+    std::vector<Kinematics> rows = make_kinematics(batch, 4);
+    std::vector<FourMomentum> momenta;
+    ParticleStore store;
+    for (const Kinematics& row : rows)
+    {
+      momenta.emplace_back(row.energy, row.px, row.py, row.pz);
+      store.add_muon(105.7, -1, row.energy, row.px, row.py, row.pz);
+    }
+    std::vector<CachedFourMomentum> cached(batch);
+    std::vector<double> pt(batch), eta(batch), phi(batch), mass(batch);
+    MutableKinematicsColumns columns{pt.data(), eta.data(), phi.data(), mass.data(), batch};
+    std::string suffix = "/" + std::to_string(batch);
+
+    kinematics_batch(store.momenta(), columns);
+    for (std::size_t i = 0; i < batch; ++i)
+    {
+      cached[i].set(momenta[i]);
+      if (pt[i] != momenta[i].get_pt() || eta[i] != momenta[i].get_eta() || phi[i] != momenta[i].get_phi() ||
+          mass[i] != momenta[i].get_mass() || eta[i] != cached[i].get_eta() || mass[i] != cached[i].get_mass())
+      {
+        throw std::runtime_error("Cached or batch kinematics disagree with the FourMomentum getters");
+      }
+    }
+
+    constexpr int selections = 3;
+    suite.run("FourMomentum pt/eta/phi/mass x3" + suffix, batch, [&]
+    {
+      double total = 0.0;
+      for (int selection = 0; selection < selections; ++selection)
+      {
+        for (const FourMomentum& momentum : momenta)
+        {
+          total += momentum.get_pt() + momentum.get_eta() + momentum.get_phi() + momentum.get_mass();
+        }
+      }
+      do_not_optimize(total);
+    });
+    suite.run("CachedFourMomentum pt/eta/phi/mass x3" + suffix, batch, [&]
+    {
+      for (std::size_t i = 0; i < batch; ++i)
+      {
+        cached[i].set(momenta[i]); // Start cold, as a freshly built object does
+      }
+      double total = 0.0;
+      for (int selection = 0; selection < selections; ++selection)
+      {
+        for (const CachedFourMomentum& momentum : cached)
+        {
+          total += momentum.get_pt() + momentum.get_eta() + momentum.get_phi() + momentum.get_mass();
+        }
+      }
+      do_not_optimize(total);
+    });
+    std::string level = simd_level_name(get_kernel_simd_level());
+    suite.run("kinematics_batch[" + level + "]" + suffix, batch, [&]
+    {
+      kinematics_batch(store.momenta(), columns);
+      do_not_optimize(pt.data());
+    });
+  }
+
+  void bench_detection(BenchSuite& suite, std::size_t batch)
+  {
+    std::vector<std::unique_ptr<Lepton>> particles = make_mixed(make_kinematics(batch, 3));
+    std::array<Detector, detector_type_count> detectors = {Detector(DetectorType::Tracker), Detector(DetectorType::Calorimeter),
+                                                           Detector(DetectorType::MuonChamber)};
+    for (auto& detector : detectors)
+    {
+      detector.turn_on();
+    }
+    std::string suffix = "/" + std::to_string(batch);
+
+    // Items are particle-detector pairs
+    suite.run("Detector::detect_particle" + suffix, batch * detectors.size(), [&]
+    {
+      int seen = 0;
+      for (const auto& detector : detectors)
+      {
+        for (const auto& particle : particles)
+        {
+          seen += detector.detect_particle(*particle);
+        }
+      }
+      do_not_optimize(seen);
+    });
+
+    ParticleStore store;
+    for (const auto& particle : particles)
+    {
+      store.add(*particle);
+    }
+    suite.run("Detector::detect_particles(store)" + suffix, batch * detectors.size(), [&]
+    {
+      std::size_t seen = 0;
+      for (const auto& detector : detectors)
+      {
+        seen += detector.detect_particles(store);
+      }
+      do_not_optimize(seen);
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("leptons", argc, argv);
+    for (std::size_t batch : batch_sizes)
+    {
+      bench_construction(suite, batch);
+      bench_kinematics(suite, batch);
+      bench_derived(suite, batch);
+      bench_detection(suite, batch);
+    }
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,70 @@
+// Description: Microbenchmarks for the cost of Metrics counters and timers on the hot path.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "Metrics.h"
+
+namespace
+{
+  constexpr std::size_t operations = 1 << 16;
+
+  void bench_metrics(BenchSuite& suite)
+  {
+    // The alternative the per-thread shards avoid: one shared counter with a locked add
+    std::atomic<std::uint64_t> shared{0};
+    suite.run("shared atomic fetch_add", operations, [&]
+    {
+      for (std::size_t i = 0; i < operations; ++i)
+      {
+        shared.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+
+    std::uint64_t before = Metrics::instance().snapshot().get(MetricCounter::LeptonCopied);
+    for (std::size_t i = 0; i < operations; ++i)
+    {
+      Metrics::count(MetricCounter::LeptonCopied);
+    }
+    if (Metrics::instance().snapshot().get(MetricCounter::LeptonCopied) - before != operations)
+    {
+      throw std::runtime_error("Metrics::count lost increments");
+    }
+    suite.run("Metrics::count", operations, [&]
+    {
+      for (std::size_t i = 0; i < operations; ++i)
+      {
+        Metrics::count(MetricCounter::LeptonCopied);
+      }
+    });
+
+    suite.run("ScopedMetricTimer", operations, [&]
+    {
+      for (std::size_t i = 0; i < operations; ++i)
+      {
+        ScopedMetricTimer timer(MetricTimer::PipelineWait);
+      }
+    });
+
+    suite.run("Metrics::snapshot", 1, [&]
+    {
+      do_not_optimize(Metrics::instance().snapshot().counters.data());
+    });
+    Metrics::instance().reset();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("metrics", argc, argv);
+    bench_metrics(suite);
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,95 @@
+// Description: Microbenchmarks for the W mass constraint neutrino pz solver, per object and in batches.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "EventGenerator.h"
+#include "EventSummary.h"
+#include "MomentumKernels.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "NeutrinoReconstruction.h"
+#include "ThreadPool.h"
+#include <string>
+
+namespace
+{
+  constexpr std::size_t event_count = 20000;
+
+  void bench_solver(BenchSuite& suite, const std::vector<ParticleStore>& events, ThreadPool& pool)
+  {
+    std::vector<EventSummary> summaries;
+    summarize_events(events, summaries, pool);
+    NeutrinoReconstruction reconstruction;
+    WCandidates candidates;
+    std::size_t count = reconstruction.reconstruct(events, summaries, candidates);
+
+    // The candidates' leptons as Muon objects, for the one-at-a-time path
+    std::vector<Muon> leptons;
+    std::vector<double> met_x, met_y, energy, px, py, pz;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const ParticleStore& event = events[candidates.event[i]];
+      ParticleView lepton = event[candidates.lepton[i]];
+      leptons.emplace_back(lepton.get_rest_mass(), lepton.get_charge(), lepton.get_e(), lepton.get_px(), lepton.get_py(), lepton.get_pz());
+      energy.push_back(lepton.get_e());
+      px.push_back(lepton.get_px());
+      py.push_back(lepton.get_py());
+      pz.push_back(lepton.get_pz());
+      met_x.push_back(summaries[candidates.event[i]].met_x);
+      met_y.push_back(summaries[candidates.event[i]].met_y);
+    }
+    MomentumColumns columns{energy.data(), px.data(), py.data(), pz.data(), count};
+
+    // Items are candidates; tests/test_neutrino_reconstruction checks that the paths agree
+    std::vector<double> object_pz(count);
+    suite.run("make_neutrino_candidate", count, [&]
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        object_pz[i] = make_neutrino_candidate(leptons[i], met_x[i], met_y[i]).get_four_momentum().get_pz();
+      }
+      do_not_optimize(object_pz.data());
+    });
+
+    SimdLevel detected = get_kernel_simd_level();
+    NeutrinoSolutions solutions;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512})
+    {
+      if (level > detected)
+      {
+        continue;
+      }
+      set_kernel_simd_level(level);
+      suite.run("solve_neutrino_pz[" + std::string(simd_level_name(level)) + "]", count, [&]
+      {
+        solve_neutrino_pz(columns, met_x.data(), met_y.data(), solutions);
+        do_not_optimize(solutions.pz.data());
+      });
+    }
+    set_kernel_simd_level(detected);
+
+    suite.run("NeutrinoReconstruction::reconstruct", count, [&]
+    {
+      reconstruction.reconstruct(events, summaries, candidates);
+      do_not_optimize(candidates.neutrinos.size());
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("neutrino", argc, argv);
+    ThreadPool pool;
+    std::vector<ParticleStore> events = EventGenerator().generate(0, event_count, pool);
+    bench_solver(suite, events, pool);
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,215 @@
+// Description: Microbenchmarks comparing std::variant Particle vectors with vectors of unique_ptr<Lepton>.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "EventGenerator.h"
+#include "Particle.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <streambuf>
+
+namespace
+{
+  constexpr std::size_t event_count = 2000;
+
+  using PointerEvent = std::vector<std::unique_ptr<Lepton>>;
+
+  // Swallows print_info output so the timings show dispatch and formatting, not the terminal
+  class NullBuffer : public std::streambuf
+  {
+  protected:
+    int overflow(int character) override { return character; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+  };
+
+  // The current representation: one heap object per particle. Tau products are left
+  // unlinked on both sides; none of the benchmarks follows them.
+  PointerEvent make_pointer_event(const std::vector<Particle>& particles)
+  {
+    PointerEvent event;
+    for (const Particle& particle : particles)
+    {
+      std::visit([&](const auto& lepton)
+      {
+        auto copy = std::make_unique<std::decay_t<decltype(lepton)>>(lepton);
+        if constexpr (std::is_same_v<std::decay_t<decltype(lepton)>, Tau>)
+        {
+          copy->clear_decay_products();
+        }
+        event.push_back(std::move(copy));
+      }, particle);
+    }
+    return event;
+  }
+
+  void check_representations(const std::vector<PointerEvent>& pointers, const std::vector<std::vector<Particle>>& variants,
+                             const Detector& detector)
+  {
+    for (std::size_t e = 0; e < variants.size(); ++e)
+    {
+      std::size_t detected = 0;
+      for (std::size_t i = 0; i < variants[e].size(); ++i)
+      {
+        const Lepton& lepton = *pointers[e][i];
+        if (lepton.get_particle_type() != get_particle_type_name(variants[e][i]) ||
+            lepton.get_kinematics().get_pt() != get_kinematics(variants[e][i]).get_pt())
+        {
+          throw std::runtime_error("Variant particles differ from the Lepton objects");
+        }
+        detected += Detector::accepts(detector.get_type(), lepton.get_type_id());
+      }
+      if (detected != detect_particles(detector, variants[e]))
+      {
+        throw std::runtime_error("Variant detection differs from the Lepton objects");
+      }
+    }
+  }
+
+  void bench_particles(BenchSuite& suite, const std::vector<ParticleStore>& events)
+  {
+    std::vector<std::vector<Particle>> variants;
+    std::vector<PointerEvent> pointers;
+    std::size_t particles = 0;
+    for (const auto& event : events)
+    {
+      variants.push_back(make_particles(event));
+      pointers.push_back(make_pointer_event(variants.back()));
+      particles += event.size();
+    }
+    Detector detector(DetectorType::Calorimeter);
+    detector.turn_on();
+    check_representations(pointers, variants, detector);
+
+    // Items are particles
+    suite.run("unique_ptr<Lepton> build", particles, [&]
+    {
+      for (const auto& event : variants)
+      {
+        do_not_optimize(make_pointer_event(event).data());
+      }
+    });
+    suite.run("Particle build (make_particles)", particles, [&]
+    {
+      for (const auto& event : events)
+      {
+        do_not_optimize(make_particles(event).data());
+      }
+    });
+
+    suite.run("unique_ptr<Lepton> get_particle_type", particles, [&]
+    {
+      std::size_t length = 0;
+      for (const auto& event : pointers)
+      {
+        for (const auto& particle : event)
+        {
+          length += particle->get_particle_type().size();
+        }
+      }
+      do_not_optimize(length);
+    });
+    suite.run("Particle get_particle_type_name", particles, [&]
+    {
+      std::size_t length = 0;
+      for (const auto& event : variants)
+      {
+        for (const Particle& particle : event)
+        {
+          length += std::char_traits<char>::length(get_particle_type_name(particle));
+        }
+      }
+      do_not_optimize(length);
+    });
+
+    suite.run("unique_ptr<Lepton> detection", particles, [&]
+    {
+      std::size_t detected = 0;
+      for (const auto& event : pointers)
+      {
+        for (const auto& particle : event)
+        {
+          detected += detector.get_status() && Detector::accepts(detector.get_type(), particle->get_type_id());
+        }
+      }
+      do_not_optimize(detected);
+    });
+    suite.run("Particle detect_particles", particles, [&]
+    {
+      std::size_t detected = 0;
+      for (const auto& event : variants)
+      {
+        detected += detect_particles(detector, event);
+      }
+      do_not_optimize(detected);
+    });
+
+    suite.run("unique_ptr<Lepton> sum pT", particles, [&]
+    {
+      double total = 0.0;
+      for (const auto& event : pointers)
+      {
+        for (const auto& particle : event)
+        {
+          total += particle->get_kinematics().get_pt();
+        }
+      }
+      do_not_optimize(total);
+    });
+    suite.run("Particle sum pT", particles, [&]
+    {
+      double total = 0.0;
+      for (const auto& event : variants)
+      {
+        for (const Particle& particle : event)
+        {
+          total += get_kinematics(particle).get_pt();
+        }
+      }
+      do_not_optimize(total);
+    });
+
+    NullBuffer null_buffer;
+    suite.run("unique_ptr<Lepton> print_info", particles, [&]
+    {
+      std::streambuf* console = std::cout.rdbuf(&null_buffer);
+      for (const auto& event : pointers)
+      {
+        for (const auto& particle : event)
+        {
+          particle->print_info();
+        }
+      }
+      std::cout.rdbuf(console);
+    });
+    suite.run("Particle print_info", particles, [&]
+    {
+      std::streambuf* console = std::cout.rdbuf(&null_buffer);
+      for (const auto& event : variants)
+      {
+        for (const Particle& particle : event)
+        {
+          print_info(particle);
+        }
+      }
+      std::cout.rdbuf(console);
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("particles", argc, argv);
+    ThreadPool pool(1);
+    std::vector<ParticleStore> events = EventGenerator().generate(0, event_count, pool);
+    bench_particles(suite, events);
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
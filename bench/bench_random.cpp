@@ -0,0 +1,152 @@
+// Description: Microbenchmarks for the Philox random streams against mt19937_64, single draws and batch samplers.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "MomentumKernels.h"
+#include "Random.h"
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace
+{
+  // One generated event's worth of draws and one EventFile block
+  constexpr std::array<std::size_t, 2> batch_sizes = {64, 4096};
+
+  // The batch samplers must reproduce single draws exactly at every instruction set
+  void check_batches(std::size_t count)
+  {
+    RandomEngine reference(7, 3, 1);
+    std::vector<std::uint64_t> expected(count);
+    for (auto& value : expected)
+    {
+      value = reference();
+    }
+    SimdLevel original = get_kernel_simd_level();
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512})
+    {
+      set_kernel_simd_level(level);
+      RandomEngine engine(7, 3, 1);
+      std::vector<std::uint64_t> bits(count);
+      fill_random_bits(engine, bits.data(), count);
+      RandomEngine uniform_engine(7, 3, 1);
+      std::vector<double> uniforms(count);
+      fill_uniform(uniform_engine, uniforms.data(), count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        if (bits[i] != expected[i] || uniforms[i] != to_unit_interval(expected[i]))
+        {
+          throw std::runtime_error(std::string("Batch sampler disagrees with single draws at ") + simd_level_name(level));
+        }
+      }
+    }
+    set_kernel_simd_level(original);
+  }
+
+  void bench_single_draws(BenchSuite& suite, std::size_t count)
+  {
+    std::string suffix = "/" + std::to_string(count);
+    // Seeding is part of the cost: the generator builds one engine per event
+    suite.run("mt19937_64 seed+draw" + suffix, count, [&]
+    {
+      std::mt19937_64 engine(splitmix64(1));
+      std::uint64_t sum = 0;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        sum += engine();
+      }
+      do_not_optimize(sum);
+    });
+    suite.run("Philox seed+draw" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, 0);
+      std::uint64_t sum = 0;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        sum += engine();
+      }
+      do_not_optimize(sum);
+    });
+  }
+
+  void bench_batches(BenchSuite& suite, std::size_t count)
+  {
+    std::string suffix = "/" + std::to_string(count);
+    std::string level = simd_level_name(get_kernel_simd_level());
+    std::vector<std::uint64_t> bits(count);
+    std::vector<double> e(count), x(count), y(count), z(count);
+    std::uint64_t event = 0;
+    suite.run("fill_random_bits[" + level + "]" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, event++);
+      fill_random_bits(engine, bits.data(), count);
+      do_not_optimize(bits.data());
+    });
+    suite.run("fill_uniform[" + level + "]" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, event++);
+      fill_uniform(engine, x.data(), count, -1.0, 1.0);
+      do_not_optimize(x.data());
+    });
+    suite.run("fill_gaussian[" + level + "]" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, event++);
+      fill_gaussian(engine, x.data(), count, 0.0, 40000.0);
+      do_not_optimize(x.data());
+    });
+    suite.run("fill_exponential[" + level + "]" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, event++);
+      fill_exponential(engine, x.data(), count, 20000.0);
+      do_not_optimize(x.data());
+    });
+
+    // Momentum columns for count massless particles, as a detector smearing pass would fill them
+    suite.run("momentum columns std::normal_distribution" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, event++);
+      std::normal_distribution<double> momentum(0.0, 40000.0);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        x[i] = momentum(engine);
+        y[i] = momentum(engine);
+        z[i] = momentum(engine);
+        e[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+      }
+      do_not_optimize(e.data());
+    });
+    suite.run("momentum columns fill_gaussian[" + level + "]" + suffix, count, [&]
+    {
+      RandomEngine engine = make_event_engine(1, event++);
+      fill_gaussian(engine, x.data(), count, 0.0, 40000.0);
+      fill_gaussian(engine, y.data(), count, 0.0, 40000.0);
+      fill_gaussian(engine, z.data(), count, 0.0, 40000.0);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        e[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+      }
+      do_not_optimize(e.data());
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("random", argc, argv);
+    for (std::size_t count : batch_sizes)
+    {
+      check_batches(count + 1); // Odd, so the half-used last block is covered too
+      bench_single_draws(suite, count);
+      bench_batches(suite, count);
+    }
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,107 @@
+// Description: Microbenchmarks for TauDecayer phase-space decays per channel and with sampled channels.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "Random.h"
+#include "TauDecay.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace
+{
+  constexpr std::size_t decays_per_op = 1024;
+  constexpr const char* channel_names[tau_decay_channel_count] = {"e nu nu", "mu nu nu", "pi nu", "pi pi0 nu", "pi 2pi0 nu", "3pi nu"};
+
+  struct TauKinematics
+  {
+    double energy, px, py, pz;
+  };
+
+  std::vector<TauKinematics> make_taus()
+  {
+    RandomEngine engine = make_event_engine(1, 0);
+    std::exponential_distribution<double> transverse(1.0 / 20000.0);
+    std::uniform_real_distribution<double> angle(-3.141592653589793, 3.141592653589793);
+    std::uniform_real_distribution<double> pseudorapidity(-2.5, 2.5);
+    std::vector<TauKinematics> taus;
+    for (std::size_t i = 0; i < decays_per_op; ++i)
+    {
+      double pt = transverse(engine);
+      double phi = angle(engine);
+      TauKinematics tau{0.0, pt * std::cos(phi), pt * std::sin(phi), pt * std::sinh(pseudorapidity(engine))};
+      tau.energy = std::sqrt(tau.px * tau.px + tau.py * tau.py + tau.pz * tau.pz + 1776.86 * 1776.86);
+      taus.push_back(tau);
+    }
+    return taus;
+  }
+
+  // Largest relative four-momentum mismatch between a tau and the sum of its products
+  double check_conservation(const TauDecayer& decayer, const std::vector<TauKinematics>& taus, RandomEngine& engine)
+  {
+    std::array<DecayProduct, max_tau_decay_multiplicity> products;
+    double worst = 0.0;
+    for (const TauKinematics& tau : taus)
+    {
+      std::size_t count = decayer.decay(-1, tau.energy, tau.px, tau.py, tau.pz, engine, products.data());
+      std::array<double, 4> sum{};
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        sum[0] += products[i].energy;
+        sum[1] += products[i].px;
+        sum[2] += products[i].py;
+        sum[3] += products[i].pz;
+      }
+      double mismatch = std::max({std::abs(sum[0] - tau.energy), std::abs(sum[1] - tau.px), std::abs(sum[2] - tau.py),
+                                  std::abs(sum[3] - tau.pz)});
+      worst = std::max(worst, mismatch / tau.energy);
+    }
+    return worst;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("tau_decay", argc, argv);
+    TauDecayer decayer;
+    std::vector<TauKinematics> taus = make_taus();
+    RandomEngine engine = make_event_engine(2, 0);
+    std::array<DecayProduct, max_tau_decay_multiplicity> products;
+
+    if (check_conservation(decayer, taus, engine) > 1e-6)
+    {
+      throw std::runtime_error("Tau decay products do not conserve four-momentum");
+    }
+
+    for (std::size_t c = 0; c < tau_decay_channel_count; ++c)
+    {
+      TauDecayChannel channel = static_cast<TauDecayChannel>(c);
+      suite.run(std::string("decay ") + channel_names[c], decays_per_op, [&]
+      {
+        for (const TauKinematics& tau : taus)
+        {
+          decayer.decay(channel, -1, tau.energy, tau.px, tau.py, tau.pz, engine, products.data());
+          do_not_optimize(products);
+        }
+      });
+    }
+    suite.run("decay sampled channel", decays_per_op, [&]
+    {
+      for (const TauKinematics& tau : taus)
+      {
+        decayer.decay(-1, tau.energy, tau.px, tau.py, tau.pz, engine, products.data());
+        do_not_optimize(products);
+      }
+    });
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,153 @@
+// Description: Microbenchmarks comparing the columnar Trigger with selecting events after building every Lepton object.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "BenchHarness.h"
+#include "EventArena.h"
+#include "EventGenerator.h"
+#include "Lepton.h"
+#include "ThreadPool.h"
+#include "Trigger.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+  constexpr std::size_t event_count = 20000;
+
+  std::vector<Detector> make_detectors()
+  {
+    std::vector<Detector> detectors{Detector(DetectorType::Tracker), Detector(DetectorType::Calorimeter), Detector(DetectorType::MuonChamber)};
+    for (auto& detector : detectors)
+    {
+      detector.turn_on();
+    }
+    return detectors;
+  }
+
+  // The two physics paths main.cpp runs, without prescales
+  std::vector<TriggerPathConfig> make_paths()
+  {
+    TriggerPathConfig single_muon;
+    single_muon.name = "single_muon";
+    single_muon.particle_types = particle_type_bit(ParticleType::Muon);
+    single_muon.min_pt = 25000.0;
+    single_muon.max_abs_eta = 2.4;
+    single_muon.required_detectors = detector_type_bit(DetectorType::Tracker) | detector_type_bit(DetectorType::MuonChamber);
+    single_muon.min_detected = 1;
+    TriggerPathConfig dielectron;
+    dielectron.name = "dielectron";
+    dielectron.particle_types = particle_type_bit(ParticleType::Electron);
+    dielectron.min_pt = 10000.0;
+    dielectron.min_candidates = 2;
+    dielectron.max_abs_charge_sum = 0;
+    dielectron.required_detectors = detector_type_bit(DetectorType::Tracker) | detector_type_bit(DetectorType::Calorimeter);
+    dielectron.min_detected = 2;
+    return {single_muon, dielectron};
+  }
+
+  // What selection cost before: every particle becomes an object, and each path asks
+  // the objects for pT, eta and which detectors saw them
+  bool passes_objects(const TriggerPathConfig& path, const std::vector<Detector>& detectors, const ArenaSpan<Lepton*>& particles)
+  {
+    std::size_t candidates = 0;
+    std::size_t detected = 0;
+    int charge_sum = 0;
+    for (const Lepton* particle : particles)
+    {
+      const CachedFourMomentum& momentum = particle->get_kinematics(); // Later paths reuse the first one's pT and eta
+      if ((path.particle_types & particle_type_bit(particle->get_type_id())) == 0 || momentum.get_pt() < path.min_pt ||
+          std::abs(momentum.get_eta()) > path.max_abs_eta)
+      {
+        continue;
+      }
+      ++candidates;
+      charge_sum += particle->get_charge();
+      std::uint8_t seen = 0;
+      for (const auto& detector : detectors)
+      {
+        if (detector.get_status() && Detector::accepts(detector.get_type(), particle->get_type_id()))
+        {
+          seen |= detector_type_bit(detector.get_type());
+        }
+      }
+      detected += (seen & path.required_detectors) == path.required_detectors;
+    }
+    return candidates >= path.min_candidates && std::abs(charge_sum) <= path.max_abs_charge_sum && detected >= path.min_detected;
+  }
+
+  std::size_t select_objects(const std::vector<TriggerPathConfig>& paths, const std::vector<Detector>& detectors,
+                             const std::vector<ParticleStore>& events, EventArena& arena, std::vector<std::uint32_t>& accepted)
+  {
+    accepted.assign(events.size(), 0);
+    std::size_t count = 0;
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+      ArenaSpan<Lepton*> particles = events[e].materialize(arena);
+      for (std::size_t p = 0; p < paths.size(); ++p)
+      {
+        if (passes_objects(paths[p], detectors, particles))
+        {
+          accepted[e] |= 1u << p;
+        }
+      }
+      count += accepted[e] != 0;
+    }
+    return count;
+  }
+
+  void bench_trigger(BenchSuite& suite, const std::vector<ParticleStore>& events)
+  {
+    std::vector<Detector> detectors = make_detectors();
+    std::vector<TriggerPathConfig> paths = make_paths();
+    Trigger trigger(paths, detectors); // tests/test_trigger checks it against the object selection
+
+    // Items are events offered to the trigger
+    EventArena arena;
+    std::vector<std::uint32_t> accepted;
+    suite.run("materialize all + object selection", events.size(), [&]
+    {
+      arena.reset();
+      do_not_optimize(select_objects(paths, detectors, events, arena, accepted));
+    });
+
+    std::vector<TriggerDecision> decisions;
+    suite.run("Trigger::filter", events.size(), [&]
+    {
+      TriggerStats stats = trigger.make_stats();
+      do_not_optimize(trigger.filter(0, events, decisions, stats));
+    });
+    suite.run("Trigger::filter + materialize accepted", events.size(), [&]
+    {
+      arena.reset();
+      TriggerStats stats = trigger.make_stats();
+      trigger.filter(0, events, decisions, stats);
+      std::size_t objects = 0;
+      for (std::size_t e = 0; e < events.size(); ++e)
+      {
+        if (decisions[e].is_accepted())
+        {
+          objects += events[e].materialize(arena).size();
+        }
+      }
+      do_not_optimize(objects);
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    BenchSuite suite("trigger", argc, argv);
+    ThreadPool pool(1);
+    std::vector<ParticleStore> events = EventGenerator().generate(0, event_count, pool);
+    bench_trigger(suite, events);
+    return suite.finish();
+  }
+  catch (const std::exception& error)
+  {
+    std::cerr << "Benchmark failed: " << error.what() << "\n";
+    return 1;
+  }
+}
@@ -8,9 +8,33 @@
 #include "Neutrino.h"
 #include "Tau.h"
 #include "TauNeutrino.h"
+#include "ParticleStore.h"
+#include "Particle.h"
+#include "MomentumKernels.h"
+#include "EventGenerator.h"
+#include "EventSummary.h"
+#include "NeutrinoReconstruction.h"
+#include "ThreadPool.h"
+#include "EventArena.h"
+#include "EventFile.h"
+#include "EventExporter.h"
+#include "Trigger.h"
+#include "Metrics.h"
+#include "Pipeline.h"
+#include "Histogram.h"
+#include "Combinatorics.h"
+#include "Calorimeter.h"
+#include "Isolation.h"
+#include "TauDecay.h"
+#include "Random.h"
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <chrono>
+#include <fstream>
+#include <array>
+#include <cmath>
+#include <unistd.h>
 
 int main() 
 {
@@ -33,6 +57,7 @@ int main()
   // Storing them in a vector
   std::cout << "--------------------------------------------------\n";
   std::cout << "[INFO] Storing leptons in a vector...\n";
+  EventArena event_arena; // Owns the tau decay products below; declared first so it outlives the taus
   std::vector<std::unique_ptr<Lepton>> particles;
   particles.push_back(std::make_unique<Electron>(0.511, -1, 10.2, 3, 2, 1));
   particles.push_back(std::make_unique<Electron>(0.511, -1, 8.9, 2, 3, 2));
@@ -50,28 +75,363 @@ int main()
   // Adding Tau particles and their decay products
   std::cout << "--------------------------------------------------\n";
   std::cout << "[INFO] Adding Tau particles and their decay products...\n";
-  auto tau_decay_muon = std::make_shared<Muon>(105.7, -1, 502.3, 20, 15, 5);
-  auto tau_decay_muon_neutrino = std::make_shared<Neutrino>(0.0, 0, 10.0, 1, 2, 3, "muon", false);
-  auto tau_decay_tau_neutrino = std::make_shared<TauNeutrino>(0.0, 0, 20.0, 4, 5, 6, false);
-
-  auto tau = std::make_unique<Tau>(1776.86, -1, 700.0, 30, 20, 10, TauDecayMode::Leptonic);
-  tau->add_decay_product(tau_decay_muon);
-  tau->add_decay_product(tau_decay_muon_neutrino);
-  tau->add_decay_product(tau_decay_tau_neutrino);
-  particles.push_back(std::move(tau));
+  // The taus decay through the phase-space generator, so their products add up to the tau four-momentum
+  TauDecayer tau_decayer;
+  RandomEngine decay_engine = make_event_engine(1, 0, RandomStream::TauDecay);
+  std::array<DecayProduct, max_tau_decay_multiplicity> decay_products;
+  auto add_decay = [&](Tau& parent, TauDecayChannel channel)
+  {
+    const FourMomentum& momentum = parent.get_four_momentum();
+    std::size_t count = tau_decayer.decay(channel, parent.get_charge(), momentum.get_energy(), momentum.get_px(), momentum.get_py(),
+                                          momentum.get_pz(), decay_engine, decay_products.data());
+    for (std::size_t i = 0; i < count; ++i) 
+    {
+      parent.add_decay_product(create_decay_lepton(event_arena, decay_products[i]));
+    }
+  };
 
-  auto anti_tau_decay_electron = std::make_shared<Electron>(0.511, 1, 12.4, 4, 1, 3);
-  auto anti_tau_decay_electron_neutrino = std::make_shared<Neutrino>(0.0, 0, 10.0, 1, 2, 3, "electron", true);
-  auto anti_tau_decay_tau_neutrino = std::make_shared<TauNeutrino>(0.0, 0, 20.0, 4, 5, 6, true);
+  auto tau = std::make_unique<Tau>(1776.86, -1, std::sqrt(1776.86 * 1776.86 + 3000.0 * 3000.0 + 2000.0 * 2000.0 + 1000.0 * 1000.0),
+                                   3000, 2000, 1000, TauDecayMode::Leptonic);
+  add_decay(*tau, TauDecayChannel::MuonNeutrinos);
+  particles.push_back(std::move(tau));
 
-  auto anti_tau = std::make_unique<Tau>(1776.86, 1, 800.0, 35, 25, 15, TauDecayMode::Leptonic);
-  anti_tau->add_decay_product(anti_tau_decay_electron);
-  anti_tau->add_decay_product(anti_tau_decay_electron_neutrino);
-  anti_tau->add_decay_product(anti_tau_decay_tau_neutrino);
+  auto anti_tau = std::make_unique<Tau>(1776.86, 1, std::sqrt(1776.86 * 1776.86 + 3500.0 * 3500.0 + 2500.0 * 2500.0 + 1500.0 * 1500.0),
+                                        3500, 2500, 1500, TauDecayMode::Leptonic);
+  add_decay(*anti_tau, TauDecayChannel::ElectronNeutrinos);
   particles.push_back(std::move(anti_tau));
   std::cout << "[SUCCESS] Tau particles added successfully.\n";
   std::cout << "--------------------------------------------------\n\n";
 
+  // Copying the event into a columnar ParticleStore and scanning it with a kinematic cut
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Building columnar ParticleStore from the event...\n";
+  ParticleStore event_store;
+  event_store.reserve(particles.size() + 6);
+  for (const auto& particle : particles) 
+  {
+    event_store.add(*particle);
+  }
+  std::size_t passing_cut = 0;
+  for (const auto& view : event_store) 
+  {
+    if (view.get_four_momentum().get_pt() > 20.0) 
+    {
+      ++passing_cut;
+    }
+  }
+  std::cout << "Particles in store (including tau decay products): " << event_store.size() << "\n";
+  std::cout << "Particles with pT > 20 MeV/c: " << passing_cut << "\n";
+  std::cout << "[SUCCESS] ParticleStore built successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // The same event as value-semantic variants, held contiguously with no virtual calls on the hot paths
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Converting the event to std::variant particles...\n";
+  std::vector<Particle> event_particles = make_particles(event_store);
+  Detector variant_tracker(DetectorType::Tracker);
+  variant_tracker.turn_on();
+  std::size_t tracked = detect_particles(variant_tracker, event_particles);
+  FourMomentum event_total = total_momentum(event_particles);
+  std::cout << "Particles: " << event_particles.size() << " (first: " << get_particle_type_name(event_particles.front())
+            << "), seen by the tracker: " << tracked << "\n";
+  std::cout << "Total energy (MeV): " << event_total.get_energy() << "\n";
+  std::cout << "[SUCCESS] Variant particles built successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Running the detectors over the whole event in one batch call each
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Running detectors over the event...\n";
+  for (DetectorType type : {DetectorType::Tracker, DetectorType::Calorimeter, DetectorType::MuonChamber}) 
+  {
+    Detector detector(type);
+    detector.turn_on();
+    std::cout << "Particles seen by " << detector.get_detector_type() << ": " << detector.detect_particles(event_store) << "\n";
+  }
+  std::cout << "[SUCCESS] Detection completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Generating a Monte Carlo event sample on the thread pool
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Generating Monte Carlo events...\n";
+  ThreadPool pool;
+  EventGenerator generator;
+  auto generation_start = std::chrono::steady_clock::now();
+  std::vector<ParticleStore> generated_events = generator.generate(0, 10000, pool);
+  std::chrono::duration<double> generation_time = std::chrono::steady_clock::now() - generation_start;
+  std::size_t generated_particles = 0;
+  for (const auto& event : generated_events) 
+  {
+    generated_particles += event.size();
+  }
+  std::cout << "Generated " << generated_events.size() << " events (" << generated_particles << " particles) on "
+            << pool.size() << " threads at " << generated_events.size() / generation_time.count() << " events/sec\n";
+  std::cout << "[SUCCESS] Event generation completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Materialising generated events as Lepton objects in a reusable per-event arena
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Materialising generated events in an EventArena...\n";
+  EventArena generated_arena;
+  std::size_t materialised_taus = 0;
+  for (const auto& event : generated_events) 
+  {
+    generated_arena.reset();
+    for (Lepton* particle : event.materialize(generated_arena)) 
+    {
+      materialised_taus += particle->get_type_id() == ParticleType::Tau;
+    }
+  }
+  std::cout << "Materialised " << generated_particles << " particles (" << materialised_taus << " taus) using "
+            << generated_arena.get_block_count() << " arena block(s) of " << generated_arena.get_capacity() << " bytes in total\n";
+  std::cout << "[SUCCESS] Materialisation completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Clustering calorimeter deposits and feeding the clusters back into the electrons' layer energies
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Clustering calorimeter deposits of the generated events...\n";
+  Calorimeter calorimeter;
+  std::vector<CaloCluster> clusters;
+  std::size_t cluster_count = 0;
+  std::size_t matched_electrons = 0;
+  for (auto& event : generated_events) 
+  {
+    calorimeter.reset();
+    calorimeter.deposit_event(event);
+    calorimeter.cluster(clusters);
+    cluster_count += clusters.size();
+    matched_electrons += calorimeter.update_electron_layers(event, clusters);
+  }
+  std::cout << "Built " << cluster_count << " clusters in " << calorimeter.get_cell_count() << " cells; "
+            << matched_electrons << " electrons took their layer energies from a cluster\n";
+  std::cout << "[SUCCESS] Calorimeter clustering completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Flagging isolated muons from the cone sums of the generated events
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Computing muon isolation of the generated events...\n";
+  MuonIsolation isolation;
+  std::size_t muon_count = 0;
+  std::size_t isolated_muons = 0;
+  for (auto& event : generated_events) 
+  {
+    isolated_muons += isolation.apply(event);
+    for (ParticleType type : event.type_column()) 
+    {
+      muon_count += type == ParticleType::Muon;
+    }
+  }
+  std::cout << isolated_muons << " of " << muon_count << " muons are isolated (cone " << isolation.get_config().cone_size
+            << ", relative threshold " << isolation.get_config().threshold << ")\n";
+  std::cout << "[SUCCESS] Muon isolation completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Summarising every generated event and totalling the sample with a fixed-order reduction
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Computing MET, visible momentum and HT of the generated events...\n";
+  std::vector<EventSummary> summaries;
+  summarize_events(generated_events, summaries, pool);
+  EventSampleTotals sample_totals = reduce_summaries(summaries, pool);
+  EventSampleTotals serial_totals = reduce_summaries(summaries);
+  bool reproducible = sample_totals.ht == serial_totals.ht && sample_totals.met == serial_totals.met &&
+                      sample_totals.visible.get_energy() == serial_totals.visible.get_energy();
+  std::cout << "Mean HT " << sample_totals.mean_ht() << " MeV, mean MET " << sample_totals.mean_met() << " MeV over "
+            << sample_totals.events << " events (" << sample_totals.visible_count << " visible particles, "
+            << sample_totals.neutrino_count << " neutrinos)\n";
+  std::cout << "Pool and serial totals identical: " << (reproducible ? "yes" : "no") << "\n";
+  std::cout << "[SUCCESS] Event summaries completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Reconstructing the neutrino of a W -> lepton + neutrino hypothesis from the leading lepton and the MET
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Solving the W mass constraint for neutrino pz...\n";
+  NeutrinoReconstruction neutrino_reconstruction;
+  WCandidates w_candidates;
+  neutrino_reconstruction.reconstruct(generated_events, summaries, w_candidates);
+  std::array<std::size_t, 3> solution_counts{};
+  for (NeutrinoSolution solution : w_candidates.solutions.solution) 
+  {
+    ++solution_counts[static_cast<std::size_t>(solution)];
+  }
+  std::cout << "Reconstructed " << w_candidates.neutrinos.size() << " neutrino candidates: " << solution_counts[0] << " took the + root, "
+            << solution_counts[1] << " the - root, " << solution_counts[2] << " had no real solution\n";
+  std::cout << "[SUCCESS] Neutrino reconstruction completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Persisting the generated sample and scanning one column straight from the mapped file
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Writing generated events to generated_events.lepevt...\n";
+  {
+    EventFileWriter writer("generated_events.lepevt");
+    for (const auto& event : generated_events) 
+    {
+      writer.write(event);
+    }
+    writer.close();
+  }
+  EventFileReader reader("generated_events.lepevt");
+  double total_energy = 0.0;
+  for (std::size_t block = 0; block < reader.get_block_count(); ++block) 
+  {
+    for (double energy : reader.column<double>(block, EventColumn::Energy)) 
+    {
+      total_energy += energy;
+    }
+  }
+  std::cout << "Read back " << reader.get_event_count() << " events in " << reader.get_block_count()
+            << " block(s); total particle energy " << total_energy << " MeV\n";
+  std::cout << "[SUCCESS] Event file round trip completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Exporting the same sample as CSV, formatted in bulk and written chunk by chunk on a background thread
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Exporting generated events to generated_events.csv...\n";
+  {
+    ExportConfig export_config;
+    export_config.decimals = 3;
+    export_config.background = true;
+    auto export_start = std::chrono::steady_clock::now();
+    EventExporter exporter("generated_events.csv", export_config);
+    exporter.write(generated_events);
+    exporter.close();
+    std::chrono::duration<double> export_time = std::chrono::steady_clock::now() - export_start;
+    std::cout << "Exported " << exporter.get_particle_count() << " particles (" << exporter.get_bytes_written() << " bytes) in "
+              << export_time.count() * 1000.0 << " ms\n";
+  }
+  std::cout << "[SUCCESS] CSV export completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Triggering on the columns first, so only accepted events are ever turned into Lepton objects
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Running the two-level trigger over the generated events...\n";
+  {
+    std::vector<Detector> trigger_detectors{Detector(DetectorType::Tracker), Detector(DetectorType::Calorimeter), Detector(DetectorType::MuonChamber)};
+    for (auto& detector : trigger_detectors) 
+    {
+      detector.turn_on();
+    }
+    TriggerPathConfig single_muon;
+    single_muon.name = "single_muon";
+    single_muon.particle_types = particle_type_bit(ParticleType::Muon);
+    single_muon.min_pt = 25000.0;
+    single_muon.max_abs_eta = 2.4;
+    single_muon.required_detectors = detector_type_bit(DetectorType::Tracker) | detector_type_bit(DetectorType::MuonChamber);
+    single_muon.min_detected = 1;
+    TriggerPathConfig dielectron;
+    dielectron.name = "dielectron";
+    dielectron.particle_types = particle_type_bit(ParticleType::Electron);
+    dielectron.min_pt = 10000.0;
+    dielectron.min_candidates = 2;
+    dielectron.max_abs_charge_sum = 0;
+    dielectron.required_detectors = detector_type_bit(DetectorType::Tracker) | detector_type_bit(DetectorType::Calorimeter);
+    dielectron.min_detected = 2;
+    TriggerPathConfig minimum_bias;
+    minimum_bias.name = "minimum_bias";
+    minimum_bias.particle_types = 0xFF;
+    minimum_bias.prescale = 100;
+    Trigger trigger({single_muon, dielectron, minimum_bias}, trigger_detectors);
+
+    TriggerStats trigger_stats = trigger.make_stats();
+    std::vector<TriggerDecision> decisions;
+    std::size_t accepted_events = trigger.filter(0, generated_events, decisions, trigger_stats);
+    EventArena trigger_arena;
+    std::size_t materialized = 0;
+    for (std::size_t i = 0; i < generated_events.size(); ++i) 
+    {
+      if (decisions[i].is_accepted()) 
+      {
+        materialized += generated_events[i].materialize(trigger_arena).size();
+      }
+    }
+    for (std::size_t path = 0; path < trigger.get_path_count(); ++path) 
+    {
+      const TriggerPathStats& path_stats = trigger_stats.paths[path];
+      std::cout << "  " << trigger.get_path(path).name << ": level 1 " << path_stats.level1 << ", high level " << path_stats.high_level
+                << ", accepted " << path_stats.accepted << " (" << trigger_stats.get_accept_rate(path) * 100.0 << "%) in "
+                << (path_stats.level1_seconds + path_stats.high_level_seconds) * 1e3 << " ms\n";
+    }
+    std::cout << "Accepted " << accepted_events << " of " << trigger_stats.events << " events; " << materialized
+              << " Lepton objects built for them\n";
+  }
+  std::cout << "[SUCCESS] Trigger completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
+  // Running generation, detector response and analysis as a concurrent pipeline
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Running the generate -> detect -> analyze pipeline...\n";
+  std::vector<Detector> pipeline_detectors{Detector(DetectorType::Tracker), Detector(DetectorType::Calorimeter), Detector(DetectorType::MuonChamber)};
+  for (auto& detector : pipeline_detectors) 
+  {
+    detector.turn_on();
+  }
+  PipelineConfig pipeline_config;
+  pipeline_config.total_events = 20000;
+  std::vector<std::size_t> detected_per_worker(pipeline_config.analysis_threads, 0);
+  // Analysis workers fill their own histogram slots, so filling takes no locks
+  Histogram1D pt_histogram("lepton_pt", BinAxis(50, 0.0, 100000.0), pipeline_config.analysis_threads);
+  Histogram1D mass_histogram("pair_mass", BinAxis({0.0, 10000.0, 20000.0, 40000.0, 60000.0, 80000.0, 100000.0, 150000.0, 250000.0}),
+                             pipeline_config.analysis_threads);
+  // Opposite-charge, same-flavour electron and muon pairs, one finder per analysis worker
+  std::vector<Combinatorics> pair_finders(pipeline_config.analysis_threads);
+  std::vector<PairCandidates> pair_candidates(pipeline_config.analysis_threads);
+  Histogram2D eta_phi_histogram("lepton_eta_phi", BinAxis(25, -2.5, 2.5), BinAxis(32, -3.141592653589793, 3.141592653589793),
+                                pipeline_config.analysis_threads);
+  Pipeline pipeline(generator, pipeline_detectors, [&](const EventBatch& batch, std::size_t worker) 
+  {
+    for (std::uint8_t mask : batch.hit_masks) 
+    {
+      detected_per_worker[worker] += mask != 0;
+    }
+    std::vector<double> pts, etas, phis, masses;
+    for (const auto& event : batch.events) 
+    {
+      pts.resize(event.size());
+      etas.resize(event.size());
+      phis.resize(event.size());
+      masses.resize(event.size());
+      kinematics_batch(event.momenta(), MutableKinematicsColumns{pts.data(), etas.data(), phis.data(), masses.data(), event.size()});
+      pt_histogram.fill_batch_slot(worker, pts.data(), pts.size());
+      eta_phi_histogram.fill_batch_slot(worker, etas.data(), phis.data(), etas.size());
+      pair_candidates[worker].clear();
+      pair_finders[worker].find_pairs(event, pair_candidates[worker]);
+      mass_histogram.fill_batch_slot(worker, pair_candidates[worker].mass.data(), pair_candidates[worker].size());
+    }
+  }, pipeline_config);
+  PipelineStats pipeline_stats = pipeline.run();
+  std::size_t detected_particles = 0;
+  for (std::size_t detected : detected_per_worker) 
+  {
+    detected_particles += detected;
+  }
+  std::cout << "Pipeline processed " << pipeline_stats.analysis.events << " events at " << pipeline_stats.get_throughput()
+            << " events/sec; " << detected_particles << " particles detected\n";
+  std::cout << "Stage capacity (events/sec): generate " << pipeline_stats.generation.get_capacity()
+            << ", detect " << pipeline_stats.detection.get_capacity()
+            << ", analyze " << pipeline_stats.analysis.get_capacity() << "\n";
+  std::cout << "Stage time per batch (ms): generate mean " << pipeline_stats.generation.get_mean_batch_seconds() * 1e3
+            << ", max " << pipeline_stats.generation.max_batch_seconds * 1e3
+            << "; detect mean " << pipeline_stats.detection.get_mean_batch_seconds() * 1e3
+            << ", max " << pipeline_stats.detection.max_batch_seconds * 1e3
+            << "; analyze mean " << pipeline_stats.analysis.get_mean_batch_seconds() * 1e3
+            << ", max " << pipeline_stats.analysis.max_batch_seconds * 1e3 << "\n";
+  std::cout << "Batch latency (end to end): mean " << pipeline_stats.mean_latency_seconds * 1e3 << " ms, max "
+            << pipeline_stats.max_latency_seconds * 1e3 << " ms\n";
+  pt_histogram.merge();
+  mass_histogram.merge();
+  eta_phi_histogram.merge();
+  std::cout << "Histograms: " << pt_histogram.get_entries() << " pT entries (" << pt_histogram.get_bin_content(51)
+            << " overflow), " << mass_histogram.get_integral() << " opposite-charge pair masses in range, "
+            << eta_phi_histogram.get_integral() << " eta-phi entries in acceptance\n";
+  {
+    std::ofstream csv("lepton_pt.csv");
+    pt_histogram.write_csv(csv);
+    std::ofstream binary("lepton_histograms.hist", std::ios::binary);
+    pt_histogram.write_binary(binary);
+    mass_histogram.write_binary(binary);
+    eta_phi_histogram.write_binary(binary);
+  }
+  std::cout << "[SUCCESS] Pipeline completed successfully.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
   // Creating a unique_ptr for a new Electron and moving its data to another Electron using std::move
   std::unique_ptr<Electron> electron_ptr = std::make_unique<Electron>(0.511, -1, 11.3, 3, 3, 2);
   std::unique_ptr<Electron> another_electron_ptr = std::move(electron_ptr);
@@ -97,6 +457,7 @@ int main()
   auto sum = sum_four_momenta(electron, electron2);
   std::cout << "Sum of electron four-vectors: Energy=" << sum.get_energy() 
             << ", Px=" << sum.get_px() << ", Py=" << sum.get_py() << ", Pz=" << sum.get_pz() << "\n";
+  std::cout << "Invariant mass of the pair (lazy operator+): " << (electron + electron2).get_mass() << "\n";
   std::cout << "--------------------------------------------------\n\n";
 
   // Taking the dot product of the antielectron and antimuon four-vector and printing the result
@@ -109,13 +470,39 @@ int main()
   // Print all particles
   std::cout << "--------------------------------------------------\n";
   std::cout << "[INFO] Printing all particle information...\n";
-  for (const auto& particle : particles) 
   {
-      particle->print_info();
+    // One JSON line per particle, written in a single call rather than field by field through std::cout
+    std::vector<const Lepton*> particle_pointers;
+    for (const auto& particle : particles) 
+    {
+      particle_pointers.push_back(particle.get());
+    }
+    ExportConfig print_config;
+    print_config.format = ExportFormat::JsonLines;
+    std::cout.flush();
+    EventExporter printer(STDOUT_FILENO, print_config);
+    printer.write(particle_pointers.data(), particle_pointers.size());
+    printer.close();
   }
   std::cout << "[SUCCESS] All particle information printed successfully.\n";
   std::cout << "--------------------------------------------------\n\n";
 
+  // Where constructions, copies and detector work happened over the whole run
+  std::cout << "--------------------------------------------------\n";
+  std::cout << "[INFO] Writing run metrics...\n";
+  MetricsSnapshot metrics = Metrics::instance().snapshot();
+  std::cout << "Lepton constructions: " << metrics.get(MetricCounter::LeptonConstructed) << ", copies: " << metrics.get(MetricCounter::LeptonCopied)
+            << ", moves: " << metrics.get(MetricCounter::LeptonMoved) << "\n";
+  for (std::size_t detector = 0; detector < detector_type_count; ++detector) 
+  {
+    std::uint64_t checked = metrics.get(detector_checked_counter(detector));
+    std::uint64_t accepted = metrics.get(detector_accepted_counter(detector));
+    std::cout << "Detector " << detector_type_name(static_cast<DetectorType>(detector)) << ": " << accepted << " of " << checked << " particles seen\n";
+  }
+  Metrics::instance().write_snapshot("lepton_metrics.prom", MetricsFormat::Prometheus);
+  std::cout << "[SUCCESS] Metrics written to lepton_metrics.prom.\n";
+  std::cout << "--------------------------------------------------\n\n";
+
   std::cout << "=== Particle Detection Simulation Program Completed ===\n";
   return 0;
 }
@@ -0,0 +1,93 @@
+// Description: Minimal unit-test harness: named cases, checks that report file and line, and a process exit code for CTest.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#ifndef TESTHARNESS_H
+#define TESTHARNESS_H
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Thrown by a failed check; ends the current case only
+class TestFailure : public std::runtime_error
+{
+public:
+  explicit TestFailure(const std::string& message) : std::runtime_error(message) {}
+};
+
+// Runs named cases in order. A case fails on its first failed check or on any
+// exception it lets escape; the remaining cases still run.
+class TestSuite
+{
+private:
+  std::string suite_name;
+  int cases = 0;
+  int failures = 0;
+
+public:
+  explicit TestSuite(std::string name) : suite_name(std::move(name)) {}
+
+  template <typename Body>
+  void run(const std::string& name, Body body)
+  {
+    ++cases;
+    try
+    {
+      body();
+      std::cout << "[ OK ] " << suite_name << ": " << name << "\n";
+    }
+    catch (const std::exception& error)
+    {
+      ++failures;
+      std::cout << "[FAIL] " << suite_name << ": " << name << "\n       " << error.what() << "\n";
+    }
+  }
+
+  // Returns the process exit code
+  int finish() const
+  {
+    std::cout << suite_name << ": " << cases - failures << " of " << cases << " cases passed\n";
+    return failures == 0 ? 0 : 1;
+  }
+};
+
+inline void test_check(bool condition, const char* expression, const char* file, int line, const std::string& detail = "")
+{
+  if (!condition)
+  {
+    throw TestFailure(std::string(file) + ":" + std::to_string(line) + ": check failed: " + expression + (detail.empty() ? "" : " (" + detail + ")"));
+  }
+}
+
+// Equal bit patterns, so -0.0 differs from 0.0 and a NaN matches the same NaN
+inline bool same_bits(double first, double second)
+{
+  std::uint64_t first_bits;
+  std::uint64_t second_bits;
+  std::memcpy(&first_bits, &first, sizeof(double));
+  std::memcpy(&second_bits, &second, sizeof(double));
+  return first_bits == second_bits;
+}
+
+#define LEPTON_CHECK(condition) test_check((condition), #condition, __FILE__, __LINE__)
+#define LEPTON_CHECK_MESSAGE(condition, detail) test_check((condition), #condition, __FILE__, __LINE__, (detail))
+#define LEPTON_CHECK_THROWS(exception_type, statement)                                                        \
+  do                                                                                                          \
+  {                                                                                                           \
+    bool lepton_thrown_ = false;                                                                              \
+    try                                                                                                       \
+    {                                                                                                         \
+      statement;                                                                                              \
+    }                                                                                                         \
+    catch (const exception_type&)                                                                             \
+    {                                                                                                         \
+      lepton_thrown_ = true;                                                                                  \
+    }                                                                                                         \
+    test_check(lepton_thrown_, #statement " throws " #exception_type, __FILE__, __LINE__);                    \
+  } while (false)
+
+#endif
@@ -0,0 +1,276 @@
+// Description: Checks Combinatorics pairs and pruned triplets against exhaustive enumeration, and the lazy lepton sums it replaces.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "Combinatorics.h"
+#include "EventArena.h"
+#include "Muon.h"
+#include "ParticleStore.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+  // Electrons, muons and hadronic taus of both charges; one in eight repeats the
+  // previous lepton's momentum, so equal pT has to be ordered by index
+  ParticleStore make_event(std::size_t count, std::uint64_t seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::exponential_distribution<double> transverse(1.0 / 20000.0);
+    std::uniform_real_distribution<double> angle(-3.141592653589793, 3.141592653589793);
+    std::uniform_real_distribution<double> pseudorapidity(-2.5, 2.5);
+    ParticleStore event;
+    double px = 0.0, py = 0.0, pz = 0.0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      if (i % 8 != 1)
+      {
+        double pt = transverse(engine);
+        double phi = angle(engine);
+        px = pt * std::cos(phi);
+        py = pt * std::sin(phi);
+        pz = pt * std::sinh(pseudorapidity(engine));
+      }
+      int charge = engine() % 2 == 0 ? -1 : 1;
+      switch (engine() % 3)
+      {
+        case 0: event.add_electron(0.511, charge, std::sqrt(px * px + py * py + pz * pz + 0.511 * 0.511), px, py, pz); break;
+        case 1: event.add_muon(105.66, charge, std::sqrt(px * px + py * py + pz * pz + 105.66 * 105.66), px, py, pz); break;
+        default:
+          event.add_tau(1776.86, charge, std::sqrt(px * px + py * py + pz * pz + 1776.86 * 1776.86), px, py, pz, TauDecayMode::Hadronic);
+          break;
+      }
+    }
+    return event;
+  }
+
+  // The selection as the header words it, applied to every combination
+  struct Reference
+  {
+    const ParticleStore& event;
+    const CandidateSelection& selection;
+    std::vector<ParticleStore::Index> ranked; // Selected rows by falling pT, ties by row
+
+    Reference(const ParticleStore& event, const CandidateSelection& selection) : event(event), selection(selection)
+    {
+      for (ParticleStore::Index row = 0; row < event.size(); ++row)
+      {
+        if ((selection.type_mask & particle_type_bit(event[row].get_type())) != 0)
+        {
+          ranked.push_back(row);
+        }
+      }
+      std::stable_sort(ranked.begin(), ranked.end(), [&](ParticleStore::Index a, ParticleStore::Index b) { return pt(a) > pt(b); });
+    }
+
+    double pt(ParticleStore::Index row) const { return std::hypot(event[row].get_px(), event[row].get_py()); }
+
+    bool in_window(const FourMomentum& sum, double& mass) const
+    {
+      mass = sum.get_mass();
+      return mass >= selection.min_mass && mass <= selection.max_mass;
+    }
+
+    // (first, second, third) -> mass; third is unused for pairs
+    using Candidates = std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, double>;
+
+    Candidates pairs() const
+    {
+      Candidates result;
+      for (std::size_t i = 0; i < ranked.size(); ++i)
+      {
+        for (std::size_t j = i + 1; j < ranked.size(); ++j)
+        {
+          ParticleView a = event[ranked[i]], b = event[ranked[j]];
+          bool charges = selection.charge == ChargeRequirement::Any ||
+                         (selection.charge == ChargeRequirement::Opposite ? a.get_charge() == -b.get_charge() : a.get_charge() == b.get_charge());
+          bool flavors = selection.flavor == FlavorRequirement::Any ||
+                         (selection.flavor == FlavorRequirement::Same) == (a.get_type() == b.get_type());
+          double mass;
+          if (pt(ranked[i]) >= selection.min_pt[0] && pt(ranked[j]) >= selection.min_pt[1] && charges && flavors &&
+              in_window(a.get_four_momentum() + b.get_four_momentum(), mass))
+          {
+            result[std::make_tuple(ranked[i], ranked[j], 0u)] = mass;
+          }
+        }
+      }
+      return result;
+    }
+
+    Candidates triplets() const
+    {
+      Candidates result;
+      for (std::size_t i = 0; i < ranked.size(); ++i)
+      {
+        for (std::size_t j = i + 1; j < ranked.size(); ++j)
+        {
+          for (std::size_t k = j + 1; k < ranked.size(); ++k)
+          {
+            ParticleView a = event[ranked[i]], b = event[ranked[j]], c = event[ranked[k]];
+            bool same_charge = a.get_charge() == b.get_charge() && b.get_charge() == c.get_charge();
+            bool same_flavor = a.get_type() == b.get_type() && b.get_type() == c.get_type();
+            bool charges = selection.charge == ChargeRequirement::Any || (selection.charge == ChargeRequirement::Same) == same_charge;
+            bool flavors = selection.flavor == FlavorRequirement::Any || (selection.flavor == FlavorRequirement::Same) == same_flavor;
+            double mass;
+            if (pt(ranked[i]) >= selection.min_pt[0] && pt(ranked[j]) >= selection.min_pt[1] && pt(ranked[k]) >= selection.min_pt[2] &&
+                charges && flavors && in_window(a.get_four_momentum() + b.get_four_momentum() + c.get_four_momentum(), mass))
+            {
+              result[std::make_tuple(ranked[i], ranked[j], ranked[k])] = mass;
+            }
+          }
+        }
+      }
+      return result;
+    }
+  };
+
+  void check_pairs(const PairCandidates& found, std::size_t added, const Reference::Candidates& expected, const std::string& label)
+  {
+    LEPTON_CHECK_MESSAGE(added == found.size() && found.size() == expected.size(), label);
+    for (std::size_t i = 0; i < found.size(); ++i)
+    {
+      auto match = expected.find(std::make_tuple(found.first[i], found.second[i], 0u));
+      LEPTON_CHECK_MESSAGE(match != expected.end() && same_bits(match->second, found.mass[i]), label);
+    }
+  }
+
+  void check_triplets(const TripletCandidates& found, std::size_t added, const Reference::Candidates& expected, const std::string& label)
+  {
+    LEPTON_CHECK_MESSAGE(added == found.size() && found.size() == expected.size(), label);
+    for (std::size_t i = 0; i < found.size(); ++i)
+    {
+      auto match = expected.find(std::make_tuple(found.first[i], found.second[i], found.third[i]));
+      LEPTON_CHECK_MESSAGE(match != expected.end() && same_bits(match->second, found.mass[i]), label);
+    }
+  }
+
+  std::vector<CandidateSelection> selections()
+  {
+    std::vector<CandidateSelection> result(5);
+    result[0].min_mass = 60000.0; // Z window, opposite-sign same-flavor
+    result[0].max_mass = 120000.0;
+    result[1].charge = ChargeRequirement::Any;
+    result[1].flavor = FlavorRequirement::Any;
+    result[1].max_mass = 15000.0; // Narrow and low: most pairs are already above it, so triplet pruning does the work
+    result[2].charge = ChargeRequirement::Same;
+    result[2].flavor = FlavorRequirement::Different;
+    result[2].min_pt = {25000.0, 15000.0, 5000.0};
+    result[3].flavor = FlavorRequirement::Different;
+    result[3].type_mask |= particle_type_bit(ParticleType::Tau);
+    result[3].min_mass = 5000.0;
+    result[3].max_mass = 40000.0;
+    result[4].type_mask = particle_type_bit(ParticleType::Muon) | particle_type_bit(ParticleType::Tau);
+    result[4].charge = ChargeRequirement::Any;
+    result[4].min_pt = {10000.0, 0.0, 0.0};
+    return result;
+  }
+
+  const std::size_t lepton_counts[] = {0, 1, 2, 3, 9, 40};
+}
+
+int main()
+{
+  TestSuite suite("combinatorics");
+
+  suite.run("pairs match exhaustive enumeration", [&]
+  {
+    for (const CandidateSelection& selection : selections())
+    {
+      Combinatorics combinatorics(selection);
+      for (std::size_t count : lepton_counts)
+      {
+        ParticleStore event = make_event(count, count + 11);
+        PairCandidates found;
+        std::size_t added = combinatorics.find_pairs(event, found);
+        check_pairs(found, added, Reference(event, selection).pairs(), std::to_string(count) + " leptons");
+      }
+    }
+  });
+
+  suite.run("pruned triplets match exhaustive enumeration", [&]
+  {
+    std::size_t total = 0;
+    for (const CandidateSelection& selection : selections())
+    {
+      Combinatorics combinatorics(selection);
+      for (std::size_t count : lepton_counts)
+      {
+        ParticleStore event = make_event(count, 3 * count + 5);
+        TripletCandidates found;
+        std::size_t added = combinatorics.find_triplets(event, found);
+        check_triplets(found, added, Reference(event, selection).triplets(), std::to_string(count) + " leptons");
+        total += added;
+      }
+    }
+    LEPTON_CHECK_MESSAGE(total > 0, "the selections need to accept some triplets");
+  });
+
+  suite.run("Lepton arrays give the store's candidates", [&]
+  {
+    for (const CandidateSelection& selection : selections())
+    {
+      Combinatorics combinatorics(selection);
+      ParticleStore event = make_event(40, 1234);
+      EventArena arena;
+      ArenaSpan<Lepton*> objects = event.materialize(arena);
+      std::vector<const Lepton*> leptons(objects.begin(), objects.end());
+      PairCandidates pairs;
+      combinatorics.find_pairs(leptons.data(), leptons.size(), pairs);
+      check_pairs(pairs, pairs.size(), Reference(event, selection).pairs(), "pairs");
+      TripletCandidates triplets;
+      combinatorics.find_triplets(leptons.data(), leptons.size(), triplets);
+      check_triplets(triplets, triplets.size(), Reference(event, selection).triplets(), "triplets");
+    }
+  });
+
+  suite.run("candidates append to earlier events' output", [&]
+  {
+    Combinatorics combinatorics(selections()[1]);
+    ParticleStore first = make_event(9, 1);
+    ParticleStore second = make_event(12, 2);
+    TripletCandidates together;
+    std::size_t first_count = combinatorics.find_triplets(first, together);
+    std::size_t second_count = combinatorics.find_triplets(second, together);
+    TripletCandidates alone;
+    combinatorics.find_triplets(second, alone);
+    LEPTON_CHECK(together.size() == first_count + second_count && alone.size() == second_count);
+    LEPTON_CHECK(std::equal(alone.mass.begin(), alone.mass.end(), together.mass.begin() + static_cast<std::ptrdiff_t>(first_count)));
+  });
+
+  suite.run("lazy lepton sums match summed four-momenta", [&]
+  {
+    ParticleStore event = make_event(40, 77);
+    std::vector<Muon> muons;
+    for (ParticleView particle : event)
+    {
+      muons.emplace_back(particle.get_rest_mass(), particle.get_charge(), particle.get_e(), particle.get_px(), particle.get_py(), particle.get_pz());
+    }
+    FourMomentum chained;
+    for (std::size_t i = 0; i < muons.size(); ++i)
+    {
+      chained += muons[i].get_four_momentum();
+      for (std::size_t j = i + 1; j < muons.size(); ++j)
+      {
+        LEPTON_CHECK(same_bits((muons[i] + muons[j]).get_mass(), (muons[i].get_four_momentum() + muons[j].get_four_momentum()).get_mass()));
+      }
+    }
+    FourMomentum total = sum_momenta(muons);
+    LEPTON_CHECK(same_bits(total.get_energy(), chained.get_energy()) && same_bits(total.get_px(), chained.get_px()) &&
+                 same_bits(total.get_py(), chained.get_py()) && same_bits(total.get_pz(), chained.get_pz()));
+  });
+
+  suite.run("an inverted mass window is rejected", [&]
+  {
+    CandidateSelection selection;
+    selection.min_mass = 2.0;
+    selection.max_mass = 1.0;
+    LEPTON_CHECK_THROWS(std::invalid_argument, Combinatorics{selection});
+  });
+  return suite.finish();
+}
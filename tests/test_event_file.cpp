@@ -0,0 +1,203 @@
+// Description: Round-trips generated events through an event file and checks that corrupted files are rejected on open.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventFile.h"
+#include "EventGenerator.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+  const std::string file_path = "test_event_file.lepevt";
+  const std::string corrupt_path = "test_event_file_corrupt.lepevt";
+
+  // Byte positions from the version 1 layout, which EventFile.cpp pins with static_asserts
+  constexpr std::size_t index_offset_position = 40; // FileHeader::index_offset
+  constexpr std::size_t block_header_size = 32;
+  constexpr std::size_t column_entry_size = 24;
+
+  using Bytes = std::vector<unsigned char>;
+
+  template <typename T>
+  T read_at(const Bytes& bytes, std::size_t position)
+  {
+    T value;
+    std::memcpy(&value, bytes.data() + position, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  void write_at(Bytes& bytes, std::size_t position, const T& value)
+  {
+    std::memcpy(bytes.data() + position, &value, sizeof(T));
+  }
+
+  // Start of the first block, and of a column's table entry in it
+  std::size_t first_block(const Bytes& bytes)
+  {
+    return static_cast<std::size_t>(read_at<std::uint64_t>(bytes, static_cast<std::size_t>(read_at<std::uint64_t>(bytes, index_offset_position))));
+  }
+
+  std::size_t column_entry(const Bytes& bytes, EventColumn column)
+  {
+    return first_block(bytes) + block_header_size + static_cast<std::size_t>(column) * column_entry_size;
+  }
+
+  std::size_t column_start(const Bytes& bytes, EventColumn column)
+  {
+    return first_block(bytes) + static_cast<std::size_t>(read_at<std::uint64_t>(bytes, column_entry(bytes, column) + 8));
+  }
+
+  void decrement_count(Bytes& bytes, EventColumn column)
+  {
+    std::size_t position = column_entry(bytes, column) + 16;
+    write_at(bytes, position, read_at<std::uint64_t>(bytes, position) - 1);
+  }
+
+  // Applies the corruption to a copy of the good file and expects the reader to refuse it
+  void check_rejected(const Bytes& good, const std::function<void(Bytes&)>& corrupt)
+  {
+    Bytes bytes = good;
+    corrupt(bytes);
+    {
+      std::ofstream out(corrupt_path, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    LEPTON_CHECK_THROWS(std::runtime_error, EventFileReader reader(corrupt_path));
+  }
+}
+
+int main()
+{
+  TestSuite suite("event_file");
+  ThreadPool pool(1);
+  std::vector<ParticleStore> events = EventGenerator().generate(0, 200, pool);
+  {
+    EventFileWriter writer(file_path, 64);
+    for (const ParticleStore& event : events)
+    {
+      writer.write(event);
+    }
+    writer.close();
+  }
+
+  suite.run("events survive a round trip", [&]
+  {
+    EventFileReader reader(file_path);
+    LEPTON_CHECK(reader.get_event_count() == events.size());
+    ParticleStore event;
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+      reader.read_event(i, event);
+      LEPTON_CHECK(event.size() == events[i].size());
+      for (ParticleStore::Index particle = 0; particle < event.size(); ++particle)
+      {
+        LEPTON_CHECK(event[particle].get_type() == events[i][particle].get_type());
+        LEPTON_CHECK(same_bits(event[particle].get_e(), events[i][particle].get_e()));
+        if (event[particle].get_type() == ParticleType::Tau)
+        {
+          LEPTON_CHECK(event[particle].get_decay_product_count() == events[i][particle].get_decay_product_count());
+        }
+      }
+    }
+  });
+
+  std::ifstream in(file_path, std::ios::binary);
+  const Bytes good((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+
+  // First tau of the first block with at least one decay product
+  std::size_t tau_entry = 0;
+  std::size_t tau_products = 0;
+  std::uint32_t foreign_product = 0; // A particle of a neighbouring event
+  {
+    EventFileReader reader(file_path);
+    auto counts = reader.column<std::uint8_t>(0, EventColumn::TauProductCount);
+    while (tau_entry < counts.size && counts[tau_entry] == 0)
+    {
+      ++tau_entry;
+    }
+    if (tau_entry < counts.size)
+    {
+      tau_products = counts[tau_entry];
+      std::uint32_t row = reader.column<std::uint32_t>(0, EventColumn::TauRow)[tau_entry];
+      auto offsets = reader.column<std::uint64_t>(0, EventColumn::EventOffsets);
+      std::size_t event = 0;
+      while (offsets[event + 1] <= row)
+      {
+        ++event;
+      }
+      foreign_product = static_cast<std::uint32_t>(event + 2 < offsets.size ? offsets[event + 1] : offsets[event] - 1);
+    }
+  }
+
+  suite.run("corrupt offsets are rejected", [&]
+  {
+    check_rejected(good, [](Bytes& bytes)
+    {
+      std::size_t offsets = column_start(bytes, EventColumn::EventOffsets);
+      write_at(bytes, offsets + 8, read_at<std::uint64_t>(bytes, offsets + 16) + 1); // Event 0 ends after event 1
+    });
+    check_rejected(good, [](Bytes& bytes)
+    {
+      write_at(bytes, column_start(bytes, EventColumn::EventOffsets), std::uint64_t{1}); // Does not start at 0
+    });
+    check_rejected(good, [](Bytes& bytes)
+    {
+      std::size_t entry = column_entry(bytes, EventColumn::EventOffsets);
+      std::uint64_t count = read_at<std::uint64_t>(bytes, entry + 16);
+      std::size_t last = column_start(bytes, EventColumn::EventOffsets) + static_cast<std::size_t>(count - 1) * 8;
+      write_at(bytes, last, read_at<std::uint64_t>(bytes, last) + 1); // Past the particle count
+    });
+  });
+
+  suite.run("short particle and side columns are rejected", [&]
+  {
+    for (EventColumn column : {EventColumn::Energy, EventColumn::Type, EventColumn::ElectronRow, EventColumn::ElectronLayers,
+                               EventColumn::MuonIsolated, EventColumn::TauRow, EventColumn::TauProducts})
+    {
+      check_rejected(good, [column](Bytes& bytes) { decrement_count(bytes, column); });
+    }
+  });
+
+  suite.run("bad tau decay products are rejected", [&]
+  {
+    LEPTON_CHECK_MESSAGE(tau_products > 0, "the generated block needs a tau with decay products");
+    check_rejected(good, [&](Bytes& bytes)
+    {
+      write_at(bytes, column_start(bytes, EventColumn::TauProductCount) + tau_entry, static_cast<std::uint8_t>(max_tau_decay_products + 1));
+    });
+    check_rejected(good, [&](Bytes& bytes)
+    {
+      std::size_t product = column_start(bytes, EventColumn::TauProducts) + tau_entry * 4 * max_tau_decay_products;
+      write_at(bytes, product, std::uint32_t{0xFFFFFFF0}); // Outside the block
+    });
+    check_rejected(good, [&](Bytes& bytes)
+    {
+      std::size_t product = column_start(bytes, EventColumn::TauProducts) + tau_entry * 4 * max_tau_decay_products;
+      write_at(bytes, product, foreign_product); // In the block, but in another event
+    });
+  });
+
+  suite.run("unknown neutrino flavors and tau decay modes are rejected", [&]
+  {
+    {
+      EventFileReader reader(file_path);
+      LEPTON_CHECK_MESSAGE(reader.column<NeutrinoFlavor>(0, EventColumn::NeutrinoFlavor).size > 0, "the generated block needs a neutrino");
+      LEPTON_CHECK_MESSAGE(reader.column<TauDecayMode>(0, EventColumn::TauDecayMode).size > 0, "the generated block needs a tau");
+    }
+    check_rejected(good, [](Bytes& bytes) { write_at(bytes, column_start(bytes, EventColumn::NeutrinoFlavor), std::uint8_t{2}); });
+    check_rejected(good, [](Bytes& bytes) { write_at(bytes, column_start(bytes, EventColumn::TauDecayMode), std::uint8_t{0xFF}); });
+  });
+
+  std::remove(file_path.c_str());
+  std::remove(corrupt_path.c_str());
+  return suite.finish();
+}
@@ -0,0 +1,183 @@
+// Description: Checks that generated events depend only on the seed and event number: not on the pool size, the SIMD level or the order they are made in.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventGenerator.h"
+#include "MomentumKernels.h"
+#include "ThreadPool.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr std::uint64_t first_event = 1000;
+  constexpr std::size_t event_count = 600;
+
+  // Every column of every row, bit for bit
+  bool same_event(const ParticleStore& a, const ParticleStore& b)
+  {
+    if (a.size() != b.size())
+    {
+      return false;
+    }
+    for (ParticleStore::Index i = 0; i < a.size(); ++i)
+    {
+      ParticleView x = a[i];
+      ParticleView y = b[i];
+      if (x.get_type() != y.get_type() || x.get_charge() != y.get_charge() || !same_bits(x.get_rest_mass(), y.get_rest_mass()) ||
+          !same_bits(x.get_e(), y.get_e()) || !same_bits(x.get_px(), y.get_px()) || !same_bits(x.get_py(), y.get_py()) ||
+          !same_bits(x.get_pz(), y.get_pz()))
+      {
+        return false;
+      }
+      switch (x.get_type())
+      {
+        case ParticleType::Electron:
+          for (std::size_t layer = 0; layer < 4; ++layer)
+          {
+            if (!same_bits(x.get_layer_energies()[layer], y.get_layer_energies()[layer]))
+            {
+              return false;
+            }
+          }
+          break;
+        case ParticleType::Muon:
+          if (x.get_isolated() != y.get_isolated())
+          {
+            return false;
+          }
+          break;
+        case ParticleType::Neutrino:
+          if (x.get_flavor() != y.get_flavor() || x.get_has_interacted() != y.get_has_interacted())
+          {
+            return false;
+          }
+          break;
+        case ParticleType::TauNeutrino:
+          if (x.get_has_interacted() != y.get_has_interacted())
+          {
+            return false;
+          }
+          break;
+        case ParticleType::Tau:
+          if (x.get_decay_mode() != y.get_decay_mode() || x.get_decay_product_count() != y.get_decay_product_count())
+          {
+            return false;
+          }
+          for (std::size_t product = 0; product < x.get_decay_product_count(); ++product)
+          {
+            if (x.get_decay_product(product).get_index() != y.get_decay_product(product).get_index())
+            {
+              return false;
+            }
+          }
+          break;
+      }
+    }
+    return true;
+  }
+
+  void check_same_events(const std::vector<ParticleStore>& events, const std::vector<ParticleStore>& reference, const std::string& label)
+  {
+    LEPTON_CHECK_MESSAGE(events.size() == reference.size(), label);
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+      LEPTON_CHECK_MESSAGE(same_event(events[i], reference[i]), label + ", event " + std::to_string(first_event + i));
+    }
+  }
+}
+
+int main()
+{
+  TestSuite suite("event_generator");
+  EventGeneratorConfig config;
+  config.seed = 20261017;
+  config.type_weights = {{0.2, 0.2, 0.2, 0.1, 0.3}}; // Plenty of taus, whose decays draw from a stream of their own
+  const EventGenerator generator(config);
+
+  // The reference is one event at a time in order, with no pool involved
+  std::vector<ParticleStore> reference(event_count);
+  for (std::size_t i = 0; i < event_count; ++i)
+  {
+    generator.generate_event(first_event + i, reference[i]);
+  }
+
+  suite.run("the reference sample has every particle type", [&]
+  {
+    std::array<std::size_t, particle_type_count> counts{};
+    for (const ParticleStore& event : reference)
+    {
+      for (ParticleView particle : event)
+      {
+        ++counts[static_cast<std::size_t>(particle.get_type())];
+      }
+    }
+    for (std::size_t type = 0; type < particle_type_count; ++type)
+    {
+      LEPTON_CHECK_MESSAGE(counts[type] > 0, particle_type_name(static_cast<ParticleType>(type)));
+    }
+  });
+
+  suite.run("generate gives the same events for any pool size", [&]
+  {
+    for (std::size_t threads : {1, 2, 4, 7})
+    {
+      ThreadPool pool(threads);
+      check_same_events(generator.generate(first_event, event_count, pool), reference, std::to_string(threads) + " threads");
+    }
+  });
+
+  SimdLevel detected = detect_simd_level();
+  for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512})
+  {
+    std::string name = std::string("generate gives the same events [") + simd_level_name(level) + "]";
+    if (level > detected)
+    {
+      std::cout << "[SKIP] event_generator: " << name << " (not supported by this CPU)\n";
+      continue;
+    }
+    suite.run(name, [&]
+    {
+      set_kernel_simd_level(level);
+      ThreadPool pool(2);
+      check_same_events(generator.generate(first_event, event_count, pool), reference, simd_level_name(level));
+    });
+  }
+  set_kernel_simd_level(detected);
+
+  suite.run("an event regenerated on its own matches its place in the sample", [&]
+  {
+    ParticleStore reused;
+    for (std::size_t i = event_count; i-- > 0;) // Backwards, into a store that still holds another event
+    {
+      generator.generate_event(first_event + i, reused);
+      LEPTON_CHECK_MESSAGE(same_event(reused, reference[i]), "event " + std::to_string(first_event + i));
+    }
+    ThreadPool pool(3);
+    std::vector<ParticleStore> slice = generator.generate(first_event + 250, 7, pool); // A window from the middle
+    for (std::size_t i = 0; i < slice.size(); ++i)
+    {
+      LEPTON_CHECK(same_event(slice[i], reference[250 + i]));
+    }
+  });
+
+  suite.run("generate reuses stores without carrying anything over", [&]
+  {
+    ThreadPool pool(4);
+    std::vector<ParticleStore> events = generator.generate(first_event + 1, event_count, pool); // Shifted by one: different contents
+    generator.generate(first_event, events, pool);
+    check_same_events(events, reference, "reused stores");
+  });
+
+  suite.run("another seed gives other events", [&]
+  {
+    EventGeneratorConfig other = config;
+    other.seed = config.seed + 1;
+    ParticleStore event;
+    EventGenerator(other).generate_event(first_event, event);
+    LEPTON_CHECK(!same_event(event, reference[0]));
+  });
+  return suite.finish();
+}
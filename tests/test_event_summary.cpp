@@ -0,0 +1,200 @@
+// Description: Checks event summaries on events with hadronic and leptonic taus (MET is minus the visible pT sum and matches the neutrinos) and that sample totals do not depend on the pool.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventArena.h"
+#include "EventGenerator.h"
+#include "EventSummary.h"
+#include "MomentumKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr double tau_mass = 1776.86;
+  constexpr double muon_mass = 105.66;
+
+  bool close(double a, double b, double scale) { return std::abs(a - b) <= 1e-9 * std::max(scale, 1.0); }
+
+  double massless_energy(double px, double py, double pz) { return std::sqrt(px * px + py * py + pz * pz); }
+
+  double tau_energy(double px, double py, double pz) { return std::sqrt(px * px + py * py + pz * pz + tau_mass * tau_mass); }
+
+  // W -> tau nu with the tau decaying to hadrons: the tau is the only visible row and
+  // recoils against the W's neutrino, so MET is the neutrino's pT
+  void add_hadronic_tau_decay(ParticleStore& event, double px, double py)
+  {
+    event.add_tau(tau_mass, -1, tau_energy(px, py, 12000.0), px, py, 12000.0, TauDecayMode::Hadronic);
+    event.add_tau_neutrino(0.0, 0, massless_energy(-px, -py, -3000.0), -px, -py, -3000.0);
+  }
+
+  // W -> tau nu with tau -> mu nu nu: the muon and neutrinos are rows of their own and
+  // the tau is not visible. The muon takes half the tau's transverse momentum.
+  void add_leptonic_tau_decay(ParticleStore& event, double px, double py)
+  {
+    ParticleStore::Index tau = event.add_tau(tau_mass, 1, tau_energy(px, py, -8000.0), px, py, -8000.0, TauDecayMode::Leptonic);
+    ParticleStore::Index muon = event.add_muon(muon_mass, 1, std::sqrt(0.25 * (px * px + py * py) + 16e6 + muon_mass * muon_mass),
+                                               0.5 * px, 0.5 * py, -4000.0);
+    ParticleStore::Index neutrino = event.add_neutrino(0.0, 0, massless_energy(0.5 * px, 0.0, -2000.0), 0.5 * px, 0.0, -2000.0,
+                                                       NeutrinoFlavor::Muon);
+    ParticleStore::Index tau_neutrino = event.add_tau_neutrino(0.0, 0, massless_energy(0.0, 0.5 * py, -2000.0), 0.0, 0.5 * py, -2000.0);
+    event.add_decay_product(tau, muon);
+    event.add_decay_product(tau, neutrino);
+    event.add_decay_product(tau, tau_neutrino);
+    event.add_tau_neutrino(0.0, 0, massless_energy(-px, -py, 5000.0), -px, -py, 5000.0); // From the W
+  }
+
+  // Visible px and py summed row by row, independently of EventSummary's weights, and
+  // the size of the terms for a rounding tolerance
+  void visible_sums(const ParticleStore& event, double& px, double& py, double& scale)
+  {
+    px = py = scale = 0.0;
+    for (ParticleView particle : event)
+    {
+      ParticleType type = particle.get_type();
+      bool visible = type == ParticleType::Electron || type == ParticleType::Muon ||
+                     (type == ParticleType::Tau && particle.get_decay_mode() == TauDecayMode::Hadronic);
+      if (visible)
+      {
+        px += particle.get_px();
+        py += particle.get_py();
+        scale += std::abs(particle.get_px()) + std::abs(particle.get_py());
+      }
+    }
+  }
+
+  bool same_summary(const EventSummary& a, const EventSummary& b)
+  {
+    return same_bits(a.met_x, b.met_x) && same_bits(a.met_y, b.met_y) && same_bits(a.ht, b.ht) && same_bits(a.true_met_x, b.true_met_x) &&
+           same_bits(a.true_met_y, b.true_met_y) && same_bits(a.visible.get_energy(), b.visible.get_energy()) &&
+           a.visible_count == b.visible_count && a.neutrino_count == b.neutrino_count;
+  }
+
+  bool same_totals(const EventSampleTotals& a, const EventSampleTotals& b)
+  {
+    return a.events == b.events && same_bits(a.visible.get_energy(), b.visible.get_energy()) &&
+           same_bits(a.visible.get_px(), b.visible.get_px()) && same_bits(a.visible.get_py(), b.visible.get_py()) &&
+           same_bits(a.visible.get_pz(), b.visible.get_pz()) && same_bits(a.ht, b.ht) && same_bits(a.met, b.met) &&
+           same_bits(a.met_x, b.met_x) && same_bits(a.met_y, b.met_y) && a.visible_count == b.visible_count &&
+           a.neutrino_count == b.neutrino_count;
+  }
+
+  // The store at every SIMD level and the materialized objects give the same summary
+  EventSummary summarize_everywhere(const ParticleStore& event)
+  {
+    SimdLevel detected = detect_simd_level();
+    set_kernel_simd_level(SimdLevel::Scalar);
+    EventSummary scalar = summarize_event(event);
+    set_kernel_simd_level(detected);
+    EventSummary vector = summarize_event(event);
+    EventArena arena;
+    ArenaSpan<Lepton*> objects = event.materialize(arena);
+    EventSummary from_objects = summarize_event(objects.data(), objects.size());
+    LEPTON_CHECK(same_summary(scalar, vector));
+    LEPTON_CHECK(same_summary(scalar, from_objects));
+    return scalar;
+  }
+}
+
+int main()
+{
+  TestSuite suite("event_summary");
+
+  suite.run("a hadronic tau is visible and balances the neutrino", [&]
+  {
+    ParticleStore event;
+    add_hadronic_tau_decay(event, 31000.0, -17000.0);
+    EventSummary summary = summarize_everywhere(event);
+    LEPTON_CHECK(summary.visible_count == 1);
+    LEPTON_CHECK(summary.met_x == -31000.0 && summary.met_y == 17000.0);
+    LEPTON_CHECK(summary.met_x == summary.true_met_x && summary.met_y == summary.true_met_y);
+    LEPTON_CHECK(summary.ht == std::sqrt(31000.0 * 31000.0 + 17000.0 * 17000.0));
+  });
+
+  suite.run("a leptonic tau is carried by its decay products", [&]
+  {
+    ParticleStore event;
+    add_leptonic_tau_decay(event, 24000.0, 9000.0);
+    EventSummary summary = summarize_everywhere(event);
+    LEPTON_CHECK(summary.visible_count == 1); // The muon
+    LEPTON_CHECK(summary.neutrino_count == 3);
+    LEPTON_CHECK(summary.met_x == -12000.0 && summary.met_y == -4500.0);
+    LEPTON_CHECK(close(summary.met_x, summary.true_met_x, 24000.0) && close(summary.met_y, summary.true_met_y, 9000.0));
+  });
+
+  suite.run("mixed events over every lane and tail length agree with the neutrinos", [&]
+  {
+    for (std::size_t taus = 1; taus <= 9; ++taus)
+    {
+      ParticleStore event;
+      for (std::size_t i = 0; i < taus; ++i)
+      {
+        double px = 5000.0 * static_cast<double>(i + 1);
+        double py = -3000.0 * static_cast<double>(i % 3) + 1000.0;
+        if (i % 2 == 0)
+        {
+          add_hadronic_tau_decay(event, px, py);
+        }
+        else
+        {
+          add_leptonic_tau_decay(event, px, py);
+        }
+      }
+      EventSummary summary = summarize_everywhere(event);
+      double px, py, scale;
+      visible_sums(event, px, py, scale);
+      LEPTON_CHECK_MESSAGE(close(summary.met_x, -px, scale) && close(summary.met_y, -py, scale), std::to_string(taus) + " taus");
+      LEPTON_CHECK_MESSAGE(close(summary.met_x, summary.true_met_x, scale) && close(summary.met_y, summary.true_met_y, scale),
+                           std::to_string(taus) + " taus");
+    }
+  });
+
+  suite.run("generated events: MET is minus the visible pT sum", [&]
+  {
+    EventGeneratorConfig config;
+    config.type_weights = {{0.2, 0.2, 0.1, 0.1, 0.4}};
+    ThreadPool pool(2);
+    std::vector<ParticleStore> events = EventGenerator(config).generate(0, 500, pool);
+    std::size_t hadronic = 0;
+    for (const ParticleStore& event : events)
+    {
+      for (ParticleView particle : event)
+      {
+        hadronic += particle.get_type() == ParticleType::Tau && particle.get_decay_mode() == TauDecayMode::Hadronic;
+      }
+      EventSummary summary = summarize_everywhere(event);
+      double px, py, scale;
+      visible_sums(event, px, py, scale);
+      LEPTON_CHECK(close(summary.met_x, -px, scale) && close(summary.met_y, -py, scale));
+    }
+    LEPTON_CHECK_MESSAGE(hadronic > 0, "the sample needs hadronic taus");
+  });
+  suite.run("sample totals are bit-identical for any pool size", [&]
+  {
+    ThreadPool generation_pool(2);
+    std::vector<ParticleStore> events = EventGenerator().generate(0, 3 * summary_block_size + 37, generation_pool); // A partial last block
+    std::vector<EventSummary> summaries;
+    summarize_events(events, summaries, generation_pool);
+    EventSampleTotals serial = reduce_summaries(summaries);
+    LEPTON_CHECK(serial.events == events.size());
+    for (std::size_t threads : {1, 2, 3, 4, 7})
+    {
+      ThreadPool pool(threads);
+      LEPTON_CHECK_MESSAGE(same_totals(reduce_summaries(summaries, pool), serial), std::to_string(threads) + " threads");
+      std::vector<EventSummary> again;
+      summarize_events(events, again, pool);
+      LEPTON_CHECK_MESSAGE(same_totals(reduce_summaries(again, pool), serial), std::to_string(threads) + " threads, summarized again");
+    }
+    for (std::size_t count : {std::size_t{0}, std::size_t{1}, summary_block_size, summary_block_size + 1})
+    {
+      std::vector<EventSummary> prefix(summaries.begin(), summaries.begin() + static_cast<std::ptrdiff_t>(count));
+      ThreadPool pool(3);
+      LEPTON_CHECK_MESSAGE(same_totals(reduce_summaries(prefix, pool), reduce_summaries(prefix)), std::to_string(count) + " summaries");
+    }
+  });
+  return suite.finish();
+}
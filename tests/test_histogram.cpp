@@ -0,0 +1,124 @@
+// Description: Checks that histograms filled from ThreadPool workers merge to the same totals as a serial fill.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "Histogram.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <future>
+#include <vector>
+
+namespace
+{
+  constexpr std::size_t value_count = 100000;
+
+  // Weights are multiples of 1/4, so every sum is exact and the fill order cannot change it
+  double weight_of(std::size_t i) { return 1.0 + 0.25 * static_cast<double>(i % 4); }
+  double x_of(std::size_t i) { return std::fmod(0.6180339887 * static_cast<double>(i), 1.2) - 0.1; } // Reaches both under- and overflow
+  double y_of(std::size_t i) { return std::fmod(0.4142135623 * static_cast<double>(i), 1.0); }
+
+  void check_same_1d(const Histogram1D& filled, const Histogram1D& serial)
+  {
+    LEPTON_CHECK(filled.get_entries() == serial.get_entries());
+    for (std::size_t bin = 0; bin < filled.get_axis().get_bin_count() + 2; ++bin)
+    {
+      LEPTON_CHECK_MESSAGE(filled.get_bin_content(bin) == serial.get_bin_content(bin), "bin " + std::to_string(bin));
+      LEPTON_CHECK_MESSAGE(filled.get_bin_error(bin) == serial.get_bin_error(bin), "bin " + std::to_string(bin));
+    }
+  }
+}
+
+int main()
+{
+  TestSuite suite("histogram");
+  ThreadPool pool(4);
+  const BinAxis axis(20, 0.0, 1.0);
+
+  std::vector<double> x(value_count), y(value_count), weights(value_count);
+  for (std::size_t i = 0; i < value_count; ++i)
+  {
+    x[i] = x_of(i);
+    y[i] = y_of(i);
+    weights[i] = weight_of(i);
+  }
+  Histogram1D serial("serial", axis);
+  Histogram2D serial_2d("serial_2d", axis, axis);
+  for (std::size_t i = 0; i < value_count; ++i)
+  {
+    serial.fill(x[i], weights[i]);
+    serial_2d.fill(x[i], y[i], weights[i]);
+  }
+
+  suite.run("fill from parallel_for matches a serial fill", [&]
+  {
+    Histogram1D histogram("parallel", axis, pool.size() + 1);
+    pool.parallel_for(0, value_count, 1000, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        histogram.fill(x[i], weights[i]);
+      }
+    });
+    check_same_1d(histogram, serial);
+    histogram.merge();
+    check_same_1d(histogram, serial);
+  });
+
+  suite.run("fill_batch from parallel_for matches a serial fill", [&]
+  {
+    Histogram1D histogram("parallel_batch", axis, pool.size() + 1);
+    Histogram2D histogram_2d("parallel_batch_2d", axis, axis, pool.size() + 1);
+    pool.parallel_for(0, value_count, 1000, [&](std::size_t begin, std::size_t end)
+    {
+      histogram.fill_batch(x.data() + begin, end - begin, weights.data() + begin);
+      histogram_2d.fill_batch(x.data() + begin, y.data() + begin, end - begin, weights.data() + begin);
+    });
+    histogram.merge();
+    histogram_2d.merge();
+    check_same_1d(histogram, serial);
+    LEPTON_CHECK(histogram_2d.get_entries() == serial_2d.get_entries());
+    for (std::size_t x_bin = 0; x_bin < axis.get_bin_count() + 2; ++x_bin)
+    {
+      for (std::size_t y_bin = 0; y_bin < axis.get_bin_count() + 2; ++y_bin)
+      {
+        LEPTON_CHECK(histogram_2d.get_bin_content(x_bin, y_bin) == serial_2d.get_bin_content(x_bin, y_bin));
+      }
+    }
+  });
+
+  suite.run("default slots cover a default-sized pool", [&]
+  {
+    ThreadPool default_pool;
+    Histogram1D histogram("default_slots", axis);
+    LEPTON_CHECK(histogram.get_slot_count() == default_pool.size() + 1);
+    default_pool.parallel_for(0, value_count, 1000, [&](std::size_t begin, std::size_t end)
+    {
+      histogram.fill_batch(x.data() + begin, end - begin, weights.data() + begin);
+    });
+    check_same_1d(histogram, serial);
+  });
+
+  suite.run("a worker without a slot gets an explanatory error", [&]
+  {
+    Histogram1D histogram("too_few_slots", axis, 1);
+    std::promise<std::string> message;
+    pool.submit([&]
+    {
+      try
+      {
+        histogram.fill(0.5);
+        message.set_value("");
+      }
+      catch (const std::out_of_range& error)
+      {
+        message.set_value(error.what());
+      }
+    });
+    std::string what = message.get_future().get();
+    LEPTON_CHECK_MESSAGE(what.find("pool.size() + 1") != std::string::npos, what);
+    LEPTON_CHECK(what.find("too_few_slots") != std::string::npos);
+    LEPTON_CHECK(histogram.get_entries() == 0.0);
+  });
+  return suite.finish();
+}
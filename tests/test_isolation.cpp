@@ -0,0 +1,151 @@
+// Description: Checks the grid-indexed muon isolation against the brute-force O(N^2) cone sums, for stores and Lepton objects.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventArena.h"
+#include "Isolation.h"
+#include "Muon.h"
+#include "ParticleStore.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr double pi = 3.141592653589793;
+
+  // Every particle type, with some rows far forward (beyond the grid's eta range) and
+  // some close to phi = +-pi, where the grid wraps
+  ParticleStore make_event(std::size_t count, std::uint64_t seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::exponential_distribution<double> transverse(1.0 / 10000.0);
+    std::uniform_real_distribution<double> angle(-pi, pi);
+    std::uniform_real_distribution<double> central(-2.5, 2.5);
+    std::uniform_real_distribution<double> forward(-6.0, 6.0);
+    std::uniform_real_distribution<double> near_edge(-0.2, 0.2);
+    ParticleStore event;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      double pt = transverse(engine);
+      double phi = i % 7 == 0 ? pi + near_edge(engine) : angle(engine); // Past pi is the same as past -pi
+      double eta = i % 11 == 0 ? forward(engine) : central(engine);
+      double px = pt * std::cos(phi);
+      double py = pt * std::sin(phi);
+      double pz = pt * std::sinh(eta);
+      int charge = i % 2 == 0 ? -1 : 1;
+      switch (i % 6)
+      {
+        case 0:
+        case 1: event.add_muon(105.7, charge, std::sqrt(pt * pt + pz * pz + 105.7 * 105.7), px, py, pz); break;
+        case 2: event.add_electron(0.511, charge, std::sqrt(pt * pt + pz * pz + 0.511 * 0.511), px, py, pz); break;
+        case 3: event.add_neutrino(0.0, 0, std::sqrt(pt * pt + pz * pz), px, py, pz, NeutrinoFlavor::Muon); break;
+        case 4: event.add_tau_neutrino(0.0, 0, std::sqrt(pt * pt + pz * pz), px, py, pz); break;
+        default: event.add_tau(1776.86, charge, std::sqrt(pt * pt + pz * pz + 1776.86 * 1776.86), px, py, pz, TauDecayMode::Hadronic); break;
+      }
+    }
+    return event;
+  }
+
+  void check_sums(const std::vector<double>& sums, const std::vector<double>& reference, const std::string& label)
+  {
+    LEPTON_CHECK_MESSAGE(sums.size() == reference.size(), label);
+    for (std::size_t row = 0; row < reference.size(); ++row)
+    {
+      LEPTON_CHECK_MESSAGE(std::abs(sums[row] - reference[row]) <= 1e-9 * (1.0 + reference[row]), label + ", row " + std::to_string(row));
+    }
+  }
+
+  std::vector<IsolationConfig> configs()
+  {
+    std::vector<IsolationConfig> result(5);
+    result[1].cone_size = 0.1;
+    result[2].cone_size = 0.8;
+    result[2].min_pt = 0.0;
+    result[3].type_mask = 1u << static_cast<unsigned>(ParticleType::Muon);
+    result[4].relative = false;
+    result[4].threshold = 2000.0;
+    return result;
+  }
+
+  const std::size_t particle_counts[] = {0, 1, 2, 8, 37, 100, 1000};
+}
+
+int main()
+{
+  TestSuite suite("isolation");
+
+  suite.run("cone sums match the brute force", [&]
+  {
+    for (const IsolationConfig& config : configs())
+    {
+      MuonIsolation isolation(config); // One instance for every event, so its scratch carries over
+      for (std::size_t count : particle_counts)
+      {
+        ParticleStore event = make_event(count, count + 1);
+        std::vector<double> reference;
+        compute_isolation_brute_force(event, config, reference);
+        isolation.compute(event);
+        check_sums(isolation.get_cone_sums(), reference, "cone " + std::to_string(config.cone_size) + ", " + std::to_string(count) + " particles");
+      }
+    }
+  });
+
+  suite.run("Lepton objects give the store's cone sums", [&]
+  {
+    for (const IsolationConfig& config : configs())
+    {
+      MuonIsolation isolation(config);
+      for (std::size_t count : particle_counts)
+      {
+        ParticleStore event = make_event(count, 7 * count + 3);
+        std::vector<double> reference;
+        compute_isolation_brute_force(event, config, reference);
+        EventArena arena;
+        ArenaSpan<Lepton*> objects = event.materialize(arena);
+        isolation.compute(objects.data(), objects.size());
+        check_sums(isolation.get_cone_sums(), reference, std::to_string(count) + " objects");
+      }
+    }
+  });
+
+  suite.run("apply flags the muons the brute-force sums isolate", [&]
+  {
+    for (const IsolationConfig& config : configs())
+    {
+      MuonIsolation isolation(config);
+      ParticleStore event = make_event(1000, 99);
+      std::vector<double> reference;
+      compute_isolation_brute_force(event, config, reference);
+      EventArena arena;
+      ArenaSpan<Lepton*> objects = event.materialize(arena);
+
+      std::size_t expected = 0;
+      std::size_t isolated = isolation.apply(event);
+      for (ParticleStore::Index row = 0; row < event.size(); ++row)
+      {
+        if (event[row].get_type() != ParticleType::Muon)
+        {
+          continue;
+        }
+        bool flag = isolation.is_isolated(reference[row], event[row].get_four_momentum().get_pt());
+        expected += flag;
+        LEPTON_CHECK_MESSAGE(event[row].get_isolated() == flag, "row " + std::to_string(row));
+      }
+      LEPTON_CHECK(isolated == expected);
+      LEPTON_CHECK(expected > 0 && expected < event.size() / 3); // Both outcomes occur
+
+      LEPTON_CHECK(isolation.apply(objects.data(), objects.size()) == expected);
+      for (std::size_t row = 0; row < objects.size(); ++row)
+      {
+        if (objects[row]->get_type_id() == ParticleType::Muon)
+        {
+          LEPTON_CHECK(static_cast<const Muon*>(objects[row])->get_isolated() == event[static_cast<ParticleStore::Index>(row)].get_isolated());
+        }
+      }
+    }
+  });
+  return suite.finish();
+}
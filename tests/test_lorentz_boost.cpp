@@ -0,0 +1,209 @@
+// Description: Checks LorentzBoost round trips, its edge cases and the batched boost kernels at every SIMD level.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "LorentzBoost.h"
+#include "MomentumKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+  // Two AVX-512 iterations plus every tail length, and one EventFile-sized block
+  constexpr std::size_t sizes[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 4096};
+
+  // A Z boson moving along the beam
+  const FourMomentum parent(std::sqrt(91187.6 * 91187.6 + 60000.0 * 60000.0 + 250000.0 * 250000.0), 60000.0, 0.0, 250000.0);
+
+  struct Columns
+  {
+    std::vector<double> energy, px, py, pz;
+
+    explicit Columns(std::size_t size) : energy(size), px(size), py(size), pz(size) {}
+    MomentumColumns view() const { return MomentumColumns{energy.data(), px.data(), py.data(), pz.data(), energy.size()}; }
+    MutableMomentumColumns mutable_view() { return MutableMomentumColumns{energy.data(), px.data(), py.data(), pz.data(), energy.size()}; }
+    FourMomentum operator[](std::size_t i) const { return FourMomentum(energy[i], px[i], py[i], pz[i]); }
+  };
+
+  struct Boosts
+  {
+    std::vector<double> beta_x, beta_y, beta_z, gamma, gamma_factor;
+
+    explicit Boosts(std::size_t size) : beta_x(size), beta_y(size), beta_z(size), gamma(size), gamma_factor(size) {}
+    MutableBoostColumns mutable_view()
+    {
+      return MutableBoostColumns{beta_x.data(), beta_y.data(), beta_z.data(), gamma.data(), gamma_factor.data(), beta_x.size()};
+    }
+  };
+
+  // On-shell particles of the given mass
+  Columns make_momenta(std::size_t count, double mass, std::uint64_t seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::normal_distribution<double> momentum(0.0, 40000.0);
+    Columns columns(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      columns.px[i] = momentum(engine);
+      columns.py[i] = momentum(engine);
+      columns.pz[i] = momentum(engine);
+      columns.energy[i] = std::sqrt(columns.px[i] * columns.px[i] + columns.py[i] * columns.py[i] + columns.pz[i] * columns.pz[i] + mass * mass);
+    }
+    return columns;
+  }
+
+  double relative_difference(const FourMomentum& a, const FourMomentum& b)
+  {
+    double difference = std::max({std::abs(a.get_energy() - b.get_energy()), std::abs(a.get_px() - b.get_px()),
+                                  std::abs(a.get_py() - b.get_py()), std::abs(a.get_pz() - b.get_pz())});
+    return difference / std::max(std::abs(a.get_energy()), std::abs(b.get_energy()));
+  }
+
+  bool same_momentum(const FourMomentum& a, const FourMomentum& b)
+  {
+    return same_bits(a.get_energy(), b.get_energy()) && same_bits(a.get_px(), b.get_px()) && same_bits(a.get_py(), b.get_py()) &&
+           same_bits(a.get_pz(), b.get_pz());
+  }
+
+  // One boost for the whole batch: matches apply() exactly, keeps masses, and the
+  // inverse brings every vector back
+  void check_uniform_boost(std::size_t size)
+  {
+    Columns muons = make_momenta(size, 105.7, size + 1);
+    LorentzBoost to_rest = LorentzBoost::to_rest_frame(parent);
+    Columns boosted(size);
+    boost_batch(to_rest, muons.view(), boosted.mutable_view());
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      FourMomentum single = to_rest.apply(muons[i]);
+      LEPTON_CHECK_MESSAGE(same_momentum(single, boosted[i]), "element " + std::to_string(i));
+      LEPTON_CHECK(std::abs(single.get_mass() - muons[i].get_mass()) <= 1e-6 * muons[i].get_energy());
+    }
+    boost_batch(to_rest.inverse(), boosted.view(), boosted.mutable_view()); // In place
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      LEPTON_CHECK_MESSAGE(relative_difference(boosted[i], muons[i]) <= 1e-12, "element " + std::to_string(i));
+    }
+  }
+
+  // A boost per element, built from each element's own parent
+  void check_per_element_boosts(std::size_t size)
+  {
+    Columns muons = make_momenta(size, 105.7, size + 1);
+    Columns parents = make_momenta(size, 105.7, size + 2);
+    Boosts to_rest(size), from_rest(size);
+    to_rest_frame_boosts(parents.view(), to_rest.mutable_view());
+    from_rest_frame_boosts(parents.view(), from_rest.mutable_view());
+
+    Columns boosted(size);
+    boost_batch(to_rest.mutable_view(), muons.view(), boosted.mutable_view());
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      LorentzBoost boost = LorentzBoost::to_rest_frame(parents[i]);
+      LEPTON_CHECK(same_bits(to_rest.beta_x[i], boost.get_beta_x()) && same_bits(to_rest.gamma[i], boost.get_gamma()) &&
+                   same_bits(to_rest.gamma_factor[i], boost.get_gamma_factor()));
+      LEPTON_CHECK_MESSAGE(same_momentum(boost.apply(muons[i]), boosted[i]), "element " + std::to_string(i));
+    }
+    boost_batch(from_rest.mutable_view(), boosted.view(), boosted.mutable_view());
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      // Rounding grows with gamma^2, and muon parents reach gamma ~ 1000
+      LEPTON_CHECK_MESSAGE(relative_difference(boosted[i], muons[i]) <= 1e-13 * to_rest.gamma[i] * to_rest.gamma[i],
+                           "element " + std::to_string(i));
+    }
+  }
+
+  void check_level(SimdLevel level)
+  {
+    set_kernel_simd_level(level);
+    LEPTON_CHECK(get_kernel_simd_level() == level);
+    for (std::size_t size : sizes)
+    {
+      check_uniform_boost(size);
+      check_per_element_boosts(size);
+    }
+  }
+}
+
+int main()
+{
+  TestSuite suite("lorentz_boost");
+
+  suite.run("to_rest_frame puts the parent at rest", [&]
+  {
+    FourMomentum at_rest = LorentzBoost::to_rest_frame(parent).apply(parent);
+    LEPTON_CHECK(std::abs(at_rest.get_energy() - parent.get_mass()) <= 1e-9 * parent.get_energy());
+    LEPTON_CHECK(std::abs(at_rest.get_px()) <= 1e-9 * parent.get_energy());
+    LEPTON_CHECK(std::abs(at_rest.get_py()) <= 1e-9 * parent.get_energy());
+    LEPTON_CHECK(std::abs(at_rest.get_pz()) <= 1e-9 * parent.get_energy());
+    FourMomentum back = LorentzBoost::from_rest_frame(parent).apply(at_rest);
+    LEPTON_CHECK(relative_difference(back, parent) <= 1e-12);
+  });
+
+  suite.run("identity boost leaves vectors unchanged", [&]
+  {
+    FourMomentum muon(50000.0, 12000.0, -30000.0, 38000.0);
+    LEPTON_CHECK(same_momentum(LorentzBoost().apply(muon), muon));
+    LEPTON_CHECK(same_momentum(LorentzBoost(0.0, 0.0, 0.0).apply(muon), muon));
+    LEPTON_CHECK(LorentzBoost().get_gamma() == 1.0);
+  });
+
+  suite.run("inverse of inverse is the original boost", [&]
+  {
+    LorentzBoost boost(0.3, -0.5, 0.7);
+    LorentzBoost twice = boost.inverse().inverse();
+    LEPTON_CHECK(same_bits(twice.get_beta_x(), boost.get_beta_x()));
+    LEPTON_CHECK(same_bits(twice.get_beta_y(), boost.get_beta_y()));
+    LEPTON_CHECK(same_bits(twice.get_beta_z(), boost.get_beta_z()));
+    LEPTON_CHECK(same_bits(twice.get_gamma(), boost.get_gamma()));
+    LEPTON_CHECK(same_bits(twice.get_gamma_factor(), boost.get_gamma_factor()));
+    FourMomentum muon(50000.0, 12000.0, -30000.0, 38000.0);
+    LEPTON_CHECK(relative_difference(boost.inverse().apply(boost.apply(muon)), muon) <= 1e-14);
+  });
+
+  suite.run("velocities at or above c throw", [&]
+  {
+    LEPTON_CHECK_THROWS(std::invalid_argument, LorentzBoost(1.0, 0.0, 0.0));
+    LEPTON_CHECK_THROWS(std::invalid_argument, LorentzBoost(0.0, 0.0, -1.5));
+    LEPTON_CHECK_THROWS(std::invalid_argument, LorentzBoost(0.8, 0.8, 0.0));
+    LEPTON_CHECK_THROWS(std::invalid_argument, LorentzBoost(std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0));
+  });
+
+  suite.run("rest frames of space-like or non-positive-energy parents throw", [&]
+  {
+    const FourMomentum invalid[] = {
+      FourMomentum(1000.0, 2000.0, 0.0, 0.0),  // Space-like
+      FourMomentum(1000.0, 1000.0, 0.0, 0.0),  // Light-like
+      FourMomentum(0.0, 0.0, 0.0, 0.0),        // Zero energy
+      FourMomentum(-5000.0, 1000.0, 0.0, 0.0), // Time-like, negative energy
+    };
+    for (const FourMomentum& momentum : invalid)
+    {
+      LEPTON_CHECK_THROWS(std::invalid_argument, LorentzBoost::to_rest_frame(momentum));
+      LEPTON_CHECK_THROWS(std::invalid_argument, LorentzBoost::from_rest_frame(momentum));
+    }
+    Columns parents(1);
+    parents.energy[0] = 1000.0;
+    parents.px[0] = 2000.0;
+    Boosts boosts(1);
+    LEPTON_CHECK_THROWS(std::invalid_argument, to_rest_frame_boosts(parents.view(), boosts.mutable_view()));
+  });
+
+  SimdLevel detected = detect_simd_level();
+  for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512})
+  {
+    std::string name = std::string("boost_batch matches LorentzBoost::apply and round trips [") + simd_level_name(level) + "]";
+    if (level > detected)
+    {
+      std::cout << "[SKIP] lorentz_boost: " << name << " (not supported by this CPU)\n";
+      continue;
+    }
+    suite.run(name, [&] { check_level(level); });
+  }
+  set_kernel_simd_level(detected);
+  return suite.finish();
+}
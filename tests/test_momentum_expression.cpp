@@ -0,0 +1,114 @@
+// Description: Checks lazy lepton sums against eager FourMomentum arithmetic, and the particle-returning call sites they replace.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "Electron.h"
+#include "Muon.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  bool same_momentum(const FourMomentum& a, const FourMomentum& b)
+  {
+    return same_bits(a.get_energy(), b.get_energy()) && same_bits(a.get_px(), b.get_px()) && same_bits(a.get_py(), b.get_py()) &&
+           same_bits(a.get_pz(), b.get_pz());
+  }
+
+  // Non-round components, so the sums round and the order of additions shows
+  const Muon a(105.7, -1, 45312.1, 11874.3, -20431.7, 38127.9);
+  const Muon b(105.7, 1, 38974.6, -15300.2, 9912.8, -33278.1);
+  const Electron c(0.511, -1, 27615.3, 3121.9, 24510.4, -12187.2);
+
+  // Only same-type sums turn back into a particle
+  static_assert(std::is_convertible<decltype(a + b), Muon>::value, "a sum of muons converts to Muon");
+  static_assert(std::is_convertible<decltype(a + b + a), Muon>::value, "a sum of muons converts to Muon");
+  static_assert(std::is_convertible<decltype(c + c), Electron>::value, "a sum of electrons converts to Electron");
+  static_assert(!std::is_constructible<Electron, decltype(a + b)>::value, "a sum of muons is not an Electron");
+  static_assert(!std::is_constructible<Muon, decltype(c + c)>::value, "a sum of electrons is not a Muon");
+  static_assert(!std::is_constructible<Muon, decltype(a + c)>::value, "a mixed sum is not a Muon");
+  static_assert(!std::is_constructible<Muon, decltype(a + b + c)>::value, "a mixed sum is not a Muon");
+  static_assert(!std::is_constructible<Muon, decltype(a - b)>::value, "a difference is not a particle");
+}
+
+int main()
+{
+  TestSuite suite("momentum_expression");
+
+  suite.run("(a + b + c).mass() matches the eager sum", [&]
+  {
+    FourMomentum eager = a.get_four_momentum() + b.get_four_momentum() + c.get_four_momentum();
+    LEPTON_CHECK(same_bits((a + b + c).mass(), eager.get_mass()));
+    LEPTON_CHECK(same_bits((a + b + c).get_mass(), eager.get_mass()));
+    LEPTON_CHECK(same_momentum(a + b + c, eager));
+    LEPTON_CHECK(same_bits((a + b).get_pt(), (a.get_four_momentum() + b.get_four_momentum()).get_pt()));
+  });
+
+  suite.run("differences match eager subtraction", [&]
+  {
+    FourMomentum eager = a.get_four_momentum() + b.get_four_momentum() - c.get_four_momentum();
+    LEPTON_CHECK(same_momentum(a + b - c, eager));
+    LEPTON_CHECK(same_momentum(a - b, a.get_four_momentum() - b.get_four_momentum()));
+  });
+
+  suite.run("FourMomentum temporaries are held by value", [&]
+  {
+    auto sum = a + b + FourMomentum(1000.0, 200.0, -300.0, 400.0);
+    auto difference = FourMomentum(90000.0, 100.0, 200.0, 300.0) - (a + b);
+    FourMomentum expected = a.get_four_momentum() + b.get_four_momentum() + FourMomentum(1000.0, 200.0, -300.0, 400.0);
+    LEPTON_CHECK(same_momentum(sum, expected));
+    LEPTON_CHECK(same_momentum(difference, FourMomentum(90000.0, 100.0, 200.0, 300.0) - (a.get_four_momentum() + b.get_four_momentum())));
+  });
+
+  suite.run("old particle-returning call sites still compile and agree", [&]
+  {
+    Muon combined = a + b;
+    LEPTON_CHECK(combined.get_rest_mass() == 2 * 105.7);
+    LEPTON_CHECK(combined.get_charge() == 0);
+    LEPTON_CHECK(same_momentum(combined.get_four_momentum(), a.get_four_momentum() + b.get_four_momentum()));
+
+    Electron electrons = c + c;
+    LEPTON_CHECK(electrons.get_charge() == -2);
+    LEPTON_CHECK(same_momentum(electrons.get_four_momentum(), c.get_four_momentum() + c.get_four_momentum()));
+
+    Muon three = a + b + a;
+    LEPTON_CHECK(three.get_charge() == -1);
+    LEPTON_CHECK(same_momentum(three.get_four_momentum(), a.get_four_momentum() + b.get_four_momentum() + a.get_four_momentum()));
+
+    const Lepton& lepton = a;
+    FourMomentum through_base = lepton.operator+(c);
+    LEPTON_CHECK(same_momentum(through_base, a.get_four_momentum() + c.get_four_momentum()));
+    LEPTON_CHECK(same_momentum(through_base, sum_four_momenta(a, c)));
+  });
+
+  suite.run("a sum of muons is isolated only if every muon is", [&]
+  {
+    Muon isolated_a = a, isolated_b = b;
+    isolated_a.set_isolated(true);
+    isolated_b.set_isolated(true);
+    Muon both = isolated_a + isolated_b;
+    Muon one = isolated_a + b;
+    Muon neither = a + b;
+    Muon three = isolated_a + isolated_b + isolated_a;
+    Muon three_with_one_not = isolated_a + isolated_b + b;
+    LEPTON_CHECK(both.get_isolated());
+    LEPTON_CHECK(!one.get_isolated());
+    LEPTON_CHECK(!neither.get_isolated());
+    LEPTON_CHECK(three.get_isolated());
+    LEPTON_CHECK(!three_with_one_not.get_isolated());
+  });
+
+  suite.run("sum_momenta matches chained addition", [&]
+  {
+    std::vector<std::unique_ptr<Lepton>> leptons;
+    leptons.push_back(std::make_unique<Muon>(a));
+    leptons.push_back(std::make_unique<Muon>(b));
+    leptons.push_back(std::make_unique<Electron>(c));
+    LEPTON_CHECK(same_momentum(sum_momenta(leptons), a + b + c));
+    std::vector<const Lepton*> pointers = {&a, &b, &c};
+    LEPTON_CHECK(same_momentum(sum_momenta(pointers), a + b + c));
+  });
+  return suite.finish();
+}
@@ -0,0 +1,133 @@
+// Description: Checks the batch four-momentum kernels bit for bit against the scalar Lepton functions at every SIMD level.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "Muon.h"
+#include "MomentumKernels.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+  // Up to two AVX-512 iterations plus every tail length
+  constexpr std::size_t max_size = 17;
+
+  struct Columns
+  {
+    std::vector<double> energy, px, py, pz;
+
+    explicit Columns(std::size_t size) : energy(size), px(size), py(size), pz(size) {}
+    MomentumColumns view() const { return MomentumColumns{energy.data(), px.data(), py.data(), pz.data(), energy.size()}; }
+    MutableMomentumColumns mutable_view() { return MutableMomentumColumns{energy.data(), px.data(), py.data(), pz.data(), energy.size()}; }
+  };
+
+  // Mostly physical muons; every third one is given too little energy, so some sums are
+  // space-like and take the negative-mass branch
+  std::vector<Muon> make_muons(std::size_t count, std::uint64_t seed)
+  {
+    std::mt19937_64 engine(seed);
+    std::normal_distribution<double> momentum(0.0, 20000.0);
+    std::vector<Muon> muons;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      double px = momentum(engine), py = momentum(engine), pz = momentum(engine);
+      double energy = std::sqrt(px * px + py * py + pz * pz + 105.7 * 105.7);
+      muons.emplace_back(105.7, i % 2 == 0 ? -1 : 1, i % 3 == 2 ? 0.25 * energy : energy, px, py, pz);
+    }
+    return muons;
+  }
+
+  Columns to_columns(const std::vector<Muon>& muons)
+  {
+    Columns columns(muons.size());
+    for (std::size_t i = 0; i < muons.size(); ++i)
+    {
+      const FourMomentum& momentum = muons[i].get_four_momentum();
+      columns.energy[i] = momentum.get_energy();
+      columns.px[i] = momentum.get_px();
+      columns.py[i] = momentum.get_py();
+      columns.pz[i] = momentum.get_pz();
+    }
+    return columns;
+  }
+
+  void check_sum(const FourMomentum& expected, const Columns& out, std::size_t i)
+  {
+    LEPTON_CHECK_MESSAGE(same_bits(out.energy[i], expected.get_energy()) && same_bits(out.px[i], expected.get_px()) &&
+                         same_bits(out.py[i], expected.get_py()) && same_bits(out.pz[i], expected.get_pz()),
+                         "element " + std::to_string(i));
+  }
+
+  void check_level(SimdLevel level)
+  {
+    set_kernel_simd_level(level);
+    LEPTON_CHECK(get_kernel_simd_level() == level);
+    for (std::size_t size = 0; size <= max_size; ++size)
+    {
+      std::vector<Muon> first = make_muons(size, 2 * size + 1);
+      std::vector<Muon> second = make_muons(size, 2 * size + 2);
+      Columns a = to_columns(first);
+      Columns b = to_columns(second);
+
+      Columns sums(size);
+      std::vector<double> dots(size), masses(size);
+      sum_four_momenta_batch(a.view(), b.view(), sums.mutable_view());
+      dot_product_four_momenta_batch(a.view(), b.view(), dots.data());
+      invariant_mass_batch(a.view(), b.view(), masses.data());
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        FourMomentum expected = sum_four_momenta(first[i], second[i]);
+        check_sum(expected, sums, i);
+        LEPTON_CHECK_MESSAGE(same_bits(dots[i], dot_product_four_momenta(first[i], second[i])), "element " + std::to_string(i));
+        LEPTON_CHECK_MESSAGE(same_bits(masses[i], expected.get_mass()), "element " + std::to_string(i));
+      }
+
+      // Outputs written over either input
+      Columns into_a = a;
+      sum_four_momenta_batch(into_a.view(), b.view(), into_a.mutable_view());
+      Columns into_b = b;
+      sum_four_momenta_batch(a.view(), into_b.view(), into_b.mutable_view());
+      Columns dot_into_a = a;
+      dot_product_four_momenta_batch(dot_into_a.view(), b.view(), dot_into_a.energy.data());
+      Columns mass_into_b = b;
+      invariant_mass_batch(a.view(), mass_into_b.view(), mass_into_b.pz.data());
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        FourMomentum expected = sum_four_momenta(first[i], second[i]);
+        check_sum(expected, into_a, i);
+        check_sum(expected, into_b, i);
+        LEPTON_CHECK(same_bits(dot_into_a.energy[i], dot_product_four_momenta(first[i], second[i])));
+        LEPTON_CHECK(same_bits(mass_into_b.pz[i], expected.get_mass()));
+      }
+    }
+  }
+}
+
+int main()
+{
+  TestSuite suite("momentum_kernels");
+  SimdLevel detected = detect_simd_level();
+  for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512})
+  {
+    std::string name = std::string("batch kernels match the scalar functions [") + simd_level_name(level) + "]";
+    if (level > detected)
+    {
+      std::cout << "[SKIP] momentum_kernels: " << name << " (not supported by this CPU)\n";
+      continue;
+    }
+    suite.run(name, [&] { check_level(level); });
+  }
+  set_kernel_simd_level(detected);
+
+  suite.run("mismatched sizes throw", [&]
+  {
+    Columns a(4), b(5), out(4);
+    std::vector<double> values(4);
+    LEPTON_CHECK_THROWS(std::invalid_argument, sum_four_momenta_batch(a.view(), b.view(), out.mutable_view()));
+    LEPTON_CHECK_THROWS(std::invalid_argument, dot_product_four_momenta_batch(a.view(), b.view(), values.data()));
+    LEPTON_CHECK_THROWS(std::invalid_argument, invariant_mass_batch(a.view(), b.view(), values.data()));
+  });
+  return suite.finish();
+}
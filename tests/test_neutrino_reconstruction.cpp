@@ -0,0 +1,165 @@
+// Description: Checks the neutrino pz solver at every SIMD level and against the object path, and the W reconstruction's handling of leptons the solver cannot use.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventGenerator.h"
+#include "EventSummary.h"
+#include "MomentumKernels.h"
+#include "Muon.h"
+#include "Neutrino.h"
+#include "NeutrinoReconstruction.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Leptons with their events' MET: the W candidates of a generated sample, then random
+  // leptons and MET, which often leave no real root
+  struct SolverInputs
+  {
+    std::vector<double> energy, px, py, pz, mass, met_x, met_y;
+
+    void add(double lepton_mass, double lepton_px, double lepton_py, double lepton_pz, double x, double y)
+    {
+      mass.push_back(lepton_mass);
+      energy.push_back(std::sqrt(lepton_px * lepton_px + lepton_py * lepton_py + lepton_pz * lepton_pz + lepton_mass * lepton_mass));
+      px.push_back(lepton_px);
+      py.push_back(lepton_py);
+      pz.push_back(lepton_pz);
+      met_x.push_back(x);
+      met_y.push_back(y);
+    }
+
+    MomentumColumns columns(std::size_t count) const { return MomentumColumns{energy.data(), px.data(), py.data(), pz.data(), count}; }
+  };
+
+  SolverInputs make_inputs()
+  {
+    SolverInputs inputs;
+    ThreadPool pool(2);
+    std::vector<ParticleStore> events = EventGenerator().generate(0, 2000, pool);
+    std::vector<EventSummary> summaries;
+    summarize_events(events, summaries, pool);
+    WCandidates candidates;
+    NeutrinoReconstruction().reconstruct(events, summaries, candidates);
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      ParticleView lepton = events[candidates.event[i]][candidates.lepton[i]];
+      inputs.add(lepton.get_rest_mass(), lepton.get_px(), lepton.get_py(), lepton.get_pz(), summaries[candidates.event[i]].met_x,
+                 summaries[candidates.event[i]].met_y);
+    }
+    std::mt19937_64 engine(80379);
+    std::normal_distribution<double> momentum(0.0, 40000.0);
+    for (int i = 0; i < 2000; ++i)
+    {
+      inputs.add(105.66, momentum(engine), momentum(engine), momentum(engine), momentum(engine), momentum(engine));
+    }
+    return inputs;
+  }
+
+  bool same_solution(const NeutrinoSolutions& a, const NeutrinoSolutions& b, std::size_t i)
+  {
+    return same_bits(a.pz_plus[i], b.pz_plus[i]) && same_bits(a.pz_minus[i], b.pz_minus[i]) && same_bits(a.pz[i], b.pz[i]) &&
+           a.solution[i] == b.solution[i];
+  }
+}
+
+int main()
+{
+  TestSuite suite("neutrino_reconstruction");
+  const SolverInputs inputs = make_inputs();
+  const std::size_t count = inputs.energy.size();
+
+  SimdLevel detected = detect_simd_level();
+  set_kernel_simd_level(SimdLevel::Scalar);
+  NeutrinoSolutions scalar;
+  solve_neutrino_pz(inputs.columns(count), inputs.met_x.data(), inputs.met_y.data(), scalar);
+  set_kernel_simd_level(detected);
+
+  suite.run("the inputs reach every kind of solution", [&]
+  {
+    std::size_t kinds[3] = {};
+    for (NeutrinoSolution solution : scalar.solution)
+    {
+      ++kinds[static_cast<std::size_t>(solution)];
+    }
+    LEPTON_CHECK(kinds[0] > 0 && kinds[1] > 0 && kinds[2] > 0);
+  });
+
+  for (SimdLevel level : {SimdLevel::Avx2, SimdLevel::Avx512})
+  {
+    std::string name = std::string("solve_neutrino_pz matches the scalar solver bit for bit [") + simd_level_name(level) + "]";
+    if (level > detected)
+    {
+      std::cout << "[SKIP] neutrino_reconstruction: " << name << " (not supported by this CPU)\n";
+      continue;
+    }
+    suite.run(name, [&]
+    {
+      set_kernel_simd_level(level);
+      NeutrinoSolutions solutions;
+      solve_neutrino_pz(inputs.columns(count), inputs.met_x.data(), inputs.met_y.data(), solutions);
+      LEPTON_CHECK(solutions.size() == count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        LEPTON_CHECK_MESSAGE(same_solution(solutions, scalar, i), "lepton " + std::to_string(i));
+      }
+      for (std::size_t tail = 0; tail <= 17; ++tail) // Every remainder after the full vectors
+      {
+        solve_neutrino_pz(inputs.columns(tail), inputs.met_x.data(), inputs.met_y.data(), solutions);
+        LEPTON_CHECK(solutions.size() == tail);
+        for (std::size_t i = 0; i < tail; ++i)
+        {
+          LEPTON_CHECK_MESSAGE(same_solution(solutions, scalar, i), std::to_string(tail) + " leptons");
+        }
+      }
+    });
+  }
+  set_kernel_simd_level(detected);
+
+  suite.run("make_neutrino_candidate matches the batch solver", [&]
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      Muon lepton(inputs.mass[i], -1, inputs.energy[i], inputs.px[i], inputs.py[i], inputs.pz[i]);
+      NeutrinoSolution solution;
+      Neutrino neutrino = make_neutrino_candidate(lepton, inputs.met_x[i], inputs.met_y[i], &solution);
+      LEPTON_CHECK_MESSAGE(same_bits(neutrino.get_four_momentum().get_pz(), scalar.pz[i]) && solution == scalar.solution[i],
+                           "lepton " + std::to_string(i));
+      LEPTON_CHECK(neutrino.get_four_momentum().get_px() == inputs.met_x[i] && neutrino.get_four_momentum().get_py() == inputs.met_y[i]);
+    }
+  });
+
+  suite.run("candidates with no valid neutrino energy are left out", [&]
+  {
+    std::vector<ParticleStore> events(3);
+    events[0].add_muon(105.7, -1, 40000.0, 25000.0, -12000.0, 29000.0);
+    events[0].add_neutrino(0.0, 0, 30000.0, -18000.0, 9000.0, 22000.0, NeutrinoFlavor::Muon);
+    events[1].add_muon(0.0, -1, 50000.0, 0.0, 0.0, 50000.0); // E = |pz|: the solver divides by zero
+    events[1].add_neutrino(0.0, 0, 20000.0, 12000.0, 16000.0, 0.0, NeutrinoFlavor::Muon);
+    events[2].add_electron(0.511, 1, 35000.0, -20000.0, 15000.0, -24000.0);
+    std::vector<EventSummary> summaries;
+    for (const ParticleStore& event : events)
+    {
+      summaries.push_back(summarize_event(event));
+    }
+
+    NeutrinoReconstruction reconstruction;
+    WCandidates candidates;
+    LEPTON_CHECK(reconstruction.reconstruct(events, summaries, candidates) == 2);
+    LEPTON_CHECK(candidates.size() == 2 && candidates.solutions.size() == 2 && candidates.neutrinos.size() == 2);
+    LEPTON_CHECK(candidates.event[0] == 0 && candidates.event[1] == 2);
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      LEPTON_CHECK(std::isfinite(candidates.solutions.pz[i]));
+      LEPTON_CHECK(same_bits(candidates.neutrinos[static_cast<ParticleStore::Index>(i)].get_pz(), candidates.solutions.pz[i]));
+      LEPTON_CHECK(candidates.neutrinos[static_cast<ParticleStore::Index>(i)].get_e() > 0.0);
+    }
+    LEPTON_CHECK(candidates.neutrinos[1].get_flavor() == NeutrinoFlavor::Electron);
+  });
+  return suite.finish();
+}
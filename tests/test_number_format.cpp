@@ -0,0 +1,145 @@
+// Description: Checks NumberFormat against std::to_chars: shortest round-trip text, fixed decimals and unsigned integers.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "NumberFormat.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace
+{
+  std::string shortest(double value)
+  {
+    char text[number_room];
+    return std::string(text, format_shortest(text, value));
+  }
+
+  std::string expected_shortest(double value)
+  {
+    char text[number_room];
+    return std::string(text, std::to_chars(text, text + sizeof(text), value).ptr);
+  }
+
+  std::string fixed(double value, int decimals)
+  {
+    char text[number_room];
+    return std::string(text, format_fixed(text, value, decimals));
+  }
+
+  // std::to_chars rounds the exact binary value; away from ties that is what rounding
+  // value * 10^decimals gives too. Its "-0.000" for tiny negatives is written "0.000".
+  std::string expected_fixed(double value, int decimals)
+  {
+    char text[400];
+    std::string result(text, std::to_chars(text, text + sizeof(text), value, std::chars_format::fixed, decimals).ptr);
+    return result.find_first_not_of("-0.") == std::string::npos && result[0] == '-' ? result.substr(1) : result;
+  }
+
+  bool near_tie(double value, int decimals)
+  {
+    double scaled = std::abs(value) * std::pow(10.0, decimals);
+    return std::abs(scaled - std::floor(scaled) - 0.5) < 1e-6;
+  }
+
+  double from_bits(std::uint64_t bits)
+  {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+}
+
+int main()
+{
+  TestSuite suite("number_format");
+
+  suite.run("shortest matches to_chars on random bit patterns", [&]
+  {
+    std::mt19937_64 engine(20261017);
+    for (int i = 0; i < 2000000; ++i)
+    {
+      double value = from_bits(engine());
+      LEPTON_CHECK_MESSAGE(shortest(value) == expected_shortest(value), expected_shortest(value));
+    }
+  });
+
+  suite.run("shortest matches to_chars on edge cases", [&]
+  {
+    const double specials[] = {0.0, -0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::denorm_min(),
+                               std::numeric_limits<double>::min(), std::numeric_limits<double>::max(),
+                               std::numeric_limits<double>::epsilon(), 9007199254740992.0, 9007199254740993.0, 1e23, 5e-324};
+    for (double value : specials)
+    {
+      LEPTON_CHECK_MESSAGE(shortest(value) == expected_shortest(value), expected_shortest(value));
+    }
+    for (int exponent = -1074; exponent < 1024; ++exponent) // Powers of two and their neighbours
+    {
+      double power = std::ldexp(1.0, exponent);
+      for (double value : {power, std::nextafter(power, 0.0), std::nextafter(power, 1e308), -power})
+      {
+        LEPTON_CHECK_MESSAGE(shortest(value) == expected_shortest(value), expected_shortest(value));
+      }
+    }
+    for (int exponent = -325; exponent < 310; ++exponent) // Multiples of powers of ten, where fixed and scientific trade places
+    {
+      double power = std::pow(10.0, exponent);
+      for (int multiple = 1; multiple < 100; ++multiple)
+      {
+        double value = multiple * power;
+        LEPTON_CHECK_MESSAGE(shortest(value) == expected_shortest(value), expected_shortest(value));
+      }
+    }
+    for (int i = 0; i < 200000; ++i) // Integers and short decimals, as the generator's MeV values often are
+    {
+      for (double value : {static_cast<double>(i), -static_cast<double>(i), i * 0.001, i * 0.1, i * 1e-5})
+      {
+        LEPTON_CHECK_MESSAGE(shortest(value) == expected_shortest(value), expected_shortest(value));
+      }
+    }
+  });
+
+  suite.run("fixed matches to_chars away from ties", [&]
+  {
+    std::mt19937_64 engine(17102026);
+    std::uniform_real_distribution<double> momentum(-1e6, 1e6);
+    for (int i = 0; i < 500000; ++i)
+    {
+      double value = i % 3 == 0 ? momentum(engine) * 1e-7 : momentum(engine);
+      int decimals = i % 10;
+      if (!near_tie(value, decimals))
+      {
+        LEPTON_CHECK_MESSAGE(fixed(value, decimals) == expected_fixed(value, decimals), expected_fixed(value, decimals));
+      }
+    }
+    LEPTON_CHECK(fixed(0.0005, 3) == "0.001"); // Half away from zero
+    LEPTON_CHECK(fixed(-2.5, 0) == "-3");
+    LEPTON_CHECK(fixed(-0.0001, 3) == "0.000");
+    LEPTON_CHECK(fixed(12.0, 9) == "12.000000000");
+  });
+
+  suite.run("fixed hands large and non-finite values to the shortest form", [&]
+  {
+    for (double value : {9.0e15, -1.0e300, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()})
+    {
+      LEPTON_CHECK(fixed(value, 0) == expected_shortest(value));
+    }
+    LEPTON_CHECK(fixed(1.0e13, 3) == expected_shortest(1.0e13));
+  });
+
+  suite.run("unsigned integers", [&]
+  {
+    for (unsigned long long value : {0ULL, 9ULL, 10ULL, 99999999ULL, 100000000ULL, 12345678901234567ULL, 100000000000000000ULL,
+                                     std::numeric_limits<unsigned long long>::max()})
+    {
+      char text[number_room];
+      LEPTON_CHECK(std::string(text, format_unsigned(text, value)) == std::to_string(value));
+    }
+  });
+  return suite.finish();
+}
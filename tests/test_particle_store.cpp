@@ -0,0 +1,65 @@
+// Description: Checks that ParticleStore validates energies the same way for every particle type and round-trips rows through objects.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventArena.h"
+#include "Particle.h"
+#include "ParticleStore.h"
+#include <limits>
+
+int main()
+{
+  TestSuite suite("particle_store");
+
+  suite.run("every add_* rejects non-positive and NaN energy", [&]
+  {
+    for (double energy : {0.0, -1000.0, std::numeric_limits<double>::quiet_NaN()})
+    {
+      ParticleStore store;
+      LEPTON_CHECK_THROWS(std::invalid_argument, store.add_electron(0.511, -1, energy, 10.0, 20.0, 30.0));
+      LEPTON_CHECK_THROWS(std::invalid_argument, store.add_muon(105.7, -1, energy, 10.0, 20.0, 30.0));
+      LEPTON_CHECK_THROWS(std::invalid_argument, store.add_neutrino(0.0, 0, energy, 10.0, 20.0, 30.0, NeutrinoFlavor::Muon));
+      LEPTON_CHECK_THROWS(std::invalid_argument, store.add_tau_neutrino(0.0, 0, energy, 10.0, 20.0, 30.0));
+      LEPTON_CHECK_THROWS(std::invalid_argument, store.add_tau(1776.9, -1, energy, 10.0, 20.0, 30.0, TauDecayMode::Hadronic));
+      LEPTON_CHECK(store.empty()); // A rejected particle leaves no partial row behind
+    }
+  });
+
+  suite.run("positive energies are stored unchanged", [&]
+  {
+    ParticleStore store;
+    store.add_muon(105.7, 1, 5000.0, 1000.0, -2000.0, 3000.0);
+    store.add_neutrino(0.0, 0, 1e-3, 0.0, 0.0, 1e-3, NeutrinoFlavor::Electron);
+    LEPTON_CHECK(store.size() == 2);
+    LEPTON_CHECK(store[0].get_e() == 5000.0);
+    LEPTON_CHECK(store[1].get_e() == 1e-3);
+    LEPTON_CHECK_THROWS(std::invalid_argument, store.set_four_momentum(0, 0.0, 0.0, 0.0, 0.0));
+    LEPTON_CHECK_THROWS(std::invalid_argument, store.set_four_momentum(0, std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0, 0.0));
+    LEPTON_CHECK(store[0].get_e() == 5000.0);
+  });
+  suite.run("electron layers round-trip through objects unchanged", [&]
+  {
+    const std::array<std::array<double, 4>, 3> layers = {{{0.0, 0.0, 0.0, 0.0}, {100.0, 200.0, 300.0, 50.0}, {600.0, 300.0, 75.0, 25.0}}};
+    ParticleStore store;
+    for (const std::array<double, 4>& electron_layers : layers)
+    {
+      store.add_electron(0.511, -1, 1000.0, 300.0, -400.0, 800.0, electron_layers); // Only the last matches the energy
+    }
+    EventArena arena;
+    ArenaSpan<Lepton*> objects = store.materialize(arena);
+    std::vector<Particle> particles = make_particles(store);
+    ParticleStore copy;
+    for (Lepton* object : objects)
+    {
+      copy.add(*object);
+    }
+    for (ParticleStore::Index i = 0; i < store.size(); ++i)
+    {
+      LEPTON_CHECK(static_cast<const Electron*>(objects[i])->get_layer_energies() == layers[i]);
+      LEPTON_CHECK(std::get<Electron>(particles[i]).get_layer_energies() == layers[i]);
+      LEPTON_CHECK(copy[i].get_layer_energies() == layers[i]);
+    }
+  });
+  return suite.finish();
+}
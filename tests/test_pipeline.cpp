@@ -0,0 +1,50 @@
+// Description: Checks the per-stage batch timings the Pipeline reports against its counts and end-to-end latency.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "Pipeline.h"
+#include <chrono>
+#include <thread>
+
+int main()
+{
+  TestSuite suite("pipeline");
+
+  suite.run("stage timings are per batch and bounded by the latency", [&]
+  {
+    PipelineConfig config;
+    config.total_events = 1000;
+    config.batch_size = 100;
+    config.analysis_threads = 2;
+    std::vector<Detector> detectors{Detector(DetectorType::Tracker)};
+    // A fixed sleep makes analysis the slowest stage by a known margin
+    Pipeline pipeline(EventGenerator(), detectors, [](const EventBatch&, std::size_t)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }, config);
+    PipelineStats stats = pipeline.run();
+
+    for (const StageStats* stage : {&stats.generation, &stats.detection, &stats.analysis})
+    {
+      LEPTON_CHECK(stage->batches == 10);
+      LEPTON_CHECK(stage->events == 1000);
+      LEPTON_CHECK(stage->get_mean_batch_seconds() > 0.0);
+      LEPTON_CHECK(stage->get_mean_batch_seconds() <= stage->max_batch_seconds);
+      LEPTON_CHECK(stage->max_batch_seconds <= stats.max_latency_seconds); // A batch's latency includes every stage's work on it
+    }
+    LEPTON_CHECK(stats.analysis.get_mean_batch_seconds() >= 0.002);
+    LEPTON_CHECK(stats.mean_latency_seconds >= stats.analysis.get_mean_batch_seconds());
+  });
+
+  suite.run("add_batch tracks the mean and max per batch", [&]
+  {
+    StageStats stage;
+    LEPTON_CHECK(stage.get_mean_batch_seconds() == 0.0);
+    stage.add_batch(0.5, 10);
+    stage.add_batch(0.25, 10);
+    LEPTON_CHECK(stage.get_mean_batch_seconds() == 0.375);
+    LEPTON_CHECK(stage.max_batch_seconds == 0.5);
+  });
+  return suite.finish();
+}
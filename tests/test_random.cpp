@@ -0,0 +1,156 @@
+// Description: Checks the batch samplers value for value against single draws from the same Philox stream, at every SIMD level.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "MomentumKernels.h"
+#include "Random.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr std::uint64_t seed = 20261017;
+  constexpr std::uint64_t event_number = 4242;
+  constexpr double two_pi = 6.283185307179586;
+
+  // Around the vector widths (4 and 8 blocks) and the 256-block chunks
+  const std::size_t counts[] = {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 33, 511, 512, 513, 1024, 1027};
+
+  RandomEngine make_engine() { return make_event_engine(seed, event_number, RandomStream::DetectorResponse); }
+
+  // The single draws each batch must reproduce, from an engine positioned like the batch's
+  std::vector<std::uint64_t> single_bits(RandomEngine& engine, std::size_t count)
+  {
+    std::vector<std::uint64_t> bits(count + count % 2); // Whole blocks, as the batch consumes
+    for (std::uint64_t& value : bits)
+    {
+      value = engine();
+    }
+    bits.resize(count);
+    return bits;
+  }
+
+  std::string label(std::size_t count) { return std::to_string(count) + " values"; }
+
+  void check_level()
+  {
+    for (std::size_t count : counts)
+    {
+      RandomEngine batch = make_engine();
+      RandomEngine single = make_engine();
+      std::vector<std::uint64_t> bits(count);
+      fill_random_bits(batch, bits.data(), count);
+      LEPTON_CHECK_MESSAGE(bits == single_bits(single, count), label(count));
+      LEPTON_CHECK_MESSAGE(batch() == single(), label(count) + ": the engine goes on after the batch's last block");
+    }
+
+    for (std::size_t count : counts)
+    {
+      RandomEngine batch = make_engine();
+      RandomEngine single = make_engine();
+      std::vector<double> values(count);
+      fill_uniform(batch, values.data(), count, -2.5, 7.0);
+      std::vector<std::uint64_t> bits = single_bits(single, count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        LEPTON_CHECK_MESSAGE(same_bits(values[i], -2.5 + 9.5 * to_unit_interval(bits[i])), label(count));
+      }
+    }
+
+    for (std::size_t count : counts)
+    {
+      RandomEngine batch = make_engine();
+      RandomEngine single = make_engine();
+      std::vector<double> values(count);
+      fill_gaussian(batch, values.data(), count, 100.0, 15.0);
+      std::vector<std::uint64_t> bits = single_bits(single, count + 1);
+      for (std::size_t i = 0; i < count; i += 2)
+      {
+        double radius = 15.0 * std::sqrt(-2.0 * std::log(1.0 - to_unit_interval(bits[i])));
+        double angle = two_pi * to_unit_interval(bits[i + 1]);
+        LEPTON_CHECK_MESSAGE(same_bits(values[i], 100.0 + radius * std::cos(angle)), label(count));
+        if (i + 1 < count)
+        {
+          LEPTON_CHECK_MESSAGE(same_bits(values[i + 1], 100.0 + radius * std::sin(angle)), label(count));
+        }
+      }
+    }
+
+    for (std::size_t count : counts)
+    {
+      RandomEngine batch = make_engine();
+      RandomEngine single = make_engine();
+      std::vector<double> values(count);
+      fill_exponential(batch, values.data(), count, 3.0);
+      std::vector<std::uint64_t> bits = single_bits(single, count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        LEPTON_CHECK_MESSAGE(same_bits(values[i], -3.0 * std::log(1.0 - to_unit_interval(bits[i]))), label(count));
+      }
+    }
+  }
+}
+
+int main()
+{
+  TestSuite suite("random");
+
+  SimdLevel detected = detect_simd_level();
+  for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512})
+  {
+    std::string name = std::string("batch samplers match single draws [") + simd_level_name(level) + "]";
+    if (level > detected)
+    {
+      std::cout << "[SKIP] random: " << name << " (not supported by this CPU)\n";
+      continue;
+    }
+    suite.run(name, [&]
+    {
+      set_kernel_simd_level(level);
+      check_level();
+    });
+  }
+  set_kernel_simd_level(detected);
+
+  suite.run("a batch after an odd number of draws starts at the next block", [&]
+  {
+    RandomEngine batch = make_engine();
+    RandomEngine single = make_engine();
+    LEPTON_CHECK(batch() == single());
+    std::vector<std::uint64_t> bits(5);
+    fill_random_bits(batch, bits.data(), bits.size());
+    single(); // The rest of the first block is skipped, not handed out
+    LEPTON_CHECK(bits == single_bits(single, bits.size()));
+    LEPTON_CHECK(batch() == single());
+  });
+
+  suite.run("streams and events are independent", [&]
+  {
+    std::uint64_t first[4];
+    std::uint64_t other_stream[4];
+    std::uint64_t other_event[4];
+    RandomEngine engine = make_engine();
+    RandomEngine stream_engine = make_event_engine(seed, event_number, RandomStream::TauDecay);
+    RandomEngine event_engine = make_event_engine(seed, event_number + 1, RandomStream::DetectorResponse);
+    fill_random_bits(engine, first, 4);
+    fill_random_bits(stream_engine, other_stream, 4);
+    fill_random_bits(event_engine, other_event, 4);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      LEPTON_CHECK(first[i] != other_stream[i] && first[i] != other_event[i]);
+    }
+  });
+
+  suite.run("an exhausted stream throws instead of repeating", [&]
+  {
+    RandomEngine engine = make_engine();
+    engine.reserve_blocks((std::uint64_t(1) << 32) - 1);
+    std::uint64_t bits[4];
+    fill_random_bits(engine, bits, 2); // The last block
+    LEPTON_CHECK_THROWS(std::out_of_range, fill_random_bits(engine, bits, 1));
+    LEPTON_CHECK_THROWS(std::out_of_range, engine());
+  });
+  return suite.finish();
+}
@@ -0,0 +1,244 @@
+// Description: Checks Trigger decisions and counters against selection on Lepton objects, and that prescales are reproducible.
+// Author: Leo Feasby
+// Date: 17/10/2026
+
+#include "TestHarness.h"
+#include "EventArena.h"
+#include "EventGenerator.h"
+#include "Lepton.h"
+#include "ThreadPool.h"
+#include "Trigger.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr std::uint64_t first_event = 5000;
+
+  std::vector<Detector> make_detectors(bool calorimeter_on = true)
+  {
+    std::vector<Detector> detectors{Detector(DetectorType::Tracker), Detector(DetectorType::Calorimeter), Detector(DetectorType::MuonChamber)};
+    for (auto& detector : detectors)
+    {
+      detector.turn_on();
+    }
+    if (!calorimeter_on)
+    {
+      detectors[1].turn_off();
+    }
+    return detectors;
+  }
+
+  // main.cpp's two physics paths, a charge-sum path over every lepton type, and an |eta|-only path
+  std::vector<TriggerPathConfig> make_paths()
+  {
+    TriggerPathConfig single_muon;
+    single_muon.name = "single_muon";
+    single_muon.particle_types = particle_type_bit(ParticleType::Muon);
+    single_muon.min_pt = 25000.0;
+    single_muon.max_abs_eta = 2.4;
+    single_muon.required_detectors = detector_type_bit(DetectorType::Tracker) | detector_type_bit(DetectorType::MuonChamber);
+    single_muon.min_detected = 1;
+    TriggerPathConfig dielectron;
+    dielectron.name = "dielectron";
+    dielectron.particle_types = particle_type_bit(ParticleType::Electron);
+    dielectron.min_pt = 10000.0;
+    dielectron.min_candidates = 2;
+    dielectron.max_abs_charge_sum = 0;
+    dielectron.required_detectors = detector_type_bit(DetectorType::Tracker) | detector_type_bit(DetectorType::Calorimeter);
+    dielectron.min_detected = 2;
+    TriggerPathConfig multilepton;
+    multilepton.name = "multilepton";
+    multilepton.particle_types = particle_type_bit(ParticleType::Electron) | particle_type_bit(ParticleType::Muon) | particle_type_bit(ParticleType::Tau);
+    multilepton.min_pt = 5000.0;
+    multilepton.min_candidates = 3;
+    multilepton.max_abs_charge_sum = 1;
+    multilepton.required_detectors = detector_type_bit(DetectorType::Tracker);
+    multilepton.min_detected = 3;
+    TriggerPathConfig central;
+    central.name = "central";
+    central.max_abs_eta = 1.0;
+    return {single_muon, dielectron, multilepton, central};
+  }
+
+  // The same selection asked of Lepton objects, one level at a time
+  void decide_objects(const TriggerPathConfig& path, const std::vector<Detector>& detectors, const ArenaSpan<Lepton*>& particles,
+                      bool& level1, bool& high_level)
+  {
+    std::size_t candidates = 0;
+    std::size_t detected = 0;
+    int charge_sum = 0;
+    for (const Lepton* particle : particles)
+    {
+      const CachedFourMomentum& momentum = particle->get_kinematics();
+      if ((path.particle_types & particle_type_bit(particle->get_type_id())) == 0 || momentum.get_pt() < path.min_pt ||
+          std::abs(momentum.get_eta()) > path.max_abs_eta)
+      {
+        continue;
+      }
+      ++candidates;
+      charge_sum += particle->get_charge();
+      std::uint8_t seen = 0;
+      for (const auto& detector : detectors)
+      {
+        if (detector.get_status() && Detector::accepts(detector.get_type(), particle->get_type_id()))
+        {
+          seen |= detector_type_bit(detector.get_type());
+        }
+      }
+      detected += (seen & path.required_detectors) == path.required_detectors;
+    }
+    level1 = candidates >= path.min_candidates && std::abs(charge_sum) <= path.max_abs_charge_sum;
+    high_level = level1 && detected >= path.min_detected;
+  }
+
+  std::uint64_t count_bit(const std::vector<TriggerDecision>& decisions, std::uint32_t TriggerDecision::*field, std::size_t path)
+  {
+    std::uint64_t count = 0;
+    for (const TriggerDecision& decision : decisions)
+    {
+      count += (decision.*field >> path) & 1;
+    }
+    return count;
+  }
+
+  void check_against_objects(const std::vector<TriggerPathConfig>& paths, const std::vector<Detector>& detectors,
+                             const std::vector<ParticleStore>& events)
+  {
+    Trigger trigger(paths, detectors);
+    std::vector<TriggerDecision> decisions;
+    TriggerStats stats = trigger.make_stats();
+    std::size_t accepted = trigger.filter(first_event, events, decisions, stats);
+    LEPTON_CHECK(decisions.size() == events.size() && stats.events == events.size());
+
+    EventArena arena;
+    std::size_t expected_accepted = 0;
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+      ArenaSpan<Lepton*> particles = events[e].materialize(arena);
+      for (std::size_t p = 0; p < paths.size(); ++p)
+      {
+        bool level1, high_level;
+        decide_objects(paths[p], detectors, particles, level1, high_level);
+        std::string label = paths[p].name + ", event " + std::to_string(e);
+        LEPTON_CHECK_MESSAGE(((decisions[e].level1 >> p) & 1) == level1, label);
+        LEPTON_CHECK_MESSAGE(((decisions[e].high_level >> p) & 1) == high_level, label);
+        LEPTON_CHECK_MESSAGE(((decisions[e].accepted >> p) & 1) == high_level, label); // No prescales
+      }
+      expected_accepted += decisions[e].is_accepted();
+      arena.reset();
+    }
+    LEPTON_CHECK(accepted == expected_accepted && stats.accepted == expected_accepted);
+    for (std::size_t p = 0; p < paths.size(); ++p)
+    {
+      LEPTON_CHECK_MESSAGE(stats.paths[p].level1 == count_bit(decisions, &TriggerDecision::level1, p), paths[p].name);
+      LEPTON_CHECK_MESSAGE(stats.paths[p].high_level == count_bit(decisions, &TriggerDecision::high_level, p), paths[p].name);
+      LEPTON_CHECK_MESSAGE(stats.paths[p].accepted == count_bit(decisions, &TriggerDecision::accepted, p), paths[p].name);
+      LEPTON_CHECK_MESSAGE(stats.paths[p].level1 > 0 && stats.paths[p].level1 < events.size(), paths[p].name + " must pass some events, not all");
+    }
+  }
+}
+
+int main()
+{
+  TestSuite suite("trigger");
+  ThreadPool pool(2);
+  EventGeneratorConfig config;
+  config.type_weights = {{0.3, 0.3, 0.1, 0.1, 0.2}};
+  const std::vector<ParticleStore> events = EventGenerator(config).generate(first_event, 3000, pool);
+
+  suite.run("decisions and counters match selection on Lepton objects", [&]
+  {
+    check_against_objects(make_paths(), make_detectors(), events);
+  });
+
+  suite.run("a detector that is off fails the paths that need it at the high level only", [&]
+  {
+    check_against_objects(make_paths(), make_detectors(false), events);
+    Trigger trigger(make_paths(), make_detectors(false));
+    std::vector<TriggerDecision> decisions;
+    TriggerStats stats = trigger.make_stats();
+    trigger.filter(first_event, events, decisions, stats);
+    LEPTON_CHECK(stats.paths[1].level1 > 0 && stats.paths[1].high_level == 0); // The dielectron path needs the calorimeter
+  });
+
+  suite.run("prescales keep about one in n, reproducibly", [&]
+  {
+    std::vector<TriggerPathConfig> paths;
+    for (std::uint32_t prescale : {1u, 2u, 5u, 20u})
+    {
+      TriggerPathConfig path = make_paths()[3];
+      path.name = "central_" + std::to_string(prescale);
+      path.prescale = prescale;
+      paths.push_back(path);
+    }
+    Trigger trigger(paths, make_detectors());
+    std::vector<TriggerDecision> decisions;
+    TriggerStats stats = trigger.make_stats();
+    trigger.filter(first_event, events, decisions, stats);
+    for (std::size_t p = 0; p < paths.size(); ++p)
+    {
+      for (const TriggerDecision& decision : decisions)
+      {
+        LEPTON_CHECK(((decision.accepted & ~decision.high_level) >> p & 1) == 0);
+        LEPTON_CHECK(((decision.high_level ^ decision.level1) >> p & 1) == 0); // No detectors required, so both levels agree
+      }
+      double high_level = static_cast<double>(stats.paths[p].high_level);
+      double expected = high_level / paths[p].prescale;
+      double accepted = static_cast<double>(stats.paths[p].accepted);
+      LEPTON_CHECK_MESSAGE(std::abs(accepted - expected) <= 5.0 * std::sqrt(expected) + 1.0, paths[p].name + ": " + std::to_string(accepted));
+    }
+    LEPTON_CHECK(stats.paths[0].accepted == stats.paths[0].high_level);
+    LEPTON_CHECK(stats.paths[3].accepted < stats.paths[2].accepted && stats.paths[2].accepted < stats.paths[1].accepted);
+
+    // The same event numbers in other batches get the same decisions
+    std::vector<ParticleStore> first_half(events.begin(), events.begin() + 1300);
+    std::vector<ParticleStore> second_half(events.begin() + 1300, events.end());
+    std::vector<TriggerDecision> first_decisions, second_decisions;
+    TriggerStats first_stats = trigger.make_stats();
+    TriggerStats second_stats = trigger.make_stats();
+    trigger.filter(first_event, first_half, first_decisions, first_stats);
+    trigger.filter(first_event + 1300, second_half, second_decisions, second_stats);
+    first_stats.merge(second_stats);
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+      const TriggerDecision& split = e < 1300 ? first_decisions[e] : second_decisions[e - 1300];
+      LEPTON_CHECK(split.accepted == decisions[e].accepted);
+    }
+    LEPTON_CHECK(first_stats.events == stats.events && first_stats.accepted == stats.accepted);
+    for (std::size_t p = 0; p < paths.size(); ++p)
+    {
+      LEPTON_CHECK(first_stats.paths[p].accepted == stats.paths[p].accepted && first_stats.paths[p].level1 == stats.paths[p].level1);
+    }
+
+    // Other event numbers make other choices
+    std::vector<TriggerDecision> shifted;
+    TriggerStats shifted_stats = trigger.make_stats();
+    trigger.filter(first_event + 1, events, shifted, shifted_stats);
+    bool differs = false;
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+      differs |= shifted[e].accepted != decisions[e].accepted;
+    }
+    LEPTON_CHECK(differs);
+  });
+
+  suite.run("unusable configurations are rejected", [&]
+  {
+    LEPTON_CHECK_THROWS(std::invalid_argument, Trigger({}, make_detectors()));
+    LEPTON_CHECK_THROWS(std::invalid_argument, Trigger(std::vector<TriggerPathConfig>(max_trigger_paths + 1), make_detectors()));
+    std::vector<TriggerPathConfig> paths = make_paths();
+    paths[2].prescale = 0;
+    LEPTON_CHECK_THROWS(std::invalid_argument, Trigger(paths, make_detectors()));
+
+    Trigger trigger(make_paths(), make_detectors());
+    Trigger other({make_paths()[0]}, make_detectors());
+    std::vector<TriggerDecision> decisions;
+    TriggerStats stats = other.make_stats();
+    LEPTON_CHECK_THROWS(std::invalid_argument, trigger.filter(first_event, events, decisions, stats));
+    TriggerStats merged = trigger.make_stats();
+    LEPTON_CHECK_THROWS(std::invalid_argument, merged.merge(stats));
+  });
+  return suite.finish();
+}